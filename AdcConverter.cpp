@@ -0,0 +1,77 @@
+/**
+ * AdcConverter.cpp
+ *
+ * Implementation der Integer-ADC-Umrechnung
+ */
+
+#include "include/AdcConverter.h"
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LINEARE ABBILDUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+AdcLinear AdcLinear::make(float gain, int32_t offset) {
+    AdcLinear map;
+    map.gainQ16 = (int32_t)(gain * 65536.0f + (gain >= 0.0f ? 0.5f : -0.5f));
+    map.offset = offset;
+    return map;
+}
+
+bool AdcLinear::fromPoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, AdcLinear& out) {
+    if (x1 == x2) return false;
+    int64_t num = (int64_t)(y2 - y1) * 65536;
+    int32_t den = x2 - x1;
+    // Auf nächsten Wert runden (Vorzeichen beachten)
+    out.gainQ16 = (int32_t)((num + ((num < 0) == (den < 0) ? den / 2 : -den / 2)) / den);
+    out.offset = 0;
+    out.offset = y1 - out.apply(x1);
+    return true;
+}
+
+AdcLinear AdcLinear::then(const AdcLinear& next) const {
+    AdcLinear map;
+    map.gainQ16 = (int32_t)(((int64_t)gainQ16 * next.gainQ16 + 0x8000) >> 16);
+    map.offset = next.apply(offset);
+    return map;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// KENNLINIE
+// ═══════════════════════════════════════════════════════════════════════════
+
+AdcConverter::AdcConverter() {
+    setLinear(3300);
+}
+
+void AdcConverter::setLinear(uint16_t fullScaleMv) {
+    for (uint16_t i = 0; i < LUT_POINTS; i++) {
+        uint32_t counts = (uint32_t)i << LUT_SHIFT;
+        lut[i] = (uint16_t)((counts * fullScaleMv + MAX_COUNTS / 2) / MAX_COUNTS);
+    }
+    name = "linear";
+}
+
+void AdcConverter::build(RawToMv source, void* ctx, const char* sourceName) {
+    for (uint16_t i = 0; i < LUT_POINTS - 1; i++) {
+        int mv = source(i << LUT_SHIFT, ctx);
+        lut[i] = (uint16_t)(mv < 0 ? 0 : mv);
+    }
+
+    // Letzter Stützpunkt liegt bei 4096 (außerhalb 12 Bit): aus 4064..4095 fortsetzen
+    uint16_t lastStart = (LUT_POINTS - 2) << LUT_SHIFT;
+    int32_t atStart = source(lastStart, ctx);
+    int32_t atMax = source(MAX_COUNTS, ctx);
+    int32_t span = MAX_COUNTS - lastStart;
+    int32_t extrapolated = atStart + ((atMax - atStart) * (1 << LUT_SHIFT) + span / 2) / span;
+    lut[LUT_POINTS - 1] = (uint16_t)(extrapolated < 0 ? 0 : extrapolated);
+
+    name = sourceName;
+}
+
+float AdcConverter::toMvFloat(float counts) const {
+    if (counts <= 0.0f) return lut[0];
+    if (counts >= MAX_COUNTS) return (float)toMv(MAX_COUNTS);
+    uint16_t i = (uint16_t)counts >> LUT_SHIFT;
+    float frac = (counts - (float)(i << LUT_SHIFT)) / (1 << LUT_SHIFT);
+    return lut[i] + (lut[i + 1] - lut[i]) * frac;
+}
@@ -0,0 +1,284 @@
+/**
+ * AdcSampler.cpp
+ *
+ * Implementation der kontinuierlichen ADC-Abtastung
+ */
+
+#include "include/AdcSampler.h"
+#include <esp_timer.h>
+
+AdcSampler::AdcSampler()
+    : handle(nullptr)
+    , task(nullptr)
+    , running(false)
+    , frames(0)
+    , samples(0)
+    , overflows(0)
+    , foreign(0)
+    , lastFrameCycles(0)
+    , maxFrameCycles(0)
+    , busyCycles(0)
+    , statsStartUs(0)
+{
+    windowLock = portMUX_INITIALIZER_UNLOCKED;
+
+    for (int i = 0; i < 16; i++) {
+        slotOf[i] = -1;
+    }
+    for (int i = 0; i < ADC_CH_COUNT; i++) {
+        decimSum[i] = 0;
+        decimCount[i] = 0;
+        fastRaw[i] = 0;
+        windowSum[i] = 0;
+        windowBlocks[i] = 0;
+        windowMin[i] = 0xFFFF;
+        windowMax[i] = 0;
+    }
+}
+
+AdcSampler::~AdcSampler() {
+    end();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INITIALISIERUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool AdcSampler::begin(uint8_t voltagePin, uint8_t currentPin) {
+    if (running) return true;
+
+    const uint8_t pins[ADC_CH_COUNT] = { voltagePin, currentPin };
+    adc_digi_pattern_config_t pattern[ADC_CH_COUNT] = {};
+
+    for (uint8_t i = 0; i < ADC_CH_COUNT; i++) {
+        adc_unit_t unit;
+        adc_channel_t channel;
+        if (adc_continuous_io_to_channel(pins[i], &unit, &channel) != ESP_OK || unit != ADC_UNIT_1) {
+            DEBUG_PRINTF("AdcSampler: ❌ GPIO%d ist kein ADC1-Pin\n", pins[i]);
+            return false;
+        }
+        pattern[i].atten = ADC_ATTEN_DB_12;
+        pattern[i].channel = (uint8_t)channel;
+        pattern[i].unit = ADC_UNIT_1;
+        pattern[i].bit_width = ADC_BITWIDTH_12;
+        slotOf[channel & 0x0F] = (int8_t)i;
+    }
+
+    adc_continuous_handle_cfg_t handleConfig = {};
+    handleConfig.max_store_buf_size = ADC_DMA_POOL_SIZE;
+    handleConfig.conv_frame_size = ADC_DMA_FRAME_SIZE;
+    if (adc_continuous_new_handle(&handleConfig, &handle) != ESP_OK) {
+        DEBUG_PRINTLN("AdcSampler: ❌ DMA-Handle fehlgeschlagen");
+        handle = nullptr;
+        return false;
+    }
+
+    adc_continuous_config_t config = {};
+    config.pattern_num = ADC_CH_COUNT;
+    config.adc_pattern = pattern;
+    config.sample_freq_hz = ADC_SAMPLE_HZ;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+
+    adc_continuous_evt_cbs_t callbacks = {};
+    callbacks.on_conv_done = onConvDone;
+    callbacks.on_pool_ovf = onPoolOverflow;
+
+    if (adc_continuous_config(handle, &config) != ESP_OK ||
+        adc_continuous_register_event_callbacks(handle, &callbacks, this) != ESP_OK) {
+        DEBUG_PRINTLN("AdcSampler: ❌ Konfiguration fehlgeschlagen");
+        adc_continuous_deinit(handle);
+        handle = nullptr;
+        return false;
+    }
+
+    // Task vor dem Start anlegen: der erste Frame weckt ihn bereits
+    if (xTaskCreatePinnedToCore(taskEntry, "adc_sampler", ADC_TASK_STACK, this,
+                                ADC_TASK_PRIORITY, &task, ADC_TASK_CORE) != pdPASS) {
+        DEBUG_PRINTLN("AdcSampler: ❌ Task konnte nicht erstellt werden");
+        adc_continuous_deinit(handle);
+        handle = nullptr;
+        task = nullptr;
+        return false;
+    }
+
+    resetStats();
+    if (adc_continuous_start(handle) != ESP_OK) {
+        DEBUG_PRINTLN("AdcSampler: ❌ Start fehlgeschlagen");
+        vTaskDelete(task);
+        task = nullptr;
+        adc_continuous_deinit(handle);
+        handle = nullptr;
+        return false;
+    }
+    running = true;
+
+    DEBUG_PRINTF("AdcSampler: ✅ %d Hz (%d Hz/Kanal), Dezimation %d → %d Hz\n",
+                 ADC_SAMPLE_HZ, ADC_SAMPLE_HZ / ADC_CH_COUNT, ADC_DECIMATION,
+                 ADC_SAMPLE_HZ / ADC_CH_COUNT / ADC_DECIMATION);
+    return true;
+}
+
+void AdcSampler::end() {
+    if (!handle) return;
+
+    running = false;
+    adc_continuous_stop(handle);
+    if (task) {
+        vTaskDelete(task);
+        task = nullptr;
+    }
+    adc_continuous_deinit(handle);
+    handle = nullptr;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DMA-CALLBACKS & TASK
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool IRAM_ATTR AdcSampler::onConvDone(adc_continuous_handle_t handle,
+                                      const adc_continuous_evt_data_t* data, void* arg) {
+    AdcSampler* self = static_cast<AdcSampler*>(arg);
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(self->task, &woken);
+    return woken == pdTRUE;
+}
+
+bool IRAM_ATTR AdcSampler::onPoolOverflow(adc_continuous_handle_t handle,
+                                          const adc_continuous_evt_data_t* data, void* arg) {
+    static_cast<AdcSampler*>(arg)->overflows++;
+    return false;
+}
+
+void AdcSampler::taskEntry(void* arg) {
+    AdcSampler* self = static_cast<AdcSampler*>(arg);
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // Alle fertigen Frames abholen (mehrere, falls der Task verdrängt war)
+        // Gemessen wird Abholen aus dem DMA-Pool + Verarbeitung
+        while (self->handle) {
+            uint32_t start = ESP.getCycleCount();
+            uint32_t length = 0;
+            if (adc_continuous_read(self->handle, self->frameBuffer, ADC_DMA_FRAME_SIZE, &length, 0) != ESP_OK) {
+                break;
+            }
+            self->processFrame(self->frameBuffer, length);
+            uint32_t cycles = ESP.getCycleCount() - start;
+
+            self->lastFrameCycles = cycles;
+            if (cycles > self->maxFrameCycles) self->maxFrameCycles = cycles;
+            self->busyCycles += cycles;
+            self->frames++;
+        }
+    }
+}
+
+void AdcSampler::processFrame(const uint8_t* buffer, uint32_t length) {
+    const adc_digi_output_data_t* results = (const adc_digi_output_data_t*)buffer;
+    uint32_t count = length / sizeof(adc_digi_output_data_t);
+
+    for (uint32_t i = 0; i < count; i++) {
+        int8_t slot = slotOf[results[i].type2.channel];
+        if (slot < 0) {
+            foreign++;
+            continue;
+        }
+
+        decimSum[slot] += results[i].type2.data;
+        if (++decimCount[slot] == ADC_DECIMATION) {
+            uint16_t value = (uint16_t)((decimSum[slot] + ADC_DECIMATION / 2) / ADC_DECIMATION);
+            decimSum[slot] = 0;
+            decimCount[slot] = 0;
+            fastRaw[slot] = value;
+            pushBlock((uint8_t)slot, value);
+        }
+    }
+    samples += count;
+}
+
+void AdcSampler::pushBlock(uint8_t slot, uint16_t value) {
+    portENTER_CRITICAL(&windowLock);
+    windowSum[slot] += value;
+    windowBlocks[slot]++;
+    if (value < windowMin[slot]) windowMin[slot] = value;
+    if (value > windowMax[slot]) windowMax[slot] = value;
+    portEXIT_CRITICAL(&windowLock);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ABRUF
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool AdcSampler::takeWindow(AdcChannelId ch, AdcWindow& out) {
+    portENTER_CRITICAL(&windowLock);
+    uint32_t sum = windowSum[ch];
+    out.blocks = windowBlocks[ch];
+    out.min = windowMin[ch];
+    out.max = windowMax[ch];
+    windowSum[ch] = 0;
+    windowBlocks[ch] = 0;
+    windowMin[ch] = 0xFFFF;
+    windowMax[ch] = 0;
+    portEXIT_CRITICAL(&windowLock);
+
+    if (out.blocks == 0) {
+        out.mean = 0;
+        out.min = 0;
+        return false;
+    }
+
+    out.mean = (uint16_t)((sum + out.blocks / 2) / out.blocks);
+    return true;
+}
+
+AdcSamplerStats AdcSampler::getStats() const {
+    AdcSamplerStats stats;
+    stats.running = running;
+    stats.frames = frames;
+    stats.samples = samples;
+    stats.overflows = overflows;
+    stats.foreign = foreign;
+    stats.lastFrameCycles = lastFrameCycles;
+    stats.maxFrameCycles = maxFrameCycles;
+    stats.cyclesPerSample = samples ? (uint32_t)(busyCycles / samples) : 0;
+
+    int64_t elapsedUs = esp_timer_get_time() - statsStartUs;
+    if (elapsedUs > 0) {
+        stats.sampleRateHz = (uint32_t)((uint64_t)samples * 1000000ULL / elapsedUs);
+        uint64_t elapsedCycles = (uint64_t)elapsedUs * ESP.getCpuFreqMHz();
+        stats.cpuLoadPermille = (uint32_t)(busyCycles * 1000ULL / elapsedCycles);
+    } else {
+        stats.sampleRateHz = 0;
+        stats.cpuLoadPermille = 0;
+    }
+    return stats;
+}
+
+void AdcSampler::resetStats() {
+    frames = 0;
+    samples = 0;
+    overflows = 0;
+    foreign = 0;
+    lastFrameCycles = 0;
+    maxFrameCycles = 0;
+    busyCycles = 0;
+    statsStartUs = esp_timer_get_time();
+}
+
+void AdcSampler::printInfo() const {
+    AdcSamplerStats stats = getStats();
+
+    DEBUG_PRINTF("ADC-Modus:    %s\n", stats.running ? "DMA kontinuierlich" : "analogRead (Einzelmessung)");
+    if (!stats.running) {
+        return;
+    }
+    DEBUG_PRINTF("Abtastrate:   %lu Hz gemessen (Soll %d Hz, Dezimation %d)\n",
+                 stats.sampleRateHz, ADC_SAMPLE_HZ, ADC_DECIMATION);
+    DEBUG_PRINTF("Frames:       %lu (%lu Werte, Überlauf %lu, fremd %lu)\n",
+                 stats.frames, stats.samples, stats.overflows, stats.foreign);
+    DEBUG_PRINTF("CPU:          %lu Zyklen/Wert, Frame last %lu / max %lu, Last %lu.%lu %%\n",
+                 stats.cyclesPerSample, stats.lastFrameCycles, stats.maxFrameCycles,
+                 stats.cpuLoadPermille / 10, stats.cpuLoadPermille % 10);
+}
@@ -0,0 +1,395 @@
+/**
+ * BatteryHistory.cpp
+ *
+ * Implementation des Akku-Verlaufs
+ */
+
+#include "include/BatteryHistory.h"
+#include "include/BatteryMonitor.h"
+#include <esp_rom_crc.h>
+#include <stddef.h>
+
+// Periode (s) und Slots pro Stufe
+static const uint32_t TIER_PERIOD[HISTORY_TIERS] = { 1, 60, 3600 };
+static const uint32_t TIER_SLOTS[HISTORY_TIERS] = {
+    HISTORY_SECONDS_SLOTS, HISTORY_MINUTES_SLOTS, HISTORY_HOURS_SLOTS
+};
+static const char* TIER_NAMES[HISTORY_TIERS] = { "Sekunden", "Minuten", "Stunden" };
+
+// Nullblock beim Anlegen der Datei
+static const size_t CREATE_CHUNK = 4096;
+
+static uint16_t toMillivolt(float volts) {
+    return (uint16_t)constrain(volts * 1000.0f + 0.5f, 0.0f, 65535.0f);
+}
+
+static int16_t toMilliamp(float amps) {
+    return (int16_t)constrain(lroundf(amps * 1000.0f), -32768L, 32767L);
+}
+
+BatteryHistory::BatteryHistory()
+    : sdHandler(nullptr)
+    , ready(false)
+    , baseTime(0)
+    , baseMs(0)
+    , lastTime(0)
+    , flushes(0)
+    , lastConsumedMAh(0.0f)
+    , lastConsumedWh(0.0f)
+    , haveCounters(false)
+    , pendingCount(0)
+    , lastFlushMs(0)
+    , samplesTotal(0)
+    , writeErrors(0)
+    , flushUsLast(0)
+    , flushUsMax(0)
+{
+    memset(open, 0, sizeof(open));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INITIALISIERUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool BatteryHistory::begin(SDCardHandler* sdHandler) {
+    this->sdHandler = sdHandler;
+    ready = false;
+
+    if (!sdHandler || !sdHandler->isAvailable()) {
+        DEBUG_PRINTLN("BatteryHistory: ⚠️ SD-Karte nicht verfügbar");
+        return false;
+    }
+
+    HistoryFileHeader header;
+    if (loadHeader(header)) {
+        // Zeitachse fortsetzen (nicht gesicherte Sekunden vor dem Neustart sind verloren)
+        baseTime = header.lastTime + 1;
+        flushes = header.flushes;
+    } else {
+        if (!createFile()) {
+            DEBUG_PRINTLN("BatteryHistory: ❌ Datei konnte nicht angelegt werden!");
+            return false;
+        }
+        baseTime = 1;
+        flushes = 0;
+    }
+
+    baseMs = millis();
+    lastTime = baseTime - 1;
+    lastFlushMs = baseMs;
+    pendingCount = 0;
+    haveCounters = false;
+    memset(open, 0, sizeof(open));
+    ready = true;
+
+    DEBUG_PRINTF("BatteryHistory: ✅ %s (%lu Bytes, Betriebszeit %lu s)\n",
+                 HISTORY_FILE, (unsigned long)tierOffset(HISTORY_TIERS), (unsigned long)baseTime);
+    return true;
+}
+
+bool BatteryHistory::createFile() {
+    if (!sdHandler->fileExists(BATTERY_STATE_DIR)) {
+        sdHandler->createDir(BATTERY_STATE_DIR);
+    }
+
+    uint8_t* zeros = (uint8_t*)calloc(1, CREATE_CHUNK);
+    if (!zeros) return false;
+
+    lastTime = 0;
+    flushes = 0;
+    bool ok = sdHandler->writeBinaryFile(HISTORY_FILE, zeros, sizeof(HistoryFileHeader)) && writeHeader();
+
+    // Alle Slots leer (samples = 0) in voller Größe vorbelegen
+    size_t remaining = tierOffset(HISTORY_TIERS) - sizeof(HistoryFileHeader);
+    while (ok && remaining > 0) {
+        size_t len = remaining < CREATE_CHUNK ? remaining : CREATE_CHUNK;
+        ok = sdHandler->appendBinaryFile(HISTORY_FILE, zeros, len);
+        remaining -= len;
+    }
+
+    free(zeros);
+    return ok;
+}
+
+bool BatteryHistory::loadHeader(HistoryFileHeader& header) {
+    if (!sdHandler->fileExists(HISTORY_FILE)) {
+        return false;
+    }
+
+    if (sdHandler->readBinaryAt(HISTORY_FILE, 0, (uint8_t*)&header, sizeof(header)) != (int)sizeof(header)) {
+        return false;
+    }
+
+    bool layoutOk = memcmp(header.magic, HISTORY_MAGIC, 4) == 0 &&
+                    header.version == HISTORY_VERSION &&
+                    header.headerSize == sizeof(HistoryFileHeader) &&
+                    header.recordSize == sizeof(HistoryRecord) &&
+                    header.tierCount == HISTORY_TIERS;
+    for (uint8_t i = 0; layoutOk && i < HISTORY_TIERS; i++) {
+        layoutOk = header.slots[i] == TIER_SLOTS[i];
+    }
+
+    if (!layoutOk ||
+        header.crc != esp_rom_crc32_le(0, (const uint8_t*)&header, offsetof(HistoryFileHeader, crc)) ||
+        sdHandler->getFileSize(HISTORY_FILE) != tierOffset(HISTORY_TIERS)) {
+        DEBUG_PRINTLN("BatteryHistory: ⚠️ Datei ungültig oder anderes Layout - neu angelegt");
+        return false;
+    }
+    return true;
+}
+
+bool BatteryHistory::writeHeader() {
+    HistoryFileHeader header = {};
+    memcpy(header.magic, HISTORY_MAGIC, 4);
+    header.version = HISTORY_VERSION;
+    header.headerSize = sizeof(HistoryFileHeader);
+    header.recordSize = sizeof(HistoryRecord);
+    header.tierCount = HISTORY_TIERS;
+    for (uint8_t i = 0; i < HISTORY_TIERS; i++) {
+        header.slots[i] = TIER_SLOTS[i];
+    }
+    header.lastTime = lastTime;
+    header.flushes = flushes;
+    header.crc = esp_rom_crc32_le(0, (const uint8_t*)&header, offsetof(HistoryFileHeader, crc));
+
+    if (!sdHandler->writeBinaryAt(HISTORY_FILE, 0, (const uint8_t*)&header, sizeof(header))) {
+        writeErrors++;
+        return false;
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// AUFZEICHNUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+void BatteryHistory::addSample(BatteryMonitor& battery) {
+    if (!ready) return;
+
+    // Verlaufs-Uhr läuft pro Messung weiter: Messintervall und Sekundengrenze
+    // liegen um die loop()-Verzögerung versetzt, die Uhrsekunde springt dann
+    // mal um 0 oder 2 - die Folge-Sekunde bleibt trotzdem lückenlos belegt.
+    // Erst ab 3 s Abstand (Blockade, Pause) entsteht eine echte Lücke.
+    uint32_t now = getTime();
+    if (now < lastTime) return;                 // Verlaufs-Uhr schon voraus
+    if (now <= lastTime + 2) now = lastTime + 1;
+
+    // Ladung/Energie als Differenz der Zähler (Rücksetzen → 0)
+    float consumedMAh = battery.getConsumedMAh();
+    float consumedWh = battery.getConsumedWh();
+    float deltaMAh = haveCounters ? consumedMAh - lastConsumedMAh : 0.0f;
+    float deltaWh = haveCounters ? consumedWh - lastConsumedWh : 0.0f;
+    lastConsumedMAh = consumedMAh;
+    lastConsumedWh = consumedWh;
+    haveCounters = true;
+
+    HistoryRecord sample = {};
+    sample.time = now;
+    sample.voltageMinMv = toMillivolt(battery.getVoltageMin());
+    sample.voltageAvgMv = toMillivolt(battery.getRawVoltage());
+    sample.voltageMaxMv = toMillivolt(battery.getVoltageMax());
+    sample.currentMinMa = toMilliamp(battery.getCurrentMin());
+    sample.currentAvgMa = toMilliamp(battery.getRawCurrent());
+    sample.currentMaxMa = toMilliamp(battery.getCurrentMax());
+    sample.chargeUah = deltaMAh > 0.0f ? (uint32_t)(deltaMAh * 1000.0f + 0.5f) : 0;
+    sample.energyUwh = deltaWh > 0.0f ? (uint32_t)(deltaWh * 1000000.0f + 0.5f) : 0;
+    sample.samples = 1;
+
+    lastTime = now;
+    samplesTotal++;
+
+    // Minuten-/Stunden-Aggregat: abgeschlossenes Intervall final schreiben
+    for (uint8_t tier = 1; tier < HISTORY_TIERS; tier++) {
+        Aggregate& agg = open[tier - 1];
+        uint32_t start = now - now % TIER_PERIOD[tier];
+
+        if (agg.rec.samples == 0 || agg.rec.time != start) {
+            if (agg.rec.samples > 0) {
+                writeRecords(tier, (agg.rec.time / TIER_PERIOD[tier]) % TIER_SLOTS[tier], &agg.rec, 1);
+            }
+            openInterval(tier, start);
+        }
+        fold(agg, sample);
+    }
+
+    pending[pendingCount++] = sample;
+    if (pendingCount >= HISTORY_FLUSH_RECORDS || millis() - lastFlushMs >= HISTORY_FLUSH_MS) {
+        flush();
+    }
+}
+
+void BatteryHistory::openInterval(uint8_t tier, uint32_t start) {
+    Aggregate& agg = open[tier - 1];
+    memset(&agg, 0, sizeof(agg));
+    agg.rec.time = start;
+
+    // Vor dem Neustart begonnenes Intervall fortsetzen
+    HistoryRecord stored;
+    uint32_t slot = (start / TIER_PERIOD[tier]) % TIER_SLOTS[tier];
+    if (sdHandler->readBinaryAt(HISTORY_FILE, tierOffset(tier) + slot * sizeof(HistoryRecord),
+                                (uint8_t*)&stored, sizeof(stored)) == (int)sizeof(stored) &&
+        stored.samples > 0 && stored.time == start) {
+        agg.rec = stored;
+        agg.voltageSumMv = (uint32_t)stored.voltageAvgMv * stored.samples;
+        agg.currentSumMa = (int32_t)stored.currentAvgMa * stored.samples;
+    }
+}
+
+void BatteryHistory::fold(Aggregate& agg, const HistoryRecord& sample) {
+    HistoryRecord& rec = agg.rec;
+
+    if (rec.samples == 0) {
+        rec.voltageMinMv = sample.voltageMinMv;
+        rec.voltageMaxMv = sample.voltageMaxMv;
+        rec.currentMinMa = sample.currentMinMa;
+        rec.currentMaxMa = sample.currentMaxMa;
+    } else {
+        if (sample.voltageMinMv < rec.voltageMinMv) rec.voltageMinMv = sample.voltageMinMv;
+        if (sample.voltageMaxMv > rec.voltageMaxMv) rec.voltageMaxMv = sample.voltageMaxMv;
+        if (sample.currentMinMa < rec.currentMinMa) rec.currentMinMa = sample.currentMinMa;
+        if (sample.currentMaxMa > rec.currentMaxMa) rec.currentMaxMa = sample.currentMaxMa;
+    }
+
+    // Mittelwerte aus exakten Summen (kein Rundungsfehler über 3600 Werte)
+    agg.voltageSumMv += (uint32_t)sample.voltageAvgMv * sample.samples;
+    agg.currentSumMa += (int32_t)sample.currentAvgMa * sample.samples;
+    rec.chargeUah += sample.chargeUah;
+    rec.energyUwh += sample.energyUwh;
+    rec.samples += sample.samples;
+
+    rec.voltageAvgMv = (uint16_t)((agg.voltageSumMv + rec.samples / 2) / rec.samples);
+    rec.currentAvgMa = (int16_t)lroundf((float)agg.currentSumMa / rec.samples);
+}
+
+void BatteryHistory::flush() {
+    if (!ready) return;
+
+    uint32_t startUs = micros();
+
+    // 1-s-Werte: zusammenhängende Slots mit einem Schreibzugriff
+    uint8_t i = 0;
+    while (i < pendingCount) {
+        uint32_t slot = pending[i].time % HISTORY_SECONDS_SLOTS;
+        uint8_t run = 1;
+        while (i + run < pendingCount &&
+               pending[i + run].time == pending[i].time + run &&
+               slot + run < HISTORY_SECONDS_SLOTS) {
+            run++;
+        }
+        writeRecords(0, slot, &pending[i], run);
+        i += run;
+    }
+    pendingCount = 0;
+
+    // Offene Aggregate an ihrer Position aktualisieren (Neustart setzt dort fort)
+    for (uint8_t tier = 1; tier < HISTORY_TIERS; tier++) {
+        const HistoryRecord& rec = open[tier - 1].rec;
+        if (rec.samples > 0) {
+            writeRecords(tier, (rec.time / TIER_PERIOD[tier]) % TIER_SLOTS[tier], &rec, 1);
+        }
+    }
+
+    flushes++;
+    writeHeader();
+
+    lastFlushMs = millis();
+    flushUsLast = micros() - startUs;
+    if (flushUsLast > flushUsMax) flushUsMax = flushUsLast;
+}
+
+bool BatteryHistory::writeRecords(uint8_t tier, uint32_t slot, const HistoryRecord* recs, uint32_t count) {
+    if (!sdHandler->writeBinaryAt(HISTORY_FILE, tierOffset(tier) + slot * sizeof(HistoryRecord),
+                                  (const uint8_t*)recs, count * sizeof(HistoryRecord))) {
+        writeErrors++;
+        return false;
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ABFRAGE
+// ═══════════════════════════════════════════════════════════════════════════
+
+uint32_t BatteryHistory::read(uint8_t tier, uint32_t skip, HistoryRecord* out, uint32_t count) {
+    if (!ready || !out || tier >= HISTORY_TIERS) return 0;
+
+    uint32_t period = TIER_PERIOD[tier];
+    uint32_t slots = TIER_SLOTS[tier];
+    uint32_t newest = lastTime / period;
+
+    // Nur Intervalle, die noch im Ring stehen können
+    if (skip > newest || skip >= slots) return 0;
+    newest -= skip;
+    if (count > newest + 1) count = newest + 1;
+    if (count > slots - skip) count = slots - skip;
+    if (count == 0) return 0;
+
+    uint32_t first = newest - count + 1;
+    uint32_t done = 0;
+    while (done < count) {
+        uint32_t slot = (first + done) % slots;
+        uint32_t run = count - done;
+        if (run > slots - slot) run = slots - slot;
+
+        int bytes = (int)(run * sizeof(HistoryRecord));
+        if (sdHandler->readBinaryAt(HISTORY_FILE, tierOffset(tier) + slot * sizeof(HistoryRecord),
+                                    (uint8_t*)&out[done], bytes) != bytes) {
+            break;
+        }
+        done += run;
+    }
+
+    // Slot aus einer früheren Runde (Lücke, z.B. Schleife blockiert) → leer
+    for (uint32_t j = 0; j < done; j++) {
+        if (out[j].time != (first + j) * period) {
+            out[j].samples = 0;
+        }
+    }
+    return done;
+}
+
+uint32_t BatteryHistory::getTime() const {
+    return baseTime + (millis() - baseMs) / 1000;
+}
+
+uint32_t BatteryHistory::getPeriod(uint8_t tier) {
+    return tier < HISTORY_TIERS ? TIER_PERIOD[tier] : 0;
+}
+
+uint32_t BatteryHistory::getSlots(uint8_t tier) {
+    return tier < HISTORY_TIERS ? TIER_SLOTS[tier] : 0;
+}
+
+uint32_t BatteryHistory::tierOffset(uint8_t tier) {
+    uint32_t offset = sizeof(HistoryFileHeader);
+    for (uint8_t i = 0; i < tier; i++) {
+        offset += TIER_SLOTS[i] * sizeof(HistoryRecord);
+    }
+    return offset;
+}
+
+void BatteryHistory::printInfo() const {
+    DEBUG_PRINTLN("═══════════════════════════════════════════════════════");
+    DEBUG_PRINTLN("BatteryHistory - Status");
+    DEBUG_PRINTLN("═══════════════════════════════════════════════════════");
+    if (!ready) {
+        DEBUG_PRINTLN("Nicht initialisiert");
+        DEBUG_PRINTLN("═══════════════════════════════════════════════════════");
+        return;
+    }
+    DEBUG_PRINTF("Datei:          %s (%lu Bytes)\n", HISTORY_FILE, (unsigned long)tierOffset(HISTORY_TIERS));
+    DEBUG_PRINTF("Betriebszeit:   %lu s (%.1f h), seit Start %lu Werte\n",
+                 (unsigned long)lastTime, lastTime / 3600.0f, (unsigned long)samplesTotal);
+    for (uint8_t tier = 0; tier < HISTORY_TIERS; tier++) {
+        uint32_t filled = lastTime / TIER_PERIOD[tier] + 1;
+        if (filled > TIER_SLOTS[tier]) filled = TIER_SLOTS[tier];
+        DEBUG_PRINTF("%-15s %4lu / %4lu Slots à %lu s (%.1f h)\n", TIER_NAMES[tier],
+                     (unsigned long)filled, (unsigned long)TIER_SLOTS[tier], (unsigned long)TIER_PERIOD[tier],
+                     TIER_SLOTS[tier] * TIER_PERIOD[tier] / 3600.0f);
+    }
+    DEBUG_PRINTF("Gepuffert:      %u 1-s-Werte (Flush alle %d ms)\n", pendingCount, HISTORY_FLUSH_MS);
+    DEBUG_PRINTF("Geschrieben:    %lu Flushes (Fehler %lu), Dauer last %lu us, max %lu us\n",
+                 (unsigned long)flushes, (unsigned long)writeErrors,
+                 (unsigned long)flushUsLast, (unsigned long)flushUsMax);
+    DEBUG_PRINTLN("═══════════════════════════════════════════════════════");
+}
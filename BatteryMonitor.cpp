@@ -7,41 +7,64 @@
 #include "include/Globals.h"
 #include "include/BatteryMonitor.h"
 #include "include/UserConfig.h"
+#include "include/MotorController.h"
+#include <esp_rom_crc.h>
+#include <esp_adc/adc_cali_scheme.h>
+#include <stddef.h>
+
+extern MotorController motorCtrl;
 
 BatteryMonitor::BatteryMonitor()
-    : initialized(false)
+    : adcCali(nullptr)
+    , voltageCorrected(false)
+    , calRevision(0)
+    , initialized(false)
     , autoShutdownEnabled(true)
     , currentVoltage(0.0f)
+    , filteredMv(0)
+    , voltageSamples(0)
     , rawVoltage(0.0f)
     , currentPercent(0)
     , currentCurrent(0.0f)
     , rawCurrent(0.0f)
     , currentPower(0.0f)
-    , currentOffset(0.0f)
+    , currentOffset(CURRENT_ZERO_POINT)
+    , currentZeroMa(0)
+    , currentOffsetCounts(CURRENT_ZERO_POINT / CURRENT_ADC_VREF * 4095)
+    , currentCalibrated(false)
+    , currentOffsetRestored(false)
+    , savedOffsetCounts(0.0f)
+    , calSum(0)
+    , calCount(0)
+    , calLastSample(0)
+    , idleSince(0)
+    , lastCalTime(0)
+    , voltageMin(0.0f)
+    , voltageMax(0.0f)
+    , currentMin(0.0f)
+    , currentMax(0.0f)
     , consumedMAh(0.0f)
     , consumedWh(0.0f)
     , lastEnergyUpdate(0)
-    , voltageBufferIndex(0)
-    , voltageBufferFilled(false)
-    , currentBufferIndex(0)
-    , currentBufferFilled(false)
     , lastUpdateTime(0)
     , lastWarningTime(0)
     , lastCurrentWarningTime(0)
     , warningActive(false)
     , criticalActive(false)
     , currentWarningActive(false)
+    , compensatedVoltage(0.0f)
+    , underVoltageSince(0)
+    , depleted(false)
+    , sagReported(false)
     , warningCallback(nullptr)
     , shutdownCallback(nullptr)
     , currentWarningCallback(nullptr)
 {
-    // Buffer initialisieren
-    for (uint8_t i = 0; i < VOLTAGE_FILTER_SAMPLES; i++) {
-        voltageBuffer[i] = 0.0f;
-    }
-    for (uint8_t i = 0; i < CURRENT_FILTER_SAMPLES; i++) {
-        currentBuffer[i] = 0.0f;
-    }
+    voltageScale = AdcLinear::make(VOLTAGE_DIVIDER_RATIO);
+    voltageCorrection = AdcLinear::make(1.0f);
+    voltageMap = voltageScale;
+    currentScale = AdcLinear::make(1.0f / CURRENT_SENSITIVITY);   // mV / (V/A) = mA
+    setCurrentOffsetCounts(currentOffsetCounts);
 }
 
 BatteryMonitor::~BatteryMonitor() {
@@ -52,45 +75,63 @@ bool BatteryMonitor::begin() {
     
     setAutoShutdown(userConfig.getAutoShutdownEnabled());
 
-    // ADC-Pins konfigurieren
-    pinMode(VOLTAGE_SENSOR_PIN, INPUT);
-    pinMode(CURRENT_SENSOR_PIN, INPUT);
+    // Kontinuierliche DMA-Abtastung bevorzugt (vor jedem analogRead: ADC1 exklusiv)
+    if (sampler.begin(VOLTAGE_SENSOR_PIN, CURRENT_SENSOR_PIN)) {
+        // Erstes Messfenster abwarten
+        delay(10);
+    } else {
+        DEBUG_PRINTLN("BatteryMonitor: ⚠️ DMA-Abtastung nicht verfügbar - analogRead");
+        
+        // ADC-Pins konfigurieren
+        pinMode(VOLTAGE_SENSOR_PIN, INPUT);
+        pinMode(CURRENT_SENSOR_PIN, INPUT);
+        
+        // ADC-Auflösung setzen (12-Bit)
+        analogReadResolution(12);
+    }
     
-    // ADC-Auflösung setzen (12-Bit)
-    analogReadResolution(12);
+    // Kennlinie aus eFuse, Spannungs-Korrektur aus UserConfig
+    initAdcCalibration();
+    applyVoltageCorrection();
+    setCurrentOffsetCounts(currentOffsetCounts);
     
-    // Erste Spannungsmessung und Buffer füllen
+    // Erste Spannungsmessung und Filter füllen
     float initialVoltage = readRawVoltage();
-    for (uint8_t i = 0; i < VOLTAGE_FILTER_SAMPLES; i++) {
-        voltageBuffer[i] = initialVoltage;
-    }
-    voltageBufferFilled = true;
+    voltageFilter.fill(initialVoltage);
     
     currentVoltage = initialVoltage;
+    filteredMv = (int32_t)(initialVoltage * 1000.0f + 0.5f);
+    voltageSamples++;
     rawVoltage = initialVoltage;
-    currentPercent = voltageToPercent(initialVoltage);
     
-    // Stromsensor kalibrieren (Nullpunkt)
-    DEBUG_PRINTLN("BatteryMonitor: Kalibriere Stromsensor...");
-    calibrateCurrent(100);
+    // Strom-Nullpunkt: gesicherter Wert sofort, Messung im Stillstand folgt in update()
+    // (kein blockierendes calibrateCurrent() beim Boot)
+    currentOffsetRestored = loadCurrentOffset();
+    idleSince = 1;  // Seit dem Einschalten kein Motorstrom
     
-    // Erste Strommessung und Buffer füllen
+    // Erste Strommessung und Filter füllen
     float initialCurrent = readRawCurrent();
-    for (uint8_t i = 0; i < CURRENT_FILTER_SAMPLES; i++) {
-        currentBuffer[i] = initialCurrent;
-    }
-    currentBufferFilled = true;
+    currentFilter.fill(initialCurrent);
     
     currentCurrent = initialCurrent;
     rawCurrent = initialCurrent;
     currentPower = currentVoltage * currentCurrent;
+    compensatedVoltage = currentVoltage;
+    
+    // Ladezustand: gesicherter Stand oder Ruhespannung (Motoren stehen beim Start),
+    // IR-Korrektur mit dem zuletzt gemessenen Innenwiderstand
+    ir.begin(&sdCard);
+    soc.setInternalResistance(ir.getResistance());
+    soc.begin(&sdCard, currentVoltage, currentCurrent);
+    currentPercent = soc.getPercent();
     
     lastEnergyUpdate = millis();
     initialized = true;
     
     DEBUG_PRINTLN("BatteryMonitor: ✅ Initialisiert");
     DEBUG_PRINTF("BatteryMonitor: Start-Spannung: %.2fV (%d%%)\n", currentVoltage, currentPercent);
-    DEBUG_PRINTF("BatteryMonitor: Start-Strom: %.2fA (Offset: %.4fV)\n", currentCurrent, currentOffset);
+    DEBUG_PRINTF("BatteryMonitor: Start-Strom: %.2fA (Offset: %.4fV, %s)\n", currentCurrent, currentOffset,
+                 currentOffsetRestored ? "von SD" : "Soll-Nullpunkt");
     
     return true;
 }
@@ -99,22 +140,43 @@ bool BatteryMonitor::update() {
     if (!initialized) return false;
 
     setAutoShutdown(userConfig.getAutoShutdownEnabled());
+    
+    // Spannungs-Korrektur nur nach Config-Änderung neu berechnen
+    if (userConfig.getRevision() != calRevision) {
+        applyVoltageCorrection();
+    }
+
+    // Strom-Nullpunkt im Stillstand nachführen (jeder Aufruf, nicht blockierend)
+    updateCurrentCalibration();
+    
+    // Innenwiderstand aus Lastsprüngen (schnelle DMA-Werte, jeder Aufruf)
+    if (sampler.isRunning() &&
+        ir.addSample(countsToVoltage(sampler.getFastRaw(ADC_CH_VOLTAGE)),
+                     countsToCurrent(sampler.getFastRaw(ADC_CH_CURRENT)), millis())) {
+        soc.setInternalResistance(ir.getResistance());
+    }
 
     // Nur alle VOLTAGE_CHECK_INTERVAL ms aktualisieren
     unsigned long now = millis();
     if (now - lastUpdateTime < VOLTAGE_CHECK_INTERVAL) {
         return false;
     }
-    lastUpdateTime = now;
+    // Festes Raster statt "ab jetzt": sonst wird jedes Intervall um die
+    // loop()-Verzögerung länger und der 1-s-Verlauf bekommt Lücken
+    lastUpdateTime += VOLTAGE_CHECK_INTERVAL;
+    if (now - lastUpdateTime >= VOLTAGE_CHECK_INTERVAL) {
+        lastUpdateTime = now;   // Nach Blockade nicht nachholen
+    }
     
     // Spannungsmessung
     rawVoltage = readRawVoltage();
-    currentVoltage = filterVoltage(rawVoltage);
-    currentPercent = voltageToPercent(currentVoltage);
+    currentVoltage = voltageFilter.update(rawVoltage);
+    filteredMv = (int32_t)(currentVoltage * 1000.0f + 0.5f);
+    voltageSamples++;
     
     // Strommessung
     rawCurrent = readRawCurrent();
-    currentCurrent = filterCurrent(rawCurrent);
+    currentCurrent = currentFilter.update(rawCurrent);
     
     // Leistung berechnen
     currentPower = currentVoltage * currentCurrent;
@@ -122,6 +184,17 @@ bool BatteryMonitor::update() {
     // Energie-Verbrauch aktualisieren
     updateEnergyConsumption();
     
+    // Ladezustand (Coulomb-Zählung, in Ruhe an Ruhespannung angeglichen)
+    soc.update(currentVoltage, currentCurrent, consumedMAh, userConfig.getBatteryCapacity());
+    currentPercent = soc.getPercent();
+    
+    // Restlaufzeit (Leistung gewichtet nach Fahranteil)
+    runtime.update(currentPower, currentVoltage, !motorCtrl.isIdle(), soc.getSoc(),
+                   userConfig.getBatteryCapacity(), soc.getInternalResistance());
+    
+    // Unterspannung: Einbruch unter Last vs. leerer Akku
+    checkDepletion(now);
+    
     // Warnungen prüfen
     checkWarnings();
     
@@ -149,6 +222,40 @@ float BatteryMonitor::getRawCurrent() {
     return rawCurrent;
 }
 
+int32_t BatteryMonitor::readCurrentCounts() const {
+    return sampler.isRunning() ? sampler.getFastRaw(ADC_CH_CURRENT) : analogRead(CURRENT_SENSOR_PIN);
+}
+
+int32_t BatteryMonitor::readCurrentFastMa() const {
+    // Kennlinie + Festkomma-Skalierung (ACS712: ~15 mA/mV), keine Gleitkomma-Rechnung im Takt
+    int32_t ma = countsToMilliamps((uint16_t)readCurrentCounts());
+    return ma < 0 ? 0 : ma;
+}
+
+int32_t BatteryMonitor::readVoltageFastMv() const {
+    uint16_t counts = sampler.isRunning() ? sampler.getFastRaw(ADC_CH_VOLTAGE)
+                                          : (uint16_t)analogRead(VOLTAGE_SENSOR_PIN);
+    return countsToMillivolts(counts);
+}
+
+uint16_t BatteryMonitor::getUncorrectedMillivolts() const {
+    // Korrektur rückrechnen: die Referenzpunkte beziehen sich auf die unkorrigierte Anzeige
+    float mv = (currentVoltage * 1000.0f - voltageCorrection.offset) / voltageCorrection.getGain();
+    return (uint16_t)constrain(mv + 0.5f, 0.0f, 65535.0f);
+}
+
+bool BatteryMonitor::printAdcCurve(Print& out) const {
+    if (!adcCali) return false;
+    
+    out.println("raw,mv");
+    for (int raw = 0; raw <= AdcConverter::MAX_COUNTS; raw++) {
+        int mv = 0;
+        adc_cali_raw_to_voltage(adcCali, raw, &mv);
+        out.printf("%d,%d\n", raw, mv);
+    }
+    return true;
+}
+
 float BatteryMonitor::getPower() {
     return currentPower;
 }
@@ -166,7 +273,7 @@ uint8_t BatteryMonitor::getPercent() {
 }
 
 bool BatteryMonitor::isCritical() {
-    return (currentVoltage <= VOLTAGE_SHUTDOWN);
+    return depleted;
 }
 
 bool BatteryMonitor::isLow() {
@@ -180,16 +287,19 @@ bool BatteryMonitor::isCurrentHigh() {
 void BatteryMonitor::calibrateCurrent(uint16_t samples) {
     DEBUG_PRINTF("BatteryMonitor: Kalibriere Stromsensor (%d Messungen)...\n", samples);
     
-    float sum = 0.0f;
+    int32_t sum = 0;
     
     for (uint16_t i = 0; i < samples; i++) {
-        int adcValue = analogRead(CURRENT_SENSOR_PIN);
-        float voltage = (adcValue / 4095.0f) * CURRENT_ADC_VREF;
-        sum += voltage;
+        sum += readCurrentCounts();
         delay(10);
     }
     
-    currentOffset = sum / samples;
+    setCurrentOffsetCounts((float)sum / samples);
+    currentCalibrated = true;
+    calSum = 0;
+    calCount = 0;
+    lastCalTime = millis();
+    saveCurrentOffset();
     
     DEBUG_PRINTF("BatteryMonitor: ✅ Nullpunkt: %.4fV\n", currentOffset);
 }
@@ -224,6 +334,10 @@ void BatteryMonitor::shutdown() {
     DEBUG_PRINTF("Spannung: %.2fV (Limit: %.2fV)\n", currentVoltage, VOLTAGE_SHUTDOWN);
     DEBUG_PRINTLN("ESP32 fährt herunter...\n");
     
+    // Ladezustand und Innenwiderstand sichern (Callback fährt das System herunter)
+    soc.save();
+    ir.save();
+    
     // Shutdown-Callback aufrufen (falls gesetzt)
     if (shutdownCallback != nullptr) {
         shutdownCallback(currentVoltage);
@@ -240,8 +354,14 @@ void BatteryMonitor::printInfo() {
     DEBUG_PRINTLN("║       BATTERY MONITOR INFO             ║");
     DEBUG_PRINTLN("╚════════════════════════════════════════╝");
     DEBUG_PRINTF("Spannung:     %.2fV (raw: %.2fV)\n", currentVoltage, rawVoltage);
-    DEBUG_PRINTF("Ladezustand:  %d%%\n", currentPercent);
+    DEBUG_PRINTF("Ladezustand:  %d%% (Spannung linear: %.0f%%)\n", currentPercent,
+                 constrain((currentVoltage - VOLTAGE_BATTERY_MIN) /
+                           (VOLTAGE_BATTERY_MAX - VOLTAGE_BATTERY_MIN) * 100.0f, 0.0f, 100.0f));
+    DEBUG_PRINTF("Spannung Min/Max: %.2fV / %.2fV (letztes Intervall)\n", voltageMin, voltageMax);
+    DEBUG_PRINTF("Ohne Last:    %.2fV (U + I·R, Shutdown ab %.2fV für %d ms)\n",
+                 compensatedVoltage, VOLTAGE_SHUTDOWN, SAG_CONFIRM_MS);
     DEBUG_PRINTF("Strom:        %.2fA (raw: %.2fA)\n", currentCurrent, rawCurrent);
+    DEBUG_PRINTF("Strom Min/Max: %.2fA / %.2fA (letztes Intervall)\n", currentMin, currentMax);
     DEBUG_PRINTF("Leistung:     %.2fW\n", currentPower);
     DEBUG_PRINTF("Verbraucht:   %.1fmAh / %.2fWh\n", consumedMAh, consumedWh);
     DEBUG_PRINTF("Status:       %s\n", 
@@ -258,7 +378,20 @@ void BatteryMonitor::printInfo() {
     DEBUG_PRINTF("V-Shutdown:   %.2fV\n", VOLTAGE_SHUTDOWN);
     DEBUG_PRINTF("I-Warnung:    %.1fA\n", CURRENT_WARNING);
     DEBUG_PRINTF("I-Max:        %.1fA\n", CURRENT_MAX);
-    DEBUG_PRINTF("I-Offset:     %.4fV\n", currentOffset);
+    DEBUG_PRINTF("I-Offset:     %.4fV (%.1f Counts, %s)\n", currentOffset, currentOffsetCounts,
+                 currentCalibrated ? "im Stillstand gemessen" :
+                 currentOffsetRestored ? "von SD, Messung ausstehend" : "Soll, Messung ausstehend");
+    DEBUG_PRINTF("ADC-Kennlinie: %s (%u mV bei 2048, %u mV bei 4064 Counts)\n", adcConv.getName(),
+                 adcConv.getPoint(64), adcConv.getPoint(127));
+    if (voltageCorrected) {
+        DEBUG_PRINTF("V-Korrektur:  × %.4f %+ld mV\n", voltageCorrection.getGain(), voltageCorrection.offset);
+    }
+    DEBUG_PRINTLN("────────────────────────────────────────");
+    soc.printInfo();
+    ir.printInfo();
+    runtime.printInfo();
+    DEBUG_PRINTLN("────────────────────────────────────────");
+    sampler.printInfo();
     DEBUG_PRINTLN("╚════════════════════════════════════════╝\n");
 }
 
@@ -266,62 +399,249 @@ void BatteryMonitor::printInfo() {
 // PRIVATE METHODEN
 // ═══════════════════════════════════════════════════════════════════════════
 
-float BatteryMonitor::readRawVoltage() {
-    int adcValue = analogRead(VOLTAGE_SENSOR_PIN);
-    float voltage = (VOLTAGE_RANGE_MAX / 4095.0f) * float(adcValue);
-    voltage *= VOLTAGE_CALIBRATION_FACTOR;
-    return voltage;
+void BatteryMonitor::updateCurrentCalibration() {
+    unsigned long now = millis();
+    
+    // Nur im Stillstand: jede Fahrt verwirft die laufende Messung
+    if (!motorCtrl.isIdle()) {
+        idleSince = 0;
+        calSum = 0;
+        calCount = 0;
+        return;
+    }
+    if (idleSince == 0) {
+        idleSince = now;
+        return;
+    }
+    if (now - idleSince < CURRENT_CAL_IDLE_MS) return;
+    
+    // Nachkalibrierung nur alle CURRENT_CAL_INTERVAL_MS
+    if (currentCalibrated && calCount == 0 && now - lastCalTime < CURRENT_CAL_INTERVAL_MS) return;
+    
+    if (calCount > 0 && now - calLastSample < CURRENT_CAL_SAMPLE_MS) return;
+    calLastSample = now;
+    calSum += readCurrentCounts();
+    if (++calCount < CURRENT_CAL_SAMPLES) return;
+    
+    float measured = (float)calSum / calCount;
+    calSum = 0;
+    calCount = 0;
+    lastCalTime = now;
+    
+    // Unplausibel (Last am Sensor trotz stehender Motoren?) → verwerfen
+    float nominal = CURRENT_ZERO_POINT / CURRENT_ADC_VREF * 4095.0f;
+    if (fabsf(measured - nominal) > CURRENT_CAL_MAX_DEV) {
+        DEBUG_PRINTF("BatteryMonitor: ⚠️ Nullpunkt %.1f Counts unplausibel (Soll %.1f) - verworfen\n",
+                     measured, nominal);
+        return;
+    }
+    
+    if (currentCalibrated) {
+        setCurrentOffsetCounts(currentOffsetCounts + (measured - currentOffsetCounts) * CURRENT_CAL_BLEND);
+    } else {
+        setCurrentOffsetCounts(measured);
+        currentCalibrated = true;
+        DEBUG_PRINTF("BatteryMonitor: ✅ Nullpunkt im Hintergrund kalibriert: %.4fV (%lu ms nach Boot)\n",
+                     currentOffset, now);
+    }
+    
+    if (fabsf(currentOffsetCounts - savedOffsetCounts) >= CURRENT_CAL_SAVE_DELTA) {
+        saveCurrentOffset();
+    }
 }
 
-float BatteryMonitor::readRawCurrent() {
-    int adcValue = analogRead(CURRENT_SENSOR_PIN);
-    
-    // ADC zu Spannung (0-3.3V)
-    float voltage = (adcValue / 4095.0f) * CURRENT_ADC_VREF;
+void BatteryMonitor::setCurrentOffsetCounts(float counts) {
+    currentOffsetCounts = counts;
     
-    // Offset abziehen (Nullpunkt bei 1.65V für 3.3V-Versorgung)
-    float deltaV = voltage - currentOffset;
+    // Nullpunkt über dieselbe Kennlinie wie die Messwerte (gebrochene Counts)
+    float zeroMv = adcConv.toMvFloat(counts);
+    currentOffset = zeroMv / 1000.0f;
+    currentZeroMa = (int32_t)(zeroMv * currentScale.getGain() + 0.5f);
+}
+
+bool BatteryMonitor::loadCurrentOffset() {
+    if (!sdCard.isAvailable() || !sdCard.fileExists(CURRENT_CAL_FILE)) {
+        return false;
+    }
     
-    // In Ampere umrechnen (Sensitivität: ~66mV/A bei 3.3V)
-    float current = deltaV / CURRENT_SENSITIVITY;
+    CurrentOffsetState state;
+    if (sdCard.readBinaryFile(CURRENT_CAL_FILE, (uint8_t*)&state, sizeof(state)) != (int)sizeof(state) ||
+        state.magic != CURRENT_CAL_MAGIC ||
+        state.crc != esp_rom_crc32_le(0, (const uint8_t*)&state, offsetof(CurrentOffsetState, crc))) {
+        DEBUG_PRINTLN("BatteryMonitor: ⚠️ Gesicherter Nullpunkt ungültig - verworfen");
+        return false;
+    }
     
-    // Negative Werte auf 0 setzen (wir messen nur Verbrauch, kein Laden)
-    if (current < 0.0f) current = 0.0f;
+    float nominal = CURRENT_ZERO_POINT / CURRENT_ADC_VREF * 4095.0f;
+    if (!(fabsf(state.offsetCounts - nominal) <= CURRENT_CAL_MAX_DEV)) {
+        return false;
+    }
     
-    return current;
+    setCurrentOffsetCounts(state.offsetCounts);
+    savedOffsetCounts = state.offsetCounts;
+    return true;
 }
 
-float BatteryMonitor::filterVoltage(float newVoltage) {
-    voltageBuffer[voltageBufferIndex] = newVoltage;
-    voltageBufferIndex = (voltageBufferIndex + 1) % VOLTAGE_FILTER_SAMPLES;
+void BatteryMonitor::saveCurrentOffset() {
+    if (!sdCard.isAvailable()) return;
     
-    float sum = 0.0f;
-    for (uint8_t i = 0; i < VOLTAGE_FILTER_SAMPLES; i++) {
-        sum += voltageBuffer[i];
+    if (!sdCard.fileExists(BATTERY_STATE_DIR)) {
+        sdCard.createDir(BATTERY_STATE_DIR);
     }
     
-    return sum / VOLTAGE_FILTER_SAMPLES;
+    CurrentOffsetState state = {};
+    state.magic = CURRENT_CAL_MAGIC;
+    state.offsetCounts = currentOffsetCounts;
+    state.crc = esp_rom_crc32_le(0, (const uint8_t*)&state, offsetof(CurrentOffsetState, crc));
+    
+    if (sdCard.writeBinaryFile(CURRENT_CAL_FILE, (const uint8_t*)&state, sizeof(state))) {
+        savedOffsetCounts = currentOffsetCounts;
+    }
 }
 
-float BatteryMonitor::filterCurrent(float newCurrent) {
-    currentBuffer[currentBufferIndex] = newCurrent;
-    currentBufferIndex = (currentBufferIndex + 1) % CURRENT_FILTER_SAMPLES;
+void BatteryMonitor::readWindow(AdcChannelId ch, uint8_t pin, AdcWindow& window) {
+    // DMA: Mittel/Min/Max aller dezimierten Werte seit dem letzten Intervall
+    if (sampler.isRunning()) {
+        if (sampler.takeWindow(ch, window)) {
+            return;
+        }
+        // Leeres Fenster (update() direkt nacheinander): letzter Blockwert
+        uint16_t last = sampler.getFastRaw(ch);
+        window.blocks = 0;
+        window.mean = window.min = window.max = last;
+        return;
+    }
+    
+    uint16_t value = (uint16_t)analogRead(pin);
+    window.blocks = 1;
+    window.mean = window.min = window.max = value;
+}
+
+void BatteryMonitor::initAdcCalibration() {
+    adc_unit_t unit;
+    adc_channel_t channel;
+    const char* scheme = nullptr;
+    
+    // Beide Sensoren an ADC1 mit gleicher Dämpfung wie AdcSampler → eine Kennlinie
+    if (adc_continuous_io_to_channel(VOLTAGE_SENSOR_PIN, &unit, &channel) == ESP_OK) {
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+        adc_cali_curve_fitting_config_t curve = {};
+        curve.unit_id = unit;
+        curve.chan = channel;
+        curve.atten = ADC_ATTEN_DB_12;
+        curve.bitwidth = ADC_BITWIDTH_12;
+        if (adc_cali_create_scheme_curve_fitting(&curve, &adcCali) == ESP_OK) {
+            scheme = "eFuse Curve Fitting";
+        }
+#endif
+#if ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+        if (!scheme) {
+            adc_cali_line_fitting_config_t line = {};
+            line.unit_id = unit;
+            line.atten = ADC_ATTEN_DB_12;
+            line.bitwidth = ADC_BITWIDTH_12;
+            if (adc_cali_create_scheme_line_fitting(&line, &adcCali) == ESP_OK) {
+                scheme = "eFuse Line Fitting";
+            }
+        }
+#endif
+    }
     
-    float sum = 0.0f;
-    for (uint8_t i = 0; i < CURRENT_FILTER_SAMPLES; i++) {
-        sum += currentBuffer[i];
+    if (!scheme) {
+        adcCali = nullptr;
+        adcConv.setLinear(ADC_FULL_SCALE_MV);
+        DEBUG_PRINTF("BatteryMonitor: ⚠️ Keine eFuse-Kalibrierung - lineare Kennlinie (%d mV)\n", ADC_FULL_SCALE_MV);
+        return;
     }
     
-    return sum / CURRENT_FILTER_SAMPLES;
+    // Kennlinie einmalig tabellieren: pro Messwert nur Tabellenzugriff + Interpolation
+    adcConv.build([](int raw, void* ctx) {
+        int mv = 0;
+        adc_cali_raw_to_voltage((adc_cali_handle_t)ctx, raw, &mv);
+        return mv;
+    }, adcCali, scheme);
+    DEBUG_PRINTF("BatteryMonitor: ✅ ADC-Kennlinie: %s (4095 Counts = %ld mV)\n",
+                 scheme, adcConv.toMv(AdcConverter::MAX_COUNTS));
 }
 
-uint8_t BatteryMonitor::voltageToPercent(float voltage) {
-    voltage = constrain(voltage, VOLTAGE_BATTERY_MIN, VOLTAGE_BATTERY_MAX);
+void BatteryMonitor::applyVoltageCorrection() {
+    calRevision = userConfig.getRevision();
+    
+    int32_t lowRaw = userConfig.getVoltCalLowRaw();
+    int32_t lowRef = userConfig.getVoltCalLowRef();
+    int32_t highRaw = userConfig.getVoltCalHighRaw();
+    int32_t highRef = userConfig.getVoltCalHighRef();
+    
+    AdcLinear correction = AdcLinear::make(1.0f);
+    bool valid = false;
+    
+    if (lowRaw > 0 && lowRef > 0 && highRaw > 0 && highRef > 0) {
+        // Zwei Punkte: Faktor und Offset
+        valid = abs(highRaw - lowRaw) >= VOLTAGE_CAL_MIN_SPAN_MV &&
+                AdcLinear::fromPoints(lowRaw, lowRef, highRaw, highRef, correction);
+    } else if (lowRaw > 0 && lowRef > 0) {
+        // Ein Punkt: nur Faktor (Gerade durch 0)
+        correction = AdcLinear::make((float)lowRef / lowRaw);
+        valid = true;
+    }
     
-    float percent = ((voltage - VOLTAGE_BATTERY_MIN) / 
-                     (VOLTAGE_BATTERY_MAX - VOLTAGE_BATTERY_MIN)) * 100.0f;
+    if (valid && fabsf(correction.getGain() - 1.0f) > VOLTAGE_CAL_MAX_DEV) {
+        DEBUG_PRINTF("BatteryMonitor: ⚠️ Spannungs-Korrektur × %.3f unplausibel - ignoriert\n",
+                     correction.getGain());
+        valid = false;
+    } else if (!valid && (lowRaw || lowRef || highRaw || highRef)) {
+        DEBUG_PRINTLN("BatteryMonitor: ⚠️ Spannungs-Korrektur unvollständig - ignoriert");
+    }
+    if (!valid) {
+        correction = AdcLinear::make(1.0f);
+    }
     
-    return constrain((uint8_t)percent, 0, 100);
+    if (valid != voltageCorrected || correction.gainQ16 != voltageCorrection.gainQ16 ||
+        correction.offset != voltageCorrection.offset) {
+        voltageCorrection = correction;
+        voltageMap = voltageScale.then(correction);
+        voltageCorrected = valid;
+        if (valid) {
+            DEBUG_PRINTF("BatteryMonitor: ✅ Spannungs-Korrektur × %.4f %+ld mV\n",
+                         correction.getGain(), correction.offset);
+        }
+    }
+}
+
+int32_t BatteryMonitor::countsToMillivolts(uint16_t counts) const {
+    return voltageMap.apply(adcConv.toMv(counts));
+}
+
+int32_t BatteryMonitor::countsToMilliamps(uint16_t counts) const {
+    // Nullpunkt abziehen (Soll 1.65 V bei 3.3 V Versorgung, im Stillstand nachgeführt)
+    return currentScale.apply(adcConv.toMv(counts)) - currentZeroMa;
+}
+
+float BatteryMonitor::countsToVoltage(uint16_t counts) const {
+    int32_t mv = countsToMillivolts(counts);
+    return mv > 0 ? mv / 1000.0f : 0.0f;
+}
+
+float BatteryMonitor::countsToCurrent(uint16_t counts) const {
+    // Negative Werte auf 0 setzen (wir messen nur Verbrauch, kein Laden)
+    int32_t ma = countsToMilliamps(counts);
+    return ma > 0 ? ma / 1000.0f : 0.0f;
+}
+
+float BatteryMonitor::readRawVoltage() {
+    AdcWindow window;
+    readWindow(ADC_CH_VOLTAGE, VOLTAGE_SENSOR_PIN, window);
+    voltageMin = countsToVoltage(window.min);
+    voltageMax = countsToVoltage(window.max);
+    return countsToVoltage(window.mean);
+}
+
+float BatteryMonitor::readRawCurrent() {
+    AdcWindow window;
+    readWindow(ADC_CH_CURRENT, CURRENT_SENSOR_PIN, window);
+    currentMin = countsToCurrent(window.min);
+    currentMax = countsToCurrent(window.max);
+    return countsToCurrent(window.mean);
 }
 
 void BatteryMonitor::updateEnergyConsumption() {
@@ -388,6 +708,35 @@ void BatteryMonitor::checkWarnings() {
     }
 }
 
+void BatteryMonitor::checkDepletion(unsigned long now) {
+    // Mittel desselben Messintervalls: Spannung und Strom zeitgleich (Filter laufen verschieden lang)
+    compensatedVoltage = rawVoltage + rawCurrent * soc.getInternalResistance();
+    
+    if (compensatedVoltage > VOLTAGE_SHUTDOWN) {
+        // Nur Lasteinbruch (Anfahren): Akku hat noch Ladung, Motoren drosselt der SagGuard
+        if (rawVoltage <= VOLTAGE_SHUTDOWN && !sagReported) {
+            DEBUG_PRINTF("BatteryMonitor: ⚡ Spannungseinbruch unter Last: %.2fV bei %.1fA (ohne Last %.2fV) - kein Shutdown\n",
+                         rawVoltage, rawCurrent, compensatedVoltage);
+            sagReported = true;
+        } else if (rawVoltage > VOLTAGE_SHUTDOWN) {
+            sagReported = false;
+        }
+        underVoltageSince = 0;
+        depleted = false;
+        return;
+    }
+    
+    // Auch ohne Last zu niedrig: erst nach SAG_CONFIRM_MS als leer werten
+    if (underVoltageSince == 0) {
+        underVoltageSince = now;
+    }
+    if (!depleted && now - underVoltageSince >= SAG_CONFIRM_MS) {
+        depleted = true;
+        DEBUG_PRINTF("BatteryMonitor: ⚠️ Akku leer: %.2fV (ohne Last %.2fV) seit %lu ms\n",
+                     rawVoltage, compensatedVoltage, now - underVoltageSince);
+    }
+}
+
 void BatteryMonitor::checkShutdown() {
     if (isCritical() && !criticalActive) {
         criticalActive = true;
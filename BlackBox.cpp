@@ -0,0 +1,232 @@
+/**
+ * BlackBox.cpp
+ *
+ * Implementation des Fahrtenschreibers
+ */
+
+#include "include/BlackBox.h"
+#include <esp_timer.h>
+
+// Records pro Schreibblock (Staging-Puffer im internen RAM)
+static const uint32_t BLOCK_RECORDS = BLACKBOX_STAGING_SIZE / sizeof(BlackBoxRecord);
+
+BlackBox::BlackBox()
+    : sdHandler(nullptr)
+    , ring(nullptr)
+    , stagingBuffer(nullptr)
+    , inPsram(false)
+    , capacity(0)
+    , head(0)
+    , count(0)
+    , triggerPending(false)
+    , frozen(false)
+    , postRemaining(-1)
+    , triggerReason(BlackBoxTrigger::COMMAND)
+    , triggerUs(0)
+    , dumpActive(false)
+    , dumpIndex(0)
+    , dumpStart(0)
+    , dumpCount(0)
+    , dumpStartMs(0)
+    , dumps(0)
+    , dumpErrors(0)
+    , lastDumpMs(0)
+    , cyclesLast(0)
+    , cyclesMax(0)
+    , cyclesSum(0)
+    , cyclesCount(0)
+{
+    dumpPath[0] = '\0';
+    lastPath[0] = '\0';
+}
+
+BlackBox::~BlackBox() {
+    if (ring) free(ring);
+    if (stagingBuffer) free(stagingBuffer);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INITIALISIERUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool BlackBox::begin(SDCardHandler* sdHandler) {
+    this->sdHandler = sdHandler;
+
+    if (!ring) {
+        // Volle Länge nur mit PSRAM, sonst eine Sekunde im internen RAM
+        inPsram = psramFound();
+        capacity = inPsram ? BLACKBOX_SECONDS * BLACKBOX_RATE_HZ : BLACKBOX_RATE_HZ;
+        size_t bytes = capacity * sizeof(BlackBoxRecord);
+        ring = (BlackBoxRecord*)(inPsram ? ps_malloc(bytes) : malloc(bytes));
+    }
+    if (!stagingBuffer) {
+        stagingBuffer = (uint8_t*)malloc(BLACKBOX_STAGING_SIZE);
+    }
+
+    if (!ring || !stagingBuffer) {
+        DEBUG_PRINTLN("BlackBox: ❌ Speicher-Allokation fehlgeschlagen!");
+        if (ring) free(ring);
+        ring = nullptr;
+        capacity = 0;
+        return false;
+    }
+
+    DEBUG_PRINTF("BlackBox: ✅ %lu Records (%lu s, %s)\n",
+                 capacity, capacity / BLACKBOX_RATE_HZ, inPsram ? "PSRAM" : "intern");
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// AUSLÖSER & SCHREIBEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+void BlackBox::trigger(BlackBoxTrigger reason) {
+    if (!ring || triggerPending || frozen) return;
+
+    triggerReason = reason;
+    triggerUs = esp_timer_get_time();
+    triggerPending = true;
+}
+
+void BlackBox::update() {
+    if (!frozen) return;
+
+    if (!dumpActive && !startDump()) {
+        finishDump(false);
+        return;
+    }
+
+    // Ein Block pro Aufruf, damit loop() nicht lange blockiert
+    uint32_t remaining = dumpCount - dumpIndex;
+    uint32_t block = remaining < BLOCK_RECORDS ? remaining : BLOCK_RECORDS;
+
+    BlackBoxRecord* staging = (BlackBoxRecord*)stagingBuffer;
+    uint32_t index = (dumpStart + dumpIndex) % capacity;
+    for (uint32_t i = 0; i < block; i++) {
+        staging[i] = ring[index];
+        if (++index == capacity) index = 0;
+    }
+
+    if (!sdHandler->appendBinaryFile(dumpPath, stagingBuffer, block * sizeof(BlackBoxRecord))) {
+        finishDump(false);
+        return;
+    }
+
+    dumpIndex += block;
+    if (dumpIndex >= dumpCount) {
+        finishDump(true);
+    }
+}
+
+bool BlackBox::startDump() {
+    if (!sdHandler || !sdHandler->isAvailable()) {
+        DEBUG_PRINTLN("BlackBox: ❌ SD-Karte nicht verfügbar!");
+        return false;
+    }
+
+    if (!sdHandler->fileExists(BLACKBOX_DIR)) {
+        sdHandler->createDir(BLACKBOX_DIR);
+    }
+
+    // Freien Dateinamen suchen
+    dumpPath[0] = '\0';
+    for (int i = 0; i < 1000; i++) {
+        char path[32];
+        snprintf(path, sizeof(path), "%s/bb_%03d.bin", BLACKBOX_DIR, i);
+        if (!sdHandler->fileExists(path)) {
+            strncpy(dumpPath, path, sizeof(dumpPath) - 1);
+            dumpPath[sizeof(dumpPath) - 1] = '\0';
+            break;
+        }
+    }
+
+    if (dumpPath[0] == '\0') {
+        DEBUG_PRINTLN("BlackBox: ❌ Keine freie Datei!");
+        return false;
+    }
+
+    // Ring ist eingefroren: ältester Record liegt hinter head
+    dumpCount = count;
+    dumpStart = (head + capacity - count) % capacity;
+    dumpIndex = 0;
+
+    BlackBoxFileHeader header = {};
+    memcpy(header.magic, BLACKBOX_MAGIC, 4);
+    header.version = BLACKBOX_VERSION;
+    header.headerSize = sizeof(BlackBoxFileHeader);
+    header.recordSize = sizeof(BlackBoxRecord);
+    header.rateHz = BLACKBOX_RATE_HZ;
+    header.trigger = (uint8_t)triggerReason;
+    header.recordCount = dumpCount;
+    header.triggerUs = triggerUs;
+    header.pwmMaxDuty = (1UL << MOTOR_PWM_RES) - 1;
+
+    if (!sdHandler->writeBinaryFile(dumpPath, (const uint8_t*)&header, sizeof(header))) {
+        DEBUG_PRINTF("BlackBox: ❌ Datei %s nicht schreibbar!\n", dumpPath);
+        return false;
+    }
+
+    dumpActive = true;
+    dumpStartMs = millis();
+    return true;
+}
+
+void BlackBox::finishDump(bool ok) {
+    if (ok) {
+        dumps++;
+        lastDumpMs = millis() - dumpStartMs;
+        strncpy(lastPath, dumpPath, sizeof(lastPath) - 1);
+        lastPath[sizeof(lastPath) - 1] = '\0';
+        DEBUG_PRINTF("BlackBox: ✅ %lu Records gesichert: %s (%lu ms)\n", dumpCount, dumpPath, lastDumpMs);
+    } else {
+        dumpErrors++;
+    }
+
+    // Neu beginnen: Ring leeren, dann Aufzeichnung freigeben
+    dumpActive = false;
+    head = 0;
+    count = 0;
+    postRemaining = -1;
+    triggerPending = false;
+    frozen = false;
+}
+
+void BlackBox::recordCycles(uint32_t cycles) {
+    cyclesLast = cycles;
+    if (cycles > cyclesMax) cyclesMax = cycles;
+    cyclesSum += cycles;
+    cyclesCount++;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// STATUS
+// ═══════════════════════════════════════════════════════════════════════════
+
+void BlackBox::printInfo() const {
+    static const char* triggerNames[] = { "Befehl", "Stopp", "Watchdog" };
+
+    DEBUG_PRINTLN("═══════════════════════════════════════════════════════");
+    DEBUG_PRINTLN("BlackBox - Status");
+    DEBUG_PRINTLN("═══════════════════════════════════════════════════════");
+    if (!ring) {
+        DEBUG_PRINTLN("Nicht initialisiert");
+        DEBUG_PRINTLN("═══════════════════════════════════════════════════════");
+        return;
+    }
+    DEBUG_PRINTF("Ringpuffer:     %lu / %lu Records (%s, %u Bytes/Record)\n",
+                 count, capacity, inPsram ? "PSRAM" : "intern", (unsigned)sizeof(BlackBoxRecord));
+    DEBUG_PRINTF("Zeitfenster:    %lu ms bei %d Hz\n", count * 1000UL / BLACKBOX_RATE_HZ, BLACKBOX_RATE_HZ);
+    DEBUG_PRINTF("Zustand:        %s\n",
+                 frozen ? "Schreibe auf SD" : (triggerPending ? "Nachlauf" : "Aufzeichnung"));
+    if (frozen || triggerPending) {
+        DEBUG_PRINTF("Auslöser:       %s\n", triggerNames[(uint8_t)triggerReason]);
+    }
+    DEBUG_PRINTF("Gesichert:      %lu (Fehler %lu)\n", dumps, dumpErrors);
+    if (lastPath[0]) {
+        DEBUG_PRINTF("Letzte Datei:   %s (%lu ms)\n", lastPath, lastDumpMs);
+    }
+    uint32_t avg = cyclesCount ? (uint32_t)(cyclesSum / cyclesCount) : 0;
+    DEBUG_PRINTF("Aufwand:        last %lu, avg %lu, max %lu Zyklen/Record (%.2f us avg)\n",
+                 cyclesLast, avg, cyclesMax, avg / (float)ESP.getCpuFreqMHz());
+    DEBUG_PRINTLN("═══════════════════════════════════════════════════════");
+}
@@ -0,0 +1,181 @@
+/**
+ * ClockSync.cpp
+ *
+ * Implementation der Offset-/Drift-Schätzung für die Zeitsynchronisation
+ */
+
+#include "include/ClockSync.h"
+
+ClockSync::ClockSync()
+    : sampleIndex(0)
+    , samplesFilled(0)
+    , synced(false)
+    , offsetUs(0)
+    , refLocalUs(0)
+    , drift(0.0)
+    , lastUsedLocalUs(0)
+    , pendingT1(0)
+    , lastDelayUs(0)
+    , minDelayUs(0)
+    , sampleCount(0)
+    , rejectedCount(0)
+    , stepCount(0)
+{
+    lock = portMUX_INITIALIZER_UNLOCKED;
+    memset(samples, 0, sizeof(samples));
+}
+
+void ClockSync::reset() {
+    clearEstimate();
+    pendingT1 = 0;
+    minDelayUs = 0;
+}
+
+void ClockSync::clearEstimate() {
+    portENTER_CRITICAL(&lock);
+    synced = false;
+    offsetUs = 0;
+    refLocalUs = 0;
+    drift = 0.0;
+    portEXIT_CRITICAL(&lock);
+
+    sampleIndex = 0;
+    samplesFilled = 0;
+    lastUsedLocalUs = 0;
+}
+
+void ClockSync::markRequestSent(int64_t t1) {
+    pendingT1 = t1;
+}
+
+bool ClockSync::addSample(int64_t t1, int64_t t2, int64_t t3, int64_t t4) {
+    // Nur Antwort auf den zuletzt gesendeten Request akzeptieren
+    if (pendingT1 == 0 || t1 != pendingT1) {
+        rejectedCount++;
+        return false;
+    }
+    pendingT1 = 0;
+
+    int64_t delay = (t4 - t1) - (t3 - t2);
+    int64_t offset = ((t2 - t1) + (t3 - t4)) / 2;
+
+    lastDelayUs = delay;
+
+    // Unplausible Samples verwerfen (negative Laufzeit, extrem verzögert)
+    if (delay < 0 || delay > TIMESYNC_MAX_DELAY_US) {
+        rejectedCount++;
+        return false;
+    }
+
+    // Uhrsprung des Masters (Neustart/Reconnect): alte Samples mit kleinerem
+    // Delay würden den Filter sonst noch lange dominieren
+    if (synced) {
+        int64_t predicted = offsetUs + (int64_t)(drift * (double)(t4 - refLocalUs));
+        int64_t residual = offset - predicted;
+        if (residual > TIMESYNC_STEP_US || residual < -TIMESYNC_STEP_US) {
+            stepCount++;
+            clearEstimate();
+        }
+    }
+
+    sampleCount++;
+    if (minDelayUs == 0 || delay < minDelayUs) {
+        minDelayUs = delay;
+    }
+
+    samples[sampleIndex].offsetUs = offset;
+    samples[sampleIndex].delayUs = delay;
+    samples[sampleIndex].localUs = t4;
+    sampleIndex = (sampleIndex + 1) % FILTER_SAMPLES;
+    if (samplesFilled < FILTER_SAMPLES) samplesFilled++;
+
+    // Clock-Filter: Sample mit minimalem Delay ist am wenigsten durch
+    // Queueing verfälscht (Offset-Fehler ist durch δ/2 begrenzt)
+    const Sample* best = &samples[0];
+    for (uint8_t i = 1; i < samplesFilled; i++) {
+        if (samples[i].delayUs < best->delayUs) {
+            best = &samples[i];
+        }
+    }
+
+    // Jedes Sample nur einmal in die Schätzung einfließen lassen
+    if (best->localUs <= lastUsedLocalUs) {
+        return true;
+    }
+    lastUsedLocalUs = best->localUs;
+
+    applySample(*best);
+    return true;
+}
+
+int64_t ClockSync::getSyncedTimeUs() const {
+    return toSyncedTimeUs(localTimeUs());
+}
+
+int64_t ClockSync::toSyncedTimeUs(int64_t localUs) const {
+    portENTER_CRITICAL_SAFE(&lock);
+    bool isSynced = synced;
+    int64_t offset = offsetUs;
+    int64_t ref = refLocalUs;
+    double d = drift;
+    portEXIT_CRITICAL_SAFE(&lock);
+
+    if (!isSynced) return -1;
+
+    return localUs + offset + (int64_t)(d * (double)(localUs - ref));
+}
+
+void ClockSync::printInfo() const {
+    DEBUG_PRINTLN("\n╔════════════════════════════════════════╗");
+    DEBUG_PRINTLN("║       CLOCK SYNC INFO                  ║");
+    DEBUG_PRINTLN("╚════════════════════════════════════════╝");
+    DEBUG_PRINTF("Synchronisiert: %s\n", synced ? "JA" : "NEIN");
+    DEBUG_PRINTF("Offset:         %lld us\n", offsetUs);
+    DEBUG_PRINTF("Drift:          %.2f ppm\n", getDriftPpm());
+    DEBUG_PRINTF("Delay (last):   %lld us\n", lastDelayUs);
+    DEBUG_PRINTF("Delay (min):    %lld us\n", minDelayUs);
+    DEBUG_PRINTF("Samples:        %lu (verworfen: %lu)\n", sampleCount, rejectedCount);
+    DEBUG_PRINTF("Uhrsprünge:     %lu\n", stepCount);
+    if (synced) {
+        DEBUG_PRINTF("Master-Zeit:    %lld us\n", getSyncedTimeUs());
+    }
+    DEBUG_PRINTLN("────────────────────────────────────────");
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PRIVATE METHODEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+void ClockSync::applySample(const Sample& sample) {
+    int64_t newOffset;
+    double newDrift;
+
+    if (!synced) {
+        // Erstes Sample: Offset direkt übernehmen
+        newOffset = sample.offsetUs;
+        newDrift = 0.0;
+    } else {
+        int64_t dt = sample.localUs - refLocalUs;
+        int64_t predicted = offsetUs + (int64_t)(drift * (double)dt);
+        int64_t residual = sample.offsetUs - predicted;
+
+        // Offset proportional, Drift integral nachführen
+        newOffset = predicted + residual / TIMESYNC_OFFSET_GAIN_DIV;
+        newDrift = drift;
+        if (dt > 0) {
+            newDrift += ((double)residual / (double)dt) / TIMESYNC_DRIFT_GAIN_DIV;
+        }
+
+        // Quarz-Toleranz: Drift begrenzen
+        const double maxDrift = TIMESYNC_MAX_DRIFT_PPM * 1e-6;
+        if (newDrift > maxDrift) newDrift = maxDrift;
+        if (newDrift < -maxDrift) newDrift = -maxDrift;
+    }
+
+    portENTER_CRITICAL(&lock);
+    offsetUs = newOffset;
+    drift = newDrift;
+    refLocalUs = sample.localUs;
+    synced = true;
+    portEXIT_CRITICAL(&lock);
+}
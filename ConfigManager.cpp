@@ -20,6 +20,7 @@ ConfigManager::ConfigManager()
     : sdCard(nullptr)
     , initialized(false)
     , dirty(false)
+    , revision(0)
 {
     memset(configFilePath, 0, sizeof(configFilePath));
     memset(backupFilePath, 0, sizeof(backupFilePath));
@@ -0,0 +1,110 @@
+/**
+ * CurrentLimiter.cpp
+ *
+ * Implementation des Strombegrenzers
+ */
+
+#include "include/CurrentLimiter.h"
+
+CurrentLimiter::CurrentLimiter()
+    : limitMa(0)
+    , softMa(0)
+    , filteredQ4(0)
+    , scaleQ8(SCALE_ONE)
+    , overLimit(false)
+    , overSinceUs(0)
+{
+    resetStats();
+}
+
+void CurrentLimiter::setLimit(int32_t limit) {
+    limitMa = limit > 0 ? limit : 0;
+    softMa = limitMa * CURRENT_LIMIT_SOFT_PCT / 100;
+}
+
+uint16_t CurrentLimiter::update(int32_t currentMa, uint32_t nowUs) {
+    stats.samples++;
+    if (currentMa > stats.peakMa) stats.peakMa = currentMa;
+
+    // IIR: y += (x - y) / 2^shift, Zustand mit 4 Nachkommabits
+    filteredQ4 += ((currentMa << 4) - filteredQ4) >> CURRENT_LIMIT_FILTER_SHIFT;
+    int32_t filtered = filteredQ4 >> 4;
+    stats.filteredMa = filtered;
+
+    if (limitMa == 0) {
+        scaleQ8 = SCALE_ONE;
+        stats.scaleQ8 = scaleQ8;
+        return scaleQ8;
+    }
+
+    // ═══════════════════════════════════════════════════════════════════
+    // Soll-Faktor: 1.0 bis softMa, linear bis MIN_SCALE am Limit, darüber MIN_SCALE
+    // ═══════════════════════════════════════════════════════════════════
+    int32_t target = SCALE_ONE;
+    if (filtered > softMa) {
+        int32_t band = limitMa - softMa;
+        int32_t over = filtered - softMa;
+        if (band <= 0 || over >= band) {
+            target = CURRENT_LIMIT_MIN_SCALE;
+        } else {
+            target = SCALE_ONE - over * (SCALE_ONE - CURRENT_LIMIT_MIN_SCALE) / band;
+        }
+    }
+
+    // Sofort drosseln, langsam freigeben
+    if (target < scaleQ8) {
+        if (scaleQ8 == SCALE_ONE) stats.limitEvents++;
+        scaleQ8 = (uint16_t)target;
+    } else if (scaleQ8 < target) {
+        int32_t next = scaleQ8 + CURRENT_LIMIT_RELEASE;
+        scaleQ8 = (uint16_t)(next > target ? target : next);
+    }
+
+    if (scaleQ8 < stats.minScaleQ8) stats.minScaleQ8 = scaleQ8;
+    stats.scaleQ8 = scaleQ8;
+
+    // ═══════════════════════════════════════════════════════════════════
+    // Reaktionszeit: erste Roh-Überschreitung → gefiltert wieder unter Limit
+    // ═══════════════════════════════════════════════════════════════════
+    if (!overLimit && currentMa > limitMa) {
+        overLimit = true;
+        overSinceUs = nowUs;
+    } else if (overLimit && filtered <= limitMa && currentMa <= limitMa) {
+        overLimit = false;
+        uint32_t response = nowUs - overSinceUs;
+        stats.lastResponseUs = response;
+        if (response > stats.maxResponseUs) stats.maxResponseUs = response;
+    }
+
+    return scaleQ8;
+}
+
+void CurrentLimiter::idle() {
+    filteredQ4 = 0;
+    scaleQ8 = SCALE_ONE;
+    overLimit = false;
+    stats.filteredMa = 0;
+    stats.scaleQ8 = scaleQ8;
+}
+
+void CurrentLimiter::recordSampleTime(uint32_t us) {
+    stats.lastSampleUs = us;
+    if (us > stats.maxSampleUs) stats.maxSampleUs = us;
+}
+
+CurrentLimitStats CurrentLimiter::getStats() const {
+    return stats;
+}
+
+void CurrentLimiter::resetStats() {
+    stats.samples = 0;
+    stats.limitEvents = 0;
+    stats.filteredMa = filteredQ4 >> 4;
+    stats.peakMa = 0;
+    stats.scaleQ8 = scaleQ8;
+    stats.minScaleQ8 = SCALE_ONE;
+    stats.lastResponseUs = 0;
+    stats.maxResponseUs = 0;
+    stats.lastSampleUs = 0;
+    stats.maxSampleUs = 0;
+}
@@ -24,6 +24,10 @@
 #include "include/ESPNowRemoteController.h"
 #include "include/BatteryMonitor.h"
 #include "include/MotorController.h"
+#include "include/PacketCapture.h"
+#include "include/BlackBox.h"
+#include "include/TrajectoryPlayer.h"
+#include "include/BatteryHistory.h"
 #include "include/setupConf.h"
 #include "include/Globals.h"
 
@@ -57,6 +61,8 @@ void setup() {
     
     bootTime = millis();
     systemInitialized = true;
+    Serial.printf("Boot → bereit für Kommandos: %lu ms\n", bootTime);
+    logger.logf(LOG_INFO, "BOOT", "Ready for commands after %lu ms", bootTime);
     
     Serial.println("═══════════════════════════════════════════════════════");
     Serial.println("System Ready!");
@@ -74,12 +80,23 @@ void loop() {
     // ESP-NOW Update (prüft Heartbeat/Timeouts, verarbeitet RX-Queue)
     espNow.update();
     
-    // Batterie-Status prüfen
-    battery.update();
+    // Paket-Mitschnitt flushen / Replay einspeisen
+    packetCapture.update();
+    
+    // Black Box nach Auslöser blockweise auf SD sichern
+    blackBox.update();
+    
+    // Batterie-Status prüfen, neues Messintervall in den Verlauf
+    if (battery.update()) {
+        batteryHistory.addSample(battery);
+    }
     
     // Motor Controller Update
     motorCtrl.update();
     
+    // Binäre Log-Records aus Hot-Paths formatieren/ausgeben
+    logger.update();
+    
     // Connection-Timeout prüfen (2 Sekunden)
     if (remoteConnected && (millis() - lastRemoteActivity > 2000)) {
         remoteConnected = false;
@@ -87,12 +104,12 @@ void loop() {
         logger.warning("CONNECTION", "Remote connection timeout");
     }
     
-    // Periodisch Telemetrie senden (alle 500ms)
-    /*static unsigned long lastTelemetry = 0;
-    if (remoteConnected && (millis() - lastTelemetry > 500)) {
+    // Periodisch Telemetrie senden (alle 500ms, nur bei verbundenem Master)
+    static unsigned long lastTelemetry = 0;
+    if (millis() - lastTelemetry >= TELEMETRY_INTERVAL_MS) {
         sendTelemetry();
         lastTelemetry = millis();
-    }*/
+    }
     
     delay(10);
 }
@@ -171,8 +188,9 @@ bool initializeSystem() {
     // Battery Monitor initialisieren
     // ─────────────────────────────────────────────────────────────────────
     Serial.println("[INIT] Initializing battery monitor...");
+    unsigned long batteryInitStart = millis();
     if (battery.begin()) {
-        Serial.println("  ✅ Battery OK");
+        Serial.printf("  ✅ Battery OK (%lu ms, Strom-Nullpunkt im Hintergrund)\n", millis() - batteryInitStart);
         Serial.printf("  Voltage: %.2fV, Percent: %d%%\n", 
                      battery.getVoltage(), battery.getPercent());
         logger.logf(LOG_INFO, "BOOT", "Battery: %.2fV (%d%%)", 
@@ -269,6 +287,9 @@ bool initializeSystem() {
         Serial.printf("[ESP-NOW] DATA_RECEIVED from %s\n", mac.c_str());
     });
     
+    // Log-Einträge mit synchronisierter Master-Zeit stempeln (Fallback: millis)
+    logger.setTimeSource([]() -> int64_t { return espNow.getSyncedTimeUs(); });
+    
     // Joystick-Callback (High-Level)
     /*espNow.setJoystickCallback([](const uint8_t* mac, const JoystickData& data) {
         // Joystick-Daten an MotorController weiterleiten
@@ -288,6 +309,38 @@ bool initializeSystem() {
                    data.x, data.y, data.button);
     });*/
     
+    // ─────────────────────────────────────────────────────────────────────
+    // Paket-Mitschnitt (Capture/Replay) vorbereiten
+    // ─────────────────────────────────────────────────────────────────────
+    if (!packetCapture.begin(&sdCard, &espNow)) {
+        Serial.println("  ⚠️ Packet capture unavailable");
+    }
+    
+    // ─────────────────────────────────────────────────────────────────────
+    // Black Box (Fahrtenschreiber im RAM, Sicherung auf SD bei Auslöser)
+    // ─────────────────────────────────────────────────────────────────────
+    if (!blackBox.begin(&sdCard)) {
+        Serial.println("  ⚠️ Black box unavailable");
+    }
+    
+    // ─────────────────────────────────────────────────────────────────────
+    // Trajectory (Sollwert-Wiedergabe für Testfahrten)
+    // ─────────────────────────────────────────────────────────────────────
+    if (!trajectory.begin(&sdCard)) {
+        Serial.println("  ⚠️ Trajectory playback unavailable");
+    }
+    
+    // ─────────────────────────────────────────────────────────────────────
+    // Akku-Verlauf (Ringspeicher auf SD, gepufferte Werte vor Sleep sichern)
+    // ─────────────────────────────────────────────────────────────────────
+    if (batteryHistory.begin(&sdCard)) {
+        powerMgr.setBeforeSleepCallback([]() {
+            batteryHistory.flush();
+        });
+    } else {
+        Serial.println("  ⚠️ Battery history unavailable");
+    }
+    
     // ─────────────────────────────────────────────────────────────────────
     // Serial Command Handler initialisieren
     // ─────────────────────────────────────────────────────────────────────
@@ -318,28 +371,37 @@ void shutdownSystem() {
 // TELEMETRIE SENDEN
 // ═══════════════════════════════════════════════════════════════════════════
 
-/*void sendTelemetry() {
-    // Telemetrie-Daten zusammenstellen
-    TelemetryData telemetry;
-    telemetry.batteryVoltage = (uint16_t)(battery.getVoltage() * 1000); // mV
-    telemetry.batteryPercent = battery.getPercent();
-    telemetry.temperature = 0;  // TODO: Temperature sensor
-    telemetry.rssi = WiFi.RSSI();
-    
-    // Motor-Telemetrie als RemoteESPNowPacket
-    RemoteESPNowPacket packet;
+// Restlaufzeit in Minuten für die Telemetrie (0xFFFF = unbekannt)
+static uint16_t runtimeMinutes(uint32_t seconds) {
+    if (seconds == RUNTIME_UNKNOWN) return 0xFFFF;
+    uint32_t minutes = seconds / 60;
+    return minutes > 0xFFFE ? 0xFFFE : (uint16_t)minutes;
+}
+
+void sendTelemetry() {
+    uint8_t masterMac[6];
+    if (!ESPNowRemoteController::stringToMac(userConfig.getEspnowPeerMac(), masterMac)) return;
+    if (!espNow.isPeerConnected(masterMac)) return;
+    
+    ESPNowPacket packet;
     packet.begin(MainCmd::DATA_RESPONSE);
-    packet.addTelemetry(telemetry);
+    packet.addUInt16(DataCmd::BATTERY_VOLTAGE, (uint16_t)(battery.getVoltage() * 1000));  // mV
+    packet.addByte(DataCmd::BATTERY_PERCENT, battery.getPercent());
+    packet.addUInt16(DataCmd::BATTERY_RUNTIME, runtimeMinutes(battery.getRuntime().getSecondsToEmpty()));
+    packet.addUInt16(DataCmd::BATTERY_CUTOFF, runtimeMinutes(battery.getRuntime().getSecondsToShutdown()));
+    packet.addUInt16(DataCmd::BATTERY_DERATE, runtimeMinutes(battery.getRuntime().getSecondsToDerate()));
     
     // Motor-Status
     MotorTelemetry motorTel = motorCtrl.getTelemetry();
-    packet.addMotors(motorTel.leftSpeed, motorTel.rightSpeed);
+    packet.addInt16(DataCmd::MOTOR_LEFT, motorTel.leftSpeed);
+    packet.addInt16(DataCmd::MOTOR_RIGHT, motorTel.rightSpeed);
     
-    // Verbindungsstatus
-    uint8_t connectionStatus = remoteConnected ? 1 : 0;
-    packet.add(static_cast<DataCmd>(static_cast<uint8_t>(RemoteDataCmd::CONNECTION)), 
-               &connectionStatus, 1);
+    // Signalstärke (geglättet) und Verbindungsstatus
+    ESPNowPeer* peer = espNow.getPeer(masterMac);
+    if (peer && peer->rssi != 0) {
+        packet.addInt8(DataCmd::RSSI, peer->rssi);
+    }
+    packet.addByte(DataCmd::CONNECTION, remoteConnected ? 1 : 0);
     
-    // An alle Peers senden (Broadcast)
-    espNow.broadcast(packet);
-}*/
\ No newline at end of file
+    espNow.sendSecure(masterMac, packet);
+}
\ No newline at end of file
@@ -8,10 +8,16 @@
 
 #include "include/ESPNowManager.h"
 #include <esp_wifi.h>
+#include <esp_timer.h>
 
 // Statischer Instance-Pointer
 ESPNowManager* ESPNowManager::instance = nullptr;
 
+// Capture-Hook (PacketCapture)
+volatile ESPNowCaptureHook ESPNowManager::captureHook = nullptr;
+volatile int8_t ESPNowManager::lastRssi = 0;
+volatile uint32_t ESPNowManager::rxQueueDropped = 0;
+
 // ═══════════════════════════════════════════════════════════════════════════
 // ESPNOWMANAGER - HAUPTKLASSE
 // ═══════════════════════════════════════════════════════════════════════════
@@ -182,6 +188,7 @@ bool ESPNowManager::addPeer(const uint8_t* mac, bool encrypt) {
             newPeer.packetsSent = 0;
             newPeer.packetsLost = 0;
             newPeer.rssi = 0;
+            newPeer.rssiFilter.reset();
 
             peers.push_back(newPeer);
             result = true;
@@ -222,6 +229,8 @@ bool ESPNowManager::removePeer(const uint8_t* mac) {
     xSemaphoreGive(peersMutex);
 
     if (result) {
+        onPeerLost(mac);
+        
         ESPNowEventData eventData = {};
         eventData.event = ESPNowEvent::PEER_REMOVED;
         memcpy(eventData.mac, mac, 6);
@@ -236,12 +245,17 @@ void ESPNowManager::removeAllPeers() {
         return;
     }
     
-    while (!peers.empty()) {
-        esp_now_del_peer(peers[0].mac);
-        peers.erase(peers.begin());
+    std::vector<ESPNowPeer> removed;
+    removed.swap(peers);
+    for (const auto& peer : removed) {
+        esp_now_del_peer(peer.mac);
     }
     
     xSemaphoreGive(peersMutex);
+    
+    for (const auto& peer : removed) {
+        onPeerLost(peer.mac);
+    }
 }
 
 bool ESPNowManager::hasPeer(const uint8_t* mac) {
@@ -317,6 +331,11 @@ bool ESPNowManager::send(const uint8_t* mac, const ESPNowPacket& packet) {
     // DIREKT senden - esp_now_send ist bereits nicht-blockierend!
     esp_err_t result = esp_now_send(targetMac, packet.getRawData(), packet.getTotalLength());
     
+    ESPNowCaptureHook hook = captureHook;
+    if (hook && result == ESP_OK) {
+        hook(true, targetMac, packet.getRawData(), packet.getTotalLength(), 0, esp_timer_get_time());
+    }
+    
     if (result != ESP_OK) {
         DEBUG_PRINTF("ESPNowManager: ⚠️ esp_now_send() fehlgeschlagen: %d\n", result);
         return false;
@@ -395,6 +414,7 @@ void ESPNowManager::checkTimeouts() {
                 
                 // Events nach Mutex-Release triggern
                 xSemaphoreGive(peersMutex);
+                onPeerLost(eventData.mac);
                 triggerEvent(ESPNowEvent::PEER_DISCONNECTED, &eventData);
                 triggerEvent(ESPNowEvent::HEARTBEAT_TIMEOUT, &eventData);
                 
@@ -442,6 +462,20 @@ void ESPNowManager::triggerEvent(ESPNowEvent event, ESPNowEventData* data) {
     }
 }
 
+bool ESPNowManager::injectRx(const uint8_t* mac, const uint8_t* data, size_t len) {
+    if (!rxQueue || !mac || !data || len == 0 || len > ESPNOW_MAX_PACKET_SIZE) return false;
+    
+    RxQueueItem item;
+    memcpy(item.mac, mac, 6);
+    memcpy(item.data, data, len);
+    item.length = len;
+    item.timestamp = millis();
+    item.timestampUs = esp_timer_get_time();
+    item.rssi = 0;
+    
+    return xQueueSend(rxQueue, &item, 0) == pdTRUE;
+}
+
 // ═══════════════════════════════════════════════════════════════════════════
 // STATISCHE ESP-NOW CALLBACKS (minimal - nur Queue!)
 // ═══════════════════════════════════════════════════════════════════════════
@@ -463,58 +497,25 @@ void ESPNowManager::triggerEvent(ESPNowEvent event, ESPNowEventData* data) {
 }*/
 
 void ESPNowManager::onDataRecvStatic(const esp_now_recv_info_t* info, const uint8_t* data, int len) {
-    // ⭐ WICHTIG: Dieser Callback läuft im WiFi-ISR Kontext!
-    // Nur minimale Verarbeitung, dann in Queue schieben!
-    
-    Serial.println("\n╔════════════════════════════════════════╗");
-    Serial.println("║  onDataRecvStatic CALLED!!!            ║");
-    Serial.println("╚════════════════════════════════════════╝");
-    
-    // Instance-Pointer prüfen
-    if (!instance) {
-        Serial.println("  ❌ instance is NULL!");
-        return;
-    }
+    // ⭐ WICHTIG: Dieser Callback läuft im WiFi-Task!
+    // Nur minimale Verarbeitung, dann in Queue schieben - keine Serial-Ausgaben
+    // (blockieren den WiFi-Task und verzögern Empfangszeitstempel)
     
-    Serial.println("  ✅ instance OK");
+    // Empfangszeit als Erstes erfassen (T4 für Zeitsync)
+    int64_t rxTimeUs = esp_timer_get_time();
     
-    // Parameter prüfen
-    if (!info) {
-        Serial.println("  ❌ info is NULL!");
+    if (!instance || !instance->rxQueue || !info || !data || len <= 0 || len > ESPNOW_MAX_PACKET_SIZE) {
         return;
     }
     
-    if (!data) {
-        Serial.println("  ❌ data is NULL!");
-        return;
-    }
-    
-    if (len <= 0) {
-        Serial.printf("  ❌ len is invalid: %d\n", len);
-        return;
-    }
-    
-    Serial.printf("  ✅ Parameters OK (len=%d)\n", len);
-    
-    // Queue prüfen
-    if (!instance->rxQueue) {
-        Serial.println("  ❌ rxQueue is NULL!");
-        return;
-    }
-    
-    Serial.println("  ✅ rxQueue OK");
+    // Mitschnitt (vor Queue, damit auch verworfene Frames erfasst werden)
+    int8_t rssi = info->rx_ctrl ? (int8_t)info->rx_ctrl->rssi : 0;
+    lastRssi = rssi;
     
-    // MAC ausgeben
-    Serial.printf("  From: %02X:%02X:%02X:%02X:%02X:%02X\n",
-                 info->src_addr[0], info->src_addr[1], info->src_addr[2],
-                 info->src_addr[3], info->src_addr[4], info->src_addr[5]);
-    
-    // Daten als Hex ausgeben (erste 20 Bytes)
-    Serial.print("  Data: ");
-    for (int i = 0; i < min(len, 20); i++) {
-        Serial.printf("%02X ", data[i]);
+    ESPNowCaptureHook hook = captureHook;
+    if (hook) {
+        hook(false, info->src_addr, data, len, rssi, rxTimeUs);
     }
-    Serial.println();
     
     // Item erstellen
     RxQueueItem item;
@@ -522,20 +523,13 @@ void ESPNowManager::onDataRecvStatic(const esp_now_recv_info_t* info, const uint
     memcpy(item.data, data, len);
     item.length = len;
     item.timestamp = millis();
+    item.timestampUs = rxTimeUs;
+    item.rssi = rssi;
     
-    Serial.println("  Item prepared, adding to queue...");
-    
-    // In Queue schieben (non-blocking, von ISR aus)
-    BaseType_t result = xQueueSendFromISR(instance->rxQueue, &item, nullptr);
-    
-    if (result == pdTRUE) {
-        int pending = uxQueueMessagesWaiting(instance->rxQueue);
-        Serial.printf("  ✅ Added to queue! Pending: %d\n", pending);
-    } else {
-        Serial.println("  ❌ Queue FULL or error!");
+    // In Queue schieben (non-blocking), volle Queue nur zählen
+    if (xQueueSendFromISR(instance->rxQueue, &item, nullptr) != pdTRUE) {
+        rxQueueDropped++;
     }
-    
-    Serial.println("════════════════════════════════════════\n");
 }
 
 /*void ESPNowManager::onDataSentStatic(const wifi_tx_info_t* tx_info, esp_now_send_status_t status) {
@@ -672,8 +666,7 @@ void ESPNowManager::processRxQueue() {
             if (index >= 0) {
                 wasDisconnected = !peers[index].connected;
                 peers[index].connected = true;
-                peers[index].lastSeen = rxItem.timestamp;
-                peers[index].packetsReceived++;
+                notePeerReceived(peers[index], rxItem);
             }
             xSemaphoreGive(peersMutex);
         }
@@ -776,6 +769,16 @@ int ESPNowManager::findPeerIndex(const uint8_t* mac) {
     return -1;
 }
 
+void ESPNowManager::notePeerReceived(ESPNowPeer& peer, const RxQueueItem& rxItem) {
+    peer.lastSeen = rxItem.timestamp;
+    peer.packetsReceived++;
+    
+    // Pakete ohne RX-Info (RSSI 0) verfälschen das Mittel nicht
+    if (rxItem.rssi != 0) {
+        peer.rssi = (int8_t)peer.rssiFilter.update(rxItem.rssi);
+    }
+}
+
 bool ESPNowManager::compareMac(const uint8_t* mac1, const uint8_t* mac2) {
     if (!mac1 || !mac2) return false;
     return memcmp(mac1, mac2, 6) == 0;
@@ -797,6 +800,7 @@ void ESPNowManager::printInfo() {
     // Queue-Statistiken
     DEBUG_PRINTLN("\n─── Queue ─────────────────────────────────────");
     DEBUG_PRINTF("RX-Queue:   %d / %d\n", getQueuePending(), ESPNOW_RX_QUEUE_SIZE);
+    DEBUG_PRINTF("Verworfen:  %lu (Queue voll)\n", getQueueDropped());
     
     DEBUG_PRINTLN("\n─── Peers ─────────────────────────────────────");
     
@@ -809,6 +813,9 @@ void ESPNowManager::printInfo() {
             DEBUG_PRINTF("  LastSeen:   %lums ago\n", peer.lastSeen > 0 ? (millis() - peer.lastSeen) : 0);
             DEBUG_PRINTF("  RX/TX/Lost: %lu / %lu / %lu\n", 
                          peer.packetsReceived, peer.packetsSent, peer.packetsLost);
+            if (peer.rssi != 0) {
+                DEBUG_PRINTF("  RSSI:       %d dBm (geglättet)\n", peer.rssi);
+            }
         }
         
         xSemaphoreGive(peersMutex);
@@ -91,6 +91,10 @@ ESPNowPacket& ESPNowPacket::addInt32(DataCmd dataCmd, int32_t value) {
     return add(dataCmd, &value, 4);
 }
 
+ESPNowPacket& ESPNowPacket::addInt64(DataCmd dataCmd, int64_t value) {
+    return add(dataCmd, &value, 8);
+}
+
 ESPNowPacket& ESPNowPacket::addFloat(DataCmd dataCmd, float value) {
     return add(dataCmd, &value, 4);
 }
@@ -211,6 +215,17 @@ bool ESPNowPacket::getInt32(DataCmd dataCmd, int32_t& outValue) const {
     return false;
 }
 
+bool ESPNowPacket::getInt64(DataCmd dataCmd, int64_t& outValue) const {
+    size_t len;
+    const uint8_t* data = getData(dataCmd, &len);
+    if (data && len >= sizeof(int64_t)) {
+        // memcpy: TLV-Daten sind nicht 8-Byte aligned
+        memcpy(&outValue, data, sizeof(int64_t));
+        return true;
+    }
+    return false;
+}
+
 bool ESPNowPacket::getFloat(DataCmd dataCmd, float& outValue) const {
     const float* data = get<float>(dataCmd);
     if (data) {
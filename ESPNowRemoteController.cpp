@@ -8,7 +8,9 @@
 #include "include/ESPNowPacket.h"
 #include "include/UserConfig.h"
 #include "include/MotorController.h"
+#include "include/PowerManager.h"
 #include "include/Globals.h"
+#include <esp_random.h>
 
 extern UserConfig userConfig;
 extern MotorController motorCtrl;
@@ -22,7 +24,18 @@ struct __attribute__((packed)) JoystickData {
 
 ESPNowRemoteController::ESPNowRemoteController()
     : ESPNowManager()
+    , joystickFramesReceived(0)
+    , joystickFramesSuperseded(0)
+    , plaintextRejected(0)
+    , lastTimeSyncSent(0)
+    , latencyLastUs(0)
+    , latencyMinUs(0)
+    , latencyMaxUs(0)
+    , latencySumUs(0)
+    , latencyCount(0)
 {
+    memset(joystickMailbox, 0, sizeof(joystickMailbox));
+    
     Serial.println("[ESPNowRemoteController] Constructor");
     Serial.printf("[ESPNowRemoteController] JoystickData size: %d bytes\n", sizeof(JoystickData));
 }
@@ -52,7 +65,8 @@ bool ESPNowRemoteController::isValidMasterMac(const uint8_t* mac) {
 // PAIR_REQUEST HANDLER
 // ═══════════════════════════════════════════════════════════════════════════
 
-void ESPNowRemoteController::handlePairRequest(const uint8_t* mac, unsigned long timestamp) {
+void ESPNowRemoteController::handlePairRequest(const uint8_t* mac, const ESPNowPacket& packet, unsigned long timestamp,
+                                               bool secureFrame) {
     Serial.println("\n╔════════════════════════════════════════╗");
     Serial.println("║     PAIR_REQUEST HANDLER               ║");
     Serial.println("╚════════════════════════════════════════╝");
@@ -68,6 +82,63 @@ void ESPNowRemoteController::handlePairRequest(const uint8_t* mac, unsigned long
         return;
     }
     
+    size_t nonceLen = 0;
+    const uint8_t* masterNonce = packet.getData(DataCmd::SESSION_NONCE, &nonceLen);
+    bool hasNonce = masterNonce && nonceLen >= CRYPTO_PAIR_NONCE_LEN;
+    bool encryptRequired = userConfig.getEspnowEncrypt();
+    bool pskValid = crypto.setPsk(userConfig.getEspnowPsk());
+    
+    // ═════════════════════════════════════════════════════════════════
+    // Authentifizierung: MAC allein ist fälschbar. Eine bestehende Session
+    // ersetzt nur eine Anfrage im SECURE-Envelope oder mit gültigem
+    // PAIR_AUTH-Tag (HMAC mit PSK, Nonce nicht wiederverwendet)
+    // ═════════════════════════════════════════════════════════════════
+    size_t tagLen = 0;
+    const uint8_t* tag = packet.getData(DataCmd::PAIR_AUTH, &tagLen);
+    bool authenticated = secureFrame;
+    
+    if (!authenticated && tag) {
+        if (!hasNonce || !pskValid || !crypto.verifyPairRequest(mac, masterNonce, tag, tagLen)) {
+            Serial.println("❌ REJECTED: Pairing tag invalid or replayed!");
+            return;
+        }
+        authenticated = true;
+    }
+    
+    if (!authenticated && crypto.hasSession() && isPeerConnected(mac)) {
+        // Kein ERROR an die (evtl. gefälschte) MAC: der echte Master bleibt verbunden
+        plaintextRejected++;
+        Serial.println("❌ REJECTED: Unauthenticated re-pair while session active!");
+        return;
+    }
+    
+    // Session-Key aus PSK und Pairing-Nonces ableiten
+    ESPNowPacket response;
+    response.begin(MainCmd::PAIR_RESPONSE);
+    
+    if (hasNonce && pskValid) {
+        uint8_t deviceNonce[CRYPTO_PAIR_NONCE_LEN];
+        esp_fill_random(deviceNonce, sizeof(deviceNonce));
+        
+        if (crypto.deriveSession(masterNonce, deviceNonce)) {
+            response.add(DataCmd::SESSION_NONCE, deviceNonce, sizeof(deviceNonce));
+            Serial.println("🔐 Session key derived");
+        }
+    } else {
+        crypto.clearSession();
+    }
+    
+    if (encryptRequired && !crypto.hasSession()) {
+        Serial.println("❌ REJECTED: Encryption required (nonce/PSK missing)!");
+        
+        ESPNowPacket errorPacket;
+        errorPacket.begin(MainCmd::ERROR);
+        uint8_t errorCode = 0x02;
+        errorPacket.addByte(DataCmd::ERROR_CODE, errorCode);
+        send(mac, errorPacket);
+        return;
+    }
+    
     if (!hasPeer(mac)) {
         if (!addPeer(mac, false)) {
             Serial.println("❌ addPeer() FAILED!");
@@ -84,8 +155,9 @@ void ESPNowRemoteController::handlePairRequest(const uint8_t* mac, unsigned long
         xSemaphoreGive(peersMutex);
     }
     
-    ESPNowPacket response;
-    response.begin(MainCmd::PAIR_RESPONSE);
+    // Neues Pairing (z.B. nach Master-Neustart): Zeitbasis neu aufbauen
+    clockSync.reset();
+    
     send(mac, response);
     
     ESPNowEventData eventData = {};
@@ -96,6 +168,171 @@ void ESPNowRemoteController::handlePairRequest(const uint8_t* mac, unsigned long
     Serial.println("✅ PAIRING SUCCESSFUL!\n");
 }
 
+// ═══════════════════════════════════════════════════════════════════════════
+// VERSCHLÜSSELUNG (SECURE-Envelope)
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool ESPNowRemoteController::sendSecure(const uint8_t* mac, const ESPNowPacket& packet) {
+    if (!crypto.hasSession()) {
+        return send(mac, packet);
+    }
+    
+    uint8_t sealed[CRYPTO_MAX_PLAINTEXT + CRYPTO_TAG_LEN];
+    uint32_t seq;
+    size_t len = packet.getTotalLength();
+    
+    if (!crypto.seal(CRYPTO_DIR_DEVICE, static_cast<uint8_t>(MainCmd::SECURE),
+                     packet.getRawData(), len, sealed, seq)) {
+        DEBUG_PRINTLN("[TX] ❌ Seal FAILED!");
+        return false;
+    }
+    
+    ESPNowPacket envelope;
+    envelope.begin(MainCmd::SECURE);
+    envelope.addUInt32(DataCmd::SECURE_SEQ, seq);
+    envelope.add(DataCmd::SECURE_PAYLOAD, sealed, len + CRYPTO_TAG_LEN);
+    
+    return send(mac, envelope);
+}
+
+bool ESPNowRemoteController::unwrapSecure(const uint8_t* mac, ESPNowPacket& packet) {
+    if (!crypto.hasSession() || !isValidMasterMac(mac)) return false;
+    
+    uint32_t seq;
+    size_t len = 0;
+    const uint8_t* payload = packet.getData(DataCmd::SECURE_PAYLOAD, &len);
+    
+    if (!packet.getUInt32(DataCmd::SECURE_SEQ, seq) || !payload) {
+        return false;
+    }
+    
+    uint8_t plain[CRYPTO_MAX_PLAINTEXT];
+    if (!crypto.open(CRYPTO_DIR_MASTER, static_cast<uint8_t>(MainCmd::SECURE),
+                     seq, payload, len, plain)) {
+        return false;
+    }
+    
+    // Innerer Frame ersetzt den Envelope (Kommando SECURE ist nicht verschachtelbar)
+    return packet.parse(plain, len - CRYPTO_TAG_LEN) && packet.getMainCmd() != MainCmd::SECURE;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ZEITSYNCHRONISATION
+// ═══════════════════════════════════════════════════════════════════════════
+
+void ESPNowRemoteController::update() {
+    ESPNowManager::update();
+    
+    if (!initialized) return;
+    
+    // OTA: pausieren solange die Motoren laufen (Flash-Löschen hält den Regel-Takt an)
+    ota.setMotorsActive(!motorCtrl.isIdle());
+    ESPNowPacket otaReply;
+    if (ota.update(otaReply)) {
+        uint8_t masterMac[6];
+        if (stringToMac(userConfig.getEspnowPeerMac(), masterMac)) {
+            sendSecure(masterMac, otaReply);
+        }
+    }
+    
+    // Neues Image: erst im Stand und über PowerManager (sichert SoC, R, Verlauf)
+    if (ota.isRestartPending() && motorCtrl.isIdle()) {
+        DEBUG_PRINTLN("[OTA] 🔄 Restart into new image");
+        powerMgr.restart();
+    }
+    
+    // Periodischer Sync-Request (nur bei verbundenem Master)
+    unsigned long now = millis();
+    if (now - lastTimeSyncSent >= TIMESYNC_INTERVAL_MS) {
+        lastTimeSyncSent = now;
+        sendTimeSyncRequest();
+    }
+}
+
+void ESPNowRemoteController::sendTimeSyncRequest() {
+    uint8_t masterMac[6];
+    if (!stringToMac(userConfig.getEspnowPeerMac(), masterMac)) return;
+    if (!isPeerConnected(masterMac)) return;
+    
+    // T1 so spät wie möglich erfassen
+    int64_t t1 = ClockSync::localTimeUs();
+    
+    ESPNowPacket request;
+    request.begin(MainCmd::TIME_SYNC_REQ);
+    request.addInt64(DataCmd::SYNC_T1, t1);
+    
+    if (send(masterMac, request)) {
+        clockSync.markRequestSent(t1);
+    }
+}
+
+void ESPNowRemoteController::handleTimeSyncRequest(const uint8_t* mac, const ESPNowPacket& packet, int64_t rxTimeUs) {
+    int64_t t1;
+    if (!packet.getInt64(DataCmd::SYNC_T1, t1)) return;
+    
+    ESPNowPacket response;
+    response.begin(MainCmd::TIME_SYNC_RESP);
+    response.addInt64(DataCmd::SYNC_T1, t1);
+    response.addInt64(DataCmd::SYNC_T2, rxTimeUs);
+    response.addInt64(DataCmd::SYNC_T3, ClockSync::localTimeUs());
+    send(mac, response);
+}
+
+void ESPNowRemoteController::handleTimeSyncResponse(const uint8_t* mac, const ESPNowPacket& packet, int64_t rxTimeUs) {
+    // Nur der konfigurierte Master ist Zeitreferenz
+    if (!isValidMasterMac(mac)) return;
+    
+    int64_t t1, t2, t3;
+    if (!packet.getInt64(DataCmd::SYNC_T1, t1) ||
+        !packet.getInt64(DataCmd::SYNC_T2, t2) ||
+        !packet.getInt64(DataCmd::SYNC_T3, t3)) {
+        Serial.println("[RX] ❌ TIME_SYNC_RESP incomplete!");
+        return;
+    }
+    
+    bool wasSynced = clockSync.isSynced();
+    
+    if (clockSync.addSample(t1, t2, t3, rxTimeUs) && !wasSynced) {
+        Serial.printf("[TimeSync] ✅ Synchronized (offset=%lld us, delay=%lld us)\n",
+                     clockSync.getOffsetUs(), clockSync.getLastDelayUs());
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FIRMWARE-UPDATE
+// ═══════════════════════════════════════════════════════════════════════════
+
+void ESPNowRemoteController::handleOtaFrame(const uint8_t* mac, const ESPNowPacket& packet, bool secureFrame) {
+    // Firmware nur vom konfigurierten Master annehmen
+    if (!isValidMasterMac(mac)) {
+        DEBUG_PRINTLN("[OTA] ❌ Frame from unknown MAC rejected");
+        return;
+    }
+    
+    // Immer nur authentisch (unabhängig von espnowEncrypt): die MAC ist fälschbar
+    // und der SHA-256 prüft nur die Übertragung, nicht den Absender
+    ESPNowPacket reply;
+    if (!secureFrame) {
+        plaintextRejected++;
+        if (ota.rejectPacket(packet, OtaStatus::ERR_AUTH, reply)) {
+            send(mac, reply);
+        }
+        return;
+    }
+    
+    if (ota.handlePacket(packet, reply)) {
+        sendSecure(mac, reply);
+    }
+}
+
+void ESPNowRemoteController::resetLatencyStats() {
+    latencyLastUs = 0;
+    latencyMinUs = 0;
+    latencyMaxUs = 0;
+    latencySumUs = 0;
+    latencyCount = 0;
+}
+
 // ═══════════════════════════════════════════════════════════════════════════
 // RX-QUEUE VERARBEITUNG
 // ═══════════════════════════════════════════════════════════════════════════
@@ -119,11 +356,56 @@ void ESPNowRemoteController::processRxQueue() {
         
         MainCmd cmd = packet.getMainCmd();
         
+        // ═════════════════════════════════════════════════════════════════
+        // SECURE - Envelope entschlüsseln, danach normal weiterverarbeiten
+        // ═════════════════════════════════════════════════════════════════
+        bool secureFrame = false;
+        if (cmd == MainCmd::SECURE) {
+            if (!unwrapSecure(rxItem.mac, packet)) {
+                DEBUG_PRINTLN("[RX] ❌ SECURE frame rejected (auth/replay)");
+                continue;
+            }
+            secureFrame = true;
+            cmd = packet.getMainCmd();
+        }
+        
         // ═════════════════════════════════════════════════════════════════
         // PAIR_REQUEST
         // ═════════════════════════════════════════════════════════════════
         if (cmd == MainCmd::PAIR_REQUEST) {
-            handlePairRequest(rxItem.mac, rxItem.timestamp);
+            handlePairRequest(rxItem.mac, packet, rxItem.timestamp, secureFrame);
+            continue;
+        }
+        
+        // ═════════════════════════════════════════════════════════════════
+        // TIME SYNC
+        // ═════════════════════════════════════════════════════════════════
+        if (cmd == MainCmd::TIME_SYNC_REQ) {
+            handleTimeSyncRequest(rxItem.mac, packet, rxItem.timestampUs);
+            continue;
+        }
+        
+        if (cmd == MainCmd::TIME_SYNC_RESP) {
+            handleTimeSyncResponse(rxItem.mac, packet, rxItem.timestampUs);
+            continue;
+        }
+        
+        // ═════════════════════════════════════════════════════════════════
+        // FIRMWARE-UPDATE (OTA)
+        // ═════════════════════════════════════════════════════════════════
+        if (cmd >= MainCmd::OTA_BEGIN && cmd <= MainCmd::OTA_ABORT) {
+            handleOtaFrame(rxItem.mac, packet, secureFrame);
+            
+            // Peer aktualisieren (Update-Traffic ersetzt Heartbeats)
+            if (xSemaphoreTake(peersMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+                int index = findPeerIndex(rxItem.mac);
+                if (index >= 0) {
+                    peers[index].connected = true;
+                    notePeerReceived(peers[index], rxItem);
+                }
+                xSemaphoreGive(peersMutex);
+            }
+            
             continue;
         }
         
@@ -135,108 +417,184 @@ void ESPNowRemoteController::processRxQueue() {
                 int index = findPeerIndex(rxItem.mac);
                 if (index >= 0) {
                     peers[index].connected = true;
-                    peers[index].lastSeen = rxItem.timestamp;
-                    peers[index].packetsReceived++;
+                    notePeerReceived(peers[index], rxItem);
                 }
                 xSemaphoreGive(peersMutex);
             }
             
             ESPNowPacket ackPacket;
             ackPacket.begin(MainCmd::ACK);
-            send(rxItem.mac, ackPacket);
+            sendSecure(rxItem.mac, ackPacket);
             
             continue;
         }
         
         // ═════════════════════════════════════════════════════════════════
-        // JOYSTICK DATA - MIT DEBUG
+        // JOYSTICK DATA - nur in Mailbox ablegen (Latest-Wins)
         // ═════════════════════════════════════════════════════════════════
         if (cmd == MainCmd::USER_START || cmd == MainCmd::DATA_REQUEST) {
             
-            Serial.println("\n──── JOYSTICK DATA ────");
-            Serial.printf("MainCmd: 0x%02X\n", static_cast<uint8_t>(cmd));
-            Serial.printf("Entries: %d\n", packet.getEntryCount());
-            
-            // JOYSTICK_ALL prüfen
-            if (packet.has(DataCmd::JOYSTICK_ALL)) {
-                Serial.println("✅ Has JOYSTICK_ALL (0x13)");
-                
-                size_t dataLen = 0;
-                const uint8_t* data = packet.getData(DataCmd::JOYSTICK_ALL, &dataLen);
-                
-                Serial.printf("Data length: %d bytes (expected: %d)\n", dataLen, sizeof(JoystickData));
-                
-                if (data && dataLen > 0) {
-                    // Hex dump der Rohdaten
-                    Serial.print("Raw data: ");
-                    for (size_t i = 0; i < dataLen; i++) {
-                        Serial.printf("%02X ", data[i]);
-                    }
-                    Serial.println();
-                    
-                    // Prüfe Länge
-                    if (dataLen >= sizeof(JoystickData)) {
-                        const JoystickData* joyData = packet.get<JoystickData>(DataCmd::JOYSTICK_ALL);
-                        
-                        if (joyData) {
-                            Serial.printf("✅ Joystick: X=%d, Y=%d, Btn=%d\n", 
-                                         joyData->x, joyData->y, joyData->btn);
-                            
-                            // An Motor weitergeben
-                            motorCtrl.processMovementInput((int8_t)joyData->x, (int8_t)joyData->y);
-                            
-                        } else {
-                            Serial.println("❌ get<JoystickData>() returned NULL!");
-                        }
-                    } else {
-                        Serial.printf("❌ Data too short: %d < %d bytes\n", dataLen, sizeof(JoystickData));
-                        
-                        // Versuche manuelle Extraktion (Little Endian)
-                        if (dataLen >= 5) {
-                            int16_t x = (int16_t)((data[1] << 8) | data[0]);
-                            int16_t y = (int16_t)((data[3] << 8) | data[2]);
-                            uint8_t btn = data[4];
-                            
-                            Serial.printf("⚠️  Manual extract: X=%d, Y=%d, Btn=%d\n", x, y, btn);
-                            motorCtrl.processMovementInput((int8_t)x, (int8_t)y);
-                        }
-                    }
-                } else {
-                    Serial.println("❌ getData() returned NULL or length=0");
-                }
-                
-            } else {
-                Serial.println("❌ JOYSTICK_ALL (0x13) NOT found!");
-                
-                // Fallback: Einzelne X/Y Werte (0x10, 0x11)
-                if (packet.has(DataCmd::JOYSTICK_X) && packet.has(DataCmd::JOYSTICK_Y)) {
-                    int16_t joyX, joyY;
-                    
-                    if (packet.getInt16(DataCmd::JOYSTICK_X, joyX) &&
-                        packet.getInt16(DataCmd::JOYSTICK_Y, joyY)) {
-                        
-                        Serial.printf("✅ Joystick (separate): X=%d, Y=%d\n", joyX, joyY);
-                        motorCtrl.processMovementInput((int8_t)joyX, (int8_t)joyY);
-                    }
-                } else {
-                    Serial.println("❌ No joystick data found!");
-                }
+            // Steuerframes nur authentisch (MAC allein ist fälschbar)
+            if (!secureFrame && userConfig.getEspnowEncrypt()) {
+                plaintextRejected++;
+                continue;
             }
             
-            Serial.println("──────────────────────");
-            
-            // Peer aktualisieren
+            // Peer aktualisieren (nur registrierte Peers erhalten einen Mailbox-Slot)
+            bool registered = false;
             if (xSemaphoreTake(peersMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
                 int index = findPeerIndex(rxItem.mac);
                 if (index >= 0) {
                     peers[index].connected = true;
-                    peers[index].lastSeen = rxItem.timestamp;
-                    peers[index].packetsReceived++;
+                    notePeerReceived(peers[index], rxItem);
+                    registered = true;
                 }
                 xSemaphoreGive(peersMutex);
             }
             
+            if (!registered) {
+                continue;
+            }
+            
+            int16_t joyX, joyY;
+            uint8_t joyBtn;
+            
+            if (extractJoystick(packet, joyX, joyY, joyBtn)) {
+                // Optionale Master-Sendezeit für Latenzmessung
+                uint32_t txTimeUs = 0;
+                bool hasTxTime = packet.getUInt32(DataCmd::TIMESTAMP, txTimeUs);
+                
+                postJoystick(rxItem.mac, joyX, joyY, joyBtn, rxItem.timestamp, hasTxTime, txTimeUs);
+            } else {
+                Serial.printf("[RX] ❌ No joystick data found (MainCmd 0x%02X, %d entries)\n",
+                             static_cast<uint8_t>(cmd), packet.getEntryCount());
+            }
+            
             continue;
         }
     }
+    
+    // Nur der jeweils neueste Joystick-Frame pro Peer erreicht den Motor
+    dispatchJoystickMailbox();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// JOYSTICK MAILBOX (Latest-Wins)
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool ESPNowRemoteController::extractJoystick(const ESPNowPacket& packet, int16_t& x, int16_t& y, uint8_t& btn) {
+    // JOYSTICK_ALL (0x13) bevorzugt
+    size_t dataLen = 0;
+    const uint8_t* data = packet.getData(DataCmd::JOYSTICK_ALL, &dataLen);
+    
+    if (data && dataLen >= 5) {
+        // Little Endian, unabhängig vom Alignment im Paket-Buffer
+        x = (int16_t)((data[1] << 8) | data[0]);
+        y = (int16_t)((data[3] << 8) | data[2]);
+        btn = data[4];
+        return true;
+    }
+    
+    // Fallback: Einzelne X/Y Werte (0x10, 0x11)
+    if (packet.getInt16(DataCmd::JOYSTICK_X, x) && packet.getInt16(DataCmd::JOYSTICK_Y, y)) {
+        if (!packet.getByte(DataCmd::JOYSTICK_BTN, btn)) {
+            btn = 0;
+        }
+        return true;
+    }
+    
+    return false;
+}
+
+void ESPNowRemoteController::postJoystick(const uint8_t* mac, int16_t x, int16_t y, uint8_t btn, unsigned long timestamp,
+                                          bool hasTxTime, uint32_t txTimeUs) {
+    joystickFramesReceived++;
+    
+    // Slot für Peer suchen (oder freien Slot belegen)
+    JoystickMailbox* slot = nullptr;
+    JoystickMailbox* freeSlot = nullptr;
+    
+    for (int i = 0; i < ESPNOW_MAX_PEERS_LIMIT; i++) {
+        if (joystickMailbox[i].used) {
+            if (compareMac(joystickMailbox[i].mac, mac)) {
+                slot = &joystickMailbox[i];
+                break;
+            }
+        } else if (!freeSlot) {
+            freeSlot = &joystickMailbox[i];
+        }
+    }
+    
+    if (!slot) {
+        if (!freeSlot) {
+            Serial.println("[RX] ❌ Joystick mailbox full!");
+            return;
+        }
+        slot = freeSlot;
+        memcpy(slot->mac, mac, 6);
+        slot->used = true;
+        slot->pending = false;
+    }
+    
+    // Noch nicht angewendeten Frame überschreiben
+    if (slot->pending) {
+        joystickFramesSuperseded++;
+    }
+    
+    slot->x = x;
+    slot->y = y;
+    slot->btn = btn;
+    slot->timestamp = timestamp;
+    slot->hasTxTime = hasTxTime;
+    slot->txTimeUs = txTimeUs;
+    slot->pending = true;
+}
+
+void ESPNowRemoteController::onPeerLost(const uint8_t* mac) {
+    // Master weg: Uhr kann beim Wiederverbinden gesprungen sein
+    if (isValidMasterMac(mac)) {
+        clockSync.reset();
+    }
+    
+    for (int i = 0; i < ESPNOW_MAX_PEERS_LIMIT; i++) {
+        JoystickMailbox& slot = joystickMailbox[i];
+        if (slot.used && compareMac(slot.mac, mac)) {
+            slot.used = false;
+            slot.pending = false;
+        }
+    }
+}
+
+void ESPNowRemoteController::dispatchJoystickMailbox() {
+    for (int i = 0; i < ESPNOW_MAX_PEERS_LIMIT; i++) {
+        JoystickMailbox& slot = joystickMailbox[i];
+        if (!slot.used || !slot.pending) continue;
+        
+        slot.pending = false;
+        
+        DEBUG_PRINTF("[RX] Joystick %s: X=%d, Y=%d, Btn=%d\n",
+                     macToString(slot.mac).c_str(), slot.x, slot.y, slot.btn);
+        
+        // An Motor weitergeben
+        motorCtrl.processMovementInput(slot.x, slot.y);
+        
+        // Latenz Joystick → Sollwert (Master-Sendezeit bis Sollwert gesetzt; die PWM
+        // schreibt erst der nächste Regel-Takt, bis zu 1/MOTOR_TICK_HZ später)
+        if (slot.hasTxTime) {
+            int64_t nowSynced = clockSync.getSyncedTimeUs();
+            if (nowSynced >= 0) {
+                // Differenz in 32 Bit (Überlauf-sicher)
+                uint32_t latency = (uint32_t)nowSynced - slot.txTimeUs;
+                
+                // Unplausible Werte (Sync-Sprung, negative Latenz) ignorieren
+                if (latency < 1000000UL) {
+                    latencyLastUs = latency;
+                    if (latencyCount == 0 || latency < latencyMinUs) latencyMinUs = latency;
+                    if (latency > latencyMaxUs) latencyMaxUs = latency;
+                    latencySumUs += latency;
+                    latencyCount++;
+                }
+            }
+        }
+    }
 }
\ No newline at end of file
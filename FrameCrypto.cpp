@@ -0,0 +1,346 @@
+/**
+ * FrameCrypto.cpp
+ *
+ * Implementation der AES-CCM Frame-Verschlüsselung
+ */
+
+#include "include/FrameCrypto.h"
+#include <mbedtls/md.h>
+#include <esp_timer.h>
+
+// Label für die Session-Key-Ableitung
+static const char SESSION_LABEL[] = "ESPNOW-DRIVE-SESSION";
+
+// Label für den Pairing-Tag
+static const char PAIR_LABEL[] = "ESPNOW-DRIVE-PAIR";
+
+FrameCrypto::FrameCrypto()
+    : pskLength(0)
+    , sessionActive(false)
+    , txSeq(0)
+    , rxSeqMax(0)
+    , rxWindow(0)
+    , pairNonceIndex(0)
+    , sealCount(0)
+    , openCount(0)
+    , authFailures(0)
+    , replayRejects(0)
+    , pairRejects(0)
+    , lastSealUs(0)
+    , lastOpenUs(0)
+    , maxOpenUs(0)
+{
+    memset(psk, 0, sizeof(psk));
+    memset(salt, 0, sizeof(salt));
+    memset(pairNonces, 0, sizeof(pairNonces));
+    mbedtls_ccm_init(&ccm);
+}
+
+FrameCrypto::~FrameCrypto() {
+    clearSession();
+    mbedtls_ccm_free(&ccm);
+    memset(psk, 0, sizeof(psk));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SCHLÜSSEL & SESSION
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool FrameCrypto::setPsk(const char* hexPsk) {
+    memset(psk, 0, sizeof(psk));
+    pskLength = 0;
+
+    if (!hexPsk) return false;
+
+    size_t hexLen = strlen(hexPsk);
+    if (hexLen != 32 && hexLen != 64) return false;
+
+    for (size_t i = 0; i < hexLen; i++) {
+        char c = hexPsk[i];
+        uint8_t nibble;
+        if (c >= '0' && c <= '9')      nibble = c - '0';
+        else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') nibble = c - 'A' + 10;
+        else {
+            memset(psk, 0, sizeof(psk));
+            return false;
+        }
+        psk[i / 2] = (psk[i / 2] << 4) | nibble;
+    }
+
+    pskLength = hexLen / 2;
+    return true;
+}
+
+bool FrameCrypto::deriveSession(const uint8_t* masterNonce, const uint8_t* deviceNonce) {
+    clearSession();
+
+    if (!hasPsk() || !masterNonce || !deviceNonce) return false;
+
+    // PRK = HMAC-SHA256(PSK, Label | Nonce Master | Nonce Gerät)
+    uint8_t input[sizeof(SESSION_LABEL) - 1 + 2 * CRYPTO_PAIR_NONCE_LEN];
+    size_t pos = 0;
+    memcpy(input + pos, SESSION_LABEL, sizeof(SESSION_LABEL) - 1);
+    pos += sizeof(SESSION_LABEL) - 1;
+    memcpy(input + pos, masterNonce, CRYPTO_PAIR_NONCE_LEN);
+    pos += CRYPTO_PAIR_NONCE_LEN;
+    memcpy(input + pos, deviceNonce, CRYPTO_PAIR_NONCE_LEN);
+    pos += CRYPTO_PAIR_NONCE_LEN;
+
+    uint8_t prk[32];
+    const mbedtls_md_info_t* md = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    if (!md || mbedtls_md_hmac(md, psk, pskLength, input, pos, prk) != 0) {
+        return false;
+    }
+
+    // Bytes 0..15 = AES-Key, danach Session-Salt für die Nonce
+    int ret = mbedtls_ccm_setkey(&ccm, MBEDTLS_CIPHER_ID_AES, prk, CRYPTO_KEY_LEN * 8);
+    memcpy(salt, prk + CRYPTO_KEY_LEN, sizeof(salt));
+    memset(prk, 0, sizeof(prk));
+
+    if (ret != 0) {
+        return false;
+    }
+
+    txSeq = 0;
+    rxSeqMax = 0;
+    rxWindow = 0;
+    sessionActive = true;
+
+    return true;
+}
+
+bool FrameCrypto::computePairAuth(const uint8_t* masterMac, const uint8_t* masterNonce, uint8_t* tagOut) const {
+    if (!hasPsk() || !masterMac || !masterNonce || !tagOut) return false;
+
+    // HMAC-SHA256(PSK, Label | MAC Master | Nonce Master), gekürzt
+    uint8_t input[sizeof(PAIR_LABEL) - 1 + 6 + CRYPTO_PAIR_NONCE_LEN];
+    size_t pos = 0;
+    memcpy(input + pos, PAIR_LABEL, sizeof(PAIR_LABEL) - 1);
+    pos += sizeof(PAIR_LABEL) - 1;
+    memcpy(input + pos, masterMac, 6);
+    pos += 6;
+    memcpy(input + pos, masterNonce, CRYPTO_PAIR_NONCE_LEN);
+    pos += CRYPTO_PAIR_NONCE_LEN;
+
+    uint8_t mac[32];
+    const mbedtls_md_info_t* md = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    if (!md || mbedtls_md_hmac(md, psk, pskLength, input, pos, mac) != 0) {
+        return false;
+    }
+    memcpy(tagOut, mac, CRYPTO_PAIR_AUTH_LEN);
+    memset(mac, 0, sizeof(mac));
+    return true;
+}
+
+bool FrameCrypto::verifyPairRequest(const uint8_t* masterMac, const uint8_t* masterNonce,
+                                    const uint8_t* tag, size_t tagLen) {
+    uint8_t expected[CRYPTO_PAIR_AUTH_LEN];
+    if (!tag || tagLen < CRYPTO_PAIR_AUTH_LEN || !computePairAuth(masterMac, masterNonce, expected)) {
+        pairRejects++;
+        return false;
+    }
+
+    // Vergleich in konstanter Zeit
+    uint8_t diff = 0;
+    for (size_t i = 0; i < CRYPTO_PAIR_AUTH_LEN; i++) {
+        diff |= expected[i] ^ tag[i];
+    }
+    if (diff != 0) {
+        pairRejects++;
+        return false;
+    }
+
+    // Mitgeschnittene Anfrage erneut gesendet?
+    for (uint8_t i = 0; i < CRYPTO_PAIR_HISTORY; i++) {
+        if (memcmp(pairNonces[i], masterNonce, CRYPTO_PAIR_NONCE_LEN) == 0) {
+            pairRejects++;
+            return false;
+        }
+    }
+
+    memcpy(pairNonces[pairNonceIndex], masterNonce, CRYPTO_PAIR_NONCE_LEN);
+    pairNonceIndex = (pairNonceIndex + 1) % CRYPTO_PAIR_HISTORY;
+    return true;
+}
+
+void FrameCrypto::clearSession() {
+    if (sessionActive) {
+        // Key-Schedule im Kontext verwerfen
+        mbedtls_ccm_free(&ccm);
+        mbedtls_ccm_init(&ccm);
+    }
+
+    sessionActive = false;
+    memset(salt, 0, sizeof(salt));
+    txSeq = 0;
+    rxSeqMax = 0;
+    rxWindow = 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SEAL / OPEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool FrameCrypto::seal(uint8_t direction, uint8_t aadCmd, const uint8_t* plain, size_t len,
+                       uint8_t* out, uint32_t& seqOut) {
+    if (!sessionActive || !plain || !out || len > CRYPTO_MAX_PLAINTEXT) return false;
+
+    // Sequenz erschöpft: Nonce darf nicht wiederverwendet werden → neu pairen
+    if (txSeq == UINT32_MAX) return false;
+
+    int64_t start = esp_timer_get_time();
+
+    uint32_t seq = txSeq + 1;
+
+    uint8_t nonce[CRYPTO_NONCE_LEN];
+    buildNonce(direction, seq, nonce);
+
+    uint8_t aad[5] = { aadCmd, (uint8_t)seq, (uint8_t)(seq >> 8), (uint8_t)(seq >> 16), (uint8_t)(seq >> 24) };
+
+    int ret = mbedtls_ccm_encrypt_and_tag(&ccm, len, nonce, sizeof(nonce), aad, sizeof(aad),
+                                          plain, out, out + len, CRYPTO_TAG_LEN);
+    if (ret != 0) return false;
+
+    txSeq = seq;
+    seqOut = seq;
+    sealCount++;
+    lastSealUs = (uint32_t)(esp_timer_get_time() - start);
+
+    return true;
+}
+
+bool FrameCrypto::open(uint8_t direction, uint8_t aadCmd, uint32_t seq, const uint8_t* in, size_t inLen,
+                       uint8_t* plainOut) {
+    if (!sessionActive || !in || !plainOut || inLen < CRYPTO_TAG_LEN) return false;
+
+    size_t len = inLen - CRYPTO_TAG_LEN;
+    if (len > CRYPTO_MAX_PLAINTEXT) return false;
+
+    // Replay vor der (teureren) Entschlüsselung prüfen
+    if (isReplay(seq)) {
+        replayRejects++;
+        return false;
+    }
+
+    int64_t start = esp_timer_get_time();
+
+    uint8_t nonce[CRYPTO_NONCE_LEN];
+    buildNonce(direction, seq, nonce);
+
+    uint8_t aad[5] = { aadCmd, (uint8_t)seq, (uint8_t)(seq >> 8), (uint8_t)(seq >> 16), (uint8_t)(seq >> 24) };
+
+    int ret = mbedtls_ccm_auth_decrypt(&ccm, len, nonce, sizeof(nonce), aad, sizeof(aad),
+                                       in, plainOut, in + len, CRYPTO_TAG_LEN);
+
+    lastOpenUs = (uint32_t)(esp_timer_get_time() - start);
+    if (lastOpenUs > maxOpenUs) maxOpenUs = lastOpenUs;
+
+    if (ret != 0) {
+        authFailures++;
+        return false;
+    }
+
+    // Fenster erst nach erfolgreicher Authentifizierung verschieben
+    markReceived(seq);
+    openCount++;
+
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// BENCHMARK & DEBUG
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool FrameCrypto::benchmark(size_t payloadLen, uint32_t iterations, float& sealUs, float& openUs) {
+    if (payloadLen == 0 || payloadLen > CRYPTO_MAX_PLAINTEXT || iterations == 0) return false;
+
+    // Eigene Instanz mit Wegwerf-Key (Session des Betriebs bleibt unberührt)
+    FrameCrypto bench;
+    bench.setPsk("000102030405060708090a0b0c0d0e0f");
+
+    uint8_t nonceA[CRYPTO_PAIR_NONCE_LEN] = { 1 };
+    uint8_t nonceB[CRYPTO_PAIR_NONCE_LEN] = { 2 };
+    if (!bench.deriveSession(nonceA, nonceB)) return false;
+
+    uint8_t plain[CRYPTO_MAX_PLAINTEXT];
+    uint8_t sealed[CRYPTO_MAX_PLAINTEXT + CRYPTO_TAG_LEN];
+    uint8_t opened[CRYPTO_MAX_PLAINTEXT];
+    for (size_t i = 0; i < payloadLen; i++) {
+        plain[i] = (uint8_t)i;
+    }
+
+    uint64_t sealTotal = 0;
+    uint64_t openTotal = 0;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint32_t seq;
+
+        int64_t t0 = esp_timer_get_time();
+        if (!bench.seal(CRYPTO_DIR_MASTER, 0, plain, payloadLen, sealed, seq)) return false;
+        int64_t t1 = esp_timer_get_time();
+        if (!bench.open(CRYPTO_DIR_MASTER, 0, seq, sealed, payloadLen + CRYPTO_TAG_LEN, opened)) return false;
+        int64_t t2 = esp_timer_get_time();
+
+        sealTotal += (t1 - t0);
+        openTotal += (t2 - t1);
+    }
+
+    if (memcmp(plain, opened, payloadLen) != 0) return false;
+
+    sealUs = (float)sealTotal / iterations;
+    openUs = (float)openTotal / iterations;
+
+    return true;
+}
+
+void FrameCrypto::printInfo() const {
+    DEBUG_PRINTLN("\n╔════════════════════════════════════════╗");
+    DEBUG_PRINTLN("║       FRAME CRYPTO INFO                ║");
+    DEBUG_PRINTLN("╚════════════════════════════════════════╝");
+    DEBUG_PRINTF("PSK:            %s (%u Bit)\n", hasPsk() ? "gesetzt" : "FEHLT", pskLength * 8);
+    DEBUG_PRINTF("Session:        %s\n", sessionActive ? "AKTIV" : "keine");
+    DEBUG_PRINTF("TX Seq:         %lu\n", txSeq);
+    DEBUG_PRINTF("RX Seq (max):   %lu\n", rxSeqMax);
+    DEBUG_PRINTF("Sealed:         %lu (last %lu us)\n", sealCount, lastSealUs);
+    DEBUG_PRINTF("Opened:         %lu (last %lu us, max %lu us)\n", openCount, lastOpenUs, maxOpenUs);
+    DEBUG_PRINTF("Auth-Fehler:    %lu\n", authFailures);
+    DEBUG_PRINTF("Replays:        %lu\n", replayRejects);
+    DEBUG_PRINTF("Pairing abgew.: %lu\n", pairRejects);
+    DEBUG_PRINTLN("────────────────────────────────────────");
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PRIVATE METHODEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+void FrameCrypto::buildNonce(uint8_t direction, uint32_t seq, uint8_t* nonce) const {
+    // [Richtung 1B] [Sequenz 4B LE] [Session-Salt]
+    nonce[0] = direction;
+    nonce[1] = (uint8_t)seq;
+    nonce[2] = (uint8_t)(seq >> 8);
+    nonce[3] = (uint8_t)(seq >> 16);
+    nonce[4] = (uint8_t)(seq >> 24);
+    memcpy(nonce + 5, salt, sizeof(salt));
+}
+
+bool FrameCrypto::isReplay(uint32_t seq) const {
+    if (seq == 0) return true;              // Sequenzen beginnen bei 1
+    if (seq > rxSeqMax) return false;       // Neuer Frame
+
+    uint32_t diff = rxSeqMax - seq;
+    if (diff >= 32) return true;            // Außerhalb des Fensters
+
+    return (rxWindow & (1UL << diff)) != 0;
+}
+
+void FrameCrypto::markReceived(uint32_t seq) {
+    if (seq > rxSeqMax) {
+        uint32_t shift = seq - rxSeqMax;
+        rxWindow = (shift >= 32) ? 0 : (rxWindow << shift);
+        rxWindow |= 1;
+        rxSeqMax = seq;
+    } else {
+        rxWindow |= (1UL << (rxSeqMax - seq));
+    }
+}
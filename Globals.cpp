@@ -18,6 +18,10 @@
 #include "include/PowerManager.h"
 #include "include/ESPNowRemoteController.h"
 #include "include/BatteryMonitor.h"
+#include "include/PacketCapture.h"
+#include "include/BlackBox.h"
+#include "include/TrajectoryPlayer.h"
+#include "include/BatteryHistory.h"
 
 // ═══════════════════════════════════════════════════════════════════════════
 // GLOBALE MODUL-INSTANZEN
@@ -30,6 +34,10 @@ SerialCommandHandler serialCmd;
 PowerManager powerMgr;
 ESPNowRemoteController espNow;
 BatteryMonitor battery;
+PacketCapture packetCapture;
+BlackBox blackBox;
+TrajectoryPlayer trajectory;
+BatteryHistory batteryHistory;
 
 // ═══════════════════════════════════════════════════════════════════════════
 // GLOBALE VARIABLEN
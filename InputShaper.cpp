@@ -0,0 +1,64 @@
+/**
+ * InputShaper.cpp
+ *
+ * Implementation des Eingangs-Shapings (Tabellenaufbau)
+ */
+
+#include "include/InputShaper.h"
+
+InputShaper::InputShaper() {
+    // Neutral: keine Deadzone, linear, kein Trim, Minimum 127 (bisheriges Verhalten)
+    ShapingParams neutral = { 0, 0, 100, 100, 127 };
+    build(neutral, 255);
+}
+
+void InputShaper::build(const ShapingParams& p, uint32_t maxDuty) {
+    params = p;
+    if (params.deadzone > 50) params.deadzone = 50;
+    if (params.expo > 100) params.expo = 100;
+    if (params.trimLeft < 50) params.trimLeft = 50;
+    if (params.trimLeft > 100) params.trimLeft = 100;
+    if (params.trimRight < 50) params.trimRight = 50;
+    if (params.trimRight > 100) params.trimRight = 100;
+    if (params.minPwm > 254) params.minPwm = 254;
+
+    // ═══════════════════════════════════════════════════════════════════
+    // Achse: Deadzone, dann Expo (lineare + kubische Kennlinie gemischt)
+    // ═══════════════════════════════════════════════════════════════════
+    const int32_t dz = params.deadzone;
+    const int32_t expo = params.expo;
+
+    for (int32_t i = 0; i <= 100; i++) {
+        if (i <= dz) {
+            axis[i] = 0;
+            continue;
+        }
+
+        // Rest der Auslenkung auf 1..100 umskalieren (gerundet)
+        int32_t v = ((i - dz) * 100 + (100 - dz) / 2) / (100 - dz);
+
+        // out = ((100 - e) · v + e · v³ / 100²) / 100
+        int32_t cubic = v * v * v;
+        int32_t shaped = ((100 - expo) * v * 10000 + expo * cubic + 500000) / 1000000;
+
+        // Außerhalb der Deadzone nie 0 (sonst zweite, versteckte Deadzone)
+        axis[i] = (int16_t)(shaped < 1 ? 1 : shaped);
+    }
+
+    // ═══════════════════════════════════════════════════════════════════
+    // Seiten: Trim als Verstärkung, Ergebnis direkt als Q8-Sollwert
+    // ═══════════════════════════════════════════════════════════════════
+    const int32_t trim[2] = { params.trimLeft, params.trimRight };
+
+    for (int motor = 0; motor < 2; motor++) {
+        for (int32_t s = 0; s <= 100; s++) {
+            side[motor][s] = (s * 256 * trim[motor] + 50) / 100;
+        }
+    }
+
+    // ═══════════════════════════════════════════════════════════════════
+    // Duty: Losbrech-Minimum auf volle Auflösung umrechnen
+    // ═══════════════════════════════════════════════════════════════════
+    dutyMin = maxDuty * params.minPwm / 255;
+    dutySpan = maxDuty - dutyMin;
+}
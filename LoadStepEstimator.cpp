@@ -0,0 +1,119 @@
+/**
+ * LoadStepEstimator.cpp
+ *
+ * Implementation der Lastsprung-Erkennung und Widerstands-Schätzung
+ */
+
+#include "include/LoadStepEstimator.h"
+
+LoadStepEstimator::LoadStepEstimator()
+    : haveStable(false)
+    , stableV(0.0f)
+    , stableI(0.0f)
+    , stableMs(0)
+    , stepActive(false)
+    , preV(0.0f)
+    , preI(0.0f)
+    , stepMs(0)
+    , resistance(BATTERY_INTERNAL_R)
+    , lastMeasurement(0.0f)
+    , measurements(0)
+    , rejected(0)
+{
+    median.fill(resistance);
+    estimate.fill(resistance);
+    resetBlock(0);
+}
+
+void LoadStepEstimator::seed(float ohm, uint32_t count, unsigned long nowMs) {
+    resistance = ohm;
+    measurements = count;
+    median.fill(ohm);
+    estimate.fill(ohm);
+    haveStable = false;
+    stepActive = false;
+    resetBlock(nowMs);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SPRUNG-ERKENNUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool LoadStepEstimator::addSample(float voltage, float current, unsigned long nowMs) {
+    if (block.count == 0) {
+        block.startMs = nowMs;
+        block.minI = current;
+        block.maxI = current;
+    }
+    block.sumV += voltage;
+    block.sumI += current;
+    if (current < block.minI) block.minI = current;
+    if (current > block.maxI) block.maxI = current;
+    block.count++;
+
+    if (nowMs - block.startMs < IR_BLOCK_MS) return false;
+
+    bool stable = block.count >= IR_BLOCK_MIN_SAMPLES && (block.maxI - block.minI) < IR_STABLE_CURRENT;
+    float meanV = block.sumV / block.count;
+    float meanI = block.sumI / block.count;
+    bool recent = haveStable && nowMs - stableMs <= 2 * IR_BLOCK_MS;
+    bool accepted = false;
+
+    if (stepActive) {
+        // Nach dem Sprung: erster stabiler Block ist der neue Arbeitspunkt
+        if (stable) {
+            stepActive = false;
+            float deltaI = meanI - preI;
+            if (fabsf(deltaI) >= IR_STEP_MIN_CURRENT) {
+                accepted = accept(-(meanV - preV) / deltaI);
+            }
+        } else if (nowMs - stepMs > IR_STEP_TIMEOUT_MS) {
+            stepActive = false;   // Kein neuer Arbeitspunkt (Rampe, Fahrt)
+        }
+    } else if (stable) {
+        // Sprung genau an der Blockgrenze: zwei stabile Blöcke nacheinander
+        if (recent && fabsf(meanI - stableI) >= IR_STEP_MIN_CURRENT) {
+            accepted = accept(-(meanV - stableV) / (meanI - stableI));
+        }
+    } else if (recent) {
+        // Unruhiger Block direkt nach stabilem: möglicher Sprung
+        stepActive = true;
+        preV = stableV;
+        preI = stableI;
+        stepMs = nowMs;
+    }
+
+    haveStable = stable;
+    if (stable) {
+        stableV = meanV;
+        stableI = meanI;
+        stableMs = nowMs;
+    }
+
+    resetBlock(nowMs);
+    return accepted;
+}
+
+void LoadStepEstimator::resetBlock(unsigned long nowMs) {
+    block.sumV = 0.0f;
+    block.sumI = 0.0f;
+    block.minI = 0.0f;
+    block.maxI = 0.0f;
+    block.count = 0;
+    block.startMs = nowMs;
+}
+
+bool LoadStepEstimator::accept(float ohm) {
+    lastMeasurement = ohm;
+
+    // Unplausibel (Sprung während Spannungsänderung, Messfehler) → verwerfen
+    if (!(ohm >= IR_MIN_OHM && ohm <= IR_MAX_OHM)) {
+        rejected++;
+        return false;
+    }
+
+    // Median gegen einzelne Ausreißer, EMA für den langsamen Verlauf
+    resistance = estimate.update(median.update(ohm));
+    measurements++;
+    return true;
+}
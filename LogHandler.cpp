@@ -12,7 +12,15 @@ LogHandler::LogHandler(SDCardHandler* sdHandler, LogLevel minLevel)
     : sdHandler(sdHandler)
     , minLevel(minLevel)
     , mutex(nullptr)
+    , timeSource(nullptr)
+    , recordHead(0)
+    , recordTail(0)
+    , recordsQueued(0)
+    , recordsDropped(0)
 {
+    recordLock = portMUX_INITIALIZER_UNLOCKED;
+    memset(records, 0, sizeof(records));
+    
     // Mutex für Thread-Safety erstellen
     mutex = xSemaphoreCreateMutex();
     
@@ -67,6 +75,77 @@ void LogHandler::logf(LogLevel level, const char* tag, const char* format, ...)
     log(level, category, tag, buffer);
 }
 
+// ═══════════════════════════════════════════════════════════════════════════
+// BINÄRE LOG-RECORDS
+// ═══════════════════════════════════════════════════════════════════════════
+
+void LogHandler::record(LogLevel level, const char* tag, const char* format,
+                        int32_t a0, int32_t a1, int32_t a2,
+                        int32_t a3, int32_t a4, int32_t a5) {
+    // Level-Filter zuerst - deaktivierte Records kosten nur diesen Vergleich
+    if (level < minLevel) return;
+    
+    int64_t syncedUs = timeSource ? timeSource() : -1;
+    uint32_t ms = millis();
+    
+    portENTER_CRITICAL(&recordLock);
+    
+    uint16_t next = (recordHead + 1) % LOG_RECORD_QUEUE_SIZE;
+    if (next == recordTail) {
+        // Voll: neuester Record wird verworfen (ältere bleiben lesbar)
+        recordsDropped++;
+        portEXIT_CRITICAL(&recordLock);
+        return;
+    }
+    
+    LogRecord& rec = records[recordHead];
+    rec.tag = tag;
+    rec.format = format;
+    rec.syncedUs = syncedUs;
+    rec.ms = ms;
+    rec.args[0] = a0;
+    rec.args[1] = a1;
+    rec.args[2] = a2;
+    rec.args[3] = a3;
+    rec.args[4] = a4;
+    rec.args[5] = a5;
+    rec.level = (uint8_t)level;
+    
+    recordHead = next;
+    recordsQueued++;
+    
+    portEXIT_CRITICAL(&recordLock);
+}
+
+void LogHandler::update() {
+    for (int i = 0; i < LOG_RECORD_DRAIN_MAX; i++) {
+        LogRecord rec;
+        
+        portENTER_CRITICAL(&recordLock);
+        if (recordTail == recordHead) {
+            portEXIT_CRITICAL(&recordLock);
+            return;
+        }
+        rec = records[recordTail];
+        recordTail = (recordTail + 1) % LOG_RECORD_QUEUE_SIZE;
+        portEXIT_CRITICAL(&recordLock);
+        
+        // Level kann sich seit der Aufnahme geändert haben
+        LogLevel level = (LogLevel)rec.level;
+        if (level < minLevel) continue;
+        
+        char message[LOG_MAX_MESSAGE_LEN];
+        snprintf(message, sizeof(message), rec.format,
+                 rec.args[0], rec.args[1], rec.args[2], rec.args[3], rec.args[4], rec.args[5]);
+        
+        char timestamp[32];
+        formatTimestamp(timestamp, sizeof(timestamp), rec.syncedUs, rec.ms);
+        
+        LogCategory category = (level == LOG_ERROR) ? LOG_CAT_ERROR : LOG_CAT_GENERAL;
+        write(level, category, rec.tag, message, timestamp);
+    }
+}
+
 // ═══════════════════════════════════════════════════════════════════════════
 // SPEZIELLE LOG-FUNKTIONEN
 // ═══════════════════════════════════════════════════════════════════════════
@@ -210,6 +289,7 @@ void LogHandler::printInfo() {
     Serial.printf("  Min Level: %s\n", levelToString(minLevel));
     Serial.printf("  SD Card: %s\n", hasSDCard() ? "Available" : "Not available");
     Serial.printf("  Log Dir: %s\n", LOG_DIR);
+    Serial.printf("  Records: %lu queued, %lu dropped\n", recordsQueued, recordsDropped);
     
     if (hasSDCard()) {
         Serial.println("\n  Log Files:");
@@ -254,16 +334,21 @@ void LogHandler::log(LogLevel level, LogCategory category, const char* tag, cons
     // Level-Filter
     if (level < minLevel) return;
     
+    // Timestamp generieren
+    char timestamp[32];
+    getTimestamp(timestamp, sizeof(timestamp));
+    
+    write(level, category, tag, message, timestamp);
+}
+
+void LogHandler::write(LogLevel level, LogCategory category, const char* tag, const char* message,
+                       const char* timestamp) {
     // Thread-Safety
     if (xSemaphoreTake(mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
         Serial.println("[LogHandler] Failed to acquire mutex!");
         return;
     }
     
-    // Timestamp generieren
-    char timestamp[32];
-    getTimestamp(timestamp, sizeof(timestamp));
-    
     // Level-String
     const char* levelStr = levelToString(level);
     
@@ -279,8 +364,24 @@ void LogHandler::log(LogLevel level, LogCategory category, const char* tag, cons
 }
 
 void LogHandler::getTimestamp(char* buffer, size_t bufferSize) {
+    formatTimestamp(buffer, bufferSize, timeSource ? timeSource() : -1, millis());
+}
+
+void LogHandler::formatTimestamp(char* buffer, size_t bufferSize, int64_t syncedUs, unsigned long ms) {
+    // Synchronisierte Zeit (µs-Auflösung, mit "S" markiert)
+    if (syncedUs >= 0) {
+        uint64_t seconds = (uint64_t)syncedUs / 1000000ULL;
+        unsigned long micros = (unsigned long)((uint64_t)syncedUs % 1000000ULL);
+        
+        snprintf(buffer, bufferSize, "S%02lu:%02lu:%02lu.%06lu",
+                (unsigned long)((seconds / 3600) % 24),
+                (unsigned long)((seconds / 60) % 60),
+                (unsigned long)(seconds % 60),
+                micros);
+        return;
+    }
+    
     // Millis-basierter Timestamp (da keine RTC)
-    unsigned long ms = millis();
     unsigned long seconds = ms / 1000;
     unsigned long milliseconds = ms % 1000;
     
@@ -1,14 +1,41 @@
 #include "include/MotorController.h"
 #include "include/LogHandler.h"
 #include "include/setupConf.h"
+#include "include/SteeringKernel.h"
+#include "include/UserConfig.h"
+#include "include/BatteryMonitor.h"
+#include "include/ESPNowManager.h"
 
 extern LogHandler logger;
+extern UserConfig userConfig;
+extern BatteryMonitor battery;
+extern BlackBox blackBox;
+extern TrajectoryPlayer trajectory;
 
 MotorController::MotorController()
-    : pinEnA(0), pinIn1(0), pinIn2(0),
-      pinEnB(0), pinIn3(0), pinIn4(0),
-      enabled(false),
-      lastCommandTime(0) {
+    : shaperRevision(0), reportedLimitEvents(0), reportedSagEvents(0),
+      vcompQ8(256), vcompMv(0), vcompSamples(0),
+      encodersReady(false), closedLoop(false), pidRevision(0),
+      speedRuns(0), speedLastUs(0), speedMaxUs(0),
+      speedFault(false), speedFaultMotor(0), speedFaultReversed(false),
+      speedFaults(0), reportedSpeedFaults(0),
+      lastJoyX(0), lastJoyY(0), enabled(false),
+      tickTimer(nullptr), stateMutex(nullptr), lastTickStartUs(0),
+      tickCount(0), tickSkipped(0), tickLastUs(0), tickMaxUs(0),
+      tickSumUs(0), tickMaxJitterUs(0),
+      cmdCount(0), cmdLastCycles(0), cmdMaxCycles(0), cmdSumCycles(0),
+      firstCommandMs(0),
+      lastCommandUs(0), watchdogTripped(false),
+      tripCount(0), tripLastUs(0), tripMaxUs(0), tripLeftPwm(0), tripRightPwm(0) {
+    
+    for (int i = 0; i < 2; i++) {
+        targetQ8[i] = 0;
+        appliedQ8[i] = 0;
+        speedSuspect[i] = 0;
+        lastCount[i] = 0;
+        measuredQ8[i] = 0;
+        outputQ8[i] = 0;
+    }
     
     // Initialize telemetry
     telemetry.leftSpeed = 0;
@@ -22,105 +49,171 @@ MotorController::MotorController()
 void MotorController::begin() {
     logger.info("MotorController", "Initializing motor controller");
     
-    // Read pin configuration from setupConf.h
-    pinEnA = MOTOR_ENA;
-    pinIn1 = MOTOR_IN1;
-    pinIn2 = MOTOR_IN2;
-    pinEnB = MOTOR_ENB;
-    pinIn3 = MOTOR_IN3;
-    pinIn4 = MOTOR_IN4;
-    
-    // Configure pins
-    pinMode(pinEnA, OUTPUT);
-    pinMode(pinIn1, OUTPUT);
-    pinMode(pinIn2, OUTPUT);
-    pinMode(pinEnB, OUTPUT);
-    pinMode(pinIn3, OUTPUT);
-    pinMode(pinIn4, OUTPUT);
+    // Configure pins + LEDC channels (setupConf.h)
+    if (!driver.begin()) {
+        logger.error("MotorController", "LEDC channel setup failed!");
+    }
+    
+    // Rad-Encoder (optional - ohne Encoder bleibt der Open-Loop-Betrieb)
+    encodersReady = encoders[MOTOR_ID_LEFT].begin(ENCODER_LEFT_A, ENCODER_LEFT_B) &&
+                    encoders[MOTOR_ID_RIGHT].begin(ENCODER_RIGHT_A, ENCODER_RIGHT_B);
+    if (!encodersReady) {
+        // Nur beide Seiten zusammen sinnvoll: eine eingerichtete Seite wieder freigeben
+        encoders[MOTOR_ID_LEFT].end();
+        encoders[MOTOR_ID_RIGHT].end();
+        logger.warning("MotorController", "Wheel encoders not available - speed loop disabled");
+    }
+    
+    stateMutex = xSemaphoreCreateMutex();
+    
+    // Kennlinien und Stromlimit aus der geladenen Config
+    rebuildShaper();
+    limiter.setLimit(userConfig.getMotorCurrentLimit());
     
     // Initial state: motors stopped
     stop();
     
     // Initialize safety timeout
-    lastCommandTime = millis();
+    lastCommandUs = (uint32_t)esp_timer_get_time();
+    
+    // ═══════════════════════════════════════════════════════════════════
+    // Regel-Takt: Rampe + Ausgabe im esp_timer Task (unabhängig von loop())
+    // ═══════════════════════════════════════════════════════════════════
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = &MotorController::tickCallback;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "motor_tick";
+    timerArgs.skip_unhandled_events = true;
+    
+    if (esp_timer_create(&timerArgs, &tickTimer) != ESP_OK ||
+        esp_timer_start_periodic(tickTimer, MOTOR_TICK_US) != ESP_OK) {
+        logger.error("MotorController", "Control tick timer failed!");
+    }
     
     logger.info("MotorController", "Motor controller initialized");
 }
 
-void MotorController::processMovementInput(int8_t joystickX, int8_t joystickY) {
+void MotorController::processMovementInput(int16_t joystickX, int16_t joystickY) {
+    uint32_t cycleStart = ESP.getCycleCount();
+    
     if (!enabled) {
         stop();
         return;
     }
 
     // ═══════════════════════════════════════════════════════════════════
-    // SAFETY: Command empfangen - Timer zurücksetzen
+    // SAFETY: Command empfangen - Watchdog zurücksetzen (prüft der Regel-Takt)
     // ═══════════════════════════════════════════════════════════════════
-    lastCommandTime = millis();
+    lastCommandUs = (uint32_t)esp_timer_get_time();
+    if (firstCommandMs == 0) {
+        firstCommandMs = millis();
+    }
+    lastJoyX = joystickX;
+    lastJoyY = joystickY;
 
-    // Berechne Abstand vom Nullpunkt (Joystick-Auslenkung)
-    float distance = sqrt(joystickX * joystickX + joystickY * joystickY);
-    
-    // Skaliere auf maximal 100, falls Abstand größer
-    float scaleFactor = 1.0;
-    if (distance > 100.0) {
-        scaleFactor = 100.0 / distance;
+    // Wiedergabe: Kommandos halten nur den Watchdog (Totmann), Auslenkung übernimmt
+    if (trajectory.isPlaying()) {
+        if (abs(joystickX) <= TRAJ_OVERRIDE_PCT && abs(joystickY) <= TRAJ_OVERRIDE_PCT) {
+            return;
+        }
+        trajectory.abort();
+        logger.record(LOG_WARNING, "MotorController", "Trajectory aborted by joystick: X=%ld Y=%ld",
+                      joystickX, joystickY);
     }
-    
-    // Skalierte Joystick-Werte
-    float scaledX = joystickX * scaleFactor;
-    float scaledY = joystickY * scaleFactor;
 
-    // Differential steering
-    float leftSpeed = scaledY - scaledX;   // Range: -100 bis +100
-    float rightSpeed = scaledY + scaledX;  // Range: -100 bis +100
+    if (!stateMutex || xSemaphoreTake(stateMutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        return;
+    }
+    
+    // Config geändert → Kennlinien einmal neu berechnen (nicht pro Kommando)
+    if (userConfig.getRevision() != shaperRevision) {
+        rebuildShaper();
+    }
 
     // ═══════════════════════════════════════════════════════════════════
-    // PWM-Skalierung: 127-255 (127 = Minimum, 255 = Maximum)
+    // Shaping + Differential Steering (Festkomma, siehe SteeringKernel.h)
+    // - Deadzone/Expo pro Achse per Tabelle
+    // - Sättigung auf ±100 (kein int8-Wrap bei großen Werten)
+    // - Auslenkung > 100 wird auf den Einheitskreis normalisiert
+    // - Trim pro Seite per Tabelle, direkt als Q8-Sollwert
     // ═══════════════════════════════════════════════════════════════════
+    int16_t shapedX = shaper.shapeAxis(joystickX);
+    int16_t shapedY = shaper.shapeAxis(joystickY);
     
-    int leftPWM = 0;
-    int rightPWM = 0;
+    SteeringOutput out;
+    SteeringKernel::mix(shapedX, shapedY, out);
+
+    // Nur Sollwert setzen - Rampe & PWM-Ausgabe im Regel-Takt
+    targetQ8[MOTOR_ID_LEFT] = shaper.toTargetQ8(MOTOR_ID_LEFT, out.leftSpeed);
+    targetQ8[MOTOR_ID_RIGHT] = shaper.toTargetQ8(MOTOR_ID_RIGHT, out.rightSpeed);
+    int32_t recordLeft = targetQ8[MOTOR_ID_LEFT];
+    int32_t recordRight = targetQ8[MOTOR_ID_RIGHT];
+    xSemaphoreGive(stateMutex);
     
-    if (abs(leftSpeed) > 0) {
-        // Map von 0-100 auf 127-255
-        leftPWM = map((int)abs(leftSpeed), 0, 100, 127, 255);
+    // Live-Sollwerte für spätere Wiedergabe mitschreiben
+    if (trajectory.isRecording()) {
+        trajectory.recordPoint(recordLeft, recordRight);
     }
     
-    if (abs(rightSpeed) > 0) {
-        // Map von 0-100 auf 127-255
-        rightPWM = map((int)abs(rightSpeed), 0, 100, 127, 255);
-    }
+    // Debug logging (binärer Record: keine Allokation, Formatierung erst in logger.update())
+    logger.record(LOG_DEBUG, "MotorController", "Movement: X=%ld Y=%ld (shaped %ld/%ld) -> L=%ld R=%ld",
+                  joystickX, joystickY, shapedX, shapedY, out.leftSpeed, out.rightSpeed);
     
-    // Begrenze PWM-Werte zur Sicherheit
-    leftPWM = constrain(leftPWM, 0, 255);
-    rightPWM = constrain(rightPWM, 0, 255);
+    uint32_t cycles = ESP.getCycleCount() - cycleStart;
+    cmdLastCycles = cycles;
+    cmdSumCycles += cycles;
+    cmdCount++;
+    if (cycles > cmdMaxCycles) cmdMaxCycles = cycles;
+}
 
-    // Setze Motoren (Richtung und PWM)
-    setMotor(MOTOR_ID_LEFT, leftSpeed >= 0, leftPWM);
-    setMotor(MOTOR_ID_RIGHT, rightSpeed >= 0, rightPWM);
+bool MotorController::stopTrajectory() {
+    // Zustand nur unter dem Mutex ändern (der Tick liest Verlauf und Sollwerte)
+    if (!stateMutex || xSemaphoreTake(stateMutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        return false;
+    }
     
-    // Update telemetry
-    telemetry.leftSpeed = (int8_t)constrain(leftSpeed, -100, 100);
-    telemetry.rightSpeed = (int8_t)constrain(rightSpeed, -100, 100);
-    telemetry.leftPWM = leftPWM;
-    telemetry.rightPWM = rightPWM;
-    telemetry.lastUpdateMs = millis();
+    // Während der Wiedergabe schreibt processMovementInput() keine Sollwerte:
+    // ohne Nullen führe das Fahrzeug mit dem letzten Verlaufs-Sollwert weiter
+    if (trajectory.isPlaying()) {
+        targetQ8[MOTOR_ID_LEFT] = 0;
+        targetQ8[MOTOR_ID_RIGHT] = 0;
+    }
+    bool wasRecording = trajectory.isRecording();
+    trajectory.stop();
+    uint32_t points = trajectory.getPointCount();
+    uint32_t durationMs = trajectory.getDurationMs();
+    
+    xSemaphoreGive(stateMutex);
     
-    // Debug logging
-    logger.debug("MotorController",
-               (String("Movement: X=") + joystickX + " Y=" + joystickY + 
-               " -> L=" + leftSpeed + "(" + leftPWM + ") R=" + rightSpeed + "(" + rightPWM + ")").c_str());
+    // Ausgabe erst nach Freigabe: der Tick wartet nicht auf Serial
+    if (wasRecording) {
+        DEBUG_PRINTF("Trajectory: ✅ Aufzeichnung: %lu Stützpunkte, %lu ms\n", points, durationMs);
+    }
+    return true;
 }
 
 void MotorController::stop() {
-    // Set all motor pins low
-    digitalWrite(pinIn1, LOW);
-    digitalWrite(pinIn2, LOW);
-    digitalWrite(pinIn3, LOW);
-    digitalWrite(pinIn4, LOW);
-    analogWrite(pinEnA, 0);
-    analogWrite(pinEnB, 0);
+    // Sicherheit vor Mutex: Ausgänge auch dann abschalten, wenn der Tick hängt
+    bool locked = stateMutex && xSemaphoreTake(stateMutex, pdMS_TO_TICKS(10)) == pdTRUE;
+    
+    // Stopp beendet auch eine laufende Wiedergabe
+    trajectory.abort();
+    
+    // Stopp aus der Fahrt: Vorgeschichte sichern
+    if (appliedQ8[MOTOR_ID_LEFT] != 0 || appliedQ8[MOTOR_ID_RIGHT] != 0) {
+        blackBox.trigger(BlackBoxTrigger::STOP);
+    }
+    
+    // Set all motor outputs low (immer schreiben, unabhängig vom Cache)
+    driver.stopAll();
+    
+    // Soll und Ist ohne Rampe auf 0
+    for (int i = 0; i < 2; i++) {
+        targetQ8[i] = 0;
+        appliedQ8[i] = 0;
+    }
+    resetSpeedLoop();
     
     // Update telemetry
     telemetry.leftSpeed = 0;
@@ -129,13 +222,17 @@ void MotorController::stop() {
     telemetry.rightPWM = 0;
     telemetry.lastUpdateMs = millis();
     
+    if (locked) {
+        xSemaphoreGive(stateMutex);
+    }
+    
     logger.info("MotorController", "Motors stopped");
 }
 
 void MotorController::enable() {
     enabled = true;
     telemetry.motorsEnabled = true;
-    lastCommandTime = millis();  // Reset timeout bei Enable
+    lastCommandUs = (uint32_t)esp_timer_get_time();  // Reset timeout bei Enable
     logger.info("MotorController", "Motors enabled");
 }
 
@@ -147,73 +244,504 @@ void MotorController::disable() {
 }
 
 MotorTelemetry MotorController::getTelemetry() const {
-    return telemetry;
+    MotorTelemetry copy = telemetry;
+    
+    // Konsistente Kopie (Tick schreibt aus dem esp_timer Task)
+    if (stateMutex && xSemaphoreTake(stateMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        copy = telemetry;
+        xSemaphoreGive(stateMutex);
+    }
+    
+    return copy;
+}
+
+MotorTickStats MotorController::getTickStats() const {
+    MotorTickStats stats;
+    stats.tickCount = tickCount;
+    stats.skipped = tickSkipped;
+    stats.lastUs = tickLastUs;
+    stats.maxUs = tickMaxUs;
+    stats.avgUs = tickCount ? (uint32_t)(tickSumUs / tickCount) : 0;
+    stats.maxJitterUs = tickMaxJitterUs;
+    stats.cmdCount = cmdCount;
+    stats.cmdLastCycles = cmdLastCycles;
+    stats.cmdMaxCycles = cmdMaxCycles;
+    stats.cmdAvgCycles = cmdCount ? (uint32_t)(cmdSumCycles / cmdCount) : 0;
+    stats.watchdogTrips = tripCount;
+    stats.watchdogLastUs = tripLastUs;
+    stats.watchdogMaxUs = tripMaxUs;
+    stats.firstCommandMs = firstCommandMs;
+    return stats;
+}
+
+void MotorController::resetTickStats() {
+    tickCount = 0;
+    tickSkipped = 0;
+    tickLastUs = 0;
+    tickMaxUs = 0;
+    tickSumUs = 0;
+    tickMaxJitterUs = 0;
+    lastTickStartUs = 0;
+    cmdCount = 0;
+    cmdLastCycles = 0;
+    cmdMaxCycles = 0;
+    cmdSumCycles = 0;
+    tripCount = 0;
+    tripLastUs = 0;
+    tripMaxUs = 0;
+    limiter.resetStats();
+    reportedLimitEvents = 0;
+    sagGuard.resetStats();
+    reportedSagEvents = 0;
+    speedRuns = 0;
+    speedLastUs = 0;
+    speedMaxUs = 0;
+    
+    // Encoder-Fehler quittieren (Regler startet beim nächsten Schritt ohne Altlasten)
+    speedFault = false;
 }
 
 void MotorController::update() {
     // ═══════════════════════════════════════════════════════════════════
-    // SAFETY CHECK: Command Timeout
+    // SAFETY: Watchdog-Auslösung melden (Abschaltung selbst im Regel-Takt)
     // ═══════════════════════════════════════════════════════════════════
-    checkCommandTimeout();
+    reportWatchdogTrip();
+    
+    // Strombegrenzung greift: einmal pro Eingriff melden (Drosselung selbst im Regel-Takt)
+    CurrentLimitStats limit = limiter.getStats();
+    if (limit.limitEvents != reportedLimitEvents) {
+        reportedLimitEvents = limit.limitEvents;
+        logger.record(LOG_WARNING, "MotorController", "Current limit active: %ld mA (limit %ld, peak %ld, scale %ld/256)",
+                      limit.filteredMa, limiter.getLimit(), limit.peakMa, limit.minScaleQ8);
+    }
+    
+    // Encoder unplausibel: Regler ist bereits im Takt auf Open-Loop gefallen
+    if (speedFaults != reportedSpeedFaults) {
+        reportedSpeedFaults = speedFaults;
+        if (speedFaultReversed) {
+            logger.record(LOG_ERROR, "MotorController",
+                          "Speed loop fault: encoder on motor %ld counts against output (A/B swapped?) - open loop",
+                          speedFaultMotor);
+        } else {
+            logger.record(LOG_ERROR, "MotorController",
+                          "Speed loop fault: no encoder signal on motor %ld at full output - open loop",
+                          speedFaultMotor);
+        }
+    }
+    
+    // Spannungseinbruch: einmal pro Eingriff melden (kein Shutdown, siehe BatteryMonitor)
+    SagGuardStats sag = sagGuard.getStats();
+    if (sag.sagEvents != reportedSagEvents) {
+        reportedSagEvents = sag.sagEvents;
+        logger.record(LOG_WARNING, "MotorController", "Voltage sag: %ld mV (min %ld mV), scale %u/256",
+                      sag.filteredMv, sag.minMv, sag.minScaleQ8);
+    }
 }
 
-void MotorController::checkCommandTimeout() {
-    // Nur prüfen wenn Motoren enabled sind
-    if (!enabled) {
+void MotorController::reportWatchdogTrip() {
+    if (!watchdogTripped) {
         return;
     }
+    watchdogTripped = false;
+    
+    // Motoren sind zu diesem Zeitpunkt bereits aus
+    Serial.println("\n╔════════════════════════════════════════╗");
+    Serial.println("║  ⚠️  SAFETY TIMEOUT - EMERGENCY STOP  ║");
+    Serial.println("╚════════════════════════════════════════╝");
+    Serial.printf("Time since last command: %lu us (limit: %lu ms)\n", 
+                 tripLastUs, COMMAND_TIMEOUT_MS);
+    Serial.printf("Motors were running: L=%d, R=%d\n", 
+                 tripLeftPwm, tripRightPwm);
     
-    // Prüfe ob Motoren aktuell laufen (PWM > 0)
-    bool motorsRunning = (telemetry.leftPWM > 0 || telemetry.rightPWM > 0);
+    logger.warning("MotorController", "Command timeout - emergency stop!");
+    
+    Serial.println("✅ Motors stopped for safety");
+    Serial.println("════════════════════════════════════════\n");
+}
+
+bool MotorController::checkWatchdog(uint32_t nowUs) {
+    // Nur prüfen wenn Motoren enabled sind und laufen
+    if (!enabled) {
+        return false;
+    }
     
+    bool motorsRunning = driver.getDuty(MOTOR_ID_LEFT) > 0 || driver.getDuty(MOTOR_ID_RIGHT) > 0 ||
+                         appliedQ8[MOTOR_ID_LEFT] != 0 || appliedQ8[MOTOR_ID_RIGHT] != 0;
     if (!motorsRunning) {
-        return;  // Motoren sind bereits aus, nichts zu tun
+        return false;
+    }
+    
+    // Unsigned-Differenz: Überlauf nach ~71 min unkritisch
+    uint32_t sinceCommand = nowUs - lastCommandUs;
+    if (sinceCommand <= COMMAND_TIMEOUT_MS * 1000UL) {
+        return false;
     }
     
-    // Prüfe Timeout
-    unsigned long timeSinceLastCommand = millis() - lastCommandTime;
+    // TIMEOUT! Ausgänge direkt abschalten - ohne Rampe, ohne loop()
+    tripLeftPwm = telemetry.leftPWM;
+    tripRightPwm = telemetry.rightPWM;
+    
+    driver.stopAll();
+    trajectory.abort();
+    
+    for (int i = 0; i < 2; i++) {
+        targetQ8[i] = 0;
+        appliedQ8[i] = 0;
+    }
+    resetSpeedLoop();
+    telemetry.leftSpeed = 0;
+    telemetry.rightSpeed = 0;
+    telemetry.leftPWM = 0;
+    telemetry.rightPWM = 0;
+    telemetry.lastUpdateMs = millis();
+    
+    tripLastUs = sinceCommand;
+    if (sinceCommand > tripMaxUs) tripMaxUs = sinceCommand;
+    tripCount++;
+    watchdogTripped = true;
+    blackBox.trigger(BlackBoxTrigger::WATCHDOG);
+    
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// REGEL-TAKT (1 kHz, esp_timer Task)
+// ═══════════════════════════════════════════════════════════════════════════
+
+void MotorController::tickCallback(void* arg) {
+    static_cast<MotorController*>(arg)->tick();
+}
+
+void MotorController::tick() {
+    int64_t start = esp_timer_get_time();
+    
+    // Jitter: Abstand zum vorherigen Tick gegen Soll-Intervall
+    if (lastTickStartUs != 0) {
+        int64_t jitter = (start - lastTickStartUs) - MOTOR_TICK_US;
+        if (jitter < 0) jitter = -jitter;
+        if ((uint32_t)jitter > tickMaxJitterUs) tickMaxJitterUs = (uint32_t)jitter;
+    }
+    lastTickStartUs = start;
+    
+    // Nicht blockieren - stop() hat Vorrang, Tick wird nachgeholt
+    if (xSemaphoreTake(stateMutex, 0) != pdTRUE) {
+        tickSkipped++;
+        return;
+    }
     
-    if (timeSinceLastCommand > COMMAND_TIMEOUT_MS) {
-        // TIMEOUT! Emergency Stop
-        Serial.println("\n╔════════════════════════════════════════╗");
-        Serial.println("║  ⚠️  SAFETY TIMEOUT - EMERGENCY STOP  ║");
-        Serial.println("╚════════════════════════════════════════╝");
-        Serial.printf("Time since last command: %lu ms (limit: %lu ms)\n", 
-                     timeSinceLastCommand, COMMAND_TIMEOUT_MS);
-        Serial.printf("Motors were running: L=%d, R=%d\n", 
-                     telemetry.leftPWM, telemetry.rightPWM);
+    // Command-Watchdog (hat Vorrang vor der Rampe)
+    if (checkWatchdog((uint32_t)start)) {
+        recordBlackBox((uint32_t)start, true);
+        xSemaphoreGive(stateMutex);
+        tickCount++;
+        return;
+    }
+    
+    // Rampe pro Takt in Q8 (%/s · 256 / Hz), 0 = sofort
+    int32_t accelStep = ((int32_t)userConfig.getMotorAccel() * 256) / MOTOR_TICK_HZ;
+    int32_t decelStep = ((int32_t)userConfig.getMotorDecel() * 256) / MOTOR_TICK_HZ;
+    if (userConfig.getMotorAccel() > 0 && accelStep == 0) accelStep = 1;
+    if (userConfig.getMotorDecel() > 0 && decelStep == 0) decelStep = 1;
+    
+    // ═══════════════════════════════════════════════════════════════════
+    // Strombegrenzer + Spannungs-Wächter: bei Fahrt jeden n-ten Tick messen,
+    // Duty proportional drosseln
+    // ═══════════════════════════════════════════════════════════════════
+    bool running = appliedQ8[MOTOR_ID_LEFT] != 0 || appliedQ8[MOTOR_ID_RIGHT] != 0;
+    if (!running) {
+        limiter.idle();
+        sagGuard.idle();
+    } else if (tickCount % CURRENT_LIMIT_SAMPLE_DIV == 0) {
+        if (limiter.getLimit() != userConfig.getMotorCurrentLimit()) {
+            limiter.setLimit(userConfig.getMotorCurrentLimit());
+        }
+        int64_t sampleStart = esp_timer_get_time();
+        int32_t currentMa = battery.readCurrentFastMa();
+        int64_t sampleEnd = esp_timer_get_time();
+        limiter.recordSampleTime((uint32_t)(sampleEnd - sampleStart));
+        limiter.update(currentMa, (uint32_t)sampleEnd);
+        sagGuard.update(battery.readVoltageFastMv(), (uint32_t)sampleEnd);
+    }
+    
+    // Wiedergabe: Sollwert aus dem Verlauf (Ende → 0, Rampe bremst)
+    if (trajectory.isPlaying()) {
+        int32_t left, right;
+        trajectory.sample(start, left, right);
+        targetQ8[MOTOR_ID_LEFT] = left;
+        targetQ8[MOTOR_ID_RIGHT] = right;
+    }
+    
+    for (uint8_t motor = 0; motor < 2; motor++) {
+        if (!enabled) {
+            targetQ8[motor] = 0;
+        }
         
-        logger.warning("MotorController", "Command timeout - emergency stop!");
+        appliedQ8[motor] = rampStep(appliedQ8[motor], targetQ8[motor], accelStep, decelStep);
+    }
+    
+    // Drehzahlregler: Rampe liefert den Sollwert, Ausgang gilt bis zum nächsten Schritt
+    if (tickCount % SPEED_LOOP_DIV == 0) {
+        updateSpeedLoop();
+    }
+    
+    // Akku-Spannung ausgleichen: Faktor nur bei neuer Messung (alle VOLTAGE_CHECK_INTERVAL ms)
+    updateVoltageComp();
+    
+    for (uint8_t motor = 0; motor < 2; motor++) {
+        int32_t command = closedLoop ? outputQ8[motor] : appliedQ8[motor];
         
-        // STOP!
-        stop();
+        // Volle Duty-Auflösung aus dem Q8-Wert (feiner als 1 %), spannungskompensiert,
+        // ggf. strom-/spannungsgedrosselt
+        uint32_t duty = sagGuard.apply(limiter.apply(compensate(speedToDuty(command))));
         
-        Serial.println("✅ Motors stopped for safety");
-        Serial.println("════════════════════════════════════════\n");
+        // Treiber schreibt nur bei Änderung
+        if (driver.write(motor, command >= 0, duty)) {
+            int32_t speed = appliedQ8[motor] / 256;       // Richtung 0 (kein Floor)
+            uint8_t pwm = (uint8_t)(duty >> (MOTOR_PWM_RES - 8));
+            
+            if (motor == MOTOR_ID_LEFT) {
+                telemetry.leftSpeed = (int8_t)speed;
+                telemetry.leftPWM = pwm;
+            } else {
+                telemetry.rightSpeed = (int8_t)speed;
+                telemetry.rightPWM = pwm;
+            }
+            telemetry.lastUpdateMs = millis();
+        }
     }
+    
+    recordBlackBox((uint32_t)start, false);
+    
+    xSemaphoreGive(stateMutex);
+    
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+    tickLastUs = elapsed;
+    tickSumUs += elapsed;
+    tickCount++;
+    if (elapsed > tickMaxUs) tickMaxUs = elapsed;
 }
 
-void MotorController::setMotor(uint8_t motor, bool forward, uint8_t pwm) {
-    if (motor == MOTOR_ID_LEFT) {
-        // Left motor control
-        if (forward) {
-            digitalWrite(pinIn1, HIGH);
-            digitalWrite(pinIn2, LOW);
-        } else {
-            digitalWrite(pinIn1, LOW);
-            digitalWrite(pinIn2, HIGH);
+int32_t MotorController::rampStep(int32_t applied, int32_t target, int32_t accelStep, int32_t decelStep) {
+    int32_t diff = target - applied;
+    if (diff == 0) return applied;
+    
+    // Richtung Null (inkl. Richtungswechsel) = Verzögern, sonst Beschleunigen
+    bool towardZero = (applied > 0 && diff < 0) || (applied < 0 && diff > 0);
+    int32_t step = towardZero ? decelStep : accelStep;
+    
+    int32_t next;
+    if (step == 0 || (diff <= step && diff >= -step)) {
+        next = target;
+    } else {
+        next = applied + (diff > 0 ? step : -step);
+    }
+    
+    // Nulldurchgang: erst mit Bremsrate auf 0, danach mit Beschleunigung weiter
+    if (towardZero && step != 0 && ((applied ^ next) < 0)) {
+        next = 0;
+    }
+    
+    return next;
+}
+
+void MotorController::updateSpeedLoop() {
+    if (!encodersReady) {
+        closedLoop = false;
+        return;
+    }
+    
+    int64_t start = esp_timer_get_time();
+    
+    // Reglerparameter nur nach Config-Änderung übernehmen
+    if (userConfig.getRevision() != pidRevision) {
+        SpeedPidGains gains;
+        gains.kp = userConfig.getSpeedKp();
+        gains.ki = userConfig.getSpeedKi();
+        gains.kd = userConfig.getSpeedKd();
+        gains.kff = userConfig.getSpeedKff();
+        speedPid[MOTOR_ID_LEFT].setGains(gains);
+        speedPid[MOTOR_ID_RIGHT].setGains(gains);
+        pidRevision = userConfig.getRevision();
+    }
+    
+    // Umschalten auf Closed-Loop: ohne Altlasten im Integrator starten.
+    // Nach Encoder-Fehler bleibt Open-Loop, bis speedLoop ausgeschaltet wird
+    bool wanted = userConfig.getSpeedLoop();
+    if (!wanted) {
+        speedFault = false;
+    }
+    wanted = wanted && !speedFault;
+    if (wanted && !closedLoop) {
+        resetSpeedLoop();
+    }
+    closedLoop = wanted;
+    
+    const float dt = 1.0f / SPEED_LOOP_HZ;
+    
+    for (uint8_t motor = 0; motor < 2; motor++) {
+        // Counts pro Reglerschritt → % von ENCODER_MAX_CPS (Q8)
+        int32_t count = encoders[motor].read();
+        int32_t delta = count - lastCount[motor];
+        lastCount[motor] = count;
+        measuredQ8[motor] = (int32_t)((int64_t)delta * SPEED_LOOP_HZ * 100 * 256 / ENCODER_MAX_CPS);
+        
+        if (!closedLoop) {
+            continue;
         }
-        analogWrite(pinEnA, pwm);
-    } 
-    else if (motor == MOTOR_ID_RIGHT) {
-        // Right motor control
-        if (forward) {
-            digitalWrite(pinIn3, HIGH);
-            digitalWrite(pinIn4, LOW);
-        } else {
-            digitalWrite(pinIn3, LOW);
-            digitalWrite(pinIn4, HIGH);
+        
+        // Stillstand gewollt: kein Haltemoment, Integrator leeren
+        if (appliedQ8[motor] == 0 && targetQ8[motor] == 0) {
+            speedPid[motor].reset();
+            outputQ8[motor] = 0;
+            speedSuspect[motor] = 0;
+            continue;
+        }
+        
+        float out = speedPid[motor].update(appliedQ8[motor] / 256.0f, measuredQ8[motor] / 256.0f, dt);
+        outputQ8[motor] = (int32_t)(out * 256.0f);
+        
+        if (checkSpeedFault(motor)) {
+            break;
         }
-        analogWrite(pinEnB, pwm);
     }
-}
\ No newline at end of file
+    
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+    speedLastUs = elapsed;
+    if (elapsed > speedMaxUs) speedMaxUs = elapsed;
+    speedRuns++;
+}
+
+void MotorController::resetSpeedLoop() {
+    for (int i = 0; i < 2; i++) {
+        speedPid[i].reset();
+        outputQ8[i] = 0;
+    }
+}
+
+bool MotorController::checkSpeedFault(uint8_t motor) {
+    int32_t out = outputQ8[motor];
+    int32_t meas = measuredQ8[motor];
+    int32_t outMag = out < 0 ? -out : out;
+    int32_t measMag = meas < 0 ? -meas : meas;
+    
+    // Regler treibt kräftig, Encoder meldet nichts (fehlt) oder Gegenrichtung (verpolt)
+    bool stalled = measMag < SPEED_FAULT_MIN_PCT * 256;
+    bool reversed = !stalled && ((out ^ meas) < 0);
+    if (outMag < SPEED_FAULT_OUT_PCT * 256 || (!stalled && !reversed)) {
+        speedSuspect[motor] = 0;
+        return false;
+    }
+    
+    if (++speedSuspect[motor] < SPEED_FAULT_STEPS) {
+        return false;
+    }
+    
+    // Verriegeln: Open-Loop ab diesem Takt, Meldung in update()
+    speedFault = true;
+    speedFaultMotor = motor;
+    speedFaultReversed = reversed;
+    speedFaults++;
+    closedLoop = false;
+    resetSpeedLoop();
+    speedSuspect[MOTOR_ID_LEFT] = 0;
+    speedSuspect[MOTOR_ID_RIGHT] = 0;
+    return true;
+}
+
+SpeedLoopStats MotorController::getSpeedLoopStats() const {
+    SpeedLoopStats stats;
+    stats.encodersReady = encodersReady;
+    stats.active = closedLoop;
+    for (int i = 0; i < 2; i++) {
+        stats.count[i] = lastCount[i];
+        stats.measuredPct[i] = (int16_t)(measuredQ8[i] / 256);
+        stats.outputPct[i] = (int16_t)(outputQ8[i] / 256);
+    }
+    stats.runs = speedRuns;
+    stats.lastUs = speedLastUs;
+    stats.maxUs = speedMaxUs;
+    stats.fault = speedFault;
+    stats.faultMotor = speedFaultMotor;
+    stats.faultReversed = speedFaultReversed;
+    stats.faults = speedFaults;
+    return stats;
+}
+
+void MotorController::updateVoltageComp() {
+    uint32_t samples = battery.getVoltageSamples();
+    if (samples == vcompSamples) {
+        return;
+    }
+    vcompSamples = samples;
+    vcompMv = battery.getVoltageMv();
+    
+    // Aus oder keine plausible Akkuspannung (z.B. nur USB): Faktor 1.0
+    if (!userConfig.getMotorVoltComp() || vcompMv < MOTOR_VCOMP_MIN_MV) {
+        vcompQ8 = 256;
+        return;
+    }
+    
+    // Nenn-/Akkuspannung in Q8, gerundet; Obergrenze schützt vor Mitkopplung mit dem Einbruch
+    int32_t factor = (MOTOR_VCOMP_NOMINAL_MV * 256 + vcompMv / 2) / vcompMv;
+    if (factor < MOTOR_VCOMP_MIN_Q8) factor = MOTOR_VCOMP_MIN_Q8;
+    if (factor > MOTOR_VCOMP_MAX_Q8) factor = MOTOR_VCOMP_MAX_Q8;
+    vcompQ8 = (uint16_t)factor;
+}
+
+void MotorController::recordBlackBox(uint32_t nowUs, bool watchdogTrip) {
+    uint32_t cycleStart = ESP.getCycleCount();
+    
+    BlackBoxRecord rec;
+    rec.timeUs = nowUs;
+    rec.joyX = lastJoyX;
+    rec.joyY = lastJoyY;
+    rec.targetLeft = (int16_t)targetQ8[MOTOR_ID_LEFT];
+    rec.targetRight = (int16_t)targetQ8[MOTOR_ID_RIGHT];
+    
+    int32_t commandLeft = closedLoop ? outputQ8[MOTOR_ID_LEFT] : appliedQ8[MOTOR_ID_LEFT];
+    int32_t commandRight = closedLoop ? outputQ8[MOTOR_ID_RIGHT] : appliedQ8[MOTOR_ID_RIGHT];
+    rec.commandLeft = (int16_t)commandLeft;
+    rec.commandRight = (int16_t)commandRight;
+    
+    int32_t measLeft = measuredQ8[MOTOR_ID_LEFT];
+    int32_t measRight = measuredQ8[MOTOR_ID_RIGHT];
+    rec.measuredLeft = (int16_t)(measLeft > 32767 ? 32767 : (measLeft < -32768 ? -32768 : measLeft));
+    rec.measuredRight = (int16_t)(measRight > 32767 ? 32767 : (measRight < -32768 ? -32768 : measRight));
+    
+    rec.dutyLeft = (uint16_t)driver.getDuty(MOTOR_ID_LEFT);
+    rec.dutyRight = (uint16_t)driver.getDuty(MOTOR_ID_RIGHT);
+    
+    int32_t currentMa = limiter.getFilteredMa();
+    rec.currentMa = (uint16_t)(currentMa > 65535 ? 65535 : currentMa);
+    // Bei Fahrt die schnelle Spannung des Wächters (Einbrüche), sonst der Messwert
+    int32_t voltageMv = sagGuard.getFilteredMv();
+    rec.voltageMv = (uint16_t)(voltageMv > 0 ? voltageMv : battery.getVoltage() * 1000.0f);
+    rec.rssi = ESPNowManager::getLastRssi();
+    
+    uint16_t scale = (uint16_t)(((uint32_t)limiter.getScale() * sagGuard.getScale()) >> 8);
+    rec.limitScale = (uint8_t)(scale > 255 ? 255 : scale);
+    rec.flags = (enabled ? BLACKBOX_FLAG_ENABLED : 0) |
+                (closedLoop ? BLACKBOX_FLAG_CLOSED_LOOP : 0) |
+                (commandLeft < 0 ? BLACKBOX_FLAG_LEFT_REV : 0) |
+                (commandRight < 0 ? BLACKBOX_FLAG_RIGHT_REV : 0) |
+                (watchdogTrip ? BLACKBOX_FLAG_WATCHDOG : 0) |
+                (limiter.getScale() < CurrentLimiter::SCALE_ONE ? BLACKBOX_FLAG_CURRENT_LIMIT : 0) |
+                (sagGuard.getScale() < SagGuard::SCALE_ONE ? BLACKBOX_FLAG_SAG : 0) |
+                (speedFault ? BLACKBOX_FLAG_SPEED_FAULT : 0);
+    rec.reserved = 0;
+    
+    blackBox.record(rec);
+    blackBox.recordCycles(ESP.getCycleCount() - cycleStart);
+}
+
+void MotorController::rebuildShaper() {
+    ShapingParams params;
+    params.deadzone = userConfig.getJoyDeadzone();
+    params.expo = userConfig.getJoyExpo();
+    params.trimLeft = userConfig.getMotorTrimLeft();
+    params.trimRight = userConfig.getMotorTrimRight();
+    params.minPwm = userConfig.getMotorMinPwm();
+    
+    shaper.build(params, MotorDriver::MAX_DUTY);
+    shaperRevision = userConfig.getRevision();
+}
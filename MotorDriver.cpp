@@ -0,0 +1,107 @@
+/**
+ * MotorDriver.cpp
+ *
+ * Implementation der LEDC-Ausgabestufe
+ */
+
+#include "include/MotorDriver.h"
+
+MotorDriver::MotorDriver()
+    : initialized(false)
+    , dutyWrites(0)
+    , gpioWrites(0)
+    , skippedWrites(0)
+{
+    outputs[MOTOR_ID_LEFT] = { MOTOR_ENA, MOTOR_IN1, MOTOR_IN2, (ledc_channel_t)MOTOR_PWM_CH_LEFT, 0, 0 };
+    outputs[MOTOR_ID_RIGHT] = { MOTOR_ENB, MOTOR_IN3, MOTOR_IN4, (ledc_channel_t)MOTOR_PWM_CH_RIGHT, 0, 0 };
+}
+
+bool MotorDriver::begin() {
+    bool ok = true;
+
+    for (int i = 0; i < 2; i++) {
+        Output& out = outputs[i];
+
+        pinMode(out.pinA, OUTPUT);
+        pinMode(out.pinB, OUTPUT);
+        digitalWrite(out.pinA, LOW);
+        digitalWrite(out.pinB, LOW);
+
+        // Fester Kanal → ledc_set_duty() ohne Lookup im Betrieb
+        if (!ledcAttachChannel(out.pinPwm, MOTOR_PWM_FREQ, MOTOR_PWM_RES, MOTOR_PWM_CH_LEFT + i)) {
+            ok = false;
+        }
+
+        out.duty = 0;
+        out.direction = 0;
+    }
+
+    initialized = ok;
+    if (initialized) {
+        stopAll();
+    }
+
+    return ok;
+}
+
+bool MotorDriver::write(uint8_t motor, bool forward, uint32_t duty) {
+    if (!initialized || motor > 1) return false;
+
+    Output& out = outputs[motor];
+    if (duty > MAX_DUTY) duty = MAX_DUTY;
+
+    // Bei Duty 0 Richtung beibehalten (kein unnötiges Umschalten)
+    int8_t direction = (duty == 0) ? out.direction : (forward ? 1 : -1);
+
+    if (duty == out.duty && direction == out.direction) {
+        skippedWrites++;
+        return false;
+    }
+
+    // Beim Richtungswechsel erst Duty weg, dann umschalten (kein Kurzschluss-Puls)
+    if (direction != out.direction) {
+        if (out.duty != 0) setDuty(out, 0);
+        setDirection(out, direction);
+    }
+
+    if (duty != out.duty) {
+        setDuty(out, duty);
+    }
+
+    return true;
+}
+
+void MotorDriver::stopAll() {
+    for (int i = 0; i < 2; i++) {
+        Output& out = outputs[i];
+
+        if (initialized) {
+            setDuty(out, 0);
+        }
+        setDirection(out, 0);
+    }
+}
+
+void MotorDriver::resetStats() {
+    dutyWrites = 0;
+    gpioWrites = 0;
+    skippedWrites = 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PRIVATE METHODEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+void MotorDriver::setDirection(Output& out, int8_t direction) {
+    gpio_set_level((gpio_num_t)out.pinA, direction > 0 ? 1 : 0);
+    gpio_set_level((gpio_num_t)out.pinB, direction < 0 ? 1 : 0);
+    gpioWrites += 2;
+    out.direction = direction;
+}
+
+void MotorDriver::setDuty(Output& out, uint32_t duty) {
+    ledc_set_duty(LEDC_LOW_SPEED_MODE, out.channel, duty);
+    ledc_update_duty(LEDC_LOW_SPEED_MODE, out.channel);
+    dutyWrites++;
+    out.duty = duty;
+}
@@ -0,0 +1,425 @@
+/**
+ * OtaReceiver.cpp
+ *
+ * Implementation des ESP-NOW Firmware-Updates (Empfängerseite)
+ */
+
+#include "include/OtaReceiver.h"
+
+OtaReceiver::OtaReceiver()
+    : active(false)
+    , partition(nullptr)
+    , handle(0)
+    , imageSize(0)
+    , written(0)
+    , motorsActive(false)
+    , paused(false)
+    , lastGapAckOffset(UINT32_MAX)
+    , chunksSinceAck(0)
+    , lastActivity(0)
+    , rebootAt(0)
+    , sessionStartMs(0)
+    , sessionEndMs(0)
+    , sessionStartOffset(0)
+    , chunksReceived(0)
+    , chunksDuplicate(0)
+    , chunksOutOfOrder(0)
+    , chunksDropped(0)
+    , chunksPaused(0)
+    , acksSent(0)
+    , resumes(0)
+    , lastStatus(OtaStatus::OK)
+{
+    memset(expectedSha, 0, sizeof(expectedSha));
+    memset(slots, 0, sizeof(slots));
+    mbedtls_sha256_init(&sha);
+}
+
+OtaReceiver::~OtaReceiver() {
+    closeSession(true);
+    mbedtls_sha256_free(&sha);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FRAME-VERARBEITUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool OtaReceiver::handlePacket(const ESPNowPacket& packet, ESPNowPacket& reply) {
+    OtaStatus status = OtaStatus::OK;
+    bool sendAck = true;
+
+    switch (packet.getMainCmd()) {
+        case MainCmd::OTA_BEGIN:
+            status = handleBegin(packet);
+            break;
+
+        case MainCmd::OTA_DATA:
+            sendAck = handleData(packet, status);
+            break;
+
+        case MainCmd::OTA_END:
+            status = handleEnd();
+            break;
+
+        case MainCmd::OTA_ABORT:
+            abort();
+            status = OtaStatus::ABORTED;
+            break;
+
+        default:
+            return false;
+    }
+
+    lastStatus = status;
+
+    if (sendAck) {
+        buildAck(reply, status);
+        // Fenster 0 gemeldet → im Stand Freigabe-ACK nachschicken
+        if (motorsActive) paused = true;
+    }
+    return sendAck;
+}
+
+bool OtaReceiver::rejectPacket(const ESPNowPacket& packet, OtaStatus status, ESPNowPacket& reply) {
+    lastStatus = status;
+
+    // Chunks still verwerfen, Status nur auf BEGIN/END/ABORT (keine ACK-Stürme)
+    if (packet.getMainCmd() == MainCmd::OTA_DATA) {
+        chunksDropped++;
+        return false;
+    }
+
+    buildAck(reply, status);
+    return true;
+}
+
+OtaStatus OtaReceiver::handleBegin(const ESPNowPacket& packet) {
+    uint32_t size;
+    size_t shaLen = 0;
+    const uint8_t* shaData = packet.getData(DataCmd::OTA_SHA256, &shaLen);
+
+    if (!packet.getUInt32(DataCmd::OTA_SIZE, size) || !shaData || shaLen < sizeof(expectedSha)) {
+        return OtaStatus::ERR_SIZE;
+    }
+
+    // Gleiches Image → ab letzter Position fortsetzen
+    if (active && size == imageSize && memcmp(shaData, expectedSha, sizeof(expectedSha)) == 0) {
+        resumes++;
+        memset(slots, 0, sizeof(slots));
+        lastGapAckOffset = UINT32_MAX;
+        chunksSinceAck = 0;
+        lastActivity = millis();
+        sessionStartMs = millis();
+        sessionEndMs = 0;
+        sessionStartOffset = written;
+
+        DEBUG_PRINTF("[OTA] ⏯️ Resume at %lu / %lu bytes\n", written, imageSize);
+        return OtaStatus::OK;
+    }
+
+    // Anderes Image: alte Session verwerfen
+    closeSession(true);
+
+    partition = esp_ota_get_next_update_partition(nullptr);
+    if (!partition || size == 0 || size > partition->size) {
+        DEBUG_PRINTF("[OTA] ❌ Image size %lu does not fit partition\n", size);
+        return OtaStatus::ERR_SIZE;
+    }
+
+    // Sequentielles Löschen: Sektoren werden beim Schreiben gelöscht,
+    // statt die ganze Partition vorab zu löschen (blockiert sonst Sekunden)
+    if (esp_ota_begin(partition, OTA_WITH_SEQUENTIAL_WRITES, &handle) != ESP_OK) {
+        DEBUG_PRINTLN("[OTA] ❌ esp_ota_begin failed");
+        return OtaStatus::ERR_BEGIN;
+    }
+
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+
+    memcpy(expectedSha, shaData, sizeof(expectedSha));
+    imageSize = size;
+    written = 0;
+    memset(slots, 0, sizeof(slots));
+    lastGapAckOffset = UINT32_MAX;
+    chunksSinceAck = 0;
+    lastActivity = millis();
+    rebootAt = 0;
+
+    sessionStartMs = millis();
+    sessionEndMs = 0;
+    sessionStartOffset = 0;
+    chunksReceived = 0;
+    chunksDuplicate = 0;
+    chunksOutOfOrder = 0;
+    chunksDropped = 0;
+    chunksPaused = 0;
+    acksSent = 0;
+    resumes = 0;
+
+    active = true;
+
+    DEBUG_PRINTF("[OTA] ▶️ Begin: %lu bytes → partition '%s'\n", imageSize, partition->label);
+    return OtaStatus::OK;
+}
+
+bool OtaReceiver::handleData(const ESPNowPacket& packet, OtaStatus& status) {
+    if (!active) {
+        status = OtaStatus::ERR_NO_SESSION;
+        return true;
+    }
+
+    uint32_t offset;
+    size_t len = 0;
+    const uint8_t* data = packet.getData(DataCmd::OTA_DATA, &len);
+
+    // Bereichsprüfung ohne Überlauf (offset + len kann bei offset nahe 2^32 umbrechen)
+    if (!packet.getUInt32(DataCmd::OTA_OFFSET, offset) || !data ||
+        len == 0 || len > OTA_MAX_CHUNK || offset > imageSize || len > imageSize - offset) {
+        chunksDropped++;
+        return false;
+    }
+
+    lastActivity = millis();
+    chunksReceived++;
+
+    // Fahrt: nicht schreiben, Fenster 0 (Master wartet auf Freigabe-ACK)
+    if (motorsActive) {
+        chunksPaused++;
+        status = OtaStatus::PAUSED;
+        return true;
+    }
+
+    // Bereits geschrieben: ACK ging verloren → sofort bestätigen
+    if (offset < written) {
+        chunksDuplicate++;
+        return true;
+    }
+
+    // Außer der Reihe: puffern und Lücke einmalig melden (Fast Retransmit)
+    if (offset > written) {
+        chunksOutOfOrder++;
+        if (!storeSlot(offset, data, len)) {
+            chunksDropped++;
+        }
+
+        if (lastGapAckOffset != written) {
+            lastGapAckOffset = written;
+            return true;
+        }
+        return false;
+    }
+
+    // In Reihenfolge: schreiben und gepufferte Nachfolger nachziehen
+    if (!writeChunk(data, len) || !drainSlots()) {
+        DEBUG_PRINTF("[OTA] ❌ Flash write failed at %lu\n", written);
+        status = OtaStatus::ERR_WRITE;
+        closeSession(true);
+        return true;
+    }
+
+    chunksSinceAck++;
+
+    // Kumulatives ACK nach halbem Fenster (Fenster bleibt gefüllt)
+    uint8_t ackEvery = (OTA_WINDOW_CHUNKS > 1) ? OTA_WINDOW_CHUNKS / 2 : 1;
+
+    if (chunksSinceAck >= ackEvery || written == imageSize) {
+        return true;
+    }
+    return false;
+}
+
+OtaStatus OtaReceiver::handleEnd() {
+    if (!active) {
+        return OtaStatus::ERR_NO_SESSION;
+    }
+
+    if (written != imageSize) {
+        // ACK enthält Offset → Master setzt dort fort
+        return OtaStatus::ERR_INCOMPLETE;
+    }
+
+    // Boot-Partition setzen löscht einen Flash-Sektor → nur im Stand
+    if (motorsActive) {
+        return OtaStatus::PAUSED;
+    }
+
+    sessionEndMs = millis();
+
+    uint8_t digest[32];
+    mbedtls_sha256_finish(&sha, digest);
+
+    if (memcmp(digest, expectedSha, sizeof(digest)) != 0) {
+        DEBUG_PRINTLN("[OTA] ❌ SHA-256 mismatch!");
+        closeSession(true);
+        return OtaStatus::ERR_HASH;
+    }
+
+    esp_err_t err = esp_ota_end(handle);
+    handle = 0;
+    active = false;
+
+    if (err != ESP_OK || esp_ota_set_boot_partition(partition) != ESP_OK) {
+        DEBUG_PRINTF("[OTA] ❌ Image invalid (err=%d)\n", err);
+        closeSession(false);
+        return OtaStatus::ERR_IMAGE;
+    }
+
+    closeSession(false);
+
+    // Neustart verzögern, damit das DONE-ACK noch rausgeht
+    rebootAt = millis() + OTA_REBOOT_DELAY_MS;
+    if (rebootAt == 0) rebootAt = 1;
+
+    DEBUG_PRINTF("[OTA] ✅ Update verified (%lu B/s), restart at standstill\n", getThroughput());
+    return OtaStatus::DONE;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// UPDATE & STATUS
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool OtaReceiver::update(ESPNowPacket& reply) {
+    // Pause zählt nicht als Funkstille
+    if (active && motorsActive) {
+        lastActivity = millis();
+    }
+
+    // Verwaiste Session nach langer Funkstille verwerfen (Resume-Fenster)
+    if (active && millis() - lastActivity > OTA_SESSION_TIMEOUT_MS) {
+        DEBUG_PRINTLN("[OTA] ⚠️ Session timeout - aborting");
+        abort();
+    }
+
+    // Stillstand nach Pause: Master mit vollem Fenster fortsetzen lassen
+    if (paused && !motorsActive) {
+        paused = false;
+        if (active) {
+            lastStatus = OtaStatus::OK;
+            buildAck(reply, OtaStatus::OK);
+            return true;
+        }
+    }
+    return false;
+}
+
+void OtaReceiver::abort() {
+    if (!active) return;
+
+    closeSession(true);
+    lastStatus = OtaStatus::ABORTED;
+
+    DEBUG_PRINTLN("[OTA] ⏹️ Aborted");
+}
+
+uint32_t OtaReceiver::getThroughput() const {
+    unsigned long end = sessionEndMs ? sessionEndMs : millis();
+    unsigned long elapsed = end - sessionStartMs;
+    if (sessionStartMs == 0 || elapsed == 0) return 0;
+
+    return (uint32_t)((uint64_t)(written - sessionStartOffset) * 1000 / elapsed);
+}
+
+void OtaReceiver::printInfo() const {
+    DEBUG_PRINTLN("\n╔════════════════════════════════════════╗");
+    DEBUG_PRINTLN("║       OTA RECEIVER INFO                ║");
+    DEBUG_PRINTLN("╚════════════════════════════════════════╝");
+    DEBUG_PRINTF("Session:        %s%s\n", active ? "AKTIV" : "keine",
+                 rebootAt ? " (Neustart im Stand ausstehend)" : "");
+    DEBUG_PRINTF("Fortschritt:    %lu / %lu Bytes (%lu%%)\n",
+                 written, imageSize, imageSize ? (uint32_t)((uint64_t)written * 100 / imageSize) : 0);
+    DEBUG_PRINTF("Durchsatz:      %lu B/s\n", getThroughput());
+    DEBUG_PRINTF("Fenster:        %u Chunks%s\n",
+                 motorsActive ? 0 : OTA_WINDOW_CHUNKS,
+                 motorsActive ? " (Pause, Motoren aktiv)" : "");
+    DEBUG_PRINTF("Chunks:         %lu (dup %lu, ooo %lu, drop %lu, Pause %lu)\n",
+                 chunksReceived, chunksDuplicate, chunksOutOfOrder, chunksDropped, chunksPaused);
+    DEBUG_PRINTF("ACKs:           %lu\n", acksSent);
+    DEBUG_PRINTF("Resumes:        %lu\n", resumes);
+    DEBUG_PRINTF("Letzter Status: 0x%02X\n", static_cast<uint8_t>(lastStatus));
+    DEBUG_PRINTLN("────────────────────────────────────────");
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PRIVATE METHODEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool OtaReceiver::writeChunk(const uint8_t* data, size_t len) {
+    if (esp_ota_write(handle, data, len) != ESP_OK) {
+        return false;
+    }
+
+    mbedtls_sha256_update(&sha, data, len);
+    written += len;
+    return true;
+}
+
+bool OtaReceiver::drainSlots() {
+    bool progress = true;
+
+    while (progress) {
+        progress = false;
+        for (int i = 0; i < OTA_REORDER_SLOTS; i++) {
+            ReorderSlot& slot = slots[i];
+            if (!slot.used) continue;
+
+            if (slot.offset < written) {
+                // Inzwischen überholt
+                slot.used = false;
+            } else if (slot.offset == written) {
+                slot.used = false;
+                if (!writeChunk(slot.data, slot.length)) {
+                    return false;
+                }
+                progress = true;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool OtaReceiver::storeSlot(uint32_t offset, const uint8_t* data, size_t len) {
+    ReorderSlot* freeSlot = nullptr;
+
+    for (int i = 0; i < OTA_REORDER_SLOTS; i++) {
+        if (slots[i].used) {
+            if (slots[i].offset == offset) return true;     // Schon gepuffert
+        } else if (!freeSlot) {
+            freeSlot = &slots[i];
+        }
+    }
+
+    if (!freeSlot) return false;
+
+    freeSlot->used = true;
+    freeSlot->offset = offset;
+    freeSlot->length = len;
+    memcpy(freeSlot->data, data, len);
+    return true;
+}
+
+void OtaReceiver::buildAck(ESPNowPacket& reply, OtaStatus status) {
+    uint8_t window = motorsActive ? 0 : OTA_WINDOW_CHUNKS;
+
+    reply.begin(MainCmd::OTA_ACK);
+    reply.addByte(DataCmd::STATUS, static_cast<uint8_t>(status));
+    reply.addUInt32(DataCmd::OTA_OFFSET, written);
+    reply.addByte(DataCmd::OTA_WINDOW, window);
+
+    chunksSinceAck = 0;
+    acksSent++;
+}
+
+void OtaReceiver::closeSession(bool abortOta) {
+    if (active && abortOta && handle) {
+        esp_ota_abort(handle);
+    }
+
+    if (active) {
+        mbedtls_sha256_free(&sha);
+    }
+
+    active = false;
+    handle = 0;
+    memset(slots, 0, sizeof(slots));
+}
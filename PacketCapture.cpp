@@ -0,0 +1,410 @@
+/**
+ * PacketCapture.cpp
+ *
+ * Implementation des ESP-NOW Mitschnitts mit Ringpuffer und Replay
+ */
+
+#include "include/PacketCapture.h"
+#include <esp_timer.h>
+
+// Statischer Instance-Pointer (für Capture-Hook)
+PacketCapture* PacketCapture::instance = nullptr;
+
+PacketCapture::PacketCapture()
+    : sdHandler(nullptr)
+    , espNow(nullptr)
+    , ring(nullptr)
+    , ringHead(0)
+    , ringTail(0)
+    , stagingBuffer(nullptr)
+    , capturing(false)
+    , captureStartUs(0)
+    , lastFlush(0)
+    , framesCaptured(0)
+    , framesDropped(0)
+    , bytesWritten(0)
+    , writeErrors(0)
+    , replaying(false)
+    , replaySpeed(1)
+    , replayFileSize(0)
+    , replayOffset(0)
+    , replayBufStart(0)
+    , replayBufLen(0)
+    , replayStartUs(0)
+    , replayFirstUs(-1)
+    , replayLastRawUs(0)
+    , replayTimeBaseUs(0)
+    , replayInjected(0)
+    , replaySkipped(0)
+{
+    ringLock = portMUX_INITIALIZER_UNLOCKED;
+    capturePath[0] = '\0';
+    replayPath[0] = '\0';
+}
+
+PacketCapture::~PacketCapture() {
+    stopCapture();
+    stopReplay();
+
+    if (ring) {
+        free(ring);
+        ring = nullptr;
+    }
+    if (stagingBuffer) {
+        free(stagingBuffer);
+        stagingBuffer = nullptr;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INITIALISIERUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool PacketCapture::begin(SDCardHandler* sdHandler, ESPNowManager* espNow) {
+    this->sdHandler = sdHandler;
+    this->espNow = espNow;
+    instance = this;
+
+    if (!ring) {
+        // Ringpuffer bevorzugt im PSRAM
+        ring = (uint8_t*)(psramFound() ? ps_malloc(CAPTURE_RING_SIZE) : malloc(CAPTURE_RING_SIZE));
+    }
+    if (!stagingBuffer) {
+        stagingBuffer = (uint8_t*)malloc(CAPTURE_STAGING_SIZE);
+    }
+
+    if (!ring || !stagingBuffer) {
+        DEBUG_PRINTLN("PacketCapture: ❌ Speicher-Allokation fehlgeschlagen!");
+        return false;
+    }
+
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// AUFZEICHNUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool PacketCapture::startCapture() {
+    if (capturing) return true;
+
+    if (!ring || !sdHandler || !sdHandler->isAvailable()) {
+        DEBUG_PRINTLN("PacketCapture: ❌ SD-Karte nicht verfügbar!");
+        return false;
+    }
+
+    if (replaying) {
+        DEBUG_PRINTLN("PacketCapture: ❌ Replay aktiv!");
+        return false;
+    }
+
+    // Freien Dateinamen suchen
+    if (!sdHandler->fileExists(CAPTURE_DIR)) {
+        sdHandler->createDir(CAPTURE_DIR);
+    }
+
+    capturePath[0] = '\0';
+    for (int i = 0; i < 1000; i++) {
+        char path[32];
+        snprintf(path, sizeof(path), "%s/cap_%03d.bin", CAPTURE_DIR, i);
+        if (!sdHandler->fileExists(path)) {
+            strncpy(capturePath, path, sizeof(capturePath) - 1);
+            capturePath[sizeof(capturePath) - 1] = '\0';
+            break;
+        }
+    }
+
+    if (capturePath[0] == '\0') {
+        DEBUG_PRINTLN("PacketCapture: ❌ Keine freie Capture-Datei!");
+        return false;
+    }
+
+    // Datei-Header schreiben
+    CaptureFileHeader header = {};
+    memcpy(header.magic, CAPTURE_MAGIC, 4);
+    header.version = CAPTURE_VERSION;
+    header.headerSize = sizeof(CaptureFileHeader);
+    if (espNow) {
+        espNow->getOwnMac(header.ownMac);
+    }
+    captureStartUs = esp_timer_get_time();
+    header.startUs = captureStartUs;
+
+    if (!sdHandler->writeBinaryFile(capturePath, (const uint8_t*)&header, sizeof(header))) {
+        DEBUG_PRINTF("PacketCapture: ❌ Datei %s nicht schreibbar!\n", capturePath);
+        return false;
+    }
+
+    ringHead = 0;
+    ringTail = 0;
+    framesCaptured = 0;
+    framesDropped = 0;
+    bytesWritten = sizeof(header);
+    writeErrors = 0;
+    lastFlush = millis();
+    capturing = true;
+
+    ESPNowManager::setCaptureHook(captureHook);
+
+    DEBUG_PRINTF("PacketCapture: ✅ Aufzeichnung gestartet: %s\n", capturePath);
+    return true;
+}
+
+void PacketCapture::stopCapture() {
+    if (!capturing) return;
+
+    ESPNowManager::setCaptureHook(nullptr);
+    capturing = false;
+
+    flush(true);
+
+    DEBUG_PRINTF("PacketCapture: Aufzeichnung beendet (%lu Frames, %lu verworfen, %lu Bytes)\n",
+                 framesCaptured, framesDropped, bytesWritten);
+}
+
+void PacketCapture::captureHook(bool tx, const uint8_t* mac, const uint8_t* data, size_t len,
+                                int8_t rssi, int64_t timeUs) {
+    if (instance) {
+        instance->pushRecord(tx, mac, data, len, rssi, timeUs);
+    }
+}
+
+void PacketCapture::pushRecord(bool tx, const uint8_t* mac, const uint8_t* data, size_t len,
+                               int8_t rssi, int64_t timeUs) {
+    if (!ring || !mac || !data || len > ESPNOW_MAX_PACKET_SIZE) return;
+
+    CaptureRecordHeader header;
+    header.timeUs = (uint32_t)(timeUs - captureStartUs);
+    header.flags = tx ? CAPTURE_FLAG_TX : 0;
+    header.rssi = rssi;
+    memcpy(header.mac, mac, 6);
+    header.length = (uint8_t)len;
+
+    const uint32_t total = sizeof(header) + len;
+    const uint32_t mask = CAPTURE_RING_SIZE - 1;
+
+    // RX (WiFi-Task) und TX (Main-Thread) schreiben konkurrierend
+    portENTER_CRITICAL_SAFE(&ringLock);
+
+    if (CAPTURE_RING_SIZE - (ringHead - ringTail) < total) {
+        framesDropped++;
+        portEXIT_CRITICAL_SAFE(&ringLock);
+        return;
+    }
+
+    uint32_t pos = ringHead;
+    const uint8_t* src = (const uint8_t*)&header;
+    for (size_t i = 0; i < sizeof(header); i++) {
+        ring[(pos++) & mask] = src[i];
+    }
+    for (size_t i = 0; i < len; i++) {
+        ring[(pos++) & mask] = data[i];
+    }
+
+    ringHead = pos;
+    framesCaptured++;
+
+    portEXIT_CRITICAL_SAFE(&ringLock);
+}
+
+void PacketCapture::flush(bool force) {
+    if (!ring || !sdHandler) return;
+
+    uint32_t used = ringHead - ringTail;
+    if (used == 0) return;
+
+    // Gebündelt schreiben: erst ab Schwelle oder nach Intervall
+    if (!force && used < CAPTURE_FLUSH_THRESHOLD &&
+        millis() - lastFlush < CAPTURE_FLUSH_INTERVAL_MS) {
+        return;
+    }
+
+    lastFlush = millis();
+    const uint32_t mask = CAPTURE_RING_SIZE - 1;
+
+    while (used > 0) {
+        uint32_t chunk = min(used, (uint32_t)CAPTURE_STAGING_SIZE);
+        uint32_t start = ringTail & mask;
+
+        // Bereich hinter ringTail wird vom Schreiber nicht angefasst
+        uint32_t first = min(chunk, (uint32_t)CAPTURE_RING_SIZE - start);
+        memcpy(stagingBuffer, ring + start, first);
+        if (chunk > first) {
+            memcpy(stagingBuffer + first, ring, chunk - first);
+        }
+
+        portENTER_CRITICAL(&ringLock);
+        ringTail += chunk;
+        portEXIT_CRITICAL(&ringLock);
+
+        if (sdHandler->appendBinaryFile(capturePath, stagingBuffer, chunk)) {
+            bytesWritten += chunk;
+        } else {
+            writeErrors++;
+        }
+
+        used -= chunk;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// REPLAY
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool PacketCapture::startReplay(const char* path, uint16_t speed) {
+    if (!path || !espNow || !stagingBuffer || !sdHandler || !sdHandler->isAvailable()) {
+        return false;
+    }
+
+    if (capturing) {
+        DEBUG_PRINTLN("PacketCapture: ❌ Aufzeichnung aktiv!");
+        return false;
+    }
+
+    stopReplay();
+
+    CaptureFileHeader header;
+    if (sdHandler->readBinaryAt(path, 0, (uint8_t*)&header, sizeof(header)) != (int)sizeof(header) ||
+        memcmp(header.magic, CAPTURE_MAGIC, 4) != 0 ||
+        header.version != CAPTURE_VERSION) {
+        DEBUG_PRINTF("PacketCapture: ❌ Ungültige Capture-Datei: %s\n", path);
+        return false;
+    }
+
+    strncpy(replayPath, path, sizeof(replayPath) - 1);
+    replayPath[sizeof(replayPath) - 1] = '\0';
+    replaySpeed = speed;
+    replayFileSize = sdHandler->getFileSize(path);
+    replayOffset = header.headerSize;
+    replayBufStart = 0;
+    replayBufLen = 0;
+    replayStartUs = esp_timer_get_time();
+    replayFirstUs = -1;
+    replayLastRawUs = 0;
+    replayTimeBaseUs = 0;
+    replayInjected = 0;
+    replaySkipped = 0;
+    replaying = true;
+
+    DEBUG_PRINTF("PacketCapture: ▶️ Replay %s (%u Bytes, Speed %s%u)\n",
+                 replayPath, replayFileSize, speed ? "x" : "max", speed);
+    return true;
+}
+
+void PacketCapture::stopReplay() {
+    if (!replaying) return;
+
+    replaying = false;
+
+    DEBUG_PRINTF("PacketCapture: ⏹️ Replay beendet (%lu eingespeist, %lu TX übersprungen)\n",
+                 replayInjected, replaySkipped);
+}
+
+const uint8_t* PacketCapture::replayFetch(size_t offset, size_t len) {
+    // Bereits im Lesepuffer?
+    if (offset >= replayBufStart && offset + len <= replayBufStart + replayBufLen) {
+        return stagingBuffer + (offset - replayBufStart);
+    }
+
+    // Lesepuffer ab offset neu füllen (ein SD-Zugriff für viele Records)
+    int bytesRead = sdHandler->readBinaryAt(replayPath, offset, stagingBuffer, CAPTURE_STAGING_SIZE);
+    if (bytesRead <= 0) {
+        replayBufLen = 0;
+        return nullptr;
+    }
+
+    replayBufStart = offset;
+    replayBufLen = bytesRead;
+
+    return (len <= replayBufLen) ? stagingBuffer : nullptr;
+}
+
+void PacketCapture::processReplay() {
+    int64_t elapsedUs = (esp_timer_get_time() - replayStartUs) * replaySpeed;
+
+    // Pro Durchlauf höchstens eine Queue-Füllung einspeisen
+    for (int n = 0; n < ESPNOW_RX_QUEUE_SIZE; n++) {
+        if (replayOffset + sizeof(CaptureRecordHeader) > replayFileSize) {
+            stopReplay();
+            return;
+        }
+
+        const uint8_t* raw = replayFetch(replayOffset, sizeof(CaptureRecordHeader));
+        if (!raw) {
+            stopReplay();
+            return;
+        }
+
+        CaptureRecordHeader header;
+        memcpy(&header, raw, sizeof(header));
+
+        size_t total = sizeof(header) + header.length;
+        raw = replayFetch(replayOffset, total);
+        if (!raw) {
+            // Abgeschnittener Record am Dateiende
+            stopReplay();
+            return;
+        }
+
+        // 32-Bit Zeitstempel entfalten
+        if (header.timeUs < replayLastRawUs) {
+            replayTimeBaseUs += 0x100000000ULL;
+        }
+        replayLastRawUs = header.timeUs;
+        int64_t recordUs = (int64_t)(replayTimeBaseUs + header.timeUs);
+
+        if (replayFirstUs < 0) {
+            replayFirstUs = recordUs;
+        }
+
+        // Noch nicht fällig (Speed 0 = sofort)
+        // Erneutes Lesen desselben Records entfaltet nicht doppelt (timeUs == replayLastRawUs)
+        if (replaySpeed > 0 && recordUs - replayFirstUs > elapsedUs) {
+            return;
+        }
+
+        if (header.flags & CAPTURE_FLAG_TX) {
+            replaySkipped++;
+        } else if (!espNow->injectRx(header.mac, raw + sizeof(header), header.length)) {
+            // Queue voll: im nächsten Durchlauf erneut versuchen
+            return;
+        } else {
+            replayInjected++;
+        }
+
+        replayOffset += total;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// UPDATE & STATUS
+// ═══════════════════════════════════════════════════════════════════════════
+
+void PacketCapture::update() {
+    if (capturing) {
+        flush(false);
+    }
+
+    if (replaying) {
+        processReplay();
+    }
+}
+
+void PacketCapture::printInfo() {
+    DEBUG_PRINTLN("\n╔════════════════════════════════════════╗");
+    DEBUG_PRINTLN("║       PACKET CAPTURE INFO              ║");
+    DEBUG_PRINTLN("╚════════════════════════════════════════╝");
+    DEBUG_PRINTF("Aufzeichnung:   %s\n", capturing ? "AKTIV" : "AUS");
+    if (capturePath[0]) {
+        DEBUG_PRINTF("Datei:          %s\n", capturePath);
+    }
+    DEBUG_PRINTF("Frames:         %lu (verworfen: %lu)\n", framesCaptured, framesDropped);
+    DEBUG_PRINTF("Geschrieben:    %lu Bytes (Fehler: %lu)\n", bytesWritten, writeErrors);
+    DEBUG_PRINTF("Ringpuffer:     %lu / %u Bytes\n", (unsigned long)(ringHead - ringTail), CAPTURE_RING_SIZE);
+    DEBUG_PRINTF("Replay:         %s\n", replaying ? "AKTIV" : "AUS");
+    if (replayPath[0]) {
+        DEBUG_PRINTF("Replay-Datei:   %s (%u / %u Bytes)\n", replayPath, replayOffset, replayFileSize);
+        DEBUG_PRINTF("Eingespeist:    %lu (TX übersprungen: %lu)\n", replayInjected, replaySkipped);
+    }
+    DEBUG_PRINTLN("────────────────────────────────────────");
+}
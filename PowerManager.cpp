@@ -58,6 +58,11 @@ void PowerManager::sleep(WakeSource wakeSource, uint32_t timerSeconds, gpio_num_
         log->logf(LogLevel::LOG_INFO, "POWER", "Entering sleep mode");
     }
     
+    // Ladezustand sichern (Coulomb-Zählung über den Neustart retten)
+    if (battery) {
+        battery->saveState();
+    }
+    
     // Before-Sleep Callback
     if (beforeSleepCallback != nullptr) {
         DEBUG_PRINTLN("[PowerManager] Führe Before-Sleep Callback aus...");
@@ -96,6 +101,11 @@ void PowerManager::restart() {
         log->logf(LogLevel::LOG_INFO, "POWER", "System restart");
     }
     
+    // Ladezustand sichern (Coulomb-Zählung über den Neustart retten)
+    if (battery) {
+        battery->saveState();
+    }
+    
     // Before-Sleep Callback
     if (beforeSleepCallback != nullptr) {
         beforeSleepCallback();
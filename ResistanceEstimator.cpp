@@ -0,0 +1,110 @@
+/**
+ * ResistanceEstimator.cpp
+ *
+ * Implementation der Innenwiderstands-Schätzung
+ */
+
+#include "include/ResistanceEstimator.h"
+#include <esp_rom_crc.h>
+#include <stddef.h>
+
+ResistanceEstimator::ResistanceEstimator()
+    : sdHandler(nullptr)
+    , savedResistance(BATTERY_INTERNAL_R)
+    , lastSaveTime(0)
+    , agingReported(false)
+{
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INITIALISIERUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+void ResistanceEstimator::begin(SDCardHandler* sd) {
+    sdHandler = sd;
+
+    ResistanceState state;
+    bool fromFile = load(state);
+    if (fromFile) {
+        core.seed(state.resistance, state.measurements, millis());
+    } else {
+        core.seed(BATTERY_INTERNAL_R, 0, millis());
+    }
+
+    savedResistance = core.getResistance();
+    lastSaveTime = millis();
+
+    DEBUG_PRINTF("ResistanceEstimator: ✅ %.0f mΩ (%s, %lu Messungen)\n",
+                 core.getResistance() * 1000.0f, fromFile ? "gesichert" : "Nennwert", core.getMeasurements());
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// MESSUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool ResistanceEstimator::addSample(float voltage, float current, unsigned long nowMs) {
+    if (!core.addSample(voltage, current, nowMs)) return false;
+
+    float resistance = core.getResistance();
+    if (isAging() && !agingReported) {
+        DEBUG_PRINTF("ResistanceEstimator: ⚠️ Innenwiderstand %.0f mΩ (Nennwert %.0f mΩ) - Akku gealtert?\n",
+                     resistance * 1000.0f, BATTERY_INTERNAL_R * 1000.0f);
+        agingReported = true;
+    }
+
+    if (fabsf(resistance - savedResistance) >= IR_SAVE_DELTA && millis() - lastSaveTime >= IR_SAVE_INTERVAL_MS) {
+        save();
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SICHERUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+void ResistanceEstimator::save() {
+    if (!sdHandler || !sdHandler->isAvailable()) return;
+
+    if (!sdHandler->fileExists(BATTERY_STATE_DIR)) {
+        sdHandler->createDir(BATTERY_STATE_DIR);
+    }
+
+    ResistanceState state = {};
+    state.magic = IR_STATE_MAGIC;
+    state.resistance = core.getResistance();
+    state.measurements = core.getMeasurements();
+    state.crc = esp_rom_crc32_le(0, (const uint8_t*)&state, offsetof(ResistanceState, crc));
+
+    if (sdHandler->writeBinaryFile(IR_STATE_FILE, (const uint8_t*)&state, sizeof(state))) {
+        savedResistance = state.resistance;
+        lastSaveTime = millis();
+    }
+}
+
+bool ResistanceEstimator::load(ResistanceState& state) {
+    if (!sdHandler || !sdHandler->isAvailable() || !sdHandler->fileExists(IR_STATE_FILE)) {
+        return false;
+    }
+
+    if (sdHandler->readBinaryFile(IR_STATE_FILE, (uint8_t*)&state, sizeof(state)) != (int)sizeof(state)) {
+        return false;
+    }
+
+    if (state.magic != IR_STATE_MAGIC ||
+        state.crc != esp_rom_crc32_le(0, (const uint8_t*)&state, offsetof(ResistanceState, crc)) ||
+        !(state.resistance >= IR_MIN_OHM && state.resistance <= IR_MAX_OHM)) {
+        DEBUG_PRINTLN("ResistanceEstimator: ⚠️ Gesicherter Wert ungültig - verworfen");
+        return false;
+    }
+    return true;
+}
+
+void ResistanceEstimator::printInfo() const {
+    DEBUG_PRINTF("Innenwiderstand: %.0f mΩ (%lu Messungen, %lu verworfen, letzte %.0f mΩ)\n",
+                 core.getResistance() * 1000.0f, core.getMeasurements(), core.getRejected(),
+                 core.getLastMeasurement() * 1000.0f);
+    if (isAging()) {
+        DEBUG_PRINTF("              ⚠️ über %.0f mΩ - Akku gealtert?\n",
+                     BATTERY_INTERNAL_R * IR_AGING_FACTOR * 1000.0f);
+    }
+}
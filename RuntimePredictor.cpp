@@ -0,0 +1,83 @@
+/**
+ * RuntimePredictor.cpp
+ *
+ * Implementation der Restlaufzeit-Prognose
+ */
+
+#include "include/RuntimePredictor.h"
+#include "include/SocEstimator.h"
+
+RuntimePredictor::RuntimePredictor()
+    : predictedPower(0.0f)
+    , dutyCycle(0.0f)
+    , remainingWh(0.0f)
+    , shutdownPercent(0.0f)
+    , deratePercent(0.0f)
+    , driveCurrent(0.0f)
+    , secondsToEmpty(RUNTIME_UNKNOWN)
+    , secondsToShutdown(RUNTIME_UNKNOWN)
+    , secondsToDerate(RUNTIME_UNKNOWN)
+{
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PROGNOSE
+// ═══════════════════════════════════════════════════════════════════════════
+
+void RuntimePredictor::update(float power, float voltage, bool driving,
+                              float socPercent, uint16_t capacityMah, float internalR) {
+    if (power < 0.0f) power = 0.0f;
+
+    // Leistung je Betriebsart, Gewichtung mit dem Fahranteil
+    dutyCycle = duty.update(driving ? 1.0f : 0.0f);
+    if (driving) {
+        drivePower.update(power);
+    } else {
+        idlePower.update(power);
+    }
+    float pDrive = drivePower.getCount() ? drivePower.get() : power;
+    float pIdle = idlePower.getCount() ? idlePower.get() : power;
+    predictedPower = dutyCycle * pDrive + (1.0f - dutyCycle) * pIdle;
+
+    // Abschaltung nach Spannung ohne Last (U + I·R, Lasteinbrüche lösen sie nicht aus)
+    shutdownPercent = SocEstimator::ocvToPercent(VOLTAGE_SHUTDOWN);
+
+    // Vorher greift beim Fahren der SagGuard: Ruhespannung minus Fahrstrom × R
+    driveCurrent = voltage > 1.0f ? pDrive / voltage : 0.0f;
+    deratePercent = SocEstimator::ocvToPercent(SAG_SOFT_MV / 1000.0f + driveCurrent * internalR);
+
+    float capacityAh = capacityMah / 1000.0f;
+    float loadVoltage = voltage > 1.0f ? predictedPower / voltage * internalR : 0.0f;
+
+    remainingWh = energyAbove(socPercent, 0.0f, capacityAh, loadVoltage);
+    secondsToEmpty = toSeconds(remainingWh, predictedPower);
+    secondsToShutdown = toSeconds(energyAbove(socPercent, shutdownPercent, capacityAh, loadVoltage),
+                                  predictedPower);
+    secondsToDerate = toSeconds(energyAbove(socPercent, deratePercent, capacityAh, loadVoltage),
+                                predictedPower);
+}
+
+float RuntimePredictor::energyAbove(float socPercent, float floorPercent, float capacityAh, float loadVoltage) {
+    float span = socPercent > floorPercent ? socPercent - floorPercent : 0.0f;
+    float wh = span / 100.0f * capacityAh *
+               (SocEstimator::percentToOcv(floorPercent + span / 2.0f) - loadVoltage);
+    return wh > 0.0f ? wh : 0.0f;
+}
+
+uint32_t RuntimePredictor::toSeconds(float wh, float watts) {
+    if (watts < RUNTIME_MIN_POWER) return RUNTIME_UNKNOWN;
+    return (uint32_t)(wh / watts * 3600.0f + 0.5f);
+}
+
+void RuntimePredictor::printInfo() const {
+    if (secondsToEmpty == RUNTIME_UNKNOWN) {
+        DEBUG_PRINTF("Restlaufzeit: unbekannt (Leistung < %.1f W)\n", RUNTIME_MIN_POWER);
+    } else {
+        DEBUG_PRINTF("Restlaufzeit: %lu min bis leer, %lu min bis Abschaltung (%.1f%%), "
+                     "%lu min bis Drosselung (%.1f%% bei %.1f A)\n",
+                     secondsToEmpty / 60, secondsToShutdown / 60, shutdownPercent,
+                     secondsToDerate / 60, deratePercent, driveCurrent);
+    }
+    DEBUG_PRINTF("Prognose:     %.1f W (Fahrt %.1f W × %.0f%%, Stand %.1f W), Rest %.1f Wh\n",
+                 predictedPower, drivePower.get(), dutyCycle * 100.0f, idlePower.get(), remainingWh);
+}
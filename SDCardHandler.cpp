@@ -237,6 +237,80 @@ int SDCardHandler::readBinaryFile(const char* path, uint8_t* buffer, size_t maxL
     return bytesRead;
 }
 
+bool SDCardHandler::appendBinaryFile(const char* path, const uint8_t* data, size_t len) {
+    if (!mounted || !data) return false;
+    
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        return false;
+    }
+    
+    File file = SD.open(path, FILE_APPEND);
+    if (!file) {
+        xSemaphoreGive(mutex);
+        return false;
+    }
+    
+    size_t written = file.write(data, len);
+    file.close();
+    
+    xSemaphoreGive(mutex);
+    return written == len;
+}
+
+int SDCardHandler::readBinaryAt(const char* path, size_t offset, uint8_t* buffer, size_t len) {
+    if (!mounted || !buffer) return -1;
+    
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        return -1;
+    }
+    
+    File file = SD.open(path, FILE_READ);
+    if (!file) {
+        xSemaphoreGive(mutex);
+        return -1;
+    }
+    
+    if (offset >= file.size() || !file.seek(offset)) {
+        file.close();
+        xSemaphoreGive(mutex);
+        return 0;
+    }
+    
+    size_t bytesRead = file.read(buffer, len);
+    
+    file.close();
+    xSemaphoreGive(mutex);
+    
+    return bytesRead;
+}
+
+bool SDCardHandler::writeBinaryAt(const char* path, size_t offset, const uint8_t* data, size_t len) {
+    if (!mounted || !data) return false;
+    
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        return false;
+    }
+    
+    // "r+": bestehende Datei ohne Kürzen öffnen
+    File file = SD.open(path, "r+");
+    if (!file) {
+        xSemaphoreGive(mutex);
+        return false;
+    }
+    
+    if (offset > file.size() || !file.seek(offset)) {
+        file.close();
+        xSemaphoreGive(mutex);
+        return false;
+    }
+    
+    size_t written = file.write(data, len);
+    file.close();
+    
+    xSemaphoreGive(mutex);
+    return written == len;
+}
+
 bool SDCardHandler::deleteFile(const char* path) {
     if (!mounted) return false;
     
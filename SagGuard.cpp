@@ -0,0 +1,94 @@
+/**
+ * SagGuard.cpp
+ *
+ * Implementation des Spannungseinbruch-Wächters
+ */
+
+#include "include/SagGuard.h"
+
+SagGuard::SagGuard()
+    : filteredQ4(0)
+    , scaleQ8(SCALE_ONE)
+    , sagging(false)
+    , sagSinceUs(0)
+{
+    resetStats();
+}
+
+uint16_t SagGuard::update(int32_t voltageMv, uint32_t nowUs) {
+    stats.samples++;
+    if (voltageMv < stats.minMv) stats.minMv = voltageMv;
+
+    // IIR: y += (x - y) / 2^shift, erster Wert nach idle() setzt den Zustand
+    if (filteredQ4 == 0) {
+        filteredQ4 = voltageMv << 4;
+    } else {
+        filteredQ4 += ((voltageMv << 4) - filteredQ4) >> SAG_FILTER_SHIFT;
+    }
+    int32_t filtered = filteredQ4 >> 4;
+    stats.filteredMv = filtered;
+
+    // ═══════════════════════════════════════════════════════════════════
+    // Soll-Faktor: 1.0 über SAG_SOFT_MV, linear bis SAG_MIN_SCALE am Boden
+    // ═══════════════════════════════════════════════════════════════════
+    int32_t target = SCALE_ONE;
+    if (filtered < SAG_SOFT_MV) {
+        int32_t band = SAG_SOFT_MV - SAG_FLOOR_MV;
+        int32_t under = SAG_SOFT_MV - filtered;
+        if (band <= 0 || under >= band) {
+            target = SAG_MIN_SCALE;
+        } else {
+            target = SCALE_ONE - under * (SCALE_ONE - SAG_MIN_SCALE) / band;
+        }
+    }
+
+    // Sofort drosseln, langsam freigeben
+    if (target < scaleQ8) {
+        if (scaleQ8 == SCALE_ONE) stats.sagEvents++;
+        scaleQ8 = (uint16_t)target;
+    } else if (scaleQ8 < target) {
+        int32_t next = scaleQ8 + SAG_RELEASE;
+        scaleQ8 = (uint16_t)(next > target ? target : next);
+    }
+
+    if (scaleQ8 < stats.minScaleQ8) stats.minScaleQ8 = scaleQ8;
+    stats.scaleQ8 = scaleQ8;
+
+    // ═══════════════════════════════════════════════════════════════════
+    // Dauer des Einbruchs (gefiltert unter SAG_SOFT_MV)
+    // ═══════════════════════════════════════════════════════════════════
+    if (!sagging && filtered < SAG_SOFT_MV) {
+        sagging = true;
+        sagSinceUs = nowUs;
+    } else if (sagging && filtered >= SAG_SOFT_MV) {
+        sagging = false;
+        uint32_t duration = nowUs - sagSinceUs;
+        stats.lastSagUs = duration;
+        if (duration > stats.maxSagUs) stats.maxSagUs = duration;
+    }
+
+    return scaleQ8;
+}
+
+void SagGuard::idle() {
+    filteredQ4 = 0;
+    scaleQ8 = SCALE_ONE;
+    sagging = false;
+    stats.filteredMv = 0;
+    stats.scaleQ8 = scaleQ8;
+}
+
+SagGuardStats SagGuard::getStats() const {
+    return stats;
+}
+
+void SagGuard::resetStats() {
+    stats.samples = 0;
+    stats.sagEvents = 0;
+    stats.filteredMv = filteredQ4 >> 4;
+    stats.minMv = INT32_MAX;
+    stats.scaleQ8 = scaleQ8;
+    stats.minScaleQ8 = SCALE_ONE;
+    stats.lastSagUs = 0;
+    stats.maxSagUs = 0;
+}
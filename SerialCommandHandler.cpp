@@ -4,6 +4,14 @@
 
 #include "include/SerialCommandHandler.h"
 #include "include/setupConf.h"
+#include "include/PacketCapture.h"
+#include "include/BlackBox.h"
+#include "include/TrajectoryPlayer.h"
+#include "include/BatteryHistory.h"
+#include "include/SteeringKernel.h"
+#include "include/MotorController.h"
+
+extern MotorController motorCtrl;
 
 SerialCommandHandler::SerialCommandHandler() 
     : sdHandler(nullptr), logger(nullptr), battery(nullptr), 
@@ -171,11 +179,38 @@ void SerialCommandHandler::processCommand(const String& cmd) {
         }
     }
     else if (command == "battery") {
-        handleBattery();
+        handleBattery(args);
+    }
+    else if (command == "history") {
+        handleHistory(args);
     }
     else if (command == "espnow") {
         handleESPNow();
     }
+    else if (command == "timesync") {
+        handleTimeSync(args);
+    }
+    else if (command == "capture") {
+        handleCapture(args);
+    }
+    else if (command == "blackbox") {
+        handleBlackBox(args);
+    }
+    else if (command == "traj") {
+        handleTrajectory(args);
+    }
+    else if (command == "crypto") {
+        handleCrypto(args);
+    }
+    else if (command == "ota") {
+        handleOta(args);
+    }
+    else if (command == "steer") {
+        handleSteer(args);
+    }
+    else if (command == "motor") {
+        handleMotor(args);
+    }
     else {
         Serial.printf("❌ Unbekannter Befehl: '%s'\n", command.c_str());
         Serial.println("   Tippe 'help' für Befehlsliste");
@@ -207,8 +242,37 @@ void SerialCommandHandler::handleHelp() {
     Serial.println();
     Serial.println("ℹ️  SYSTEM-BEFEHLE:");
     Serial.println("  sysinfo               - System-Informationen");
-    Serial.println("  battery               - Battery-Status");
+    Serial.println("  battery               - Battery-Status & Restlaufzeit");
+    Serial.println("  battery cal low|high <mV> - Spannung mit Multimeter-Wert korrigieren");
+    Serial.println("  battery cal off       - Spannungs-Korrektur löschen");
+    Serial.println("  battery adc           - eFuse-Kennlinie als CSV (raw,mv)");
+    Serial.println("  history               - Akku-Verlauf Status (Ringspeicher auf SD)");
+    Serial.println("  history <s|m|h> [n]   - Letzte n Sekunden/Minuten/Stunden");
+    Serial.println("  history <s|m|h> n k   - n Intervalle, die neuesten k überspringen");
     Serial.println("  espnow                - ESP-NOW Status");
+    Serial.println("  timesync [reset]      - Zeitsync & Latenz (reset = Statistik löschen)");
+    Serial.println("  crypto                - Verschlüsselungs-Status");
+    Serial.println("  crypto bench [n]      - AES-CCM Kosten pro Frame messen");
+    Serial.println("  ota [abort]           - Firmware-Update Status / abbrechen");
+    Serial.println("  steer [n]             - Steering-Kernel prüfen & Zyklen messen (vs. Float)");
+    Serial.println("  motor [reset]         - Motor-Status & Regel-Takt (reset = Statistik löschen, Encoder-Fehler quittieren)");
+    Serial.println("  motor wdtest [ms]     - Watchdog unter SD-Last messen (Motoren laufen an!)");
+    Serial.println();
+    Serial.println("📼 CAPTURE-BEFEHLE:");
+    Serial.println("  capture               - Capture-Status anzeigen");
+    Serial.println("  capture start         - ESP-NOW Mitschnitt starten");
+    Serial.println("  capture stop          - Mitschnitt/Replay beenden");
+    Serial.println("  capture replay <f> [x]- Datei einspeisen (x = Speed, 0 = max)");
+    Serial.println("  blackbox              - Fahrtenschreiber-Status & Aufwand pro Record");
+    Serial.println("  blackbox dump         - Letzte Sekunden auf SD sichern (/blackbox)");
+    Serial.println();
+    Serial.println("🎬 TRAJECTORY-BEFEHLE:");
+    Serial.println("  traj                  - Wiedergabe-Status anzeigen");
+    Serial.println("  traj load <f>         - Verlauf laden (/traj, Text: t_ms links% rechts%)");
+    Serial.println("  traj play [n]         - Verlauf n-mal fahren (0 = endlos, Remote muss senden!)");
+    Serial.println("  traj rec              - Live-Sollwerte aufzeichnen");
+    Serial.println("  traj save <f>         - Verlauf auf SD speichern");
+    Serial.println("  traj stop             - Wiedergabe/Aufzeichnung beenden");
     Serial.println();
     Serial.println("❓ HILFE:");
     Serial.println("  help                  - Diese Hilfe anzeigen");
@@ -389,18 +453,207 @@ void SerialCommandHandler::handleSysInfo() {
     printSeparator();
 }
 
-void SerialCommandHandler::handleBattery() {
+void SerialCommandHandler::handleBattery(const String& args) {
     if (!battery) {
         Serial.println("❌ BatteryMonitor nicht verfügbar");
         return;
     }
     
+    int spaceIdx = args.indexOf(' ');
+    String subCmd = (spaceIdx > 0) ? args.substring(0, spaceIdx) : args;
+    String subArgs = (spaceIdx > 0) ? args.substring(spaceIdx + 1) : "";
+    subCmd.toLowerCase();
+    subArgs.trim();
+    
+    if (subCmd == "cal") {
+        handleBatteryCal(subArgs);
+        return;
+    }
+    if (subCmd == "adc") {
+        if (!battery->printAdcCurve(Serial)) {
+            Serial.println("❌ Keine eFuse-Kalibrierung (lineare Kennlinie)");
+        }
+        return;
+    }
+    if (subCmd.length() > 0) {
+        Serial.printf("❌ Unbekannter battery Befehl: '%s'\n", subCmd.c_str());
+        Serial.println("   Gültig: cal, adc");
+        return;
+    }
+    
     printHeader("Battery Status");
     
     Serial.printf("Voltage:       %.2f V\n", battery->getVoltage());
-    Serial.printf("Percent:       %d %%\n", battery->getPercent());
+    SocEstimator& soc = battery->getSocEstimator();
+    Serial.printf("Percent:       %d %% (SoC %.1f %%, OCV %.2f V%s)\n", battery->getPercent(),
+                 soc.getSoc(), soc.getOcvVoltage(), soc.isResting() ? ", Ruhe" : "");
+    if (config) {
+        Serial.printf("Consumed:      %.0f mAh / %u mAh\n", battery->getConsumedMAh(),
+                     config->getBatteryCapacity());
+    }
+    const ResistanceEstimator& ir = battery->getResistanceEstimator();
+    Serial.printf("Resistance:    %.0f mΩ (%lu Lastsprünge, %lu verworfen)%s\n",
+                 ir.getResistance() * 1000.0f, ir.getMeasurements(), ir.getRejected(),
+                 ir.isAging() ? " ⚠️ Akku gealtert?" : "");
+    const RuntimePredictor& runtime = battery->getRuntime();
+    if (runtime.getSecondsToEmpty() == RUNTIME_UNKNOWN) {
+        Serial.println("Runtime:       unbekannt (kein nennenswerter Verbrauch)");
+    } else {
+        Serial.printf("Runtime:       %lu:%02lu h bis leer, %lu:%02lu h bis Shutdown (%.2f V)\n",
+                     runtime.getSecondsToEmpty() / 3600, (runtime.getSecondsToEmpty() / 60) % 60,
+                     runtime.getSecondsToShutdown() / 3600, (runtime.getSecondsToShutdown() / 60) % 60,
+                     VOLTAGE_SHUTDOWN);
+        Serial.printf("               %lu:%02lu h bis Drosselung (%.1f %% bei %.1f A)\n",
+                     runtime.getSecondsToDerate() / 3600, (runtime.getSecondsToDerate() / 60) % 60,
+                     runtime.getDeratePercent(), runtime.getDriveCurrent());
+    }
+    Serial.printf("Power:         %.1f W jetzt, %.1f W Prognose (Fahranteil %.0f %%)\n",
+                 battery->getPower(), runtime.getPredictedPower(), runtime.getDutyCycle() * 100.0f);
     Serial.printf("Low:           %s\n", battery->isLow() ? "JA" : "NEIN");
-    Serial.printf("Critical:      %s\n", battery->isCritical() ? "JA" : "NEIN");
+    Serial.printf("Critical:      %s (ohne Last %.2f V, Shutdown ≤ %.2f V für %d s)\n",
+                 battery->isCritical() ? "JA" : "NEIN", battery->getCompensatedVoltage(),
+                 VOLTAGE_SHUTDOWN, SAG_CONFIRM_MS / 1000);
+    Serial.printf("Current:       %.2f A\n", battery->getCurrent());
+    Serial.printf("Window V:      %.2f .. %.2f V\n", battery->getVoltageMin(), battery->getVoltageMax());
+    if (battery->isVoltageCorrected()) {
+        const AdcLinear& corr = battery->getVoltageCorrection();
+        Serial.printf("Korrektur V:   × %.4f %+ld mV (unkorrigiert %u mV)\n",
+                     corr.getGain(), corr.offset, battery->getUncorrectedMillivolts());
+    }
+    Serial.printf("ADC Kennlinie: %s\n", battery->getAdcConverter().getName());
+    Serial.printf("Window I:      %.2f .. %.2f A\n", battery->getCurrentMin(), battery->getCurrentMax());
+    
+    // ADC-Pipeline (Abtastrate, CPU-Kosten)
+    AdcSamplerStats adc = battery->getSampler().getStats();
+    if (adc.running) {
+        Serial.printf("ADC:           DMA %lu Hz, %lu Zyklen/Wert, CPU %lu.%lu %%\n",
+                     adc.sampleRateHz, adc.cyclesPerSample,
+                     adc.cpuLoadPermille / 10, adc.cpuLoadPermille % 10);
+        Serial.printf("ADC Frames:    %lu (max %lu Zyklen, Überlauf %lu)\n",
+                     adc.frames, adc.maxFrameCycles, adc.overflows);
+    } else {
+        Serial.println("ADC:           analogRead (DMA nicht aktiv)");
+    }
+    
+    printSeparator();
+}
+
+void SerialCommandHandler::handleBatteryCal(const String& args) {
+    if (!config) {
+        Serial.println("❌ UserConfig nicht verfügbar");
+        return;
+    }
+    
+    int spaceIdx = args.indexOf(' ');
+    String point = (spaceIdx > 0) ? args.substring(0, spaceIdx) : args;
+    point.toLowerCase();
+    
+    if (point == "off") {
+        config->setVoltCalLow(0, 0);
+        config->setVoltCalHigh(0, 0);
+        Serial.println("✅ Spannungs-Korrektur gelöscht");
+    } else if ((point == "low" || point == "high") && spaceIdx > 0) {
+        long refMv = args.substring(spaceIdx + 1).toInt();
+        if (refMv <= 0 || refMv > 30000) {
+            Serial.println("❌ Fehler: Multimeter-Wert in mV (1-30000)");
+            return;
+        }
+        // Bezug ist die unkorrigierte, gefilterte Spannung (Akku in Ruhe messen)
+        uint16_t rawMv = battery->getUncorrectedMillivolts();
+        if (point == "low") {
+            config->setVoltCalLow(rawMv, (uint16_t)refMv);
+        } else {
+            config->setVoltCalHigh(rawMv, (uint16_t)refMv);
+        }
+        Serial.printf("✅ voltCal%s: %u mV angezeigt -> %ld mV gemessen\n",
+                     point == "low" ? "Low" : "High", rawMv, refMv);
+    } else {
+        Serial.println("❌ Verwendung: battery cal low|high <mV> | battery cal off");
+        Serial.println("   Ein Punkt: nur Faktor, zwei Punkte (≥ 1 V Abstand): Faktor + Offset");
+        return;
+    }
+    
+    Serial.println("⚠️  Config noch nicht gespeichert!");
+    Serial.println("   Tippe 'config save' zum Speichern");
+}
+
+void SerialCommandHandler::handleHistory(const String& args) {
+    static const char* tierNames[] = { "Sekunden", "Minuten", "Stunden" };
+    static const uint32_t defaultCount[] = { 60, 60, 24 };
+    
+    int spaceIdx = args.indexOf(' ');
+    String subCmd = (spaceIdx > 0) ? args.substring(0, spaceIdx) : args;
+    String subArgs = (spaceIdx > 0) ? args.substring(spaceIdx + 1) : "";
+    subCmd.toLowerCase();
+    subArgs.trim();
+    
+    if (subCmd.length() == 0 || subCmd == "status") {
+        batteryHistory.printInfo();
+        return;
+    }
+    
+    uint8_t tier;
+    if (subCmd == "s") tier = 0;
+    else if (subCmd == "m") tier = 1;
+    else if (subCmd == "h") tier = 2;
+    else {
+        Serial.printf("❌ Unbekannter history Befehl: '%s'\n", subCmd.c_str());
+        Serial.println("   Gültig: status, s, m, h");
+        return;
+    }
+    
+    if (!batteryHistory.isReady()) {
+        Serial.println("❌ Akku-Verlauf nicht verfügbar (SD-Karte?)");
+        return;
+    }
+    
+    // Anzahl und zu überspringende neueste Intervalle
+    int countIdx = subArgs.indexOf(' ');
+    long count = (subArgs.length() > 0) ? subArgs.toInt() : (long)defaultCount[tier];
+    long skip = (countIdx > 0) ? subArgs.substring(countIdx + 1).toInt() : 0;
+    uint32_t slots = BatteryHistory::getSlots(tier);
+    if (count <= 0 || count > (long)slots) count = defaultCount[tier];
+    if (skip < 0) skip = 0;
+    
+    // Gepufferte Werte und offene Aggregate zuerst auf SD
+    batteryHistory.flush();
+    
+    char title[48];
+    snprintf(title, sizeof(title), "Akku-Verlauf (%s)", tierNames[tier]);
+    printHeader(title);
+    Serial.println("Betriebszeit   U min   avg   max [V]   I min   avg   max [A]       mAh       Wh");
+    
+    // Blockweise lesen, ältester Block zuerst
+    HistoryRecord records[32];
+    uint32_t remaining = (uint32_t)count;
+    uint32_t shown = 0;
+    uint64_t chargeUah = 0;
+    uint64_t energyUwh = 0;
+    
+    while (remaining > 0) {
+        uint32_t chunk = remaining < 32 ? remaining : 32;
+        uint32_t got = batteryHistory.read(tier, (uint32_t)skip + remaining - chunk, records, chunk);
+        
+        for (uint32_t i = 0; i < got; i++) {
+            const HistoryRecord& r = records[i];
+            if (r.samples == 0) continue;
+            
+            Serial.printf("%6lu:%02lu:%02lu  %5.2f %5.2f %5.2f      %5.2f %5.2f %5.2f     %9.1f %8.3f\n",
+                         r.time / 3600, (r.time / 60) % 60, r.time % 60,
+                         r.voltageMinMv / 1000.0f, r.voltageAvgMv / 1000.0f, r.voltageMaxMv / 1000.0f,
+                         r.currentMinMa / 1000.0f, r.currentAvgMa / 1000.0f, r.currentMaxMa / 1000.0f,
+                         r.chargeUah / 1000.0f, r.energyUwh / 1000000.0f);
+            chargeUah += r.chargeUah;
+            energyUwh += r.energyUwh;
+            shown++;
+        }
+        remaining -= chunk;
+    }
+    
+    Serial.println();
+    Serial.printf("Intervalle:    %lu von %ld (je %lu s)\n", shown, count, BatteryHistory::getPeriod(tier));
+    Serial.printf("Entnommen:     %.1f mAh, %.3f Wh\n", chargeUah / 1000.0f, energyUwh / 1000000.0f);
+    Serial.printf("Betriebszeit:  %lu s\n", batteryHistory.getTime());
     
     printSeparator();
 }
@@ -421,10 +674,469 @@ void SerialCommandHandler::handleESPNow() {
     
     Serial.println();
     Serial.printf("RX Queue:      %d\n", queuePending);
+    Serial.printf("Joystick RX:   %lu\n", espNow->getJoystickFramesReceived());
+    Serial.printf("Superseded:    %lu\n", espNow->getJoystickFramesSuperseded());
+    
+    printSeparator();
+}
+
+void SerialCommandHandler::handleTimeSync(const String& args) {
+    if (!espNow) {
+        Serial.println("❌ ESPNowManager nicht verfügbar");
+        return;
+    }
+    
+    if (args == "reset") {
+        espNow->resetLatencyStats();
+        Serial.println("✅ Latenz-Statistik zurückgesetzt");
+        return;
+    }
+    
+    const ClockSync& sync = espNow->getClockSync();
+    
+    printHeader("Zeitsynchronisation");
+    
+    Serial.printf("Synchronized:  %s\n", sync.isSynced() ? "JA" : "NEIN");
+    Serial.printf("Offset:        %lld us\n", sync.getOffsetUs());
+    Serial.printf("Drift:         %.2f ppm\n", sync.getDriftPpm());
+    Serial.printf("Delay (last):  %lld us\n", sync.getLastDelayUs());
+    Serial.printf("Delay (min):   %lld us\n", sync.getMinDelayUs());
+    Serial.printf("Samples:       %lu (rejected: %lu)\n", sync.getSampleCount(), sync.getRejectedCount());
+    Serial.printf("Clock steps:   %lu (re-seeded > %d us)\n", sync.getStepCount(), TIMESYNC_STEP_US);
+    if (sync.isSynced()) {
+        Serial.printf("Master Time:   %lld us\n", sync.getSyncedTimeUs());
+    }
+    
+    Serial.println();
+    Serial.printf("Latenz Joystick → Sollwert (PWM im nächsten Regel-Takt, + ≤ %d us):\n", MOTOR_TICK_US);
+    if (espNow->getLatencyCount() == 0) {
+        Serial.println("  Keine Messwerte (Sync + TIMESTAMP im Frame erforderlich)");
+    } else {
+        Serial.printf("  Last:        %lu us\n", espNow->getLatencyLastUs());
+        Serial.printf("  Min:         %lu us\n", espNow->getLatencyMinUs());
+        Serial.printf("  Max:         %lu us\n", espNow->getLatencyMaxUs());
+        Serial.printf("  Avg:         %lu us\n", espNow->getLatencyAvgUs());
+        Serial.printf("  Frames:      %lu\n", espNow->getLatencyCount());
+    }
+    
+    printSeparator();
+}
+
+void SerialCommandHandler::handleCrypto(const String& args) {
+    if (!espNow) {
+        Serial.println("❌ ESPNowManager nicht verfügbar");
+        return;
+    }
+    
+    if (args.startsWith("bench")) {
+        int iterations = args.substring(5).toInt();
+        if (iterations <= 0) iterations = 1000;
+        
+        printHeader("AES-CCM Benchmark");
+        Serial.printf("Iterationen:   %d\n", iterations);
+        Serial.println();
+        Serial.println("  Bytes     seal (us)   open (us)   gesamt (us)");
+        
+        // Joystick-Frame, typische Telemetrie, maximaler Frame
+        const size_t sizes[] = { 9, 32, CRYPTO_MAX_PLAINTEXT };
+        for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            float sealUs, openUs;
+            if (FrameCrypto::benchmark(sizes[i], iterations, sealUs, openUs)) {
+                Serial.printf("  %5u   %9.2f   %9.2f   %11.2f\n",
+                             sizes[i], sealUs, openUs, sealUs + openUs);
+            } else {
+                Serial.printf("  %5u   ❌ Benchmark fehlgeschlagen\n", sizes[i]);
+            }
+        }
+        
+        printSeparator();
+        return;
+    }
+    
+    const FrameCrypto& crypto = espNow->getCrypto();
+    
+    printHeader("Frame-Verschlüsselung");
+    
+    Serial.printf("Erzwungen:     %s\n", config && config->getEspnowEncrypt() ? "JA" : "NEIN");
+    Serial.printf("PSK:           %s\n", crypto.hasPsk() ? "gesetzt" : "FEHLT");
+    Serial.printf("Session:       %s\n", crypto.hasSession() ? "AKTIV" : "keine");
+    Serial.printf("Sealed:        %lu (last %lu us)\n", crypto.getSealCount(), crypto.getLastSealUs());
+    Serial.printf("Opened:        %lu (last %lu us, max %lu us)\n",
+                 crypto.getOpenCount(), crypto.getLastOpenUs(), crypto.getMaxOpenUs());
+    Serial.printf("Auth-Fehler:   %lu\n", crypto.getAuthFailures());
+    Serial.printf("Replays:       %lu\n", crypto.getReplayRejects());
+    Serial.printf("Pair rejects:  %lu (Tag falsch / Replay)\n", crypto.getPairRejects());
+    Serial.printf("Klartext abg.: %lu\n", espNow->getPlaintextRejected());
+    
+    printSeparator();
+}
+
+void SerialCommandHandler::handleOta(const String& args) {
+    if (!espNow) {
+        Serial.println("❌ ESPNowManager nicht verfügbar");
+        return;
+    }
+    
+    OtaReceiver& ota = espNow->getOta();
+    
+    if (args == "abort") {
+        if (!ota.isActive()) {
+            Serial.println("⚠️  Kein Firmware-Update aktiv");
+            return;
+        }
+        ota.abort();
+        Serial.println("⏹️  Firmware-Update abgebrochen");
+        return;
+    }
+    
+    ota.printInfo();
+}
+
+void SerialCommandHandler::handleSteer(const String& args) {
+    int iterations = args.toInt();
+    if (iterations <= 0) iterations = 10000;
+    
+    printHeader("Steering-Kernel");
+    
+    // Bitgenauer Vergleich gegen das Referenzmodell
+    uint32_t checked = 0;
+    uint32_t mismatches = SteeringKernel::selfTest(checked);
+    Serial.printf("Self-Test:     %lu Eingaben, %lu Abweichungen %s\n",
+                 checked, mismatches, mismatches == 0 ? "✅" : "❌");
+    
+    // Zyklen pro Kommando (Eingaben inkl. Normalisierung und Sättigung)
+    volatile uint32_t sink = 0;
+    SteeringOutput out;
+    
+    uint32_t start = ESP.getCycleCount();
+    for (int i = 0; i < iterations; i++) {
+        SteeringKernel::mix((int16_t)((i * 37) % 301 - 150), (int16_t)((i * 91) % 301 - 150), out);
+        sink += out.leftPWM + out.rightPWM;
+    }
+    uint32_t fastCycles = ESP.getCycleCount() - start;
+    
+    start = ESP.getCycleCount();
+    for (int i = 0; i < iterations; i++) {
+        SteeringKernel::mixReference((int16_t)((i * 37) % 301 - 150), (int16_t)((i * 91) % 301 - 150), out);
+        sink += out.leftPWM + out.rightPWM;
+    }
+    uint32_t refCycles = ESP.getCycleCount() - start;
+    
+    // Alter Float-Pfad als Vergleich (sqrtf ohne Hardware-Befehl auf dem Xtensa)
+    start = ESP.getCycleCount();
+    for (int i = 0; i < iterations; i++) {
+        SteeringKernel::mixFloat((int16_t)((i * 37) % 301 - 150), (int16_t)((i * 91) % 301 - 150), out);
+        sink += out.leftPWM + out.rightPWM;
+    }
+    uint32_t floatCycles = ESP.getCycleCount() - start;
+    (void)sink;
+    
+    Serial.printf("Iterationen:   %d\n", iterations);
+    Serial.printf("Festkomma:     %.1f Zyklen/Kommando\n", (float)fastCycles / iterations);
+    Serial.printf("Referenz:      %.1f Zyklen/Kommando\n", (float)refCycles / iterations);
+    Serial.printf("Float (alt):   %.1f Zyklen/Kommando (Festkomma %.2fx)\n",
+                 (float)floatCycles / iterations, (float)floatCycles / (fastCycles ? fastCycles : 1));
     
     printSeparator();
 }
 
+void SerialCommandHandler::handleMotor(const String& args) {
+    if (args == "reset") {
+        motorCtrl.resetTickStats();
+        Serial.println("✅ Tick-Statistik zurückgesetzt");
+        return;
+    }
+    
+    if (args.startsWith("wdtest")) {
+        String msArg = args.substring(6);
+        msArg.trim();
+        handleWatchdogTest(msArg.length() > 0 ? msArg.toInt() : 1000);
+        return;
+    }
+    
+    MotorTelemetry telemetry = motorCtrl.getTelemetry();
+    MotorTickStats stats = motorCtrl.getTickStats();
+    
+    printHeader("Motor-Status");
+    
+    Serial.printf("Enabled:       %s\n", telemetry.motorsEnabled ? "JA" : "NEIN");
+    Serial.printf("Links:         %4d %%  (PWM %3u)\n", telemetry.leftSpeed, telemetry.leftPWM);
+    Serial.printf("Rechts:        %4d %%  (PWM %3u)\n", telemetry.rightSpeed, telemetry.rightPWM);
+    if (config) {
+        Serial.printf("Rampe:         +%u %%/s, -%u %%/s\n", config->getMotorAccel(), config->getMotorDecel());
+    }
+    const ShapingParams& shaping = motorCtrl.getShaper().getParams();
+    Serial.printf("Shaping:       Deadzone %u %%, Expo %u %%, Trim L %u %% / R %u %%\n",
+                 shaping.deadzone, shaping.expo, shaping.trimLeft, shaping.trimRight);
+    Serial.printf("Min-PWM:       %u (Duty %lu, Tabellen-Rev. %lu)\n",
+                 shaping.minPwm, motorCtrl.getShaper().getDutyMin(), motorCtrl.getShaperRevision());
+    Serial.println();
+    Serial.printf("Regel-Takt:    %d Hz\n", MOTOR_TICK_HZ);
+    Serial.printf("Ticks:         %lu (ausgelassen %lu)\n", stats.tickCount, stats.skipped);
+    Serial.printf("Tick-Dauer:    last %lu us, avg %lu us, max %lu us\n", stats.lastUs, stats.avgUs, stats.maxUs);
+    Serial.printf("Jitter (max):  %lu us\n", stats.maxJitterUs);
+    Serial.printf("Kommandos:     %lu (last %lu, avg %lu, max %lu Zyklen)\n",
+                 stats.cmdCount, stats.cmdLastCycles, stats.cmdAvgCycles, stats.cmdMaxCycles);
+    Serial.printf("Watchdog:      %lu Auslösungen (last %lu us, max %lu us)\n",
+                 stats.watchdogTrips, stats.watchdogLastUs, stats.watchdogMaxUs);
+    if (stats.firstCommandMs) {
+        Serial.printf("Boot:          bereit nach %lu ms, erstes Kommando nach %lu ms\n",
+                     bootTime, stats.firstCommandMs);
+    } else {
+        Serial.printf("Boot:          bereit nach %lu ms, noch kein Kommando\n", bootTime);
+    }
+    Serial.println();
+    
+    CurrentLimitStats limit = motorCtrl.getCurrentLimitStats();
+    if (motorCtrl.getCurrentLimit() > 0) {
+        Serial.printf("Stromlimit:    %ld mA (Drosselung ab %d %%)\n", motorCtrl.getCurrentLimit(), CURRENT_LIMIT_SOFT_PCT);
+    } else {
+        Serial.println("Stromlimit:    AUS");
+    }
+    Serial.printf("Strom:         %ld mA gefiltert, Spitze %ld mA\n", limit.filteredMa, limit.peakMa);
+    Serial.printf("Faktor:        %u/256 (min %u/256), %lu Eingriffe\n", limit.scaleQ8, limit.minScaleQ8, limit.limitEvents);
+    Serial.printf("Messungen:     %lu (%d Hz, ADC last %lu us, max %lu us)\n",
+                 limit.samples, MOTOR_TICK_HZ / CURRENT_LIMIT_SAMPLE_DIV, limit.lastSampleUs, limit.maxSampleUs);
+    Serial.printf("Reaktion:      last %lu us, max %lu us (Überschreitung → unter Limit)\n",
+                 limit.lastResponseUs, limit.maxResponseUs);
+    Serial.println();
+    
+    SagGuardStats sag = motorCtrl.getSagGuardStats();
+    Serial.printf("Einbruch:      Drosselung ab %.2f V, %u/256 ab %.2f V\n",
+                 SAG_SOFT_MV / 1000.0f, SAG_MIN_SCALE, SAG_FLOOR_MV / 1000.0f);
+    if (sag.samples > 0) {
+        Serial.printf("Spannung:      %ld mV gefiltert, tiefster Wert %ld mV\n", sag.filteredMv, sag.minMv);
+    }
+    Serial.printf("Faktor:        %u/256 (min %u/256), %lu Eingriffe\n", sag.scaleQ8, sag.minScaleQ8, sag.sagEvents);
+    Serial.printf("Dauer:         last %lu ms, max %lu ms (unter %.2f V)\n",
+                 sag.lastSagUs / 1000, sag.maxSagUs / 1000, SAG_SOFT_MV / 1000.0f);
+    Serial.println();
+    
+    uint16_t vcomp = motorCtrl.getVoltageCompScale();
+    Serial.printf("Kompensation:  %s, Faktor %.2f (%u/256) bei %.2f V, Bezug %.2f V\n",
+                 userConfig.getMotorVoltComp() ? "an" : "aus", vcomp / 256.0f, vcomp,
+                 motorCtrl.getVoltageCompMv() / 1000.0f, MOTOR_VCOMP_NOMINAL_MV / 1000.0f);
+    Serial.println();
+    
+    SpeedLoopStats speed = motorCtrl.getSpeedLoopStats();
+    if (!speed.encodersReady) {
+        Serial.println("Drehzahl:      keine Encoder (Open-Loop)");
+    } else {
+        Serial.printf("Drehzahl:      %s, %d Hz\n", speed.active ? "Closed-Loop" : "Open-Loop", SPEED_LOOP_HZ);
+        Serial.printf("Ist:           L=%4d %%  R=%4d %%  (Counts %ld / %ld)\n",
+                     speed.measuredPct[MOTOR_ID_LEFT], speed.measuredPct[MOTOR_ID_RIGHT],
+                     speed.count[MOTOR_ID_LEFT], speed.count[MOTOR_ID_RIGHT]);
+        if (speed.active) {
+            Serial.printf("Regler-Ausg.:  L=%4d %%  R=%4d %%\n",
+                         speed.outputPct[MOTOR_ID_LEFT], speed.outputPct[MOTOR_ID_RIGHT]);
+        }
+        Serial.printf("Reglerschritt: %lu (last %lu us, max %lu us)\n", speed.runs, speed.lastUs, speed.maxUs);
+        Serial.printf("Encoder-Fehler: %lu seit Start\n", speed.faults);
+        if (speed.fault) {
+            Serial.printf("  ❌ %s %s → Open-Loop ('motor reset' oder speedLoop aus/an)\n",
+                         speed.faultMotor == MOTOR_ID_LEFT ? "Links" : "Rechts",
+                         speed.faultReversed ? "zählt gegen den Ausgang (A/B vertauscht?)" : "ohne Signal");
+        }
+    }
+    Serial.println();
+    
+    const MotorDriver& driver = motorCtrl.getDriver();
+    Serial.printf("PWM:           %d Hz, %d Bit (Duty L=%lu R=%lu / %lu)\n",
+                 MOTOR_PWM_FREQ, MOTOR_PWM_RES,
+                 driver.getDuty(MOTOR_ID_LEFT), driver.getDuty(MOTOR_ID_RIGHT), MotorDriver::MAX_DUTY);
+    Serial.printf("Schreibzugr.:  Duty %lu, GPIO %lu, eingespart %lu\n",
+                 driver.getDutyWrites(), driver.getGpioWrites(), driver.getSkippedWrites());
+    
+    printSeparator();
+}
+
+void SerialCommandHandler::handleWatchdogTest(int blockMs) {
+    MotorTelemetry telemetry = motorCtrl.getTelemetry();
+    if (!telemetry.motorsEnabled) {
+        Serial.println("❌ Motoren nicht enabled");
+        return;
+    }
+    if (!sdHandler || !sdHandler->isAvailable()) {
+        Serial.println("❌ SD-Karte nicht verfügbar");
+        return;
+    }
+    if (blockMs < 300 || blockMs > 10000) {
+        Serial.println("❌ Dauer 300-10000 ms");
+        return;
+    }
+    
+    const char* testPath = "/logs/wdtest.log";
+    
+    printHeader("Watchdog-Test");
+    Serial.printf("Blockiere loop() %d ms mit SD-Schreiblast...\n", blockMs);
+    
+    // Langsame Fahrt anfordern, Rampe hochlaufen lassen
+    MotorTickStats before = motorCtrl.getTickStats();
+    motorCtrl.processMovementInput(0, 20);
+    delay(100);
+    
+    // loop() blockieren: keine Kommandos, kein motorCtrl.update()
+    char line[200];
+    memset(line, 'X', sizeof(line) - 2);
+    line[sizeof(line) - 2] = '\n';
+    line[sizeof(line) - 1] = '\0';
+    
+    uint32_t writes = 0;
+    unsigned long start = millis();
+    while (millis() - start < (unsigned long)blockMs) {
+        sdHandler->appendFile(testPath, line);
+        writes++;
+    }
+    
+    sdHandler->deleteFile(testPath);
+    
+    MotorTickStats after = motorCtrl.getTickStats();
+    const MotorDriver& driver = motorCtrl.getDriver();
+    
+    Serial.printf("SD-Writes:     %lu x %u Bytes\n", writes, (unsigned)strlen(line));
+    if (after.watchdogTrips > before.watchdogTrips) {
+        Serial.printf("✅ Watchdog ausgelöst: %lu us nach letztem Kommando\n", after.watchdogLastUs);
+    } else {
+        Serial.println("❌ Watchdog NICHT ausgelöst!");
+        motorCtrl.stop();
+    }
+    Serial.printf("Duty jetzt:    L=%lu R=%lu\n", driver.getDuty(MOTOR_ID_LEFT), driver.getDuty(MOTOR_ID_RIGHT));
+    Serial.printf("Worst Case:    %lu us\n", after.watchdogMaxUs);
+    
+    printSeparator();
+}
+
+void SerialCommandHandler::handleCapture(const String& args) {
+    int spaceIdx = args.indexOf(' ');
+    String subCmd = (spaceIdx > 0) ? args.substring(0, spaceIdx) : args;
+    String subArgs = (spaceIdx > 0) ? args.substring(spaceIdx + 1) : "";
+    subCmd.toLowerCase();
+    subArgs.trim();
+    
+    if (subCmd.length() == 0 || subCmd == "status") {
+        packetCapture.printInfo();
+    } else if (subCmd == "start") {
+        if (packetCapture.startCapture()) {
+            Serial.printf("✅ Mitschnitt läuft: %s\n", packetCapture.getCapturePath());
+        } else {
+            Serial.println("❌ Mitschnitt konnte nicht gestartet werden");
+        }
+    } else if (subCmd == "stop") {
+        packetCapture.stopCapture();
+        packetCapture.stopReplay();
+        Serial.println("✅ Mitschnitt/Replay beendet");
+    } else if (subCmd == "replay") {
+        if (subArgs.length() == 0) {
+            Serial.println("❌ Fehler: Dateiname fehlt");
+            Serial.println("   Verwendung: capture replay <filename> [speed]");
+            return;
+        }
+        
+        int argSpace = subArgs.indexOf(' ');
+        String filename = (argSpace > 0) ? subArgs.substring(0, argSpace) : subArgs;
+        int speed = (argSpace > 0) ? subArgs.substring(argSpace + 1).toInt() : 1;
+        if (speed < 0) speed = 1;
+        
+        // Relativer Name → Capture-Verzeichnis
+        if (!filename.startsWith("/")) {
+            filename = String(CAPTURE_DIR) + "/" + filename;
+        }
+        
+        if (packetCapture.startReplay(filename.c_str(), (uint16_t)speed)) {
+            Serial.printf("✅ Replay gestartet: %s\n", filename.c_str());
+        } else {
+            Serial.println("❌ Replay konnte nicht gestartet werden");
+        }
+    } else {
+        Serial.printf("❌ Unbekannter capture Befehl: '%s'\n", subCmd.c_str());
+        Serial.println("   Gültig: status, start, stop, replay");
+    }
+}
+
+void SerialCommandHandler::handleBlackBox(const String& args) {
+    String subCmd = args;
+    subCmd.toLowerCase();
+    
+    if (subCmd.length() == 0 || subCmd == "status") {
+        blackBox.printInfo();
+    } else if (subCmd == "dump") {
+        if (!blackBox.isReady()) {
+            Serial.println("❌ Black Box nicht initialisiert");
+        } else if (blackBox.isDumping()) {
+            Serial.println("⚠️  Sicherung läuft bereits");
+        } else {
+            blackBox.trigger(BlackBoxTrigger::COMMAND);
+            Serial.printf("✅ Sicherung ausgelöst (noch %d ms Nachlauf)\n",
+                          BLACKBOX_POST_RECORDS * 1000 / BLACKBOX_RATE_HZ);
+        }
+    } else {
+        Serial.printf("❌ Unbekannter blackbox Befehl: '%s'\n", subCmd.c_str());
+        Serial.println("   Gültig: status, dump");
+    }
+}
+
+void SerialCommandHandler::handleTrajectory(const String& args) {
+    int spaceIdx = args.indexOf(' ');
+    String subCmd = (spaceIdx > 0) ? args.substring(0, spaceIdx) : args;
+    String subArgs = (spaceIdx > 0) ? args.substring(spaceIdx + 1) : "";
+    subCmd.toLowerCase();
+    subArgs.trim();
+    
+    // Relativer Name → Trajectory-Verzeichnis
+    String path = subArgs;
+    if (path.length() > 0 && !path.startsWith("/")) {
+        path = String(TRAJ_DIR) + "/" + path;
+    }
+    
+    if (subCmd.length() == 0 || subCmd == "status") {
+        trajectory.printInfo();
+    } else if (subCmd == "load") {
+        if (subArgs.length() == 0) {
+            Serial.println("❌ Fehler: Dateiname fehlt");
+            Serial.println("   Verwendung: traj load <filename>");
+            return;
+        }
+        if (!trajectory.load(path.c_str())) {
+            Serial.println("❌ Verlauf konnte nicht geladen werden");
+        }
+    } else if (subCmd == "play") {
+        int repeats = (subArgs.length() > 0) ? subArgs.toInt() : 1;
+        if (repeats < 0 || repeats > 65535) repeats = 1;
+        
+        if (trajectory.play((uint16_t)repeats)) {
+            Serial.printf("✅ Wiedergabe: %lu ms x %s\n", trajectory.getDurationMs(),
+                          repeats == 0 ? "endlos" : String(repeats).c_str());
+            Serial.printf("   Remote muss senden (Watchdog), Knüppel > %d %% übernimmt\n", TRAJ_OVERRIDE_PCT);
+        } else {
+            Serial.println("❌ Kein Verlauf geladen oder Wiedergabe/Aufzeichnung aktiv");
+        }
+    } else if (subCmd == "rec") {
+        if (trajectory.startRecording()) {
+            Serial.println("✅ Aufzeichnung läuft - 'traj stop' beendet");
+        } else {
+            Serial.println("❌ Aufzeichnung konnte nicht gestartet werden");
+        }
+    } else if (subCmd == "save") {
+        if (subArgs.length() == 0) {
+            Serial.println("❌ Fehler: Dateiname fehlt");
+            Serial.println("   Verwendung: traj save <filename>");
+            return;
+        }
+        if (!trajectory.save(path.c_str())) {
+            Serial.println("❌ Verlauf konnte nicht gespeichert werden");
+        }
+    } else if (subCmd == "stop") {
+        if (motorCtrl.stopTrajectory()) {
+            Serial.println("✅ Wiedergabe/Aufzeichnung beendet");
+        } else {
+            Serial.println("❌ Regel-Takt belegt - 'traj stop' wiederholen");
+        }
+    } else {
+        Serial.printf("❌ Unbekannter traj Befehl: '%s'\n", subCmd.c_str());
+        Serial.println("   Gültig: status, load, play, rec, save, stop");
+    }
+}
+
 // ═══════════════════════════════════════════════════════════════════
 // HILFSFUNKTIONEN
 // ═══════════════════════════════════════════════════════════════════
@@ -658,6 +1370,7 @@ void SerialCommandHandler::handleConfigSet(const String& key, const String& valu
     
     // Wert setzen
     if (setConfigValueFromString(item, value.c_str())) {
+        config->markModified();
         Serial.printf("✅ %s = %s\n", key.c_str(), value.c_str());
         Serial.println("⚠️  Config noch nicht gespeichert!");
         Serial.println("   Tippe 'config save' zum Speichern");
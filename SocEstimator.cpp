@@ -0,0 +1,192 @@
+/**
+ * SocEstimator.cpp
+ *
+ * Implementation der Ladezustands-Schätzung
+ */
+
+#include "include/SocEstimator.h"
+#include <esp_rom_crc.h>
+#include <stddef.h>
+
+// Ruhespannung pro Zelle (mV) bei 0, 10, ..., 100 % (Li-Ion NMC, 25 °C)
+// 0 % = VOLTAGE_BATTERY_MIN / Zelle (sicher leer, nicht Entladeschluss)
+static const uint16_t OCV_TABLE_MV[11] = {
+    3200, 3500, 3620, 3690, 3740, 3780, 3830, 3900, 3980, 4080, 4200
+};
+
+SocEstimator::SocEstimator()
+    : sdHandler(nullptr)
+    , socPercent(0.0f)
+    , internalR(BATTERY_INTERNAL_R)
+    , ocvVoltage(0.0f)
+    , lastConsumedMAh(0.0f)
+    , savedSoc(0.0f)
+    , capacityMah(0)
+    , resting(false)
+    , fromFile(false)
+    , restSince(0)
+    , lastSaveTime(0)
+{
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INITIALISIERUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+void SocEstimator::begin(SDCardHandler* sd, float voltage, float current) {
+    sdHandler = sd;
+
+    ocvVoltage = voltage + current * internalR;
+    float ocvSoc = ocvToPercent(ocvVoltage);
+
+    SocState state;
+    fromFile = false;
+    if (load(state)) {
+        if (fabsf(state.socPercent - ocvSoc) <= SOC_BOOT_MISMATCH) {
+            socPercent = state.socPercent;
+            fromFile = true;
+        } else {
+            DEBUG_PRINTF("SocEstimator: ⚠️ Gesichert %.1f%%, Ruhespannung %.1f%% - Akku getauscht/geladen?\n",
+                         state.socPercent, ocvSoc);
+        }
+    }
+    if (!fromFile) {
+        socPercent = ocvSoc;
+    }
+
+    savedSoc = socPercent;
+    lastSaveTime = millis();
+    lastConsumedMAh = 0.0f;
+    restSince = 0;
+    resting = false;
+
+    DEBUG_PRINTF("SocEstimator: ✅ %.1f%% (%s, OCV %.2fV)\n",
+                 socPercent, fromFile ? "gesichert" : "Ruhespannung", ocvVoltage);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SCHÄTZUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+void SocEstimator::update(float voltage, float current, float consumedMAh, uint16_t capacity) {
+    unsigned long now = millis();
+    capacityMah = capacity;
+
+    // Coulomb-Zählung (Zähler-Reset → Differenz verwerfen)
+    float delta = consumedMAh - lastConsumedMAh;
+    lastConsumedMAh = consumedMAh;
+    if (delta > 0.0f && capacityMah > 0) {
+        socPercent -= delta / capacityMah * 100.0f;
+    }
+
+    // Ruhespannung: Spannungsabfall am Innenwiderstand zurückrechnen
+    ocvVoltage = voltage + current * internalR;
+
+    // Ruhephase erst nach SOC_REST_TIME_MS (Zellspannung erholt sich nach Last)
+    if (current < SOC_REST_CURRENT) {
+        if (restSince == 0) restSince = now ? now : 1;
+        resting = (now - restSince >= SOC_REST_TIME_MS);
+    } else {
+        restSince = 0;
+        resting = false;
+    }
+
+    if (resting) {
+        float target = ocvToPercent(ocvVoltage);
+        socPercent += SOC_OCV_GAIN * ocvWeight(ocvVoltage) * (target - socPercent);
+    }
+
+    socPercent = constrain(socPercent, 0.0f, 100.0f);
+
+    if (fabsf(socPercent - savedSoc) >= SOC_SAVE_DELTA && now - lastSaveTime >= SOC_SAVE_INTERVAL_MS) {
+        save();
+    }
+}
+
+uint8_t SocEstimator::getPercent() const {
+    float percent = constrain(socPercent, 0.0f, 100.0f);
+    return (uint8_t)(percent + 0.5f);
+}
+
+float SocEstimator::ocvToPercent(float packVoltage) {
+    float cellMv = packVoltage * 1000.0f / BATTERY_CELLS;
+
+    if (cellMv <= OCV_TABLE_MV[0]) return 0.0f;
+    if (cellMv >= OCV_TABLE_MV[10]) return 100.0f;
+
+    uint8_t i = 0;
+    while (cellMv > OCV_TABLE_MV[i + 1]) i++;
+
+    float span = OCV_TABLE_MV[i + 1] - OCV_TABLE_MV[i];
+    return i * 10.0f + (cellMv - OCV_TABLE_MV[i]) / span * 10.0f;
+}
+
+float SocEstimator::percentToOcv(float percent) {
+    percent = constrain(percent, 0.0f, 100.0f);
+
+    uint8_t i = (uint8_t)(percent / 10.0f);
+    if (i > 9) i = 9;
+
+    float cellMv = OCV_TABLE_MV[i] + (percent - i * 10.0f) / 10.0f * (OCV_TABLE_MV[i + 1] - OCV_TABLE_MV[i]);
+    return cellMv * BATTERY_CELLS / 1000.0f;
+}
+
+float SocEstimator::ocvWeight(float packVoltage) {
+    float cellMv = packVoltage * 1000.0f / BATTERY_CELLS;
+
+    uint8_t i = 0;
+    while (i < 9 && cellMv > OCV_TABLE_MV[i + 1]) i++;
+
+    float weight = (float)(OCV_TABLE_MV[i + 1] - OCV_TABLE_MV[i]) / SOC_OCV_SLOPE_FULL_MV;
+    return weight > 1.0f ? 1.0f : weight;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SICHERUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+void SocEstimator::save() {
+    if (!sdHandler || !sdHandler->isAvailable()) return;
+
+    if (!sdHandler->fileExists(BATTERY_STATE_DIR)) {
+        sdHandler->createDir(BATTERY_STATE_DIR);
+    }
+
+    SocState state = {};
+    state.magic = SOC_STATE_MAGIC;
+    state.socPercent = socPercent;
+    state.capacityMah = capacityMah;
+    state.crc = esp_rom_crc32_le(0, (const uint8_t*)&state, offsetof(SocState, crc));
+
+    if (sdHandler->writeBinaryFile(SOC_STATE_FILE, (const uint8_t*)&state, sizeof(state))) {
+        savedSoc = socPercent;
+        lastSaveTime = millis();
+    }
+}
+
+bool SocEstimator::load(SocState& state) {
+    if (!sdHandler || !sdHandler->isAvailable() || !sdHandler->fileExists(SOC_STATE_FILE)) {
+        return false;
+    }
+
+    if (sdHandler->readBinaryFile(SOC_STATE_FILE, (uint8_t*)&state, sizeof(state)) != (int)sizeof(state)) {
+        return false;
+    }
+
+    if (state.magic != SOC_STATE_MAGIC ||
+        state.crc != esp_rom_crc32_le(0, (const uint8_t*)&state, offsetof(SocState, crc)) ||
+        !(state.socPercent >= 0.0f && state.socPercent <= 100.0f)) {
+        DEBUG_PRINTLN("SocEstimator: ⚠️ Gesicherter Zustand ungültig - verworfen");
+        return false;
+    }
+    return true;
+}
+
+void SocEstimator::printInfo() const {
+    DEBUG_PRINTF("SoC:          %.1f%% von %u mAh (Start: %s)\n",
+                 socPercent, capacityMah, fromFile ? "gesichert" : "Ruhespannung");
+    DEBUG_PRINTF("OCV (IR-korr.): %.2fV → %.1f%% (R = %.0f mΩ)\n",
+                 ocvVoltage, ocvToPercent(ocvVoltage), internalR * 1000.0f);
+    DEBUG_PRINTF("Ruhephase:    %s\n", resting ? "ja (OCV-Angleich)" :
+                 restSince ? "wartet" : "nein (Last)");
+}
@@ -0,0 +1,177 @@
+/**
+ * SteeringKernel.cpp
+ *
+ * Implementation des Festkomma-Differential-Steerings
+ */
+
+#include "include/SteeringKernel.h"
+#include <math.h>
+
+// ═══════════════════════════════════════════════════════════════════════════
+// NORMALISIERUNGSTABELLE
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Radius r = 101..142 (142² = 20164 ≥ 2 · 100²)
+static const int32_t NORM_R_MIN = 101;
+static const int32_t NORM_ENTRIES = 42;
+
+// NORM_Q15[i] = ceil(100 · 2^15 / (101 + i))
+// Für |v| ≤ 100 gilt exakt: (|v| · NORM_Q15[i]) >> 15 == |v| · 100 / r
+static const uint16_t NORM_Q15[NORM_ENTRIES] = {
+    32444, 32126, 31814, 31508, 31208, 30914, 30625, 30341,
+    30063, 29790, 29521, 29258, 28999, 28744, 28494, 28249,
+    28007, 27770, 27537, 27307, 27081, 26860, 26641, 26426,
+    26215, 26007, 25802, 25600, 25402, 25207, 25014, 24825,
+    24638, 24454, 24273, 24095, 23919, 23745, 23575, 23406,
+    23240, 23077,
+};
+
+// Grobindex: d2 = 10001..20000 in Blöcken zu 128 → Index für ceil(sqrt(Blockanfang))
+// Quadrate liegen ≥ 203 auseinander → pro Block höchstens eine Korrektur um +1
+static const int32_t BUCKET_BASE = 100 * 100 + 1;
+static const int32_t BUCKET_SHIFT = 7;
+static const uint8_t NORM_BUCKET[79] = {
+    0, 0, 1, 1, 2, 3, 3, 4, 4, 5, 6, 6, 7, 8, 8, 9,
+    9, 10, 10, 11, 12, 12, 13, 13, 14, 14, 15, 16, 16, 17, 17, 18,
+    18, 19, 19, 20, 20, 21, 21, 22, 22, 23, 24, 24, 25, 25, 26, 26,
+    27, 27, 28, 28, 29, 29, 30, 30, 31, 31, 32, 32, 32, 33, 33, 34,
+    34, 35, 35, 36, 36, 37, 37, 38, 38, 39, 39, 40, 40, 40, 41,
+};
+
+// Q15-Faktor 1.0 (keine Normalisierung)
+static const uint32_t Q15_ONE = 1UL << 15;
+
+/**
+ * Tabellenindex i mit 101 + i = ceil(sqrt(d2)), d2 = 10001..20000
+ */
+static inline int32_t normIndex(int32_t d2) {
+    int32_t i = NORM_BUCKET[(d2 - BUCKET_BASE) >> BUCKET_SHIFT];
+    int32_t r = NORM_R_MIN + i;
+    return i + (r * r < d2);
+}
+
+/**
+ * Betrag · Q15-Faktor mit Vorzeichen (Rundung Richtung 0 wie C-Division)
+ */
+static inline int32_t scaleQ15(int32_t v, uint32_t q) {
+    int32_t sign = v >> 31;                         // 0 oder -1
+    int32_t mag = (v ^ sign) - sign;
+    int32_t scaled = (int32_t)(((uint32_t)mag * q) >> 15);
+    return (scaled ^ sign) - sign;
+}
+
+static inline int32_t sat100(int32_t v) {
+    v = v < -100 ? -100 : v;
+    return v > 100 ? 100 : v;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// KERNEL
+// ═══════════════════════════════════════════════════════════════════════════
+
+void SteeringKernel::mix(int16_t joystickX, int16_t joystickY, SteeringOutput& out) {
+    int32_t x = toPercent(joystickX);
+    int32_t y = toPercent(joystickY);
+
+    int32_t d2 = x * x + y * y;
+    uint32_t q = (d2 > 100 * 100) ? NORM_Q15[normIndex(d2)] : Q15_ONE;
+
+    x = scaleQ15(x, q);
+    y = scaleQ15(y, q);
+
+    int32_t left = sat100(y - x);
+    int32_t right = sat100(y + x);
+
+    out.leftSpeed = (int8_t)left;
+    out.rightSpeed = (int8_t)right;
+    out.leftPWM = speedToPwm(left);
+    out.rightPWM = speedToPwm(right);
+}
+
+void SteeringKernel::mixReference(int16_t joystickX, int16_t joystickY, SteeringOutput& out) {
+    int32_t x = joystickX;
+    int32_t y = joystickY;
+
+    if (x > 100) x = 100;
+    if (x < -100) x = -100;
+    if (y > 100) y = 100;
+    if (y < -100) y = -100;
+
+    int32_t d2 = x * x + y * y;
+    if (d2 > 100 * 100) {
+        int32_t r = 100;
+        while (r * r < d2) r++;
+        x = x * 100 / r;
+        y = y * 100 / r;
+    }
+
+    int32_t speeds[2] = { y - x, y + x };
+    uint8_t pwms[2];
+
+    for (int i = 0; i < 2; i++) {
+        if (speeds[i] > 100) speeds[i] = 100;
+        if (speeds[i] < -100) speeds[i] = -100;
+
+        int32_t mag = speeds[i] < 0 ? -speeds[i] : speeds[i];
+        pwms[i] = (mag == 0) ? 0 : (uint8_t)(127 + mag * 128 / 100);
+    }
+
+    out.leftSpeed = (int8_t)speeds[0];
+    out.rightSpeed = (int8_t)speeds[1];
+    out.leftPWM = pwms[0];
+    out.rightPWM = pwms[1];
+}
+
+void SteeringKernel::mixFloat(int16_t joystickX, int16_t joystickY, SteeringOutput& out) {
+    float x = toPercent(joystickX);
+    float y = toPercent(joystickY);
+
+    float distance = sqrtf(x * x + y * y);
+    float scale = (distance > 100.0f) ? 100.0f / distance : 1.0f;
+
+    float speeds[2] = { (y - x) * scale, (y + x) * scale };
+    uint8_t pwms[2];
+
+    for (int i = 0; i < 2; i++) {
+        if (speeds[i] > 100.0f) speeds[i] = 100.0f;
+        if (speeds[i] < -100.0f) speeds[i] = -100.0f;
+
+        // Wie map((int)|s|, 0, 100, 127, 255) bei |s| > 0
+        float mag = fabsf(speeds[i]);
+        pwms[i] = (mag > 0.0f) ? (uint8_t)(127 + (int32_t)mag * 128 / 100) : 0;
+    }
+
+    out.leftSpeed = (int8_t)speeds[0];
+    out.rightSpeed = (int8_t)speeds[1];
+    out.leftPWM = pwms[0];
+    out.rightPWM = pwms[1];
+}
+
+uint32_t SteeringKernel::selfTest(uint32_t& checked) {
+    static const int16_t EXTREMES[] = { -32768, -32767, -1000, -129, -128, 127, 128, 1000, 32767 };
+    const int32_t extremeCount = sizeof(EXTREMES) / sizeof(EXTREMES[0]);
+
+    uint32_t mismatches = 0;
+    checked = 0;
+
+    // Eingaben: -150..150 plus Extremwerte (Index ≥ 301)
+    for (int32_t i = 0; i < 301 + extremeCount; i++) {
+        int16_t x = (i < 301) ? (int16_t)(i - 150) : EXTREMES[i - 301];
+
+        for (int32_t j = 0; j < 301 + extremeCount; j++) {
+            int16_t y = (j < 301) ? (int16_t)(j - 150) : EXTREMES[j - 301];
+
+            SteeringOutput fast, ref;
+            mix(x, y, fast);
+            mixReference(x, y, ref);
+
+            if (fast.leftSpeed != ref.leftSpeed || fast.rightSpeed != ref.rightSpeed ||
+                fast.leftPWM != ref.leftPWM || fast.rightPWM != ref.rightPWM) {
+                mismatches++;
+            }
+            checked++;
+        }
+    }
+
+    return mismatches;
+}
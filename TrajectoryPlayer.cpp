@@ -0,0 +1,376 @@
+/**
+ * TrajectoryPlayer.cpp
+ *
+ * Implementation der Sollwert-Wiedergabe
+ */
+
+#include "include/TrajectoryPlayer.h"
+#include <esp_timer.h>
+
+TrajectoryPlayer::TrajectoryPlayer()
+    : sdHandler(nullptr)
+    , points(nullptr)
+    , capacity(0)
+    , pointCount(0)
+    , state(TrajectoryState::IDLE)
+    , startUs(0)
+    , cursor(0)
+    , repeatsWanted(1)
+    , repeatsDone(0)
+    , samples(0)
+    , lastSampleCycles(0)
+    , maxSampleCycles(0)
+    , recordStartUs(0)
+    , lastLeftQ8(0)
+    , lastRightQ8(0)
+    , recordOverflow(false)
+{
+    name[0] = '\0';
+}
+
+TrajectoryPlayer::~TrajectoryPlayer() {
+    if (points) free(points);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INITIALISIERUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool TrajectoryPlayer::begin(SDCardHandler* sdHandler) {
+    this->sdHandler = sdHandler;
+
+    if (!points) {
+        bool inPsram = psramFound();
+        capacity = inPsram ? TRAJ_MAX_POINTS : TRAJ_MAX_POINTS_INTERNAL;
+        size_t bytes = capacity * sizeof(TrajectoryPoint);
+        points = (TrajectoryPoint*)(inPsram ? ps_malloc(bytes) : malloc(bytes));
+    }
+
+    if (!points) {
+        DEBUG_PRINTLN("Trajectory: ❌ Speicher-Allokation fehlgeschlagen!");
+        capacity = 0;
+        return false;
+    }
+
+    DEBUG_PRINTF("Trajectory: ✅ max. %lu Stützpunkte\n", capacity);
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LADEN & SPEICHERN
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool TrajectoryPlayer::parseLine(const char* line, TrajectoryPoint& point) {
+    while (*line == ' ' || *line == '\t') line++;
+    if (*line == '\0' || *line == '#' || *line == '\r') {
+        return false;
+    }
+
+    char* end;
+    float values[3];
+    for (int i = 0; i < 3; i++) {
+        while (*line == ' ' || *line == '\t' || *line == ',' || *line == ';') line++;
+        values[i] = strtof(line, &end);
+        if (end == line) {
+            return false;
+        }
+        line = end;
+    }
+
+    if (values[0] < 0.0f) {
+        return false;
+    }
+
+    // Werte außerhalb ±100 % sättigen
+    for (int i = 1; i < 3; i++) {
+        if (values[i] > 100.0f) values[i] = 100.0f;
+        if (values[i] < -100.0f) values[i] = -100.0f;
+    }
+
+    point.timeMs = (uint32_t)values[0];
+    point.leftQ8 = (int16_t)lroundf(values[1] * 256.0f);
+    point.rightQ8 = (int16_t)lroundf(values[2] * 256.0f);
+    return true;
+}
+
+bool TrajectoryPlayer::load(const char* path) {
+    if (!points || state != TrajectoryState::IDLE) {
+        DEBUG_PRINTLN("Trajectory: ❌ Wiedergabe/Aufzeichnung aktiv");
+        return false;
+    }
+    if (!sdHandler || !sdHandler->isAvailable() || !sdHandler->fileExists(path)) {
+        DEBUG_PRINTF("Trajectory: ❌ Datei %s nicht gefunden\n", path);
+        return false;
+    }
+
+    size_t fileSize = sdHandler->getFileSize(path);
+    uint8_t chunk[256];
+    char line[80];
+    size_t lineLen = 0;
+    size_t offset = 0;
+    uint32_t lineNo = 0;
+    bool ok = true;
+
+    pointCount = 0;
+
+    // Blockweise lesen, Zeilen über Blockgrenzen zusammensetzen
+    bool eof = false;
+    while (ok && !eof) {
+        int len = (offset < fileSize) ? sdHandler->readBinaryAt(path, offset, chunk, sizeof(chunk)) : 0;
+        if (len < 0) {
+            ok = false;
+            break;
+        }
+        offset += len;
+
+        // Dateiende: letzte Zeile ohne Zeilenumbruch abschließen
+        eof = (len == 0);
+        int count = eof ? 1 : len;
+
+        for (int i = 0; i < count && ok; i++) {
+            char c = eof ? '\n' : (char)chunk[i];
+            if (c != '\n') {
+                if (lineLen < sizeof(line) - 1) line[lineLen++] = c;
+                continue;
+            }
+            line[lineLen] = '\0';
+            lineLen = 0;
+            lineNo++;
+
+            TrajectoryPoint point;
+            if (!parseLine(line, point)) {
+                continue;
+            }
+            if (pointCount > 0 && point.timeMs <= points[pointCount - 1].timeMs) {
+                DEBUG_PRINTF("Trajectory: ❌ Zeile %lu: Zeit nicht aufsteigend\n", lineNo);
+                ok = false;
+            } else if (pointCount >= capacity) {
+                DEBUG_PRINTF("Trajectory: ❌ Mehr als %lu Stützpunkte\n", capacity);
+                ok = false;
+            } else {
+                points[pointCount++] = point;
+            }
+        }
+    }
+
+    if (ok && pointCount < 2) {
+        DEBUG_PRINTLN("Trajectory: ❌ Mindestens 2 Stützpunkte nötig");
+        ok = false;
+    }
+    if (!ok) {
+        pointCount = 0;
+        name[0] = '\0';
+        return false;
+    }
+
+    const char* slash = strrchr(path, '/');
+    strncpy(name, slash ? slash + 1 : path, sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+
+    DEBUG_PRINTF("Trajectory: ✅ %s: %lu Stützpunkte, %lu ms\n", name, pointCount, getDurationMs());
+    return true;
+}
+
+bool TrajectoryPlayer::save(const char* path) {
+    if (pointCount == 0 || state == TrajectoryState::RECORDING) {
+        return false;
+    }
+    if (!sdHandler || !sdHandler->isAvailable()) {
+        return false;
+    }
+
+    if (!sdHandler->fileExists(TRAJ_DIR)) {
+        sdHandler->createDir(TRAJ_DIR);
+    }
+
+    char buffer[512];
+    int len = snprintf(buffer, sizeof(buffer), "# t_ms links%% rechts%% (%s)\n", name);
+    if (!sdHandler->writeFile(path, buffer)) {
+        return false;
+    }
+
+    // Zeilen sammeln, in Blöcken anhängen
+    len = 0;
+    for (uint32_t i = 0; i < pointCount; i++) {
+        len += snprintf(buffer + len, sizeof(buffer) - len, "%lu %.2f %.2f\n",
+                        points[i].timeMs, points[i].leftQ8 / 256.0f, points[i].rightQ8 / 256.0f);
+        if (len > (int)sizeof(buffer) - 40 || i == pointCount - 1) {
+            if (!sdHandler->appendFile(path, buffer)) {
+                return false;
+            }
+            len = 0;
+        }
+    }
+
+    DEBUG_PRINTF("Trajectory: ✅ %lu Stützpunkte gespeichert: %s\n", pointCount, path);
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// WIEDERGABE & AUFZEICHNUNG
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool TrajectoryPlayer::play(uint16_t repeats) {
+    if (state != TrajectoryState::IDLE || pointCount < 2) {
+        return false;
+    }
+
+    cursor = 0;
+    repeatsWanted = repeats;
+    repeatsDone = 0;
+    samples = 0;
+    lastSampleCycles = 0;
+    maxSampleCycles = 0;
+    startUs = esp_timer_get_time();
+
+    // Zustand erst setzen, wenn alle Felder für den Regel-Takt sichtbar sind
+    __sync_synchronize();
+    state = TrajectoryState::PLAYING;
+    return true;
+}
+
+bool TrajectoryPlayer::startRecording() {
+    if (!points || state != TrajectoryState::IDLE) {
+        return false;
+    }
+
+    pointCount = 0;
+    recordOverflow = false;
+    recordStartUs = esp_timer_get_time();
+    lastLeftQ8 = 0;
+    lastRightQ8 = 0;
+    strncpy(name, "live", sizeof(name));
+
+    // Start im Stillstand
+    points[pointCount++] = { 0, 0, 0 };
+
+    state = TrajectoryState::RECORDING;
+    return true;
+}
+
+void TrajectoryPlayer::stop() {
+    if (state == TrajectoryState::RECORDING) {
+        // Letzten Sollwert bis zum Ende der Aufzeichnung halten
+        uint32_t nowMs = (uint32_t)((esp_timer_get_time() - recordStartUs) / 1000);
+        if (pointCount < capacity && nowMs > points[pointCount - 1].timeMs) {
+            points[pointCount++] = { nowMs, (int16_t)lastLeftQ8, (int16_t)lastRightQ8 };
+        }
+    }
+    state = TrajectoryState::IDLE;
+}
+
+void TrajectoryPlayer::recordPoint(int32_t leftQ8, int32_t rightQ8) {
+    if (state != TrajectoryState::RECORDING) {
+        return;
+    }
+
+    uint32_t nowMs = (uint32_t)((esp_timer_get_time() - recordStartUs) / 1000);
+    if (leftQ8 == lastLeftQ8 && rightQ8 == lastRightQ8) {
+        return;
+    }
+
+    // Sprung nach längerem Halten: alten Wert bis kurz vorher festhalten,
+    // sonst interpoliert die Wiedergabe eine lange Rampe
+    TrajectoryPoint& last = points[pointCount - 1];
+    if (nowMs > last.timeMs + TRAJ_RECORD_HOLD_MS && pointCount < capacity) {
+        points[pointCount++] = { nowMs - 1, (int16_t)lastLeftQ8, (int16_t)lastRightQ8 };
+    }
+
+    if (pointCount >= capacity) {
+        recordOverflow = true;
+        state = TrajectoryState::IDLE;
+        DEBUG_PRINTLN("Trajectory: ⚠️ Puffer voll - Aufzeichnung beendet");
+        return;
+    }
+
+    // Gleiche Millisekunde: letzten Punkt überschreiben (Zeit streng aufsteigend)
+    if (points[pointCount - 1].timeMs >= nowMs && pointCount > 1) {
+        points[pointCount - 1].leftQ8 = (int16_t)leftQ8;
+        points[pointCount - 1].rightQ8 = (int16_t)rightQ8;
+    } else {
+        points[pointCount++] = { nowMs > 0 ? nowMs : 1, (int16_t)leftQ8, (int16_t)rightQ8 };
+    }
+
+    lastLeftQ8 = leftQ8;
+    lastRightQ8 = rightQ8;
+}
+
+bool TrajectoryPlayer::sample(int64_t nowUs, int32_t& leftQ8, int32_t& rightQ8) {
+    uint32_t cycleStart = ESP.getCycleCount();
+
+    // Zeitachse auf das Takt-Raster runden: Jitter verschiebt den Abtastpunkt nicht,
+    // ausgelassene Ticks dehnen den Verlauf nicht
+    int64_t elapsed = nowUs - startUs;
+    int64_t tUs = ((elapsed + MOTOR_TICK_US / 2) / MOTOR_TICK_US) * MOTOR_TICK_US;
+    int64_t endUs = (int64_t)points[pointCount - 1].timeMs * 1000;
+
+    if (tUs >= endUs) {
+        repeatsDone++;
+        if (repeatsWanted != 0 && repeatsDone >= repeatsWanted) {
+            state = TrajectoryState::IDLE;
+            leftQ8 = 0;
+            rightQ8 = 0;
+            return false;
+        }
+
+        // Nächster Durchlauf exakt im Anschluss (kein Aufsummieren von Fehlern)
+        startUs += endUs;
+        tUs -= endUs;
+        cursor = 0;
+    }
+
+    // Segment suchen: monoton, pro Takt meist kein oder ein Schritt
+    while (cursor + 2 < pointCount && (int64_t)points[cursor + 1].timeMs * 1000 <= tUs) {
+        cursor++;
+    }
+
+    const TrajectoryPoint& a = points[cursor];
+    const TrajectoryPoint& b = points[cursor + 1];
+    int64_t aUs = (int64_t)a.timeMs * 1000;
+    int64_t spanUs = (int64_t)b.timeMs * 1000 - aUs;
+    int64_t frac = tUs - aUs;
+    if (frac < 0) frac = 0;
+    if (frac > spanUs) frac = spanUs;
+
+    // Linear in Q8, symmetrisch gerundet
+    int64_t num = (int64_t)(b.leftQ8 - a.leftQ8) * frac;
+    leftQ8 = a.leftQ8 + (int32_t)((num >= 0 ? num + spanUs / 2 : num - spanUs / 2) / spanUs);
+    num = (int64_t)(b.rightQ8 - a.rightQ8) * frac;
+    rightQ8 = a.rightQ8 + (int32_t)((num >= 0 ? num + spanUs / 2 : num - spanUs / 2) / spanUs);
+
+    uint32_t cycles = ESP.getCycleCount() - cycleStart;
+    lastSampleCycles = cycles;
+    if (cycles > maxSampleCycles) maxSampleCycles = cycles;
+    samples++;
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// STATUS
+// ═══════════════════════════════════════════════════════════════════════════
+
+void TrajectoryPlayer::printInfo() const {
+    static const char* stateNames[] = { "Bereit", "Wiedergabe", "Aufzeichnung" };
+
+    DEBUG_PRINTLN("═══════════════════════════════════════════════════════");
+    DEBUG_PRINTLN("Trajectory - Status");
+    DEBUG_PRINTLN("═══════════════════════════════════════════════════════");
+    DEBUG_PRINTF("Zustand:        %s\n", stateNames[(uint8_t)state]);
+    DEBUG_PRINTF("Verlauf:        %s (%lu / %lu Stützpunkte, %lu ms)\n",
+                 name[0] ? name : "-", pointCount, capacity, getDurationMs());
+    if (recordOverflow) {
+        DEBUG_PRINTLN("Aufzeichnung:   ⚠️ Puffer war voll, Verlauf gekürzt");
+    }
+    if (samples > 0) {
+        if (repeatsWanted == 0) {
+            DEBUG_PRINTF("Durchlauf:      %u (endlos)\n", repeatsDone + 1);
+        } else {
+            DEBUG_PRINTF("Durchlauf:      %u / %u\n",
+                         repeatsDone < repeatsWanted ? repeatsDone + 1 : repeatsWanted, repeatsWanted);
+        }
+        DEBUG_PRINTF("Abtastung:      %lu Takte, last %lu / max %lu Zyklen\n",
+                     samples, lastSampleCycles, maxSampleCycles);
+    }
+    DEBUG_PRINTF("Abbruch:        Knüppel > %d %%, Stopp oder Watchdog\n", TRAJ_OVERRIDE_PCT);
+    DEBUG_PRINTLN("═══════════════════════════════════════════════════════");
+}
@@ -64,6 +64,7 @@ bool UserConfig::load() {
     }
     
     setDirty(false);
+    bumpRevision();
     
     DEBUG_PRINTLN("UserConfig: ✅ Config geladen");
     return true;
@@ -131,10 +132,38 @@ void UserConfig::printInfo() const {
     DEBUG_PRINTF("  espnowHeartbeat: %lu ms\n", config.espnowHeartbeat);
     DEBUG_PRINTF("  espnowTimeout: %lu ms\n", config.espnowTimeout);
     DEBUG_PRINTF("  espnowPeerMac: %s\n", config.espnowPeerMac);
+    DEBUG_PRINTF("  espnowEncrypt: %s\n", config.espnowEncrypt ? "true" : "false");
+    DEBUG_PRINTF("  espnowPsk: %s\n", config.espnowPsk[0] ? "********" : "(leer)");
+    
+    // Motor
+    DEBUG_PRINTLN("[Motor]");
+    DEBUG_PRINTF("  motorAccel: %u %%/s\n", config.motorAccel);
+    DEBUG_PRINTF("  motorDecel: %u %%/s\n", config.motorDecel);
+    DEBUG_PRINTF("  motorMinPwm: %u\n", config.motorMinPwm);
+    DEBUG_PRINTF("  motorTrimLeft: %u %%\n", config.motorTrimLeft);
+    DEBUG_PRINTF("  motorTrimRight: %u %%\n", config.motorTrimRight);
+    DEBUG_PRINTF("  motorCurrentLimit: %u mA\n", config.motorCurrentLimit);
+    DEBUG_PRINTF("  motorVoltComp: %s\n", config.motorVoltComp ? "true" : "false");
+    
+    // Drehzahlregelung
+    DEBUG_PRINTLN("[Speed]");
+    DEBUG_PRINTF("  speedLoop: %s\n", config.speedLoop ? "true" : "false");
+    DEBUG_PRINTF("  speedKp: %.3f\n", config.speedKp);
+    DEBUG_PRINTF("  speedKi: %.3f\n", config.speedKi);
+    DEBUG_PRINTF("  speedKd: %.3f\n", config.speedKd);
+    DEBUG_PRINTF("  speedKff: %.3f\n", config.speedKff);
+    
+    // Joystick
+    DEBUG_PRINTLN("[Joystick]");
+    DEBUG_PRINTF("  joyDeadzone: %u %%\n", config.joyDeadzone);
+    DEBUG_PRINTF("  joyExpo: %u %%\n", config.joyExpo);
         
     // Power
     DEBUG_PRINTLN("[Power]");
     DEBUG_PRINTF("  autoShutdownEnabled: %s\n", config.autoShutdownEnabled ? "true" : "false");
+    DEBUG_PRINTF("  batteryCapacity: %u mAh\n", config.batteryCapacity);
+    DEBUG_PRINTF("  voltCalLow: %u -> %u mV\n", config.voltCalLowRaw, config.voltCalLowRef);
+    DEBUG_PRINTF("  voltCalHigh: %u -> %u mV\n", config.voltCalHighRaw, config.voltCalHighRef);
     
     // Debug
     DEBUG_PRINTLN("[Debug]");
@@ -179,11 +208,111 @@ void UserConfig::setEspnowPeerMac(const char* mac) {
     }
 }
 
+void UserConfig::setEspnowEncrypt(bool value) {
+    config.espnowEncrypt = value;
+    setDirty(true);
+}
+
+void UserConfig::setEspnowPsk(const char* psk) {
+    if (psk) {
+        strncpy(config.espnowPsk, psk, sizeof(config.espnowPsk) - 1);
+        config.espnowPsk[sizeof(config.espnowPsk) - 1] = '\0';
+        setDirty(true);
+    }
+}
+
+void UserConfig::setMotorAccel(uint16_t value) {
+    config.motorAccel = value;
+    setDirty(true);
+}
+
+void UserConfig::setMotorDecel(uint16_t value) {
+    config.motorDecel = value;
+    setDirty(true);
+}
+
+void UserConfig::setMotorMinPwm(uint8_t value) {
+    config.motorMinPwm = value;
+    setDirty(true);
+}
+
+void UserConfig::setMotorTrimLeft(uint8_t value) {
+    config.motorTrimLeft = value;
+    setDirty(true);
+}
+
+void UserConfig::setMotorTrimRight(uint8_t value) {
+    config.motorTrimRight = value;
+    setDirty(true);
+}
+
+void UserConfig::setMotorCurrentLimit(uint16_t value) {
+    config.motorCurrentLimit = value;
+    setDirty(true);
+}
+
+void UserConfig::setMotorVoltComp(bool value) {
+    config.motorVoltComp = value;
+    setDirty(true);
+}
+
+void UserConfig::setSpeedLoop(bool value) {
+    config.speedLoop = value;
+    setDirty(true);
+}
+
+void UserConfig::setSpeedKp(float value) {
+    config.speedKp = value;
+    setDirty(true);
+}
+
+void UserConfig::setSpeedKi(float value) {
+    config.speedKi = value;
+    setDirty(true);
+}
+
+void UserConfig::setSpeedKd(float value) {
+    config.speedKd = value;
+    setDirty(true);
+}
+
+void UserConfig::setSpeedKff(float value) {
+    config.speedKff = value;
+    setDirty(true);
+}
+
+void UserConfig::setJoyDeadzone(uint8_t value) {
+    config.joyDeadzone = value;
+    setDirty(true);
+}
+
+void UserConfig::setJoyExpo(uint8_t value) {
+    config.joyExpo = value;
+    setDirty(true);
+}
+
 void UserConfig::setAutoShutdownEnabled(bool value) {
     config.autoShutdownEnabled = value;
     setDirty(true);
 }
 
+void UserConfig::setBatteryCapacity(uint16_t value) {
+    config.batteryCapacity = value;
+    setDirty(true);
+}
+
+void UserConfig::setVoltCalLow(uint16_t rawMv, uint16_t refMv) {
+    config.voltCalLowRaw = rawMv;
+    config.voltCalLowRef = refMv;
+    setDirty(true);
+}
+
+void UserConfig::setVoltCalHigh(uint16_t rawMv, uint16_t refMv) {
+    config.voltCalHighRaw = rawMv;
+    config.voltCalHighRef = refMv;
+    setDirty(true);
+}
+
 void UserConfig::setDebugSerialEnabled(bool value) {
     config.debugSerialEnabled = value;
     setDirty(true);
@@ -252,6 +381,189 @@ ConfigScheme UserConfig::buildScheme() {
             .maxValue = 0,
             .maxLength = sizeof(config.espnowPeerMac)
         },
+        {
+            .key = "espnowEncrypt",
+            .category = "ESP-Now",
+            .type = ConfigType::BOOL,
+            .valuePtr = &config.espnowEncrypt,
+            .defaultPtr = &defaults.espnowEncrypt,
+            .hasRange = false,
+            .minValue = 0,
+            .maxValue = 0,
+            .maxLength = 0
+        },
+        {
+            .key = "espnowPsk",
+            .category = "ESP-Now",
+            .type = ConfigType::STRING,
+            .valuePtr = &config.espnowPsk,
+            .defaultPtr = &defaults.espnowPsk,
+            .hasRange = false,
+            .minValue = 0,
+            .maxValue = 0,
+            .maxLength = sizeof(config.espnowPsk)
+        },
+        
+        // Motor
+        {
+            .key = "motorAccel",
+            .category = "Motor",
+            .type = ConfigType::UINT16,
+            .valuePtr = &config.motorAccel,
+            .defaultPtr = &defaults.motorAccel,
+            .hasRange = true,
+            .minValue = 0,
+            .maxValue = 10000,
+            .maxLength = 0
+        },
+        {
+            .key = "motorDecel",
+            .category = "Motor",
+            .type = ConfigType::UINT16,
+            .valuePtr = &config.motorDecel,
+            .defaultPtr = &defaults.motorDecel,
+            .hasRange = true,
+            .minValue = 0,
+            .maxValue = 10000,
+            .maxLength = 0
+        },
+        {
+            .key = "motorMinPwm",
+            .category = "Motor",
+            .type = ConfigType::UINT8,
+            .valuePtr = &config.motorMinPwm,
+            .defaultPtr = &defaults.motorMinPwm,
+            .hasRange = true,
+            .minValue = 0,
+            .maxValue = 254,
+            .maxLength = 0
+        },
+        {
+            .key = "motorTrimLeft",
+            .category = "Motor",
+            .type = ConfigType::UINT8,
+            .valuePtr = &config.motorTrimLeft,
+            .defaultPtr = &defaults.motorTrimLeft,
+            .hasRange = true,
+            .minValue = 50,
+            .maxValue = 100,
+            .maxLength = 0
+        },
+        {
+            .key = "motorTrimRight",
+            .category = "Motor",
+            .type = ConfigType::UINT8,
+            .valuePtr = &config.motorTrimRight,
+            .defaultPtr = &defaults.motorTrimRight,
+            .hasRange = true,
+            .minValue = 50,
+            .maxValue = 100,
+            .maxLength = 0
+        },
+        {
+            .key = "motorCurrentLimit",
+            .category = "Motor",
+            .type = ConfigType::UINT16,
+            .valuePtr = &config.motorCurrentLimit,
+            .defaultPtr = &defaults.motorCurrentLimit,
+            .hasRange = true,
+            .minValue = 0,
+            .maxValue = 20000,
+            .maxLength = 0
+        },
+        {
+            .key = "motorVoltComp",
+            .category = "Motor",
+            .type = ConfigType::BOOL,
+            .valuePtr = &config.motorVoltComp,
+            .defaultPtr = &defaults.motorVoltComp,
+            .hasRange = false,
+            .minValue = 0,
+            .maxValue = 0,
+            .maxLength = 0
+        },
+        
+        // Drehzahlregelung
+        {
+            .key = "speedLoop",
+            .category = "Speed",
+            .type = ConfigType::BOOL,
+            .valuePtr = &config.speedLoop,
+            .defaultPtr = &defaults.speedLoop,
+            .hasRange = false,
+            .minValue = 0,
+            .maxValue = 0,
+            .maxLength = 0
+        },
+        {
+            .key = "speedKp",
+            .category = "Speed",
+            .type = ConfigType::FLOAT,
+            .valuePtr = &config.speedKp,
+            .defaultPtr = &defaults.speedKp,
+            .hasRange = true,
+            .minValue = 0,
+            .maxValue = 10,
+            .maxLength = 0
+        },
+        {
+            .key = "speedKi",
+            .category = "Speed",
+            .type = ConfigType::FLOAT,
+            .valuePtr = &config.speedKi,
+            .defaultPtr = &defaults.speedKi,
+            .hasRange = true,
+            .minValue = 0,
+            .maxValue = 50,
+            .maxLength = 0
+        },
+        {
+            .key = "speedKd",
+            .category = "Speed",
+            .type = ConfigType::FLOAT,
+            .valuePtr = &config.speedKd,
+            .defaultPtr = &defaults.speedKd,
+            .hasRange = true,
+            .minValue = 0,
+            .maxValue = 1,
+            .maxLength = 0
+        },
+        {
+            .key = "speedKff",
+            .category = "Speed",
+            .type = ConfigType::FLOAT,
+            .valuePtr = &config.speedKff,
+            .defaultPtr = &defaults.speedKff,
+            .hasRange = true,
+            .minValue = 0,
+            .maxValue = 2,
+            .maxLength = 0
+        },
+        
+        // Joystick
+        {
+            .key = "joyDeadzone",
+            .category = "Joystick",
+            .type = ConfigType::UINT8,
+            .valuePtr = &config.joyDeadzone,
+            .defaultPtr = &defaults.joyDeadzone,
+            .hasRange = true,
+            .minValue = 0,
+            .maxValue = 50,
+            .maxLength = 0
+        },
+        {
+            .key = "joyExpo",
+            .category = "Joystick",
+            .type = ConfigType::UINT8,
+            .valuePtr = &config.joyExpo,
+            .defaultPtr = &defaults.joyExpo,
+            .hasRange = true,
+            .minValue = 0,
+            .maxValue = 100,
+            .maxLength = 0
+        },
+        
         // Power
         {
             .key = "autoShutdownEnabled",
@@ -264,6 +576,61 @@ ConfigScheme UserConfig::buildScheme() {
             .maxValue = 0,
             .maxLength = 0
         },
+        {
+            .key = "batteryCapacity",
+            .category = "Power",
+            .type = ConfigType::UINT16,
+            .valuePtr = &config.batteryCapacity,
+            .defaultPtr = &defaults.batteryCapacity,
+            .hasRange = true,
+            .minValue = 100,
+            .maxValue = 60000,
+            .maxLength = 0
+        },
+        {
+            .key = "voltCalLowRaw",
+            .category = "Power",
+            .type = ConfigType::UINT16,
+            .valuePtr = &config.voltCalLowRaw,
+            .defaultPtr = &defaults.voltCalLowRaw,
+            .hasRange = true,
+            .minValue = 0,
+            .maxValue = 30000,
+            .maxLength = 0
+        },
+        {
+            .key = "voltCalLowRef",
+            .category = "Power",
+            .type = ConfigType::UINT16,
+            .valuePtr = &config.voltCalLowRef,
+            .defaultPtr = &defaults.voltCalLowRef,
+            .hasRange = true,
+            .minValue = 0,
+            .maxValue = 30000,
+            .maxLength = 0
+        },
+        {
+            .key = "voltCalHighRaw",
+            .category = "Power",
+            .type = ConfigType::UINT16,
+            .valuePtr = &config.voltCalHighRaw,
+            .defaultPtr = &defaults.voltCalHighRaw,
+            .hasRange = true,
+            .minValue = 0,
+            .maxValue = 30000,
+            .maxLength = 0
+        },
+        {
+            .key = "voltCalHighRef",
+            .category = "Power",
+            .type = ConfigType::UINT16,
+            .valuePtr = &config.voltCalHighRef,
+            .defaultPtr = &defaults.voltCalHighRef,
+            .hasRange = true,
+            .minValue = 0,
+            .maxValue = 30000,
+            .maxLength = 0
+        },
         
         // Debug
         {
@@ -296,9 +663,37 @@ void UserConfig::initDefaults() {
     defaults.espnowTimeout = ESPNOW_TIMEOUT;
     strncpy(defaults.espnowPeerMac, ESPNOW_PEER_MAC, sizeof(defaults.espnowPeerMac) - 1);
     defaults.espnowPeerMac[sizeof(defaults.espnowPeerMac) - 1] = '\0';
+    defaults.espnowEncrypt = ESPNOW_ENCRYPT;
+    strncpy(defaults.espnowPsk, ESPNOW_PSK, sizeof(defaults.espnowPsk) - 1);
+    defaults.espnowPsk[sizeof(defaults.espnowPsk) - 1] = '\0';
+    
+    // Motor
+    defaults.motorAccel = MOTOR_ACCEL_RATE;
+    defaults.motorDecel = MOTOR_DECEL_RATE;
+    defaults.motorMinPwm = MOTOR_MIN_PWM;
+    defaults.motorTrimLeft = MOTOR_TRIM_LEFT;
+    defaults.motorTrimRight = MOTOR_TRIM_RIGHT;
+    defaults.motorCurrentLimit = MOTOR_CURRENT_LIMIT;
+    defaults.motorVoltComp = MOTOR_VOLT_COMP;
+    
+    // Drehzahlregelung
+    defaults.speedLoop = SPEED_LOOP_ENABLED;
+    defaults.speedKp = SPEED_KP;
+    defaults.speedKi = SPEED_KI;
+    defaults.speedKd = SPEED_KD;
+    defaults.speedKff = SPEED_KFF;
+    
+    // Joystick
+    defaults.joyDeadzone = JOY_DEADZONE;
+    defaults.joyExpo = JOY_EXPO;
      
     // Power
     defaults.autoShutdownEnabled = AUTO_SHUTDOWN;
+    defaults.batteryCapacity = BATTERY_CAPACITY;
+    defaults.voltCalLowRaw = VOLT_CAL_LOW_RAW;
+    defaults.voltCalLowRef = VOLT_CAL_LOW_REF;
+    defaults.voltCalHighRaw = VOLT_CAL_HIGH_RAW;
+    defaults.voltCalHighRef = VOLT_CAL_HIGH_REF;
     
     // Debug
     defaults.debugSerialEnabled = DEBUG_SERIAL;
@@ -0,0 +1,100 @@
+/**
+ * WheelEncoder.cpp
+ *
+ * Implementation des PCNT-Quadratur-Encoders
+ */
+
+#include "include/WheelEncoder.h"
+
+// Hardware-Zähler ist 16 Bit, accum_count erweitert an den Grenzen
+static const int PCNT_LIMIT = 30000;
+
+WheelEncoder::WheelEncoder()
+    : unit(nullptr)
+{
+    channels[0] = nullptr;
+    channels[1] = nullptr;
+}
+
+bool WheelEncoder::begin(uint8_t pinA, uint8_t pinB) {
+    pcnt_unit_config_t unitConfig = {};
+    unitConfig.low_limit = -PCNT_LIMIT;
+    unitConfig.high_limit = PCNT_LIMIT;
+    unitConfig.flags.accum_count = 1;
+
+    pcnt_unit_handle_t newUnit = nullptr;
+    if (pcnt_new_unit(&unitConfig, &newUnit) != ESP_OK) {
+        return false;
+    }
+
+    pcnt_glitch_filter_config_t filterConfig = {};
+    filterConfig.max_glitch_ns = ENCODER_GLITCH_NS;
+    pcnt_unit_set_glitch_filter(newUnit, &filterConfig);
+
+    // Kanal A zählt Flanken auf A, Richtung aus Pegel B - Kanal B umgekehrt
+    pcnt_chan_config_t chanA = {};
+    chanA.edge_gpio_num = pinA;
+    chanA.level_gpio_num = pinB;
+    pcnt_chan_config_t chanB = {};
+    chanB.edge_gpio_num = pinB;
+    chanB.level_gpio_num = pinA;
+
+    pcnt_channel_handle_t channelA = nullptr;
+    pcnt_channel_handle_t channelB = nullptr;
+    if (pcnt_new_channel(newUnit, &chanA, &channelA) != ESP_OK ||
+        pcnt_new_channel(newUnit, &chanB, &channelB) != ESP_OK) {
+        release(newUnit, channelA, channelB);
+        return false;
+    }
+
+    pcnt_channel_set_edge_action(channelA, PCNT_CHANNEL_EDGE_ACTION_DECREASE, PCNT_CHANNEL_EDGE_ACTION_INCREASE);
+    pcnt_channel_set_level_action(channelA, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE);
+    pcnt_channel_set_edge_action(channelB, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_DECREASE);
+    pcnt_channel_set_level_action(channelB, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE);
+
+    // Watch-Points an den Grenzen: nötig für accum_count
+    pcnt_unit_add_watch_point(newUnit, -PCNT_LIMIT);
+    pcnt_unit_add_watch_point(newUnit, PCNT_LIMIT);
+
+    if (pcnt_unit_enable(newUnit) != ESP_OK) {
+        release(newUnit, channelA, channelB);
+        return false;
+    }
+    if (pcnt_unit_clear_count(newUnit) != ESP_OK ||
+        pcnt_unit_start(newUnit) != ESP_OK) {
+        pcnt_unit_disable(newUnit);
+        release(newUnit, channelA, channelB);
+        return false;
+    }
+
+    unit = newUnit;
+    channels[0] = channelA;
+    channels[1] = channelB;
+    return true;
+}
+
+void WheelEncoder::end() {
+    if (!unit) return;
+
+    pcnt_unit_stop(unit);
+    pcnt_unit_disable(unit);
+    release(unit, channels[0], channels[1]);
+    unit = nullptr;
+    channels[0] = nullptr;
+    channels[1] = nullptr;
+}
+
+void WheelEncoder::release(pcnt_unit_handle_t u, pcnt_channel_handle_t a, pcnt_channel_handle_t b) {
+    // Kanäle vor der Unit löschen (pcnt_del_unit schlägt sonst fehl)
+    if (a) pcnt_del_channel(a);
+    if (b) pcnt_del_channel(b);
+    if (u) pcnt_del_unit(u);
+}
+
+int32_t WheelEncoder::read() const {
+    if (!unit) return 0;
+
+    int count = 0;
+    pcnt_unit_get_count(unit, &count);
+    return count;
+}
@@ -0,0 +1,106 @@
+/**
+ * AdcConverter.h
+ *
+ * Integer-Umrechnung ADC-Counts → mV / mA (O(1), keine Gleitkomma-Rechnung pro Wert)
+ *
+ * Features:
+ * - Pin-Kennlinie Counts → mV als Stützstellen-Tabelle (alle 32 Counts,
+ *   129 Punkte), dazwischen linear interpoliert
+ * - Tabelle aus der Werkskalibrierung im eFuse (adc_cali Curve/Line Fitting,
+ *   erstellt in BatteryMonitor::begin()), ohne eFuse-Daten ideal linear
+ * - AdcLinear: lineare Abbildung mV → Messgröße (Faktor Q16 + Offset) für
+ *   Spannungsteiler, Sensor-Sensitivität und Zwei-Punkt-Korrektur
+ *
+ * Ohne Arduino-Abhängigkeiten (Host-Test: tools/adc_conv_check.cpp).
+ */
+
+#ifndef ADC_CONVERTER_H
+#define ADC_CONVERTER_H
+
+#include <stdint.h>
+
+/**
+ * Lineare Abbildung y = x · gain + offset (Festkomma)
+ */
+struct AdcLinear {
+    int32_t gainQ16;            // Faktor · 65536
+    int32_t offset;             // In Einheiten des Ergebnisses
+
+    inline int32_t apply(int32_t x) const {
+        return (int32_t)(((int64_t)x * gainQ16 + 0x8000) >> 16) + offset;
+    }
+
+    /**
+     * Abbildung aus Faktor und Offset (nur bei der Einrichtung, nicht im Takt)
+     */
+    static AdcLinear make(float gain, int32_t offset = 0);
+
+    /**
+     * Gerade durch zwei Punkte (x1 → y1, x2 → y2)
+     * @return false wenn x1 == x2
+     */
+    static bool fromPoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, AdcLinear& out);
+
+    /**
+     * Hintereinanderschalten: erst diese Abbildung, dann next
+     */
+    AdcLinear then(const AdcLinear& next) const;
+
+    float getGain() const { return gainQ16 / 65536.0f; }
+};
+
+class AdcConverter {
+public:
+    static const uint16_t MAX_COUNTS = 4095;        // 12 Bit
+    static const uint8_t LUT_SHIFT = 5;             // Stützpunkt alle 32 Counts
+    static const uint16_t LUT_POINTS = ((MAX_COUNTS + 1) >> LUT_SHIFT) + 1;
+
+    /**
+     * Kennlinien-Quelle: Rohwert → mV (z.B. adc_cali_raw_to_voltage)
+     */
+    typedef int (*RawToMv)(int raw, void* ctx);
+
+    /**
+     * Konstruktor (ideal linear, 3300 mV bei 4095 Counts)
+     */
+    AdcConverter();
+
+    /**
+     * Ideal lineare Kennlinie
+     * @param fullScaleMv mV bei MAX_COUNTS
+     */
+    void setLinear(uint16_t fullScaleMv);
+
+    /**
+     * Tabelle aus einer Kennlinien-Quelle füllen (einmalig, LUT_POINTS Aufrufe)
+     * @param source Rohwert → mV
+     * @param ctx Kontext für source (z.B. adc_cali-Handle)
+     * @param name Bezeichnung für Debug-Ausgaben
+     */
+    void build(RawToMv source, void* ctx, const char* name);
+
+    /**
+     * Counts → Pin-Spannung in mV
+     */
+    inline int32_t toMv(uint16_t counts) const {
+        if (counts > MAX_COUNTS) counts = MAX_COUNTS;
+        uint16_t i = counts >> LUT_SHIFT;
+        int32_t frac = counts & ((1 << LUT_SHIFT) - 1);
+        int32_t base = lut[i];
+        return base + (((lut[i + 1] - base) * frac + (1 << (LUT_SHIFT - 1))) >> LUT_SHIFT);
+    }
+
+    /**
+     * Gemittelte (gebrochene) Counts → mV, z.B. Strom-Nullpunkt
+     */
+    float toMvFloat(float counts) const;
+
+    uint16_t getPoint(uint16_t i) const { return i < LUT_POINTS ? lut[i] : 0; }
+    const char* getName() const { return name; }
+
+private:
+    uint16_t lut[LUT_POINTS];      // mV bei Counts = i · 32 (letzter Punkt: 4096, extrapoliert)
+    const char* name;
+};
+
+#endif // ADC_CONVERTER_H
@@ -0,0 +1,157 @@
+/**
+ * AdcSampler.h
+ *
+ * Kontinuierliche ADC-Abtastung (DMA) für Akkuspannung und Motorstrom
+ *
+ * Features:
+ * - ESP-IDF adc_continuous: beide Pins abwechselnd mit ADC_SAMPLE_HZ in DMA-Frames
+ * - Dezimation: Mittelwert über ADC_DECIMATION Rohwerte pro Kanal (Tiefpass,
+ *   ~1 kHz Ausgaberate), letzter Blockwert ohne Lock abrufbar (Strombegrenzer)
+ * - Fenster-Statistik pro Kanal (Mittelwert, Min, Max der dezimierten Werte)
+ *   seit dem letzten Abruf - Ripple und Lastspitzen zwischen zwei
+ *   BatteryMonitor::update() bleiben sichtbar
+ * - Verarbeitung in eigenem Task (vom DMA-Interrupt geweckt), CPU-Zyklen
+ *   pro Frame und Auslastung gemessen
+ *
+ * Werte sind rohe 12-Bit ADC-Counts (wie analogRead), Umrechnung im BatteryMonitor.
+ * Solange der Sampler läuft, darf auf ADC1 kein analogRead() erfolgen.
+ */
+
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include <Arduino.h>
+#include <esp_adc/adc_continuous.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "setupConf.h"
+
+enum AdcChannelId : uint8_t {
+    ADC_CH_VOLTAGE = 0,
+    ADC_CH_CURRENT = 1,
+    ADC_CH_COUNT = 2
+};
+
+/**
+ * Fenster-Statistik eines Kanals (dezimierte Werte, ADC-Counts)
+ */
+struct AdcWindow {
+    uint32_t blocks;            // Dezimierte Werte im Fenster
+    uint16_t mean;
+    uint16_t min;
+    uint16_t max;
+};
+
+/**
+ * Laufzeit-Statistik der Abtastung
+ */
+struct AdcSamplerStats {
+    bool running;
+    uint32_t frames;            // Verarbeitete DMA-Frames
+    uint32_t samples;           // Rohwerte gesamt
+    uint32_t overflows;         // DMA-Pool übergelaufen (Task zu langsam)
+    uint32_t foreign;           // Rohwerte fremder Kanäle (verworfen)
+    uint32_t sampleRateHz;      // Gemessene Rohwerte pro Sekunde (beide Kanäle)
+    uint32_t lastFrameCycles;   // CPU-Zyklen letzter Frame
+    uint32_t maxFrameCycles;
+    uint32_t cyclesPerSample;   // Mittel
+    uint32_t cpuLoadPermille;   // Anteil eines Kerns (‰)
+};
+
+class AdcSampler {
+public:
+    /**
+     * Konstruktor
+     */
+    AdcSampler();
+
+    /**
+     * Destruktor
+     */
+    ~AdcSampler();
+
+    /**
+     * Kontinuierliche Abtastung starten
+     * @param voltagePin GPIO Spannungssensor (ADC1)
+     * @param currentPin GPIO Stromsensor (ADC1)
+     * @return true bei Erfolg (sonst weiter mit analogRead)
+     */
+    bool begin(uint8_t voltagePin, uint8_t currentPin);
+
+    /**
+     * Abtastung stoppen und Treiber freigeben
+     */
+    void end();
+
+    bool isRunning() const { return running; }
+
+    /**
+     * Letzter dezimierter Wert (lockfrei, aus jedem Kontext)
+     * @return ADC-Counts
+     */
+    uint16_t getFastRaw(AdcChannelId ch) const { return fastRaw[ch]; }
+
+    /**
+     * Fenster-Statistik seit dem letzten Abruf holen und neues Fenster beginnen
+     * @return false wenn im Fenster noch kein Wert lag
+     */
+    bool takeWindow(AdcChannelId ch, AdcWindow& out);
+
+    /**
+     * Statistik
+     */
+    AdcSamplerStats getStats() const;
+    void resetStats();
+
+    /**
+     * Debug-Informationen ausgeben
+     */
+    void printInfo() const;
+
+private:
+    adc_continuous_handle_t handle;
+    TaskHandle_t task;
+    volatile bool running;
+
+    // ADC-Kanalnummer → AdcChannelId (-1 = fremd)
+    int8_t slotOf[16];
+
+    // Dezimation (nur Task)
+    uint32_t decimSum[ADC_CH_COUNT];
+    uint16_t decimCount[ADC_CH_COUNT];
+    volatile uint16_t fastRaw[ADC_CH_COUNT];
+
+    // Fenster (Task schreibt, BatteryMonitor holt ab)
+    portMUX_TYPE windowLock;
+    uint32_t windowSum[ADC_CH_COUNT];
+    uint32_t windowBlocks[ADC_CH_COUNT];
+    uint16_t windowMin[ADC_CH_COUNT];
+    uint16_t windowMax[ADC_CH_COUNT];
+
+    // Statistik
+    uint32_t frames;
+    uint32_t samples;
+    volatile uint32_t overflows;
+    uint32_t foreign;
+    uint32_t lastFrameCycles;
+    uint32_t maxFrameCycles;
+    uint64_t busyCycles;
+    int64_t statsStartUs;
+
+    uint8_t frameBuffer[ADC_DMA_FRAME_SIZE];
+
+    // DMA-Callbacks (ISR-Kontext)
+    static bool IRAM_ATTR onConvDone(adc_continuous_handle_t handle,
+                                     const adc_continuous_evt_data_t* data, void* arg);
+    static bool IRAM_ATTR onPoolOverflow(adc_continuous_handle_t handle,
+                                         const adc_continuous_evt_data_t* data, void* arg);
+
+    // Verarbeitungs-Task
+    static void taskEntry(void* arg);
+    void processFrame(const uint8_t* buffer, uint32_t length);
+
+    // Dezimierten Wert ins Fenster übernehmen
+    void pushBlock(uint8_t slot, uint16_t value);
+};
+
+#endif // ADC_SAMPLER_H
@@ -0,0 +1,182 @@
+/**
+ * BatteryHistory.h
+ *
+ * Akku-Verlauf als Ringspeicher auf SD (Round-Robin, feste Dateigröße)
+ *
+ * Features:
+ * - Drei Stufen: 1 s für 10 min, 1 min für 24 h, 1 h für 30 Tage
+ *   (Slot-Anzahl: HISTORY_*_SLOTS in setupConf.h)
+ * - Pro Record Min/Mittel/Max von Spannung und Strom, entnommene Ladung
+ *   und Energie im Intervall
+ * - Datei wird einmal in voller Größe angelegt, danach nur noch an fester
+ *   Position überschrieben (kein Wachstum, kein Löschen)
+ * - 1-s-Werte im RAM gesammelt und alle HISTORY_FLUSH_MS am Stück
+ *   geschrieben, offene Minuten-/Stunden-Aggregate werden mitgesichert
+ *   und nach einem Neustart fortgesetzt
+ * - Zeitachse: Betriebssekunden über alle Starts (kein RTC), fortgesetzt
+ *   ab der letzten gesicherten Sekunde
+ *
+ * Dateiformat (Little Endian):
+ *   HistoryFileHeader (32 Bytes)
+ *   HistoryRecord (28 Bytes) * HISTORY_SECONDS_SLOTS   (Stufe 0)
+ *   HistoryRecord (28 Bytes) * HISTORY_MINUTES_SLOTS   (Stufe 1)
+ *   HistoryRecord (28 Bytes) * HISTORY_HOURS_SLOTS     (Stufe 2)
+ *   Slot eines Intervalls = (time / Periode) % Slots
+ */
+
+#ifndef BATTERY_HISTORY_H
+#define BATTERY_HISTORY_H
+
+#include <Arduino.h>
+#include "setupConf.h"
+#include "SDCardHandler.h"
+
+class BatteryMonitor;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DATEIFORMAT
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define HISTORY_MAGIC           "EBHI"
+#define HISTORY_VERSION         1
+#define HISTORY_TIERS           3
+
+struct __attribute__((packed)) HistoryFileHeader {
+    char magic[4];              // "EBHI"
+    uint16_t version;           // Formatversion
+    uint16_t headerSize;        // sizeof(HistoryFileHeader)
+    uint16_t recordSize;        // sizeof(HistoryRecord)
+    uint16_t tierCount;         // HISTORY_TIERS
+    uint16_t slots[HISTORY_TIERS];  // Slots pro Stufe
+    uint16_t reserved;
+    uint32_t lastTime;          // Letzte gesicherte Betriebssekunde
+    uint32_t flushes;           // Schreibvorgänge gesamt (Info)
+    uint32_t crc;               // CRC32 über die Felder davor
+};
+
+struct __attribute__((packed)) HistoryRecord {
+    uint32_t time;              // Betriebssekunde am Intervallbeginn
+    uint16_t voltageMinMv;
+    uint16_t voltageAvgMv;
+    uint16_t voltageMaxMv;
+    int16_t currentMinMa;
+    int16_t currentAvgMa;
+    int16_t currentMaxMa;
+    uint32_t chargeUah;         // Entnommene Ladung im Intervall (µAh)
+    uint32_t energyUwh;         // Entnommene Energie im Intervall (µWh)
+    uint16_t samples;           // 1-s-Werte im Intervall (0 = Slot leer)
+    uint16_t reserved;
+};
+
+static_assert(sizeof(HistoryFileHeader) == 32, "HistoryFileHeader muss 32 Bytes sein");
+static_assert(sizeof(HistoryRecord) == 28, "HistoryRecord muss 28 Bytes sein");
+
+// ═══════════════════════════════════════════════════════════════════════════
+// BATTERY HISTORY
+// ═══════════════════════════════════════════════════════════════════════════
+
+class BatteryHistory {
+public:
+    /**
+     * Konstruktor
+     */
+    BatteryHistory();
+
+    /**
+     * Datei öffnen bzw. in voller Größe anlegen (falsches Layout → neu)
+     * @param sdHandler Pointer zum SDCardHandler
+     * @return true bei Erfolg
+     */
+    bool begin(SDCardHandler* sdHandler);
+
+    /**
+     * Messintervall übernehmen (nach erfolgreichem BatteryMonitor::update())
+     * Mittel/Min/Max aus dem Intervall, Ladung/Energie als Zählerdifferenz
+     * @param battery BatteryMonitor
+     */
+    void addSample(BatteryMonitor& battery);
+
+    /**
+     * Gepufferte 1-s-Werte, offene Aggregate und Header sofort schreiben
+     */
+    void flush();
+
+    /**
+     * Records einer Stufe lesen (chronologisch, ältester zuerst)
+     * Leere oder überholte Slots werden mit samples = 0 geliefert
+     * @param tier Stufe (0 = Sekunden, 1 = Minuten, 2 = Stunden)
+     * @param skip Anzahl neuester Intervalle überspringen (0 = bis jetzt)
+     * @param out Zielpuffer
+     * @param count Gewünschte Anzahl
+     * @return Anzahl gelieferter Records (≤ count)
+     */
+    uint32_t read(uint8_t tier, uint32_t skip, HistoryRecord* out, uint32_t count);
+
+    /**
+     * Aktuelle Betriebssekunde (Zeitachse des Verlaufs)
+     */
+    uint32_t getTime() const;
+
+    /**
+     * Periode einer Stufe in Sekunden
+     */
+    static uint32_t getPeriod(uint8_t tier);
+
+    /**
+     * Slots einer Stufe
+     */
+    static uint32_t getSlots(uint8_t tier);
+
+    bool isReady() const { return ready; }
+
+    /**
+     * Debug-Informationen ausgeben
+     */
+    void printInfo() const;
+
+private:
+    /**
+     * Offenes Minuten-/Stunden-Intervall mit exakten Summen
+     */
+    struct Aggregate {
+        HistoryRecord rec;
+        uint32_t voltageSumMv;
+        int32_t currentSumMa;
+    };
+
+    SDCardHandler* sdHandler;
+    bool ready;
+
+    uint32_t baseTime;             // Betriebssekunde bei begin()
+    unsigned long baseMs;          // millis() bei begin()
+    uint32_t lastTime;             // Letzte übernommene Sekunde
+    uint32_t flushes;
+    float lastConsumedMAh;
+    float lastConsumedWh;
+    bool haveCounters;             // Zählerstand für Differenz vorhanden
+
+    HistoryRecord pending[HISTORY_FLUSH_RECORDS];  // Ungeschriebene 1-s-Werte
+    uint8_t pendingCount;
+    Aggregate open[HISTORY_TIERS - 1];             // Stufe 1 und 2
+    unsigned long lastFlushMs;
+
+    // Statistik
+    uint32_t samplesTotal;
+    uint32_t writeErrors;
+    uint32_t flushUsLast;
+    uint32_t flushUsMax;
+
+    bool createFile();
+    bool loadHeader(HistoryFileHeader& header);
+    bool writeHeader();
+    bool writeRecords(uint8_t tier, uint32_t slot, const HistoryRecord* recs, uint32_t count);
+    static uint32_t tierOffset(uint8_t tier);
+
+    /**
+     * Neues Intervall beginnen, auf SD angefangenes Intervall fortsetzen
+     */
+    void openInterval(uint8_t tier, uint32_t start);
+    static void fold(Aggregate& agg, const HistoryRecord& sample);
+};
+
+#endif // BATTERY_HISTORY_H
@@ -4,11 +4,19 @@
  * Batterie-Überwachung für 4S Li-Ion (12.8V - 16.8V) mit ACS712-20A Stromsensor
  * 
  * Features:
+ * - Kontinuierliche DMA-Abtastung (AdcSampler), Fallback analogRead
+ * - Umrechnung mit eFuse-Werkskalibrierung in Integer-mV/mA (AdcConverter),
+ *   optionale Zwei-Punkt-Korrektur der Spannung (voltCal* in UserConfig)
  * - Spannungsmessung mit Glättung (Moving Average)
+ * - Min/Max von Spannung und Strom pro Messintervall (Ripple, Lastspitzen)
  * - Strommessung mit ACS712-20A (3.3V Versorgung)
  * - Leistungsberechnung (Watt)
  * - Energieverbrauch (mAh, Wh)
- * - Prozentberechnung (0-100%)
+ * - Ladezustand aus Coulomb-Zählung + Ruhespannung (SocEstimator), über Neustart gesichert
+ * - Innenwiderstand aus Lastsprüngen (ResistanceEstimator), für IR-Korrektur und Alterung
+ * - Restlaufzeit bis leer / Abschaltung / Drosselung aus Leistung und Fahranteil (RuntimePredictor)
+ * - Unterspannung: Einbruch unter Last (U + I·R über VOLTAGE_SHUTDOWN) löst keinen
+ *   Shutdown aus, erst SAG_CONFIRM_MS echte Unterspannung (Drosselung: SagGuard)
  * - Low-Voltage Warnung
  * - High-Current Warnung
  * - Auto-Shutdown bei Unterspannung
@@ -22,6 +30,22 @@
 #include "Globals.h"
 #include <Arduino.h>
 #include "setupConf.h"
+#include "AdcSampler.h"
+#include "AdcConverter.h"
+#include <esp_adc/adc_cali.h>
+#include "Filters.h"
+#include "SocEstimator.h"
+#include "RuntimePredictor.h"
+#include "ResistanceEstimator.h"
+
+/**
+ * Gesicherter Strom-Nullpunkt (CURRENT_CAL_FILE)
+ */
+struct CurrentOffsetState {
+    uint32_t magic;             // CURRENT_CAL_MAGIC
+    float offsetCounts;         // Nullpunkt in ADC-Counts
+    uint32_t crc;               // CRC32 über die Felder davor
+};
 
 // Callback-Typen
 typedef void (*BatteryWarningCallback)(float voltage, uint8_t percent);
@@ -58,6 +82,14 @@ public:
      */
     float getVoltage();
 
+    /**
+     * Gefilterte Spannung für den Motor-Regeltakt (lockfrei)
+     * Der Zähler wechselt mit jeder neuen Messung (alle VOLTAGE_CHECK_INTERVAL ms)
+     * @return Spannung in mV
+     */
+    int32_t getVoltageMv() const { return filteredMv; }
+    uint32_t getVoltageSamples() const { return voltageSamples; }
+
     /**
      * Rohe Batteriespannung abrufen (ungefiltert)
      * @return Spannung in Volt
@@ -76,6 +108,54 @@ public:
      */
     float getRawCurrent();
 
+    /**
+     * Min/Max im letzten Messintervall (dezimierte DMA-Werte, sonst = Rohwert)
+     */
+    float getVoltageMin() const { return voltageMin; }
+    float getVoltageMax() const { return voltageMax; }
+    float getCurrentMin() const { return currentMin; }
+    float getCurrentMax() const { return currentMax; }
+
+    /**
+     * Strom direkt vom ADC lesen (Integer, ohne Filter/Zustand)
+     * Für den Strombegrenzer im Motor-Regeltakt, darf parallel zu update() laufen
+     * Mit DMA-Abtastung: letzter dezimierter Wert (kein ADC-Zugriff im Takt)
+     * @return Strom in mA (≥ 0)
+     */
+    int32_t readCurrentFastMa() const;
+
+    /**
+     * Packspannung direkt vom ADC lesen (Integer, ohne Filter/Zustand)
+     * Für den Spannungs-Wächter im Motor-Regeltakt, wie readCurrentFastMa()
+     * @return Spannung in mV
+     */
+    int32_t readVoltageFastMv() const;
+
+    /**
+     * DMA-Abtastung (Statistik, CPU-Kosten)
+     */
+    const AdcSampler& getSampler() const { return sampler; }
+
+    /**
+     * ADC-Kennlinie (Quelle, Stützpunkte) und Spannungs-Korrektur
+     */
+    const AdcConverter& getAdcConverter() const { return adcConv; }
+    const AdcLinear& getVoltageCorrection() const { return voltageCorrection; }
+    bool isVoltageCorrected() const { return voltageCorrected; }
+
+    /**
+     * Gefilterte Spannung ohne Zwei-Punkt-Korrektur (Referenz für voltCal*)
+     * @return Spannung in mV
+     */
+    uint16_t getUncorrectedMillivolts() const;
+
+    /**
+     * Werkskalibrierung für alle Rohwerte als CSV ausgeben ("raw,mv")
+     * Aufzeichnung für den Host-Test tools/adc_conv_check.cpp
+     * @return false ohne eFuse-Kalibrierung
+     */
+    bool printAdcCurve(Print& out) const;
+
     /**
      * Aktuelle Leistung abrufen
      * @return Leistung in Watt
@@ -101,11 +181,37 @@ public:
     uint8_t getPercent();
 
     /**
-     * Ist Batterie in kritischem Zustand?
-     * @return true wenn Spannung <= VOLTAGE_SHUTDOWN
+     * Ladezustands-Schätzung (Innenwiderstand setzen, Details)
+     */
+    SocEstimator& getSocEstimator() { return soc; }
+
+    /**
+     * Innenwiderstands-Schätzung (Lastsprünge, Alterung)
+     */
+    const ResistanceEstimator& getResistanceEstimator() const { return ir; }
+
+    /**
+     * Restlaufzeit-Prognose (bis leer / Abschaltung / Drosselung bei Fahrstrom)
+     */
+    const RuntimePredictor& getRuntime() const { return runtime; }
+
+    /**
+     * Ladezustand und Innenwiderstand auf SD sichern (vor Sleep/Neustart)
+     */
+    void saveState() { soc.save(); ir.save(); }
+
+    /**
+     * Ist Batterie in kritischem Zustand (leer, nicht nur Einbruch unter Last)?
+     * @return true wenn Spannung + I·R seit SAG_CONFIRM_MS <= VOLTAGE_SHUTDOWN
      */
     bool isCritical();
 
+    /**
+     * Spannung ohne Lasteinbruch (Messintervall, U + I·R)
+     * @return Spannung in Volt
+     */
+    float getCompensatedVoltage() const { return compensatedVoltage; }
+
     /**
      * Ist Low-Battery Warnung aktiv?
      * @return true wenn Spannung <= VOLTAGE_ALARM_LOW
@@ -119,12 +225,19 @@ public:
     bool isCurrentHigh();
 
     /**
-     * Stromsensor kalibrieren (Nullpunkt-Offset)
-     * Sollte ohne Last aufgerufen werden
+     * Stromsensor sofort kalibrieren (Nullpunkt-Offset, blockiert samples × 10 ms)
+     * Sollte ohne Last aufgerufen werden. Im Betrieb nicht nötig: update()
+     * kalibriert im Hintergrund, sobald die Motoren stehen.
      * @param samples Anzahl Messungen für Durchschnitt (default: 100)
      */
     void calibrateCurrent(uint16_t samples = 100);
 
+    /**
+     * Nullpunkt seit dem Start im Stillstand gemessen?
+     * (sonst gesicherter Wert von SD oder Soll-Nullpunkt)
+     */
+    bool isCurrentCalibrated() const { return currentCalibrated; }
+
     /**
      * Energiezähler zurücksetzen
      */
@@ -165,11 +278,25 @@ public:
     void printInfo();
 
 private:
+    AdcSampler sampler;            // Kontinuierliche Abtastung (falls verfügbar)
+    AdcConverter adcConv;          // Counts → Pin-mV (eFuse-Kennlinie)
+    adc_cali_handle_t adcCali;     // Werkskalibrierung (nullptr = linear)
+    AdcLinear voltageScale;        // Pin-mV → Pack-mV (Spannungsteiler)
+    AdcLinear voltageCorrection;   // Zwei-Punkt-Korrektur (Pack-mV)
+    AdcLinear voltageMap;          // Beides zusammen
+    AdcLinear currentScale;        // Pin-mV → mA (Sensitivität)
+    bool voltageCorrected;         // Korrektur aktiv
+    uint32_t calRevision;          // Config-Stand der Korrektur
+    SocEstimator soc;              // Ladezustand
+    RuntimePredictor runtime;      // Restlaufzeit
+    ResistanceEstimator ir;        // Innenwiderstand
     bool initialized;              // Initialisierungs-Flag
     bool autoShutdownEnabled;      // Auto-Shutdown aktiv?
     
     // Spannungsmessung
     float currentVoltage;          // Aktuelle gefilterte Spannung
+    volatile int32_t filteredMv;   // ... in mV (für den Regel-Takt)
+    volatile uint32_t voltageSamples; // Messungen seit Start
     float rawVoltage;              // Rohe ungefilterte Spannung
     uint8_t currentPercent;        // Aktueller Ladezustand in %
     
@@ -178,23 +305,33 @@ private:
     float rawCurrent;              // Roher ungefilterter Strom (A)
     float currentPower;            // Aktuelle Leistung (W)
     float currentOffset;           // Kalibrierungs-Offset für Nullpunkt
+    volatile int32_t currentZeroMa; // Nullpunkt in mA-Skala (für readCurrentFastMa)
+    float currentOffsetCounts;     // Nullpunkt in ADC-Counts (ungerundet)
+    
+    // Nullpunkt-Kalibrierung im Hintergrund
+    bool currentCalibrated;        // Seit Start im Stillstand gemessen
+    bool currentOffsetRestored;    // Startwert von SD
+    float savedOffsetCounts;       // Zuletzt gesicherter Nullpunkt
+    int32_t calSum;
+    uint16_t calCount;
+    unsigned long calLastSample;
+    unsigned long idleSince;       // Motoren stehen seit (0 = Fahrt)
+    unsigned long lastCalTime;
+    
+    // Min/Max im letzten Messintervall
+    float voltageMin;
+    float voltageMax;
+    float currentMin;
+    float currentMax;
     
     // Energiezähler
     float consumedMAh;             // Verbrauchte Energie in mAh
     float consumedWh;              // Verbrauchte Energie in Wh
     unsigned long lastEnergyUpdate; // Letztes Update für Energieberechnung
     
-    // Moving Average Filter (Spannung)
-    static const uint8_t VOLTAGE_FILTER_SAMPLES = 10;
-    float voltageBuffer[VOLTAGE_FILTER_SAMPLES];
-    uint8_t voltageBufferIndex;
-    bool voltageBufferFilled;
-    
-    // Moving Average Filter (Strom)
-    static const uint8_t CURRENT_FILTER_SAMPLES = 20;
-    float currentBuffer[CURRENT_FILTER_SAMPLES];
-    uint8_t currentBufferIndex;
-    bool currentBufferFilled;
+    // Moving Average Filter (laufende Summe, O(1) pro Messung)
+    MovingAverage<float, 10> voltageFilter;
+    MovingAverage<float, 20> currentFilter;
     
     // Timing
     unsigned long lastUpdateTime;
@@ -206,43 +343,76 @@ private:
     bool criticalActive;           // Kritischer Zustand aktiv
     bool currentWarningActive;     // Strom-Warnung aktiv
     
+    // Unterspannung: Lasteinbruch vs. leerer Akku
+    float compensatedVoltage;      // U + I·R (Messintervall)
+    unsigned long underVoltageSince; // Kompensiert unter VOLTAGE_SHUTDOWN seit (0 = nein)
+    bool depleted;                 // Seit SAG_CONFIRM_MS unter VOLTAGE_SHUTDOWN
+    bool sagReported;              // Einbruch unter Last gemeldet
+    
     // Callbacks
     BatteryWarningCallback warningCallback;
     BatteryShutdownCallback shutdownCallback;
     CurrentWarningCallback currentWarningCallback;
     
     /**
-     * Rohe ADC-Spannung auslesen
-     * @return Spannung in Volt
+     * Messfenster eines Kanals holen (DMA-Fenster oder einzelnes analogRead)
      */
-    float readRawVoltage();
+    void readWindow(AdcChannelId ch, uint8_t pin, AdcWindow& window);
     
     /**
-     * Rohen ADC-Strom auslesen
-     * @return Strom in Ampere
+     * Nullpunkt im Stillstand schrittweise messen (jeder update()-Aufruf, nicht blockierend)
      */
-    float readRawCurrent();
+    void updateCurrentCalibration();
     
     /**
-     * Spannung filtern (Moving Average)
-     * @param newVoltage Neue Messung
-     * @return Gefilterte Spannung
+     * Nullpunkt setzen (Counts und Volt konsistent)
      */
-    float filterVoltage(float newVoltage);
+    void setCurrentOffsetCounts(float counts);
     
     /**
-     * Strom filtern (Moving Average)
-     * @param newCurrent Neue Messung
-     * @return Gefilterter Strom
+     * Nullpunkt von SD laden / auf SD sichern
      */
-    float filterCurrent(float newCurrent);
+    bool loadCurrentOffset();
+    void saveCurrentOffset();
     
     /**
-     * Spannung in Prozent umrechnen
-     * @param voltage Spannung in Volt
-     * @return Prozent (0-100)
+     * Aktuellen Strom-Rohwert (ADC-Counts) ohne Fensterwechsel
+     */
+    int32_t readCurrentCounts() const;
+    
+    /**
+     * Werkskalibrierung laden und Kennlinie aufbauen (vor der ersten Messung)
+     */
+    void initAdcCalibration();
+    
+    /**
+     * Zwei-Punkt-Korrektur aus UserConfig übernehmen (nur nach Config-Änderung)
+     */
+    void applyVoltageCorrection();
+    
+    /**
+     * ADC-Counts umrechnen (Integer, O(1))
+     */
+    int32_t countsToMillivolts(uint16_t counts) const;
+    int32_t countsToMilliamps(uint16_t counts) const;
+    
+    /**
+     * ADC-Counts umrechnen (V / A, ≥ 0)
+     */
+    float countsToVoltage(uint16_t counts) const;
+    float countsToCurrent(uint16_t counts) const;
+    
+    /**
+     * Rohe ADC-Spannung auslesen (Mittel des Messintervalls, setzt Min/Max)
+     * @return Spannung in Volt
+     */
+    float readRawVoltage();
+    
+    /**
+     * Rohen ADC-Strom auslesen (Mittel des Messintervalls, setzt Min/Max)
+     * @return Strom in Ampere
      */
-    uint8_t voltageToPercent(float voltage);
+    float readRawCurrent();
     
     /**
      * Energie-Verbrauch aktualisieren
@@ -254,6 +424,11 @@ private:
      */
     void checkWarnings();
     
+    /**
+     * Unterspannung bewerten: Einbruch unter Last oder leerer Akku
+     */
+    void checkDepletion(unsigned long now);
+    
     /**
      * Shutdown-Bedingung prüfen
      */
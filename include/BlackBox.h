@@ -0,0 +1,204 @@
+/**
+ * BlackBox.h
+ *
+ * Fahrtenschreiber: letzte BLACKBOX_SECONDS Sekunden des Fahrpfads im RAM
+ *
+ * Features:
+ * - Feste 32-Byte Records pro Regel-Takt (Joystick, Soll, Ausgabe, Duty,
+ *   Richtung, Strom, Spannung, RSSI)
+ * - Ringpuffer bevorzugt im PSRAM, Schreiben ohne Lock (ein Schreiber: Regel-Takt)
+ * - Auslöser (Watchdog, Stopp aus Fahrt, Befehl): noch BLACKBOX_POST_RECORDS
+ *   weiter aufzeichnen, dann einfrieren und in großen Blöcken auf SD schreiben
+ * - Schreiben verteilt über mehrere update()-Aufrufe, danach läuft die
+ *   Aufzeichnung weiter
+ *
+ * Dateiformat (Little Endian):
+ *   BlackBoxFileHeader (32 Bytes)
+ *   BlackBoxRecord (32 Bytes) * recordCount, chronologisch
+ *
+ * Host-Tool: tools/blackbox2csv.py
+ */
+
+#ifndef BLACK_BOX_H
+#define BLACK_BOX_H
+
+#include <Arduino.h>
+#include "setupConf.h"
+#include "SDCardHandler.h"
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DATEIFORMAT
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define BLACKBOX_MAGIC          "EBBX"
+#define BLACKBOX_VERSION        1
+
+// Record-Flags
+#define BLACKBOX_FLAG_ENABLED       0x01    // Motoren enabled
+#define BLACKBOX_FLAG_CLOSED_LOOP   0x02    // Drehzahlregler aktiv
+#define BLACKBOX_FLAG_LEFT_REV      0x04    // Links rückwärts
+#define BLACKBOX_FLAG_RIGHT_REV     0x08    // Rechts rückwärts
+#define BLACKBOX_FLAG_WATCHDOG      0x10    // Watchdog hat in diesem Takt abgeschaltet
+#define BLACKBOX_FLAG_CURRENT_LIMIT 0x20    // Strombegrenzer drosselt
+#define BLACKBOX_FLAG_SAG           0x40    // Spannungs-Wächter drosselt (Einbruch unter Last)
+#define BLACKBOX_FLAG_SPEED_FAULT   0x80    // Drehzahlregler wegen Encoder-Fehler abgeschaltet
+
+enum class BlackBoxTrigger : uint8_t {
+    COMMAND = 0,                // Serial-Befehl 'blackbox dump'
+    STOP = 1,                   // stop() während der Fahrt
+    WATCHDOG = 2                // Command-Watchdog ausgelöst
+};
+
+struct __attribute__((packed)) BlackBoxFileHeader {
+    char magic[4];              // "EBBX"
+    uint16_t version;           // Formatversion
+    uint16_t headerSize;        // sizeof(BlackBoxFileHeader)
+    uint16_t recordSize;        // sizeof(BlackBoxRecord)
+    uint16_t rateHz;            // Records pro Sekunde
+    uint8_t trigger;            // BlackBoxTrigger
+    uint8_t reserved[3];
+    uint32_t recordCount;       // Anzahl Records in der Datei
+    int64_t triggerUs;          // esp_timer beim Auslösen
+    uint32_t pwmMaxDuty;        // Vollausschlag Duty
+};
+
+struct __attribute__((packed)) BlackBoxRecord {
+    uint32_t timeUs;            // esp_timer (untere 32 Bit)
+    int16_t joyX;               // Joystick wie empfangen
+    int16_t joyY;
+    int16_t targetLeft;         // Soll nach Shaping/Mixer/Trim (% · 256)
+    int16_t targetRight;
+    int16_t commandLeft;        // An die Ausgabe gegeben (% · 256, nach Rampe/Regler)
+    int16_t commandRight;
+    int16_t measuredLeft;       // Encoder-Istdrehzahl (% · 256, 0 ohne Encoder)
+    int16_t measuredRight;
+    uint16_t dutyLeft;          // LEDC-Duty
+    uint16_t dutyRight;
+    uint16_t currentMa;         // Gefilterter Motorstrom
+    uint16_t voltageMv;         // Akkuspannung
+    int8_t rssi;                // dBm letzter RX-Frame
+    uint8_t flags;              // BLACKBOX_FLAG_*
+    uint8_t limitScale;         // Strombegrenzer-Faktor (255 = ungedrosselt)
+    uint8_t reserved;
+};
+
+static_assert(sizeof(BlackBoxRecord) == 32, "BlackBoxRecord muss 32 Bytes sein");
+static_assert(sizeof(BlackBoxFileHeader) == 32, "BlackBoxFileHeader muss 32 Bytes sein");
+
+// ═══════════════════════════════════════════════════════════════════════════
+// BLACK BOX
+// ═══════════════════════════════════════════════════════════════════════════
+
+class BlackBox {
+public:
+    /**
+     * Konstruktor
+     */
+    BlackBox();
+
+    /**
+     * Destruktor
+     */
+    ~BlackBox();
+
+    /**
+     * Ringpuffer allokieren (PSRAM bevorzugt, sonst kleiner im internen RAM)
+     * @param sdHandler Pointer zum SDCardHandler
+     * @return true bei Erfolg
+     */
+    bool begin(SDCardHandler* sdHandler);
+
+    /**
+     * Record anhängen (nur aus dem Regel-Takt, ein Schreiber)
+     */
+    inline void record(const BlackBoxRecord& rec) {
+        if (!ring || frozen) return;
+
+        ring[head] = rec;
+        if (++head == capacity) head = 0;
+        if (count < capacity) count++;
+
+        // Nach dem Auslöser noch eine Nachlaufzeit aufzeichnen
+        if (triggerPending) {
+            if (postRemaining < 0) postRemaining = BLACKBOX_POST_RECORDS;
+            if (postRemaining-- == 0) frozen = true;
+        }
+    }
+
+    /**
+     * Aufzeichnung auf SD sichern lassen (aus jedem Kontext)
+     * Weitere Auslöser bis zum Ende des Schreibens werden ignoriert
+     */
+    void trigger(BlackBoxTrigger reason);
+
+    /**
+     * Eingefrorenen Puffer blockweise auf SD schreiben (in loop() aufrufen!)
+     */
+    void update();
+
+    /**
+     * Aufwand pro Record (CPU-Zyklen, vom Regel-Takt gemessen)
+     */
+    void recordCycles(uint32_t cycles);
+
+    /**
+     * Status
+     */
+    bool isReady() const { return ring != nullptr; }
+    bool isDumping() const { return frozen; }
+    uint32_t getCapacity() const { return capacity; }
+    uint32_t getCount() const { return count; }
+    const char* getLastPath() const { return lastPath; }
+
+    /**
+     * Debug-Informationen ausgeben
+     */
+    void printInfo() const;
+
+private:
+    SDCardHandler* sdHandler;
+
+    BlackBoxRecord* ring;
+    uint8_t* stagingBuffer;
+    bool inPsram;
+    uint32_t capacity;              // Records
+    uint32_t head;                  // Nächster Schreibindex
+    uint32_t count;                 // Gültige Records
+
+    // Auslöser
+    volatile bool triggerPending;
+    volatile bool frozen;
+    int32_t postRemaining;          // -1 = Nachlauf noch nicht gestartet
+    BlackBoxTrigger triggerReason;
+    int64_t triggerUs;
+
+    // Schreiben
+    bool dumpActive;
+    uint32_t dumpIndex;             // Bereits geschriebene Records
+    uint32_t dumpStart;             // Ältester Record im Ring
+    uint32_t dumpCount;
+    unsigned long dumpStartMs;
+    char dumpPath[32];
+    char lastPath[32];
+
+    // Statistik
+    uint32_t dumps;
+    uint32_t dumpErrors;
+    uint32_t lastDumpMs;
+    uint32_t cyclesLast;
+    uint32_t cyclesMax;
+    uint64_t cyclesSum;
+    uint32_t cyclesCount;
+
+    /**
+     * Datei anlegen und Header schreiben
+     */
+    bool startDump();
+
+    /**
+     * Schreiben abschließen, Aufzeichnung freigeben
+     */
+    void finishDump(bool ok);
+};
+
+#endif // BLACK_BOX_H
@@ -0,0 +1,144 @@
+/**
+ * ClockSync.h
+ *
+ * NTP-artige Zeitsynchronisation zwischen Controller (Master) und Fahrzeug
+ *
+ * Ablauf (Vier-Zeitstempel-Austausch über ESP-NOW):
+ *   T1 = Fahrzeug sendet TIME_SYNC_REQUEST       (lokale Zeit)
+ *   T2 = Master empfängt Request                 (Master-Zeit)
+ *   T3 = Master sendet TIME_SYNC_RESPONSE        (Master-Zeit)
+ *   T4 = Fahrzeug empfängt Response              (lokale Zeit)
+ *
+ *   Offset  θ = ((T2 - T1) + (T3 - T4)) / 2
+ *   Delay   δ = (T4 - T1) - (T3 - T2)
+ *
+ * Features:
+ * - Clock-Filter: aus den letzten N Samples zählt nur das mit minimalem Delay
+ * - Offset- und Drift-Schätzung (PLL-artige Nachführung)
+ * - Sprung der Master-Uhr (> TIMESYNC_STEP_US, z.B. Neustart): Filter verwerfen
+ *   und mit dem neuen Sample neu aufsetzen statt langsam nachzuführen
+ * - getSyncedTimeUs() liefert lokale Zeit in Master-Zeitbasis
+ * - Thread-safe Lesezugriff (Logger kann aus anderen Tasks lesen)
+ */
+
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "setupConf.h"
+
+class ClockSync {
+public:
+    /**
+     * Konstruktor
+     */
+    ClockSync();
+
+    /**
+     * Schätzung verwerfen (z.B. nach Verbindungsverlust)
+     */
+    void reset();
+
+    /**
+     * Lokale Zeit in Mikrosekunden (esp_timer)
+     */
+    static int64_t localTimeUs() { return esp_timer_get_time(); }
+
+    /**
+     * Sende-Zeitpunkt eines Requests merken (T1)
+     * @param t1 Lokale Zeit beim Senden
+     */
+    void markRequestSent(int64_t t1);
+
+    /**
+     * Response auswerten (vollständiger Vier-Zeitstempel-Austausch)
+     * @param t1 Echo des Request-Zeitstempels
+     * @param t2 Master-Empfangszeit
+     * @param t3 Master-Sendezeit
+     * @param t4 Lokale Empfangszeit
+     * @return true wenn Sample akzeptiert wurde
+     */
+    bool addSample(int64_t t1, int64_t t2, int64_t t3, int64_t t4);
+
+    /**
+     * Ist eine gültige Schätzung vorhanden?
+     */
+    bool isSynced() const { return synced; }
+
+    /**
+     * Aktuelle Zeit in Master-Zeitbasis
+     * @return Mikrosekunden, -1 wenn nicht synchronisiert
+     */
+    int64_t getSyncedTimeUs() const;
+
+    /**
+     * Lokalen Zeitstempel in Master-Zeitbasis umrechnen
+     * @param localUs Lokale Zeit (esp_timer)
+     * @return Master-Zeit in Mikrosekunden, -1 wenn nicht synchronisiert
+     */
+    int64_t toSyncedTimeUs(int64_t localUs) const;
+
+    /**
+     * Ist ein Request noch unbeantwortet?
+     */
+    bool isRequestPending() const { return pendingT1 != 0; }
+
+    // Statistik
+    int64_t getOffsetUs() const { return offsetUs; }
+    float getDriftPpm() const { return (float)(drift * 1e6); }
+    int64_t getLastDelayUs() const { return lastDelayUs; }
+    int64_t getMinDelayUs() const { return minDelayUs; }
+    uint32_t getSampleCount() const { return sampleCount; }
+    uint32_t getRejectedCount() const { return rejectedCount; }
+    uint32_t getStepCount() const { return stepCount; }
+
+    /**
+     * Debug-Info ausgeben
+     */
+    void printInfo() const;
+
+private:
+    struct Sample {
+        int64_t offsetUs;       // θ
+        int64_t delayUs;        // δ
+        int64_t localUs;        // T4 (lokaler Messzeitpunkt)
+    };
+
+    static const uint8_t FILTER_SAMPLES = 8;
+    Sample samples[FILTER_SAMPLES];
+    uint8_t sampleIndex;
+    uint8_t samplesFilled;
+
+    // Schätzung
+    bool synced;
+    int64_t offsetUs;           // Offset am Referenzzeitpunkt
+    int64_t refLocalUs;         // Referenzzeitpunkt (lokal)
+    double drift;               // Relative Gangabweichung (s/s)
+    int64_t lastUsedLocalUs;    // Zuletzt verwendetes Sample
+
+    // Request-Tracking
+    int64_t pendingT1;
+
+    // Statistik
+    int64_t lastDelayUs;
+    int64_t minDelayUs;
+    uint32_t sampleCount;
+    uint32_t rejectedCount;
+    uint32_t stepCount;         // Neu aufgesetzt nach Uhrsprung
+
+    // Schutz für Lesezugriffe aus anderen Tasks
+    mutable portMUX_TYPE lock;
+
+    /**
+     * Clock-Filter und Schätzung verwerfen (Statistik bleibt)
+     */
+    void clearEstimate();
+
+    /**
+     * Schätzung mit gefiltertem Sample nachführen
+     */
+    void applySample(const Sample& sample);
+};
+
+#endif // CLOCK_SYNC_H
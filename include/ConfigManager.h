@@ -78,6 +78,12 @@ public:
      */
     virtual ~ConfigManager();
 
+    /**
+     * Änderungszähler (steigt bei jeder Änderung/jedem Laden)
+     * Abhängige Module bauen abgeleitete Daten neu, wenn er sich ändert
+     */
+    uint32_t getRevision() const { return revision; }
+
 protected:
     // ═══════════════════════════════════════════════════════════════════════
     // STORAGE SETUP
@@ -205,7 +211,12 @@ protected:
     /**
      * Dirty-Flag setzen
      */
-    void setDirty(bool isDirty) { dirty = isDirty; }
+    void setDirty(bool isDirty) { dirty = isDirty; if (isDirty) revision++; }
+    
+    /**
+     * Änderungszähler erhöhen (ohne Dirty-Flag, z.B. nach load())
+     */
+    void bumpRevision() { revision++; }
     
     /**
      * Ist Config geändert?
@@ -219,6 +230,7 @@ private:
     char backupFilePath[64];    // Pfad zur Backup-Datei
     bool initialized;           // Init erfolgt?
     bool dirty;                 // Config geändert?
+    volatile uint32_t revision; // Änderungszähler
     
     /**
      * Wert aus JSON in Config-Item schreiben
@@ -0,0 +1,104 @@
+/**
+ * CurrentLimiter.h
+ *
+ * Schneller Strombegrenzer für den Motor-Regeltakt
+ *
+ * Features:
+ * - IIR-Filter in mA (Shift CURRENT_LIMIT_FILTER_SHIFT), reine Integer-Rechnung
+ * - Weiche Begrenzung: ab CURRENT_LIMIT_SOFT_PCT des Limits wird der Duty
+ *   proportional reduziert, am Limit auf CURRENT_LIMIT_MIN_SCALE
+ * - Schnelles Eingreifen (Faktor sinkt sofort), langsames Freigeben
+ *   (CURRENT_LIMIT_RELEASE pro Messung) gegen Pendeln
+ * - Statistik: Messungen, Spitze, Eingriffe, Reaktionszeit bis unter Limit
+ *
+ * Kein Not-Aus: der Motor wird gedrosselt, nicht abgeschaltet.
+ * Ohne Arduino-Abhängigkeiten (ADC-Lesen übernimmt der Aufrufer).
+ */
+
+#ifndef CURRENT_LIMITER_H
+#define CURRENT_LIMITER_H
+
+#include <stdint.h>
+#include "setupConf.h"
+
+/**
+ * Statistik des Strombegrenzers
+ */
+struct CurrentLimitStats {
+    uint32_t samples;           // Messungen gesamt
+    uint32_t limitEvents;       // Eingriffe (Faktor < 1)
+    int32_t filteredMa;         // Aktueller gefilterter Strom
+    int32_t peakMa;             // Höchster Rohwert
+    uint16_t scaleQ8;           // Aktueller Faktor (256 = 100 %)
+    uint16_t minScaleQ8;        // Kleinster Faktor seit Reset
+    uint32_t lastResponseUs;    // Letzte Dauer Überschreitung → wieder unter Limit
+    uint32_t maxResponseUs;
+    uint32_t lastSampleUs;      // ADC-Lesezeit letzte Messung
+    uint32_t maxSampleUs;
+};
+
+class CurrentLimiter {
+public:
+    static const uint16_t SCALE_ONE = 256;
+
+    /**
+     * Konstruktor
+     */
+    CurrentLimiter();
+
+    /**
+     * Limit setzen
+     * @param limitMa Strom-Obergrenze in mA (0 = Begrenzer aus)
+     */
+    void setLimit(int32_t limitMa);
+    int32_t getLimit() const { return limitMa; }
+
+    /**
+     * Neue Messung verarbeiten
+     * @param currentMa Rohstrom in mA
+     * @param nowUs Zeitstempel (µs)
+     * @return Duty-Faktor Q8 (256 = ungedrosselt)
+     */
+    uint16_t update(int32_t currentMa, uint32_t nowUs);
+
+    /**
+     * Motoren stehen: Filter und Faktor zurücksetzen
+     */
+    void idle();
+
+    /**
+     * Duty mit aktuellem Faktor skalieren
+     */
+    inline uint32_t apply(uint32_t duty) const {
+        return (scaleQ8 >= SCALE_ONE) ? duty : (duty * scaleQ8) >> 8;
+    }
+
+    /**
+     * Aktueller Zustand ohne Statistik-Kopie (für die Black Box im Takt)
+     */
+    int32_t getFilteredMa() const { return filteredQ4 >> 4; }
+    uint16_t getScale() const { return scaleQ8; }
+
+    /**
+     * ADC-Lesezeit für die Statistik eintragen
+     */
+    void recordSampleTime(uint32_t us);
+
+    /**
+     * Statistik
+     */
+    CurrentLimitStats getStats() const;
+    void resetStats();
+
+private:
+    int32_t limitMa;
+    int32_t softMa;             // Beginn der Drosselung
+    int32_t filteredQ4;         // IIR-Zustand (mA · 16)
+    uint16_t scaleQ8;
+    bool overLimit;             // Überschreitung aktiv
+    uint32_t overSinceUs;
+
+    CurrentLimitStats stats;
+};
+
+#endif // CURRENT_LIMITER_H
@@ -32,6 +32,7 @@
 #include <vector>
 #include "setupConf.h"
 #include "ESPNowPacket.h"
+#include "Filters.h"
 
 // Internes Hardware-Limit für Peers (ESP-NOW Hardware-Beschränkung)
 #ifndef ESPNOW_MAX_PEERS_LIMIT
@@ -57,6 +58,8 @@ struct RxQueueItem {
     uint8_t data[ESPNOW_MAX_PACKET_SIZE];
     size_t length;
     unsigned long timestamp;
+    int64_t timestampUs;        // Empfangszeit (esp_timer, µs)
+    int8_t rssi;                // Signalstärke (dBm, 0 = unbekannt)
 };
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -73,7 +76,8 @@ struct ESPNowPeer {
     uint32_t packetsReceived;   // Empfangene Pakete
     uint32_t packetsSent;       // Gesendete Pakete
     uint32_t packetsLost;       // Verlorene Pakete
-    int8_t rssi;                // Signalstärke (falls verfügbar)
+    int8_t rssi;                // Signalstärke geglättet (dBm, 0 = unbekannt)
+    Ema<int16_t, 3> rssiFilter; // EMA über ~8 Pakete
 };
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -112,6 +116,18 @@ typedef std::function<void(const uint8_t* mac, ESPNowPacket& packet)> ESPNowRece
 typedef std::function<void(const uint8_t* mac, bool success)> ESPNowSendCallback;
 typedef std::function<void(ESPNowEventData* eventData)> ESPNowEventCallback;
 
+/**
+ * Capture-Hook für Mitschnitt (läuft bei RX im WiFi-Task, muss minimal sein!)
+ * @param tx true = gesendet, false = empfangen
+ * @param mac Peer-MAC
+ * @param data Rohdaten
+ * @param len Länge
+ * @param rssi Signalstärke (nur RX, sonst 0)
+ * @param timeUs Zeitpunkt (esp_timer, µs)
+ */
+typedef void (*ESPNowCaptureHook)(bool tx, const uint8_t* mac, const uint8_t* data, size_t len,
+                                  int8_t rssi, int64_t timeUs);
+
 // ═══════════════════════════════════════════════════════════════════════════
 // HAUPTKLASSE (Basis)
 // ═══════════════════════════════════════════════════════════════════════════
@@ -212,6 +228,13 @@ public:
      */
     void sendHeartbeat();
 
+    /**
+     * Empfangenes Paket in die RX-Queue einspeisen (Replay)
+     * Durchläuft denselben Pfad wie ein echter Empfang, ohne Capture-Hook
+     * @return true wenn in Queue abgelegt (false = Queue voll)
+     */
+    bool injectRx(const uint8_t* mac, const uint8_t* data, size_t len);
+
     // ═══════════════════════════════════════════════════════════════════════
     // HEARTBEAT
     // ═══════════════════════════════════════════════════════════════════════
@@ -255,6 +278,16 @@ public:
      */
     void offEvent(ESPNowEvent event);
 
+    /**
+     * Capture-Hook für RX/TX-Mitschnitt setzen (nullptr = aus)
+     */
+    static void setCaptureHook(ESPNowCaptureHook hook) { captureHook = hook; }
+
+    /**
+     * RSSI des zuletzt empfangenen Frames (dBm, 0 = noch nichts empfangen)
+     */
+    static int8_t getLastRssi() { return lastRssi; }
+
     // ═══════════════════════════════════════════════════════════════════════
     // UPDATE & STATUS
     // ═══════════════════════════════════════════════════════════════════════
@@ -296,11 +329,21 @@ public:
      * Queue-Statistiken abrufen
      */
     int getQueuePending();
+    uint32_t getQueueDropped() const { return rxQueueDropped; }
 
 protected:
     // Statischer Pointer auf die aktive Instanz (für Callbacks)
     static ESPNowManager* instance;
     
+    // Capture-Hook (optional, statisch wegen ISR-Callback)
+    static volatile ESPNowCaptureHook captureHook;
+    
+    // Letzter RX-RSSI (im WiFi-Callback gesetzt)
+    static volatile int8_t lastRssi;
+    
+    // Bei voller RX-Queue verworfene Frames (im WiFi-Callback gezählt)
+    static volatile uint32_t rxQueueDropped;
+    
     // Status
     bool initialized;
     uint8_t wifiChannel;
@@ -332,8 +375,21 @@ protected:
     virtual void processRxQueue();
     virtual void handleSendStatus(const uint8_t* mac, bool success);
     virtual void checkTimeouts();
+    
+    /**
+     * Peer getrennt (Timeout) oder entfernt - abgeleitete Klassen räumen
+     * peer-bezogenen Zustand auf. Aufruf ohne gehaltenen peersMutex
+     */
+    virtual void onPeerLost(const uint8_t* mac) { (void)mac; }
+    
     void triggerEvent(ESPNowEvent event, ESPNowEventData* data);
     int findPeerIndex(const uint8_t* mac);
+    
+    /**
+     * Empfang bei Peer verbuchen (LastSeen, RX-Zähler, geglätteter RSSI)
+     * Aufruf nur mit gehaltenem peersMutex
+     */
+    void notePeerReceived(ESPNowPeer& peer, const RxQueueItem& rxItem);
     bool compareMac(const uint8_t* mac1, const uint8_t* mac2);
 };
 
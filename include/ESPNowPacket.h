@@ -27,6 +27,14 @@ enum class MainCmd : uint8_t {
     PAIR_REQUEST    = 0x05,     // Pairing-Anfrage
     PAIR_RESPONSE   = 0x06,     // Pairing-Antwort
     ERROR           = 0x07,     // Fehlermeldung
+    TIME_SYNC_REQ   = 0x08,     // Zeitsync-Anfrage (T1)
+    TIME_SYNC_RESP  = 0x09,     // Zeitsync-Antwort (T1, T2, T3)
+    SECURE          = 0x0A,     // Verschlüsselter Frame (AES-CCM Envelope)
+    OTA_BEGIN       = 0x0B,     // Firmware-Update starten/fortsetzen
+    OTA_DATA        = 0x0C,     // Firmware-Chunk
+    OTA_END         = 0x0D,     // Firmware vollständig → prüfen
+    OTA_ABORT       = 0x0E,     // Firmware-Update abbrechen
+    OTA_ACK         = 0x0F,     // Firmware-Update Quittung (kumulativ)
     
     // User-Commands ab 0x10
     USER_START      = 0x10
@@ -44,6 +52,17 @@ enum class DataCmd : uint8_t {
     SEQUENCE_NUM    = 0x02,     // uint16_t
     STATUS          = 0x03,     // uint8_t
     ERROR_CODE      = 0x04,     // uint8_t
+    SYNC_T1         = 0x05,     // int64_t (µs, Sendezeit Request)
+    SYNC_T2         = 0x06,     // int64_t (µs, Empfangszeit Request)
+    SYNC_T3         = 0x07,     // int64_t (µs, Sendezeit Response)
+    SESSION_NONCE   = 0x08,     // uint8_t[8] (Pairing-Nonce)
+    SECURE_SEQ      = 0x09,     // uint32_t (Sequenznummer)
+    SECURE_PAYLOAD  = 0x0A,     // Ciphertext + Tag
+    OTA_SIZE        = 0x0B,     // uint32_t (Image-Größe in Bytes)
+    OTA_SHA256      = 0x0C,     // uint8_t[32] (SHA-256 des Images)
+    OTA_OFFSET      = 0x0D,     // uint32_t (Byte-Offset im Image)
+    OTA_DATA        = 0x0E,     // Chunk-Daten (max. OTA_MAX_CHUNK)
+    OTA_WINDOW      = 0x0F,     // uint8_t (erlaubte Chunks im Flug)
     
     // Joystick (0x10-0x1F)
     JOYSTICK_X      = 0x10,     // int16_t
@@ -67,10 +86,14 @@ enum class DataCmd : uint8_t {
     BATTERY_PERCENT = 0x41,     // uint8_t (0-100%)
     TEMPERATURE     = 0x42,     // int16_t (°C * 10)
     RSSI            = 0x43,     // int8_t (dBm)
+    BATTERY_RUNTIME = 0x44,     // uint16_t (min bis leer, 0xFFFF = unbekannt)
+    BATTERY_CUTOFF  = 0x45,     // uint16_t (min bis Unterspannungs-Abschaltung, 0xFFFF = unbekannt)
+    BATTERY_DERATE  = 0x46,     // uint16_t (min bis Drosselung bei Fahrstrom, 0xFFFF = unbekannt)
     
     // Status (0x50-0x5F)
     CONNECTION      = 0x50,     // uint8_t (0=disconnected, 1=connected)
     MODE            = 0x51,     // uint8_t
+    PAIR_AUTH       = 0x52,     // uint8_t[16] (HMAC über Master-MAC | Pairing-Nonce)
     
     // Sensoren (0x60-0x6F)
     DISTANCE        = 0x60,     // uint16_t (mm)
@@ -108,6 +131,7 @@ public:
     ESPNowPacket& addInt16(DataCmd dataCmd, int16_t value);
     ESPNowPacket& addUInt32(DataCmd dataCmd, uint32_t value);
     ESPNowPacket& addInt32(DataCmd dataCmd, int32_t value);
+    ESPNowPacket& addInt64(DataCmd dataCmd, int64_t value);
     ESPNowPacket& addFloat(DataCmd dataCmd, float value);
     
     template<typename T>
@@ -139,6 +163,7 @@ public:
     bool getInt16(DataCmd dataCmd, int16_t& outValue) const;
     bool getUInt32(DataCmd dataCmd, uint32_t& outValue) const;
     bool getInt32(DataCmd dataCmd, int32_t& outValue) const;
+    bool getInt64(DataCmd dataCmd, int64_t& outValue) const;
     bool getFloat(DataCmd dataCmd, float& outValue) const;
     
     // ═══════════════════════════════════════════════════════════════════════
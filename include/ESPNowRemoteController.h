@@ -10,6 +10,9 @@
 
 #include "ESPNowManager.h"
 #include "ESPNowPacket.h"
+#include "ClockSync.h"
+#include "FrameCrypto.h"
+#include "OtaReceiver.h"
 
 class ESPNowRemoteController : public ESPNowManager {
 public:
@@ -20,17 +23,169 @@ public:
      * RX-Verarbeitung mit MAC-Validierung & Pairing
      */
     void processRxQueue() override;
+    
+    /**
+     * Update mit periodischem Zeitsync-Request an den Master
+     * und OTA-Session (Timeout, Neustart, Pause bei Fahrt)
+     */
+    void update() override;
+    
+    /**
+     * Aktuelle Zeit in Master-Zeitbasis
+     * @return Mikrosekunden, -1 wenn nicht synchronisiert
+     */
+    int64_t getSyncedTimeUs() const { return clockSync.getSyncedTimeUs(); }
+    
+    /**
+     * Zeitsynchronisation (Offset/Drift/Statistik)
+     */
+    const ClockSync& getClockSync() const { return clockSync; }
+    
+    /**
+     * Paket senden - bei aktiver Session als SECURE-Envelope verschlüsselt
+     * @return true bei Erfolg
+     */
+    bool sendSecure(const uint8_t* mac, const ESPNowPacket& packet);
+    
+    /**
+     * Frame-Verschlüsselung (Session/Statistik)
+     */
+    const FrameCrypto& getCrypto() const { return crypto; }
+    
+    /**
+     * Abgewiesene Klartext-Steuerframes (bei espnowEncrypt = true)
+     */
+    uint32_t getPlaintextRejected() const { return plaintextRejected; }
+    
+    /**
+     * Firmware-Update über ESP-NOW
+     */
+    OtaReceiver& getOta() { return ota; }
+    
+    /**
+     * Latenz-Statistik Joystick → Sollwert (Master-Sendezeit bis Sollwert gesetzt,
+     * die PWM folgt im nächsten Regel-Takt)
+     * Nur für Frames mit DataCmd::TIMESTAMP bei aktiver Zeitsync
+     */
+    uint32_t getLatencyLastUs() const { return latencyLastUs; }
+    uint32_t getLatencyMinUs() const { return latencyMinUs; }
+    uint32_t getLatencyMaxUs() const { return latencyMaxUs; }
+    uint32_t getLatencyAvgUs() const { return latencyCount ? (uint32_t)(latencySumUs / latencyCount) : 0; }
+    uint32_t getLatencyCount() const { return latencyCount; }
+    
+    /**
+     * Latenz-Statistik zurücksetzen
+     */
+    void resetLatencyStats();
+    
+    /**
+     * Mailbox-Statistik: Anzahl empfangener bzw. verworfener Joystick-Frames
+     * (verworfen = vor der Anwendung durch einen neueren Frame ersetzt)
+     */
+    uint32_t getJoystickFramesReceived() const { return joystickFramesReceived; }
+    uint32_t getJoystickFramesSuperseded() const { return joystickFramesSuperseded; }
 
 private:
+    /**
+     * Latest-Wins Mailbox pro Peer für Joystick-Frames
+     * Pro processRxQueue()-Durchlauf erreicht nur der neueste Frame den MotorController.
+     * Slots nur für registrierte Peers, Freigabe bei Timeout/Entfernen (onPeerLost)
+     */
+    struct JoystickMailbox {
+        uint8_t mac[6];
+        bool used;
+        bool pending;
+        int16_t x;
+        int16_t y;
+        uint8_t btn;
+        unsigned long timestamp;
+        bool hasTxTime;         // Frame enthält Master-Sendezeit
+        uint32_t txTimeUs;      // Master-Sendezeit (µs, untere 32 Bit)
+    };
+    JoystickMailbox joystickMailbox[ESPNOW_MAX_PEERS_LIMIT];
+    uint32_t joystickFramesReceived;
+    uint32_t joystickFramesSuperseded;
+    
+    // Frame-Verschlüsselung
+    FrameCrypto crypto;
+    uint32_t plaintextRejected;
+    
+    // Firmware-Update
+    OtaReceiver ota;
+    
+    // Zeitsynchronisation
+    ClockSync clockSync;
+    unsigned long lastTimeSyncSent;
+    
+    // Latenz Joystick → Sollwert
+    uint32_t latencyLastUs;
+    uint32_t latencyMinUs;
+    uint32_t latencyMaxUs;
+    uint64_t latencySumUs;
+    uint32_t latencyCount;
+    
+    /**
+     * Joystick-Werte aus Paket extrahieren (JOYSTICK_ALL oder X/Y einzeln)
+     * @return true wenn Joystick-Daten vorhanden
+     */
+    bool extractJoystick(const ESPNowPacket& packet, int16_t& x, int16_t& y, uint8_t& btn);
+    
+    /**
+     * Joystick-Frame in Mailbox ablegen (überschreibt noch nicht angewendeten Frame)
+     */
+    void postJoystick(const uint8_t* mac, int16_t x, int16_t y, uint8_t btn, unsigned long timestamp,
+                      bool hasTxTime, uint32_t txTimeUs);
+    
+    /**
+     * Anstehende Mailbox-Einträge an MotorController übergeben
+     */
+    void dispatchJoystickMailbox();
+    
+    /**
+     * Peer getrennt/entfernt: Mailbox-Slot freigeben, bei Master Zeitsync verwerfen
+     */
+    void onPeerLost(const uint8_t* mac) override;
+
     /**
      * MAC-Validierung
      */
     bool isValidMasterMac(const uint8_t* mac);
     
+    /**
+     * OTA-Frame verarbeiten (nur vom Master, nur im SECURE-Envelope)
+     */
+    void handleOtaFrame(const uint8_t* mac, const ESPNowPacket& packet, bool secureFrame);
+    
     /**
      * PAIR_REQUEST verarbeiten
+     * Bei aktiver Session nur authentisch (SECURE-Envelope oder PAIR_AUTH-Tag),
+     * sonst erst nach Heartbeat-Timeout des Masters
+     */
+    void handlePairRequest(const uint8_t* mac, const ESPNowPacket& packet, unsigned long timestamp,
+                           bool secureFrame);
+    
+    /**
+     * SECURE-Envelope prüfen, entschlüsseln und inneren Frame parsen
+     * @param mac Absender
+     * @param packet Envelope (wird durch inneren Frame ersetzt)
+     * @return true wenn authentisch
+     */
+    bool unwrapSecure(const uint8_t* mac, ESPNowPacket& packet);
+    
+    /**
+     * TIME_SYNC_REQ beantworten (T1 zurück, T2/T3 in eigener Zeitbasis)
+     */
+    void handleTimeSyncRequest(const uint8_t* mac, const ESPNowPacket& packet, int64_t rxTimeUs);
+    
+    /**
+     * TIME_SYNC_RESP vom Master auswerten
+     */
+    void handleTimeSyncResponse(const uint8_t* mac, const ESPNowPacket& packet, int64_t rxTimeUs);
+    
+    /**
+     * TIME_SYNC_REQ an Master senden
      */
-    void handlePairRequest(const uint8_t* mac, unsigned long timestamp);
+    void sendTimeSyncRequest();
 };
 
 #endif
\ No newline at end of file
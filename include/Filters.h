@@ -0,0 +1,380 @@
+/**
+ * Filters.h
+ *
+ * Wiederverwendbare Filter für Sensorwerte (header-only)
+ *
+ * - MovingAverage<T, N>  gleitender Mittelwert über laufende Summe
+ * - Ema<T, SHIFT>        exponentieller Mittelwert, α = 1/2^SHIFT
+ * - Median<T, N>         Median der letzten N Werte (Ausreißer, Spikes)
+ * - Kalman1D<T>          skalarer Kalman-Filter (konstanter Wert + Rauschen)
+ * - Biquad<T>            Tiefpass 2. Ordnung (RBJ), Direct Form II transponiert
+ *
+ * Fenster und Shift sind Template-Parameter: kein Heap, Größe zur Compile-Zeit.
+ * MovingAverage, Ema und Median arbeiten auch mit Ganzzahl-Typen (Festkomma,
+ * z.B. ADC-Counts oder mA): Summen in breiterem Typ, Division gerundet.
+ * Kalman1D und Biquad brauchen Gleitkomma (float rechnet der S3 in Hardware).
+ *
+ * Aufwand pro Wert:
+ * - MovingAverage, Ema, Kalman1D, Biquad: O(1)
+ * - Median: O(N) mit kleinem festem N (Einsortieren in N Werte)
+ *
+ * Ohne Arduino-Abhängigkeiten, damit tools/filter_bench.cpp dieselben
+ * Filter auf dem Host prüft und misst.
+ */
+
+#ifndef FILTERS_H
+#define FILTERS_H
+
+#include <stdint.h>
+#include <math.h>
+#include <type_traits>
+
+namespace FilterDetail {
+
+// Summen-Typ: Ganzzahl → 64 Bit (kein Überlauf), Gleitkomma → eigener Typ
+// (double ist auf dem S3 Software-Emulation, float bleibt in der FPU)
+template <typename T, bool IsInt = std::is_integral<T>::value>
+struct Accumulator { typedef T type; };
+
+template <typename T>
+struct Accumulator<T, true> { typedef int64_t type; };
+
+// Gerundete Division für Ganzzahlen, normale Division sonst
+template <typename A>
+inline A divRound(A num, A den, std::true_type) {
+    return (num >= 0) ? (num + den / 2) / den : (num - den / 2) / den;
+}
+
+template <typename A>
+inline A divRound(A num, A den, std::false_type) {
+    return num / den;
+}
+
+} // namespace FilterDetail
+
+// ═══════════════════════════════════════════════════════════════════════════
+// GLEITENDER MITTELWERT
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Mittelwert der letzten N Werte über eine laufende Summe
+ * Gleitkomma: Summe im Werttyp, nach jedem Fensterdurchlauf wird sie aus
+ * dem Puffer neu gebildet (N Additionen je N Werte) - so kann der
+ * Rundungsfehler der laufenden Summe nicht über die Laufzeit wandern.
+ */
+template <typename T, uint16_t N>
+class MovingAverage {
+    static_assert(N > 0, "Fenster muss > 0 sein");
+    typedef typename FilterDetail::Accumulator<T>::type Acc;
+
+public:
+    MovingAverage() { reset(); }
+
+    /**
+     * Leeren: Mittel über die bisher gesehenen Werte bis das Fenster voll ist
+     */
+    void reset() {
+        for (uint16_t i = 0; i < N; i++) buffer[i] = T();
+        sum = Acc();
+        index = 0;
+        count = 0;
+    }
+
+    /**
+     * Fenster komplett mit einem Startwert füllen
+     */
+    void fill(T value) {
+        for (uint16_t i = 0; i < N; i++) buffer[i] = value;
+        sum = (Acc)value * N;
+        index = 0;
+        count = N;
+    }
+
+    T update(T value) {
+        sum += (Acc)value - (Acc)buffer[index];
+        buffer[index] = value;
+        if (count < N) count++;
+        if (++index == N) {
+            index = 0;
+            resum(std::is_integral<Acc>());
+        }
+        return get();
+    }
+
+    T get() const {
+        if (count == 0) return T();
+        return (T)FilterDetail::divRound<Acc>(sum, (Acc)count, std::is_integral<Acc>());
+    }
+
+    bool isFull() const { return count == N; }
+    uint16_t getCount() const { return count; }
+    static uint16_t size() { return N; }
+
+private:
+    // Ganzzahl-Summe ist exakt, Gleitkomma-Drift pro Durchlauf verwerfen
+    void resum(std::true_type) {}
+    void resum(std::false_type) {
+        Acc fresh = Acc();
+        for (uint16_t i = 0; i < count; i++) fresh += (Acc)buffer[i];
+        sum = fresh;
+    }
+
+    T buffer[N];
+    Acc sum;
+    uint16_t index;
+    uint16_t count;
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// EXPONENTIELLER MITTELWERT
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * EMA mit α = 1/2^SHIFT (Zeitkonstante ≈ 2^SHIFT Werte)
+ * Ganzzahl: Zustand mit SHIFT Nachkommabits, kein Verlust kleiner Änderungen.
+ * Der erste Wert setzt den Zustand direkt (kein Einschwingen von 0).
+ */
+template <typename T, uint8_t SHIFT>
+class Ema {
+    static_assert(SHIFT < 24, "SHIFT zu groß");
+    typedef typename FilterDetail::Accumulator<T>::type Acc;
+
+public:
+    Ema() { reset(); }
+
+    void reset() {
+        state = Acc();
+        primed = false;
+    }
+
+    void fill(T value) {
+        state = toState(value, std::is_integral<T>());
+        primed = true;
+    }
+
+    T update(T value) {
+        if (!primed) {
+            fill(value);
+        } else {
+            step(value, std::is_integral<T>());
+        }
+        return get();
+    }
+
+    T get() const { return fromState(std::is_integral<T>()); }
+    bool isPrimed() const { return primed; }
+
+private:
+    Acc state;
+    bool primed;
+
+    static Acc toState(T value, std::true_type) { return (Acc)value * ((Acc)1 << SHIFT); }
+    static Acc toState(T value, std::false_type) { return (Acc)value; }
+
+    void step(T value, std::true_type) {
+        // state = state + (value·2^S - state) / 2^S
+        state += (Acc)value - FilterDetail::divRound<Acc>(state, (Acc)1 << SHIFT, std::true_type());
+    }
+
+    void step(T value, std::false_type) {
+        state += ((Acc)value - state) / (Acc)(1UL << SHIFT);
+    }
+
+    T fromState(std::true_type) const {
+        return (T)FilterDetail::divRound<Acc>(state, (Acc)1 << SHIFT, std::true_type());
+    }
+
+    T fromState(std::false_type) const { return (T)state; }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// MEDIAN
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Median der letzten N Werte (N ungerade empfohlen)
+ * Ringpuffer + sortierte Kopie: ältesten Wert entfernen, neuen einsortieren.
+ */
+template <typename T, uint8_t N>
+class Median {
+    static_assert(N > 0, "Fenster muss > 0 sein");
+
+public:
+    Median() { reset(); }
+
+    void reset() {
+        index = 0;
+        count = 0;
+    }
+
+    void fill(T value) {
+        for (uint8_t i = 0; i < N; i++) {
+            ring[i] = value;
+            sorted[i] = value;
+        }
+        index = 0;
+        count = N;
+    }
+
+    T update(T value) {
+        uint8_t n = count;
+
+        // Ältesten Wert aus der sortierten Liste nehmen (nur bei vollem Fenster)
+        if (count == N) {
+            T old = ring[index];
+            uint8_t pos = 0;
+            while (pos < n - 1 && sorted[pos] != old) pos++;
+            for (uint8_t i = pos; i < n - 1; i++) sorted[i] = sorted[i + 1];
+            n--;
+        }
+
+        // Neuen Wert einsortieren
+        uint8_t pos = n;
+        while (pos > 0 && sorted[pos - 1] > value) {
+            sorted[pos] = sorted[pos - 1];
+            pos--;
+        }
+        sorted[pos] = value;
+
+        ring[index] = value;
+        if (++index == N) index = 0;
+        if (count < N) count++;
+        return get();
+    }
+
+    T get() const {
+        if (count == 0) return T();
+        return sorted[(count - 1) / 2];
+    }
+
+    bool isFull() const { return count == N; }
+
+private:
+    T ring[N];
+    T sorted[N];
+    uint8_t index;
+    uint8_t count;
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// KALMAN (SKALAR)
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Kalman-Filter für eine langsam veränderliche Größe
+ * @param q Prozessrauschen (Varianz pro Schritt, wie schnell darf sich der Wert ändern)
+ * @param r Messrauschen (Varianz einer Messung)
+ * Verstärkung passt sich selbst an: am Anfang schnell, eingeschwungen ≈ EMA.
+ */
+template <typename T>
+class Kalman1D {
+    static_assert(std::is_floating_point<T>::value, "Kalman1D braucht float/double");
+
+public:
+    Kalman1D(T q = T(1e-3), T r = T(1e-1)) : q(q), r(r) { reset(); }
+
+    void setNoise(T processNoise, T measurementNoise) {
+        q = processNoise;
+        r = measurementNoise;
+    }
+
+    void reset() {
+        x = T(0);
+        p = T(1);
+        primed = false;
+    }
+
+    void fill(T value) {
+        x = value;
+        p = r;
+        primed = true;
+    }
+
+    T update(T z) {
+        if (!primed) {
+            fill(z);
+            return x;
+        }
+        p += q;
+        T k = p / (p + r);
+        x += k * (z - x);
+        p *= (T(1) - k);
+        return x;
+    }
+
+    T get() const { return x; }
+    T getGain() const { return p / (p + r); }
+    T getVariance() const { return p; }
+
+private:
+    T q;
+    T r;
+    T x;
+    T p;
+    bool primed;
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// BIQUAD TIEFPASS
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Tiefpass 2. Ordnung (RBJ Cookbook), Direct Form II transponiert
+ * @param cutoffHz Grenzfrequenz (-3 dB bei q = 0.7071)
+ * @param sampleHz Abtastrate
+ */
+template <typename T>
+class Biquad {
+    static_assert(std::is_floating_point<T>::value, "Biquad braucht float/double");
+
+public:
+    Biquad() : b0(1), b1(0), b2(0), a1(0), a2(0) { reset(); }
+
+    Biquad(T cutoffHz, T sampleHz, T q = T(0.70710678)) { setLowPass(cutoffHz, sampleHz, q); }
+
+    void setLowPass(T cutoffHz, T sampleHz, T q = T(0.70710678)) {
+        T w0 = T(2.0 * M_PI) * cutoffHz / sampleHz;
+        T cosw = cos(w0);
+        T alpha = sin(w0) / (T(2) * q);
+        T a0 = T(1) + alpha;
+
+        b0 = ((T(1) - cosw) / T(2)) / a0;
+        b1 = (T(1) - cosw) / a0;
+        b2 = b0;
+        a1 = (T(-2) * cosw) / a0;
+        a2 = (T(1) - alpha) / a0;
+        reset();
+    }
+
+    void reset() {
+        z1 = T(0);
+        z2 = T(0);
+        y = T(0);
+    }
+
+    /**
+     * Zustand auf eingeschwungenen Gleichwert setzen (kein Einschwingen von 0)
+     */
+    void fill(T value) {
+        // Stationär: y = x, z1 = x - b0·x, z2 = b2·x - a2·x
+        z1 = value * (T(1) - b0);
+        z2 = value * (b2 - a2);
+        y = value;
+    }
+
+    T update(T x) {
+        y = b0 * x + z1;
+        z1 = b1 * x - a1 * y + z2;
+        z2 = b2 * x - a2 * y;
+        return y;
+    }
+
+    T get() const { return y; }
+
+private:
+    T b0, b1, b2, a1, a2;
+    T z1, z2;
+    T y;
+};
+
+#endif // FILTERS_H
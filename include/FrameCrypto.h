@@ -0,0 +1,181 @@
+/**
+ * FrameCrypto.h
+ *
+ * Authentifizierte Verschlüsselung (AES-128-CCM) für ESP-NOW Frames
+ *
+ * Features:
+ * - AES-CCM über mbedtls (ESP32-S3: AES-Hardwarebeschleuniger,
+ *   Host-Build: Software-Implementierung von mbedtls)
+ * - Session-Key pro Pairing: HMAC-SHA256(PSK, Label | Nonce Master | Nonce Gerät)
+ * - Pairing-Anfrage authentifiziert: HMAC-SHA256(PSK, Label | MAC Master | Nonce Master),
+ *   gekürzt auf CRYPTO_PAIR_AUTH_LEN, bereits verwendete Nonces abgewiesen
+ * - Nonce = Richtung | Sequenznummer | Session-Salt (nie wiederverwendet)
+ * - Replay-Schutz mit 32-Frame Sliding Window
+ * - Laufzeit-Statistik pro Frame (für Latenzbudget)
+ *
+ * Envelope (MainCmd::SECURE):
+ *   [SECURE_SEQ: uint32] [SECURE_PAYLOAD: Ciphertext(innerer Frame) | Tag 8B]
+ *   AAD = MainCmd | Sequenznummer
+ */
+
+#ifndef FRAME_CRYPTO_H
+#define FRAME_CRYPTO_H
+
+#include <Arduino.h>
+#include <mbedtls/ccm.h>
+#include "setupConf.h"
+
+class FrameCrypto {
+public:
+    /**
+     * Konstruktor & Destruktor
+     */
+    FrameCrypto();
+    ~FrameCrypto();
+
+    /**
+     * Pre-Shared Key setzen
+     * @param hexPsk PSK als Hex-String (32 oder 64 Zeichen)
+     * @return true wenn gültig
+     */
+    bool setPsk(const char* hexPsk);
+
+    /**
+     * Ist ein gültiger PSK gesetzt?
+     */
+    bool hasPsk() const { return pskLength > 0; }
+
+    /**
+     * Session-Key aus PSK und beiden Pairing-Nonces ableiten
+     * Setzt Sequenznummern und Replay-Fenster zurück
+     * @param masterNonce Nonce des Masters (CRYPTO_PAIR_NONCE_LEN Bytes)
+     * @param deviceNonce Nonce des Geräts (CRYPTO_PAIR_NONCE_LEN Bytes)
+     * @return true bei Erfolg
+     */
+    bool deriveSession(const uint8_t* masterNonce, const uint8_t* deviceNonce);
+
+    /**
+     * Pairing-Tag berechnen (Master-Seite, Tests)
+     * @param masterMac MAC des Masters (6 Bytes)
+     * @param masterNonce Nonce des Masters (CRYPTO_PAIR_NONCE_LEN Bytes)
+     * @param tagOut Ausgabe (CRYPTO_PAIR_AUTH_LEN Bytes)
+     * @return true bei Erfolg (PSK gesetzt)
+     */
+    bool computePairAuth(const uint8_t* masterMac, const uint8_t* masterNonce, uint8_t* tagOut) const;
+
+    /**
+     * Pairing-Anfrage prüfen (Tag + Replay), akzeptierte Nonce merken
+     * @param masterMac Absender-MAC
+     * @param masterNonce Nonce aus der Anfrage
+     * @param tag Tag aus der Anfrage
+     * @param tagLen Länge des Tags
+     * @return true wenn authentisch und Nonce neu
+     */
+    bool verifyPairRequest(const uint8_t* masterMac, const uint8_t* masterNonce,
+                           const uint8_t* tag, size_t tagLen);
+
+    /**
+     * Session verwerfen (z.B. bei Verbindungsverlust)
+     */
+    void clearSession();
+
+    /**
+     * Ist eine Session aktiv?
+     */
+    bool hasSession() const { return sessionActive; }
+
+    /**
+     * Frame verschlüsseln und authentifizieren
+     * @param direction CRYPTO_DIR_* (Senderichtung)
+     * @param aadCmd MainCmd des Envelopes (geht in AAD ein)
+     * @param plain Klartext
+     * @param len Länge Klartext
+     * @param out Ausgabe (Ciphertext | Tag), mind. len + CRYPTO_TAG_LEN
+     * @param seqOut Verwendete Sequenznummer
+     * @return true bei Erfolg
+     */
+    bool seal(uint8_t direction, uint8_t aadCmd, const uint8_t* plain, size_t len,
+              uint8_t* out, uint32_t& seqOut);
+
+    /**
+     * Frame prüfen und entschlüsseln (inkl. Replay-Prüfung)
+     * @param direction CRYPTO_DIR_* (Senderichtung des Gegenübers)
+     * @param aadCmd MainCmd des Envelopes
+     * @param seq Sequenznummer aus dem Envelope
+     * @param in Ciphertext | Tag
+     * @param inLen Länge inkl. Tag
+     * @param plainOut Ausgabe Klartext (mind. inLen - CRYPTO_TAG_LEN)
+     * @return true wenn authentisch und nicht wiederholt
+     */
+    bool open(uint8_t direction, uint8_t aadCmd, uint32_t seq, const uint8_t* in, size_t inLen,
+              uint8_t* plainOut);
+
+    // Statistik
+    uint32_t getSealCount() const { return sealCount; }
+    uint32_t getOpenCount() const { return openCount; }
+    uint32_t getAuthFailures() const { return authFailures; }
+    uint32_t getReplayRejects() const { return replayRejects; }
+    uint32_t getPairRejects() const { return pairRejects; }
+    uint32_t getLastSealUs() const { return lastSealUs; }
+    uint32_t getLastOpenUs() const { return lastOpenUs; }
+    uint32_t getMaxOpenUs() const { return maxOpenUs; }
+
+    /**
+     * Benchmark: seal + open mit Wegwerf-Key
+     * @param payloadLen Klartext-Länge (max. CRYPTO_MAX_PLAINTEXT)
+     * @param iterations Anzahl Durchläufe
+     * @param sealUs Ausgabe: mittlere Dauer seal() in µs
+     * @param openUs Ausgabe: mittlere Dauer open() in µs
+     * @return true bei Erfolg
+     */
+    static bool benchmark(size_t payloadLen, uint32_t iterations, float& sealUs, float& openUs);
+
+    /**
+     * Debug-Info ausgeben
+     */
+    void printInfo() const;
+
+private:
+    uint8_t psk[32];
+    size_t pskLength;
+
+    bool sessionActive;
+    mbedtls_ccm_context ccm;
+    uint8_t salt[CRYPTO_NONCE_LEN - 5];     // Session-Salt für Nonce
+
+    // Sequenznummern
+    uint32_t txSeq;                         // Zuletzt gesendete Sequenz
+    uint32_t rxSeqMax;                      // Höchste akzeptierte Sequenz
+    uint32_t rxWindow;                      // Bit n = rxSeqMax - n bereits gesehen
+
+    // Zuletzt akzeptierte Pairing-Nonces (Ring)
+    uint8_t pairNonces[CRYPTO_PAIR_HISTORY][CRYPTO_PAIR_NONCE_LEN];
+    uint8_t pairNonceIndex;
+
+    // Statistik
+    uint32_t sealCount;
+    uint32_t openCount;
+    uint32_t authFailures;
+    uint32_t replayRejects;
+    uint32_t pairRejects;
+    uint32_t lastSealUs;
+    uint32_t lastOpenUs;
+    uint32_t maxOpenUs;
+
+    /**
+     * Nonce aus Richtung, Sequenz und Salt bilden
+     */
+    void buildNonce(uint8_t direction, uint32_t seq, uint8_t* nonce) const;
+
+    /**
+     * Replay-Fenster prüfen (ohne Aktualisierung)
+     */
+    bool isReplay(uint32_t seq) const;
+
+    /**
+     * Replay-Fenster nach erfolgreicher Prüfung aktualisieren
+     */
+    void markReceived(uint32_t seq);
+};
+
+#endif // FRAME_CRYPTO_H
@@ -20,6 +20,10 @@ class SerialCommandHandler;
 class PowerManager;
 class ESPNowRemoteController;
 class BatteryMonitor;
+class PacketCapture;
+class BlackBox;
+class TrajectoryPlayer;
+class BatteryHistory;
 class ESPNowPacket;
 
 enum class MainCmd : uint8_t;
@@ -35,6 +39,10 @@ extern SerialCommandHandler serialCmd;
 extern PowerManager powerMgr;
 extern ESPNowRemoteController espNow;
 extern BatteryMonitor battery;
+extern PacketCapture packetCapture;
+extern BlackBox blackBox;
+extern TrajectoryPlayer trajectory;
+extern BatteryHistory batteryHistory;
 
 // ═══════════════════════════════════════════════════════════════════════════
 // EXTERN DECLARATIONS - GLOBALE VARIABLEN
@@ -0,0 +1,102 @@
+/**
+ * InputShaper.h
+ *
+ * Eingangs-Shaping für den Fahrpfad (Joystick → Sollwert → Duty)
+ *
+ * Features:
+ * - Deadzone um die Mittelstellung, Rest auf 0..100 umskaliert
+ * - Expo: Mischung aus linearer und kubischer Kennlinie (feinfühlig um 0)
+ * - Trim pro Seite (Verstärkung 50..100 %, gleicht ungleiche Motoren aus)
+ * - Minimum-PWM (Losbrech-Duty) statt fest verdrahteter 127/255
+ * - Kennlinien werden bei Config-Änderung einmal in Tabellen übersetzt,
+ *   pro Kommando bleibt nur ein Tabellenzugriff (keine Float-Rechnung)
+ *
+ * Pipeline:
+ *   x, y   = AXIS[|joystick|]                (Deadzone + Expo, ±100)
+ *   L, R   = SteeringKernel::mix(x, y)
+ *   Soll   = SIDE[motor][|L|], SIDE[motor][|R|]   (Trim, Q8)
+ *   Duty   = 0 oder dutyMin + |Soll| · (MAX - dutyMin) / 100 %
+ *
+ * Ohne Arduino-Abhängigkeiten, damit die Tabellen auch auf dem Host
+ * geprüft werden können.
+ */
+
+#ifndef INPUT_SHAPER_H
+#define INPUT_SHAPER_H
+
+#include <stdint.h>
+
+/**
+ * Shaping-Parameter (aus UserConfig)
+ */
+struct ShapingParams {
+    uint8_t deadzone;       // 0..50 % Auslenkung ohne Wirkung
+    uint8_t expo;           // 0 = linear, 100 = rein kubisch
+    uint8_t trimLeft;       // 50..100 % Verstärkung links
+    uint8_t trimRight;      // 50..100 % Verstärkung rechts
+    uint8_t minPwm;         // 0..254 Losbrech-PWM (auf 8 Bit bezogen)
+};
+
+class InputShaper {
+public:
+    /**
+     * Konstruktor (neutrale Kennlinien)
+     */
+    InputShaper();
+
+    /**
+     * Tabellen aus Parametern aufbauen
+     * @param params Shaping-Parameter (werden begrenzt)
+     * @param maxDuty Vollausschlag der Ausgabestufe
+     */
+    void build(const ShapingParams& params, uint32_t maxDuty);
+
+    /**
+     * Joystick-Achse formen (sättigend, ±100)
+     */
+    inline int16_t shapeAxis(int16_t value) const {
+        int32_t v = value;
+        int32_t sign = v >> 31;
+        uint32_t mag = (uint32_t)((v ^ sign) - sign);
+        if (mag > 100) mag = 100;
+        int32_t shaped = axis[mag];
+        return (int16_t)((shaped ^ sign) - sign);
+    }
+
+    /**
+     * Motor-Speed (±100 %) → Sollwert in Q8 (Trim angewendet)
+     */
+    inline int32_t toTargetQ8(uint8_t motor, int32_t speed) const {
+        int32_t sign = speed >> 31;
+        uint32_t mag = (uint32_t)((speed ^ sign) - sign);
+        if (mag > 100) mag = 100;
+        int32_t q8 = side[motor & 1][mag];
+        return (q8 ^ sign) - sign;
+    }
+
+    /**
+     * Sollwert (Q8) → Duty (0 oder dutyMin..maxDuty)
+     */
+    inline uint32_t toDuty(int32_t speedQ8) const {
+        int32_t sign = speedQ8 >> 31;
+        uint32_t mag = (uint32_t)((speedQ8 ^ sign) - sign);
+        if (mag > 100 * 256) mag = 100 * 256;
+        uint32_t duty = dutyMin + mag * dutySpan / (100 * 256);
+        return (mag != 0) ? duty : 0;
+    }
+
+    /**
+     * Aktive Parameter
+     */
+    const ShapingParams& getParams() const { return params; }
+    uint32_t getDutyMin() const { return dutyMin; }
+
+private:
+    ShapingParams params;
+    int16_t axis[101];          // |Achse| → geformte Achse (0..100)
+    int32_t side[2][101];       // |Speed| → Sollwert Q8 mit Trim
+    uint32_t dutyMin;           // Losbrech-Duty
+    uint32_t dutySpan;          // maxDuty - dutyMin
+};
+
+#endif // INPUT_SHAPER_H
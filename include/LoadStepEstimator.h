@@ -0,0 +1,88 @@
+/**
+ * LoadStepEstimator.h
+ *
+ * Innenwiderstand aus Lastsprüngen (R = -ΔU / ΔI) - Rechenkern des
+ * ResistanceEstimator
+ *
+ * Features:
+ * - Schnelle Werte gemittelt in Blöcken zu IR_BLOCK_MS; stabil = Strom-Spanne
+ *   im Block unter IR_STABLE_CURRENT
+ * - Lastsprung (≥ IR_STEP_MIN_CURRENT) zwischen zwei stabilen Blöcken:
+ *   letzter stabiler Block davor, erster stabiler Block danach
+ *   (spätestens nach IR_STEP_TIMEOUT_MS, sonst verworfen - Rampe, Fahrt)
+ * - Ausreißer: Plausibilitätsbereich IR_MIN_OHM..IR_MAX_OHM, danach Median
+ *   über 5 Messungen, Schätzwert als EMA über den Median
+ * - O(1) pro Wert
+ *
+ * Ohne Arduino-Abhängigkeiten (Sicherung und Meldungen übernimmt
+ * ResistanceEstimator), Host-Simulation: tools/resistance_sim.cpp
+ */
+
+#ifndef LOAD_STEP_ESTIMATOR_H
+#define LOAD_STEP_ESTIMATOR_H
+
+#include <stdint.h>
+#include "setupConf.h"
+#include "Filters.h"
+
+class LoadStepEstimator {
+public:
+    LoadStepEstimator();
+
+    /**
+     * Schätzwert vorbelegen und Sprung-Erkennung neu starten
+     * @param ohm Startwert (gesichert oder BATTERY_INTERNAL_R)
+     * @param count Bisher übernommene Messungen
+     * @param nowMs Aktuelle Zeit in ms
+     */
+    void seed(float ohm, uint32_t count, unsigned long nowMs);
+
+    /**
+     * Schnellen Messwert übernehmen
+     * @param voltage Packspannung in V (ungefiltert)
+     * @param current Strom in A (ungefiltert)
+     * @param nowMs Zeit in ms
+     * @return true wenn eine neue Messung in den Schätzwert einging
+     */
+    bool addSample(float voltage, float current, unsigned long nowMs);
+
+    float getResistance() const { return resistance; }
+    float getLastMeasurement() const { return lastMeasurement; }
+    uint32_t getMeasurements() const { return measurements; }
+    uint32_t getRejected() const { return rejected; }
+
+private:
+    /**
+     * Mittelungsblock (Summen, Strom-Spanne)
+     */
+    struct Block {
+        float sumV;
+        float sumI;
+        float minI;
+        float maxI;
+        uint16_t count;
+        unsigned long startMs;
+    };
+
+    Block block;
+    bool haveStable;               // Stabiler Block vor einem Sprung vorhanden
+    float stableV;                 // Letzter stabiler Block (Mittel)
+    float stableI;
+    unsigned long stableMs;        // Ende des stabilen Blocks
+    bool stepActive;               // Sprung erkannt, warte auf stabilen Block
+    float preV;
+    float preI;
+    unsigned long stepMs;
+
+    Median<float, 5> median;
+    Ema<float, 3> estimate;
+    float resistance;
+    float lastMeasurement;
+    uint32_t measurements;
+    uint32_t rejected;
+
+    void resetBlock(unsigned long nowMs);
+    bool accept(float ohm);
+};
+
+#endif // LOAD_STEP_ESTIMATOR_H
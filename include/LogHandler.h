@@ -10,12 +10,14 @@
  * - Linux-style Format: [TIMESTAMP] [LEVEL] [TAG] Message
  * - Log-Rotation bei Dateigrößen-Limit
  * - Thread-safe Operationen
+ * - Binäre Log-Records für Hot-Paths (Formatierung erst in update())
  * - Automatische Erstellung des /logs Verzeichnisses
  * 
  * Verwendung:
  *   logHandler.info("System", "Initialized successfully");
  *   logHandler.error("Touch", "Calibration failed", ERROR_TOUCH_CALIB);
  *   logHandler.logBattery(7.4, 85, false, false);
+ *   logHandler.record(LOG_DEBUG, "Motor", "L=%ld R=%ld", left, right);  // allokationsfrei
  */
 
 #ifndef LOG_HANDLER_H
@@ -98,6 +100,34 @@ public:
      */
     void logf(LogLevel level, const char* tag, const char* format, ...);
 
+    /**
+     * Ist ein Log-Level aktiv? (vor teurer Aufbereitung prüfen)
+     */
+    bool isEnabled(LogLevel level) const { return level >= minLevel; }
+
+    /**
+     * Binären Log-Record ablegen (Hot-Path, aus jedem Task aufrufbar)
+     * - Level-Prüfung vor allem anderen, keine Heap-Allokation
+     * - Nur Zeiger + int32-Argumente werden kopiert, formatiert wird in update()
+     * @param level Log-Level
+     * @param tag Modul/Tag (String-Literal, muss dauerhaft gültig sein!)
+     * @param format Format-String (String-Literal, nur %ld/%lu/%lx auf int32)
+     */
+    void record(LogLevel level, const char* tag, const char* format,
+                int32_t a0 = 0, int32_t a1 = 0, int32_t a2 = 0,
+                int32_t a3 = 0, int32_t a4 = 0, int32_t a5 = 0);
+
+    /**
+     * Abgelegte Records formatieren und ausgeben (in loop() aufrufen!)
+     */
+    void update();
+
+    /**
+     * Record-Statistik
+     */
+    uint32_t getRecordsQueued() const { return recordsQueued; }
+    uint32_t getRecordsDropped() const { return recordsDropped; }
+
     // ═══════════════════════════════════════════════════════════════════════
     // SPEZIELLE LOG-FUNKTIONEN (für dedizierte Log-Dateien)
     // ═══════════════════════════════════════════════════════════════════════
@@ -183,6 +213,13 @@ public:
         }
     }
 
+    /**
+     * Externe Zeitquelle setzen (z.B. synchronisierte Master-Zeit)
+     * Liefert die Quelle -1, wird auf millis() zurückgefallen
+     * @param source Funktion mit Zeit in Mikrosekunden (nullptr = millis)
+     */
+    void setTimeSource(int64_t (*source)()) { timeSource = source; }
+
     /**
      * Ist SD-Karte verfügbar?
      */
@@ -202,6 +239,23 @@ private:
     SDCardHandler* sdHandler;  // Pointer zum SD-Handler (optional)
     LogLevel minLevel;         // Minimales Log-Level
     SemaphoreHandle_t mutex;   // Mutex für Thread-Safety
+    int64_t (*timeSource)();   // Optionale Zeitquelle in µs (nullptr = millis)
+
+    // Binäre Log-Records (Ringpuffer)
+    struct LogRecord {
+        const char* tag;
+        const char* format;
+        int64_t syncedUs;          // Zeitquelle bei Aufnahme (-1 = keine)
+        uint32_t ms;               // millis() bei Aufnahme
+        int32_t args[LOG_RECORD_MAX_ARGS];
+        uint8_t level;
+    };
+    LogRecord records[LOG_RECORD_QUEUE_SIZE];
+    uint16_t recordHead;       // Nächster Schreibplatz
+    uint16_t recordTail;       // Nächster Leseplatz
+    portMUX_TYPE recordLock;
+    uint32_t recordsQueued;
+    uint32_t recordsDropped;
 
     /**
      * Interne Log-Funktion (Kern-Implementierung)
@@ -212,6 +266,12 @@ private:
      */
     void log(LogLevel level, LogCategory category, const char* tag, const char* message);
 
+    /**
+     * Ausgabe mit fertigem Zeitstempel (Serial + SD)
+     */
+    void write(LogLevel level, LogCategory category, const char* tag, const char* message,
+               const char* timestamp);
+
     /**
      * Zeitstempel generieren
      * @param buffer Ausgabe-Buffer
@@ -219,6 +279,13 @@ private:
      */
     void getTimestamp(char* buffer, size_t bufferSize);
 
+    /**
+     * Zeitstempel aus gespeicherten Zeitwerten formatieren
+     * @param syncedUs Synchronisierte Zeit in µs (-1 = millis verwenden)
+     * @param ms millis() zum Aufnahmezeitpunkt
+     */
+    void formatTimestamp(char* buffer, size_t bufferSize, int64_t syncedUs, unsigned long ms);
+
     /**
      * Log-Level als String
      * @param level Log-Level
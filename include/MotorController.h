@@ -2,60 +2,246 @@
 #define MOTOR_CONTROLLER_H
 
 #include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include "setupConf.h"
+#include "MotorDriver.h"
+#include "InputShaper.h"
+#include "CurrentLimiter.h"
+#include "SagGuard.h"
+#include "WheelEncoder.h"
+#include "SpeedPid.h"
+#include "BlackBox.h"
+#include "TrajectoryPlayer.h"
 
 // Motor telemetry data structure
 struct MotorTelemetry {
-    int8_t leftSpeed;      // -100 to +100
-    int8_t rightSpeed;     // -100 to +100
-    uint8_t leftPWM;       // 0-255
-    uint8_t rightPWM;      // 0-255
+    int8_t leftSpeed;      // -100 to +100 (angewendet, nach Rampe)
+    int8_t rightSpeed;     // -100 to +100 (angewendet, nach Rampe)
+    uint8_t leftPWM;       // 0-255 (Duty auf 8 Bit skaliert)
+    uint8_t rightPWM;      // 0-255 (Duty auf 8 Bit skaliert)
     bool motorsEnabled;
     uint32_t lastUpdateMs;
 };
 
+// Control tick & command path statistics
+struct MotorTickStats {
+    uint32_t tickCount;
+    uint32_t skipped;       // Tick ausgelassen (Mutex belegt)
+    uint32_t lastUs;        // Laufzeit letzter Tick
+    uint32_t maxUs;         // Maximale Laufzeit
+    uint32_t avgUs;         // Mittlere Laufzeit
+    uint32_t maxJitterUs;   // Max. Abweichung vom Soll-Intervall
+    uint32_t cmdCount;      // processMovementInput() Aufrufe
+    uint32_t cmdLastCycles; // CPU-Zyklen letzter Aufruf
+    uint32_t cmdMaxCycles;
+    uint32_t cmdAvgCycles;
+    uint32_t watchdogTrips;     // Command-Watchdog Auslösungen
+    uint32_t watchdogLastUs;    // Letztes Command → Motor aus (µs)
+    uint32_t watchdogMaxUs;     // Worst Case Command → Motor aus (µs)
+    uint32_t firstCommandMs;    // Erstes Kommando seit Boot (millis, 0 = keins)
+};
+
+// Drehzahlregler (Closed-Loop) Status
+struct SpeedLoopStats {
+    bool encodersReady;
+    bool active;            // Closed-Loop gerade aktiv
+    int32_t count[2];       // Encoder-Zählerstand
+    int16_t measuredPct[2]; // Istdrehzahl in % von ENCODER_MAX_CPS
+    int16_t outputPct[2];   // Stellgröße des Reglers
+    uint32_t runs;          // Reglerschritte
+    uint32_t lastUs;        // Laufzeit (Encoder lesen + beide Regler)
+    uint32_t maxUs;
+    bool fault;             // Encoder unplausibel → Open-Loop (verriegelt)
+    uint8_t faultMotor;     // MOTOR_ID_* der auslösenden Seite
+    bool faultReversed;     // true = Gegenrichtung (A/B vertauscht), false = kein Signal
+    uint32_t faults;        // Auslösungen seit Start
+};
+
 class MotorController {
 public:
     // Constructor
     MotorController();
-    
-    // Initialize motor controller
+
+    // Initialize motor controller (Pins + 1 kHz Regel-Takt)
     void begin();
-    
+
     // Process movement input with improved differential steering
-    void processMovementInput(int8_t joystickX, int8_t joystickY);
-    
-    // Emergency stop
+    // Joystick -100..+100, größere Werte werden gesättigt
+    // Setzt nur das Ziel - der Regel-Takt fährt die Rampe
+    void processMovementInput(int16_t joystickX, int16_t joystickY);
+
+    // Emergency stop (sofort, ohne Rampe)
     void stop();
     
+    // Wiedergabe/Aufzeichnung beenden ('traj stop'): Sollwerte auf 0, Rampe bremst
+    // wie am natürlichen Ende der Wiedergabe. false = Mutex belegt, nichts geändert
+    bool stopTrajectory();
+
     // Enable/disable motors
     void enable();
     void disable();
-    
+
     // Get telemetry data
     MotorTelemetry getTelemetry() const;
+
+    // Ausgabestufe (Duty/Schreibzugriffe)
+    const MotorDriver& getDriver() const { return driver; }
+    
+    // Aktive Shaping-Kennlinien (Deadzone/Expo/Trim/Min-PWM)
+    const InputShaper& getShaper() const { return shaper; }
+    uint32_t getShaperRevision() const { return shaperRevision; }
+    
+    // Strombegrenzer-Statistik
+    CurrentLimitStats getCurrentLimitStats() const { return limiter.getStats(); }
+    int32_t getCurrentLimit() const { return limiter.getLimit(); }
+    
+    // Spannungseinbruch-Wächter
+    SagGuardStats getSagGuardStats() const { return sagGuard.getStats(); }
+    
+    // Spannungs-Kompensation (Faktor Q8, 256 = 1.0) und zugrunde liegende Spannung
+    uint16_t getVoltageCompScale() const { return vcompQ8; }
+    int32_t getVoltageCompMv() const { return vcompMv; }
     
-    // Update method for periodic tasks (SAFETY TIMEOUT!)
+    // Drehzahlregler-Status
+    SpeedLoopStats getSpeedLoopStats() const;
+    
+    // Stillstand: Soll und Ist beider Seiten 0 (lockfrei, z.B. Nullpunkt-Kalibrierung)
+    bool isIdle() const {
+        return targetQ8[0] == 0 && targetQ8[1] == 0 && appliedQ8[0] == 0 && appliedQ8[1] == 0;
+    }
+    
+    // Regel-Takt Statistik
+    MotorTickStats getTickStats() const;
+    void resetTickStats();
+
+    // Update method for periodic tasks (meldet Watchdog-Auslösung)
     void update();
 
 private:
-    // Pin definitions
-    uint8_t pinEnA, pinIn1, pinIn2;  // Left motor
-    uint8_t pinEnB, pinIn3, pinIn4;  // Right motor
+    // Ausgabestufe (LEDC + Richtungspins, Write-on-Change)
+    MotorDriver driver;
+
+    // Eingangs-Shaping (Tabellen, neu gebaut bei Config-Änderung)
+    InputShaper shaper;
+    uint32_t shaperRevision;
+
+    // Strombegrenzer (ADC-Messung im Regel-Takt, nur bei Fahrt)
+    CurrentLimiter limiter;
+    uint32_t reportedLimitEvents;
+
+    // Spannungseinbruch-Wächter (gleicher Messtakt wie der Strombegrenzer)
+    SagGuard sagGuard;
+    uint32_t reportedSagEvents;
+
+    // Spannungs-Kompensation: Nenn-/Akkuspannung, nur bei neuer Messung neu berechnet
+    uint16_t vcompQ8;
+    int32_t vcompMv;
+    uint32_t vcompSamples;
+
+    // Drehzahlregelung (Rad-Encoder über PCNT, PID pro Kette)
+    WheelEncoder encoders[2];
+    SpeedPid speedPid[2];
+    bool encodersReady;
+    bool closedLoop;                  // Regler-Ausgang treibt die PWM
+    uint32_t pidRevision;
+    int32_t lastCount[2];
+    int32_t measuredQ8[2];            // Istdrehzahl (% · 256)
+    int32_t outputQ8[2];              // Reglerausgang (% · 256)
+    uint32_t speedRuns;
+    uint32_t speedLastUs;
+    uint32_t speedMaxUs;
     
+    // Plausibilität: Ausgang hoch, Ist ~0 oder falsches Vorzeichen → Open-Loop
+    uint16_t speedSuspect[2];         // Reglerschritte in Folge unplausibel
+    volatile bool speedFault;         // Verriegelt bis speedLoop aus oder 'motor reset'
+    uint8_t speedFaultMotor;
+    bool speedFaultReversed;
+    uint32_t speedFaults;
+    uint32_t reportedSpeedFaults;
+
+    // Zuletzt empfangener Joystick (für die Black Box)
+    volatile int16_t lastJoyX;
+    volatile int16_t lastJoyY;
+
     // Current state
     MotorTelemetry telemetry;
     bool enabled;
-    
-    // Safety timeout
-    unsigned long lastCommandTime;    // Zeitpunkt des letzten Joystick-Commands
+
+    // Rampe (Speed in Prozent · 256, Q8)
+    int32_t targetQ8[2];              // Soll (aus Joystick)
+    int32_t appliedQ8[2];             // Ist (an Motor ausgegeben)
+
+    // Regel-Takt
+    esp_timer_handle_t tickTimer;
+    SemaphoreHandle_t stateMutex;
+    int64_t lastTickStartUs;
+
+    // Tick-Statistik
+    uint32_t tickCount;
+    uint32_t tickSkipped;
+    uint32_t tickLastUs;
+    uint32_t tickMaxUs;
+    uint64_t tickSumUs;
+    uint32_t tickMaxJitterUs;
+
+    // Kommando-Statistik (CPU-Zyklen pro processMovementInput)
+    uint32_t cmdCount;
+    uint32_t cmdLastCycles;
+    uint32_t cmdMaxCycles;
+    uint64_t cmdSumCycles;
+    uint32_t firstCommandMs;          // Boot → erstes Kommando (nicht zurückgesetzt)
+
+    // Safety timeout (Command-Watchdog im Regel-Takt, unabhängig von loop())
+    volatile uint32_t lastCommandUs;  // Zeitpunkt des letzten Joystick-Commands (µs, untere 32 Bit)
     static const unsigned long COMMAND_TIMEOUT_MS = 200;  // 200ms Timeout
+    volatile bool watchdogTripped;    // Auslösung noch nicht gemeldet
+    uint32_t tripCount;
+    uint32_t tripLastUs;
+    uint32_t tripMaxUs;
+    uint8_t tripLeftPwm;
+    uint8_t tripRightPwm;
+
+    // esp_timer Callback
+    static void tickCallback(void* arg);
+    void tick();
+
+    // Ist-Wert einen Takt Richtung Soll bewegen
+    static int32_t rampStep(int32_t applied, int32_t target, int32_t accelStep, int32_t decelStep);
+
+    // Speed (Q8) → Duty (0 oder Minimum..MAX_DUTY)
+    uint32_t speedToDuty(int32_t speedQ8) const { return shaper.toDuty(speedQ8); }
+
+    // Duty mit Spannungs-Kompensation skalieren (begrenzt auf MAX_DUTY)
+    uint32_t compensate(uint32_t duty) const {
+        uint32_t scaled = (duty * vcompQ8 + 128) >> 8;
+        return (scaled > MotorDriver::MAX_DUTY) ? MotorDriver::MAX_DUTY : scaled;
+    }
+
+    // Kompensations-Faktor bei neuer Akku-Messung neu berechnen (Mutex gehalten)
+    void updateVoltageComp();
+
+    // Shaping-Tabellen aus UserConfig neu bauen (Mutex gehalten)
+    void rebuildShaper();
+
+    // Encoder lesen, PID-Schritt für beide Ketten (Mutex gehalten)
+    void updateSpeedLoop();
+
+    // Reglerzustand und -ausgang löschen (Stopp/Watchdog)
+    void resetSpeedLoop();
     
-    // Internal motor control
-    void setMotor(uint8_t motor, bool forward, uint8_t pwm);
-    
-    // Safety check
-    void checkCommandTimeout();
+    // Encoder-Plausibilität einer Seite prüfen, true = Regler abgeschaltet (Mutex gehalten)
+    bool checkSpeedFault(uint8_t motor);
+
+    // Takt-Zustand in die Black Box schreiben (Mutex gehalten)
+    void recordBlackBox(uint32_t nowUs, bool watchdogTrip);
+
+    // Safety check (im Regel-Takt, Mutex gehalten)
+    bool checkWatchdog(uint32_t nowUs);
+
+    // Auslösung ausgeben (aus loop())
+    void reportWatchdogTrip();
 };
 
-#endif // MOTOR_CONTROLLER_H
\ No newline at end of file
+#endif // MOTOR_CONTROLLER_H
@@ -0,0 +1,89 @@
+/**
+ * MotorDriver.h
+ *
+ * Ausgabestufe für den H-Brücken-Treiber (L298N/DRV8833)
+ *
+ * Features:
+ * - Feste LEDC-Kanäle pro Motor, explizit konfiguriert (ledcAttachChannel)
+ * - Duty-Updates direkt über den LEDC-Treiber (ohne Pin→Kanal-Suche von analogWrite)
+ * - Richtungspins über gpio_set_level
+ * - Write-on-Change: Duty und Richtung nur bei Änderung schreiben
+ * - 10-Bit Auflösung (MOTOR_PWM_RES, bis 11 Bit bei 20 kHz)
+ * - Zähler für tatsächliche bzw. eingesparte Schreibzugriffe
+ */
+
+#ifndef MOTOR_DRIVER_H
+#define MOTOR_DRIVER_H
+
+#include <Arduino.h>
+#include <driver/ledc.h>
+#include <driver/gpio.h>
+#include "setupConf.h"
+
+// Auflösung muss in den LEDC-Takt passen: 2^RES · f ≤ Taktquelle
+static_assert((1UL << MOTOR_PWM_RES) * (unsigned long)MOTOR_PWM_FREQ <= MOTOR_PWM_SRC_CLK,
+              "MOTOR_PWM_RES zu hoch für MOTOR_PWM_FREQ");
+
+class MotorDriver {
+public:
+    static const uint32_t MAX_DUTY = (1UL << MOTOR_PWM_RES) - 1;
+
+    /**
+     * Konstruktor
+     */
+    MotorDriver();
+
+    /**
+     * Pins und LEDC-Kanäle konfigurieren, Ausgänge aus
+     * @return true bei Erfolg
+     */
+    bool begin();
+
+    /**
+     * Motor setzen (schreibt nur bei Änderung)
+     * @param motor MOTOR_ID_LEFT / MOTOR_ID_RIGHT
+     * @param forward Drehrichtung
+     * @param duty 0..MAX_DUTY
+     * @return true wenn sich die Ausgabe geändert hat
+     */
+    bool write(uint8_t motor, bool forward, uint32_t duty);
+
+    /**
+     * Alle Ausgänge sofort aus (schreibt immer, unabhängig vom Cache)
+     */
+    void stopAll();
+
+    /**
+     * Aktueller Duty eines Motors
+     */
+    uint32_t getDuty(uint8_t motor) const { return motor < 2 ? outputs[motor].duty : 0; }
+
+    /**
+     * Statistik
+     */
+    uint32_t getDutyWrites() const { return dutyWrites; }
+    uint32_t getGpioWrites() const { return gpioWrites; }
+    uint32_t getSkippedWrites() const { return skippedWrites; }
+    void resetStats();
+
+private:
+    struct Output {
+        uint8_t pinPwm;
+        uint8_t pinA;
+        uint8_t pinB;
+        ledc_channel_t channel;
+        uint32_t duty;
+        int8_t direction;       // +1 vorwärts, -1 rückwärts, 0 beide LOW
+    };
+    Output outputs[2];
+    bool initialized;
+
+    uint32_t dutyWrites;
+    uint32_t gpioWrites;
+    uint32_t skippedWrites;
+
+    void setDirection(Output& out, int8_t direction);
+    void setDuty(Output& out, uint32_t duty);
+};
+
+#endif // MOTOR_DRIVER_H
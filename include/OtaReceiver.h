@@ -0,0 +1,202 @@
+/**
+ * OtaReceiver.h
+ *
+ * Firmware-Update über ESP-NOW (Empfängerseite)
+ *
+ * Features:
+ * - Streaming direkt in die inaktive OTA-Partition (kein Image-Puffer)
+ * - Sliding Window mit kumulativen ACKs (kein Stop-and-Wait)
+ * - Kleiner Reorder-Puffer für Chunks außer der Reihe
+ * - SHA-256 Prüfung über das komplette Image (inkrementell)
+ * - Fortsetzen nach Verbindungsabbruch (gleiches Image → ab letzter Position)
+ * - Pause (Fenster = 0, kein Flash-Zugriff) während die Motoren laufen:
+ *   Sektor-Löschen schaltet den Flash-Cache ab und hält den 1-kHz-Regel-Takt
+ *   (samt Watchdog) für zig ms an. Im Stand folgt ein ACK mit vollem Fenster.
+ * - Durchsatz-Statistik
+ * - Nur authentische Frames (SECURE-Envelope, Prüfung im ESPNowRemoteController),
+ *   sonst ERR_AUTH
+ *
+ * Protokoll (Master → Fahrzeug):
+ *   OTA_BEGIN  [OTA_SIZE: uint32] [OTA_SHA256: 32B]
+ *   OTA_DATA   [OTA_OFFSET: uint32] [OTA_DATA: Bytes]
+ *   OTA_END    (Prüfung, Boot-Partition setzen, Neustart im Stand)
+ *   OTA_ABORT
+ *
+ * Antwort (Fahrzeug → Master):
+ *   OTA_ACK    [STATUS: uint8] [OTA_OFFSET: uint32 nächster erwarteter Offset]
+ *              [OTA_WINDOW: uint8 erlaubte Chunks im Flug]
+ *
+ * Der Master darf bis zu OTA_WINDOW Chunks ab OTA_OFFSET senden.
+ * OTA_WINDOW = 0 (Status PAUSED): nichts senden bis zum nächsten ACK.
+ * Ein ACK mit unverändertem Offset nach Lücke = Neuübertragung ab Offset.
+ */
+
+#ifndef OTA_RECEIVER_H
+#define OTA_RECEIVER_H
+
+#include <Arduino.h>
+#include <esp_ota_ops.h>
+#include <mbedtls/sha256.h>
+#include "setupConf.h"
+#include "ESPNowPacket.h"
+
+/**
+ * OTA Status-Codes (DataCmd::STATUS im OTA_ACK)
+ */
+enum class OtaStatus : uint8_t {
+    OK              = 0x00,     // Weiter senden
+    DONE            = 0x01,     // Image geprüft, Neustart folgt
+    ERR_NO_SESSION  = 0x02,     // Kein OTA_BEGIN
+    ERR_SIZE        = 0x03,     // Image passt nicht in Partition
+    ERR_BEGIN       = 0x04,     // esp_ota_begin fehlgeschlagen
+    ERR_WRITE       = 0x05,     // Flash-Schreibfehler
+    ERR_HASH        = 0x06,     // SHA-256 stimmt nicht
+    ERR_IMAGE       = 0x07,     // Image ungültig (esp_ota_end)
+    ERR_INCOMPLETE  = 0x08,     // OTA_END vor vollständigem Empfang
+    ABORTED         = 0x09,     // Abgebrochen
+    ERR_AUTH        = 0x0A,     // Nicht im SECURE-Envelope (Pairing mit PSK nötig)
+    PAUSED          = 0x0B      // Motoren aktiv: Fenster 0, Chunk nicht geschrieben
+};
+
+class OtaReceiver {
+public:
+    /**
+     * Konstruktor & Destruktor
+     */
+    OtaReceiver();
+    ~OtaReceiver();
+
+    /**
+     * OTA-Frame verarbeiten
+     * @param packet Empfangenes Paket (OTA_BEGIN/DATA/END/ABORT)
+     * @param reply Antwort (nur gültig bei Rückgabe true)
+     * @return true wenn reply gesendet werden soll
+     */
+    bool handlePacket(const ESPNowPacket& packet, ESPNowPacket& reply);
+
+    /**
+     * OTA-Frame ohne Verarbeitung abweisen (z.B. nicht authentisch)
+     * @param packet Empfangenes Paket
+     * @param status Grund für den Master
+     * @param reply Antwort (nur gültig bei Rückgabe true)
+     * @return true wenn reply gesendet werden soll (nicht für jeden OTA_DATA-Chunk)
+     */
+    bool rejectPacket(const ESPNowPacket& packet, OtaStatus status, ESPNowPacket& reply);
+
+    /**
+     * Update (in loop() aufrufen!)
+     * - Session-Timeout
+     * - Ende der Pause melden
+     * @param reply ACK mit vollem Fenster (nur gültig bei Rückgabe true)
+     * @return true wenn reply an den Master gesendet werden soll
+     */
+    bool update(ESPNowPacket& reply);
+
+    /**
+     * Neustart ins neue Image fällig (OTA_REBOOT_DELAY_MS nach DONE)
+     * Der Aufrufer wartet auf Stillstand und startet über PowerManager::restart()
+     * neu (Ladezustand, Innenwiderstand, Verlauf sichern)
+     */
+    bool isRestartPending() const { return rebootAt != 0 && (long)(millis() - rebootAt) >= 0; }
+
+    /**
+     * Motorstatus setzen (aktiv = pausieren, kein Flash-Zugriff)
+     */
+    void setMotorsActive(bool active) { motorsActive = active; }
+
+    /**
+     * Laufende Session abbrechen
+     */
+    void abort();
+
+    /**
+     * Status
+     */
+    bool isActive() const { return active; }
+    uint32_t getImageSize() const { return imageSize; }
+    uint32_t getWrittenBytes() const { return written; }
+
+    /**
+     * Durchsatz der laufenden/letzten Session in Bytes/s
+     */
+    uint32_t getThroughput() const;
+
+    /**
+     * Debug-Info ausgeben
+     */
+    void printInfo() const;
+
+private:
+    // Session
+    bool active;
+    const esp_partition_t* partition;
+    esp_ota_handle_t handle;
+    uint32_t imageSize;
+    uint8_t expectedSha[32];
+    uint32_t written;               // Zusammenhängend geschrieben (= nächster Offset)
+    mbedtls_sha256_context sha;
+    bool motorsActive;
+    bool paused;                    // Fenster 0 gemeldet, Freigabe-ACK ausstehend
+
+    // Reorder-Puffer
+    struct ReorderSlot {
+        bool used;
+        uint32_t offset;
+        uint16_t length;
+        uint8_t data[OTA_MAX_CHUNK];
+    };
+    ReorderSlot slots[OTA_REORDER_SLOTS];
+    uint32_t lastGapAckOffset;      // Lücke bereits gemeldet (keine ACK-Stürme)
+    uint8_t chunksSinceAck;
+
+    // Zeitsteuerung
+    unsigned long lastActivity;
+    unsigned long rebootAt;         // 0 = kein Neustart geplant (DONE-ACK abwarten)
+
+    // Statistik
+    unsigned long sessionStartMs;
+    unsigned long sessionEndMs;
+    uint32_t sessionStartOffset;    // Fortsetzungspunkt (für Durchsatz)
+    uint32_t chunksReceived;
+    uint32_t chunksDuplicate;
+    uint32_t chunksOutOfOrder;
+    uint32_t chunksDropped;
+    uint32_t chunksPaused;          // Während Fahrt nicht geschrieben
+    uint32_t acksSent;
+    uint32_t resumes;
+    OtaStatus lastStatus;
+
+    /**
+     * Frame-Handler
+     */
+    OtaStatus handleBegin(const ESPNowPacket& packet);
+    bool handleData(const ESPNowPacket& packet, OtaStatus& status);
+    OtaStatus handleEnd();
+
+    /**
+     * Chunk an aktueller Position schreiben (Flash + SHA)
+     */
+    bool writeChunk(const uint8_t* data, size_t len);
+
+    /**
+     * Gepufferte Folge-Chunks schreiben
+     */
+    bool drainSlots();
+
+    /**
+     * Chunk im Reorder-Puffer ablegen
+     */
+    bool storeSlot(uint32_t offset, const uint8_t* data, size_t len);
+
+    /**
+     * ACK-Paket aufbauen
+     */
+    void buildAck(ESPNowPacket& reply, OtaStatus status);
+
+    /**
+     * Session-Ressourcen freigeben
+     */
+    void closeSession(bool abortOta);
+};
+
+#endif // OTA_RECEIVER_H
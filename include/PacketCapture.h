@@ -0,0 +1,188 @@
+/**
+ * PacketCapture.h
+ *
+ * Mitschnitt aller ESP-NOW Frames (RX/TX) auf SD-Karte mit Replay
+ *
+ * Features:
+ * - RX/TX-Frames mit µs-Zeitstempel, Peer-MAC und RSSI
+ * - Lock-armer RAM-Ringpuffer (Hook läuft im WiFi-Task)
+ * - Gebündelte Schreibzugriffe auf SD (Flush in update())
+ * - Replay: RX-Frames aus Capture-Datei in die RX-Queue einspeisen
+ *   (Echtzeit, beschleunigt oder so schnell wie möglich)
+ *
+ * Dateiformat (Little Endian):
+ *   CaptureFileHeader (24 Bytes)
+ *   { CaptureRecordHeader (13 Bytes) + Rohdaten (length Bytes) } * N
+ *
+ * Host-Tool: tools/capture2pcap.py (Konvertierung nach pcap)
+ */
+
+#ifndef PACKET_CAPTURE_H
+#define PACKET_CAPTURE_H
+
+#include <Arduino.h>
+#include "setupConf.h"
+#include "SDCardHandler.h"
+#include "ESPNowManager.h"
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DATEIFORMAT
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define CAPTURE_MAGIC           "ECAP"
+#define CAPTURE_VERSION         1
+#define CAPTURE_FLAG_TX         0x01    // Frame gesendet (sonst empfangen)
+
+struct __attribute__((packed)) CaptureFileHeader {
+    char magic[4];              // "ECAP"
+    uint16_t version;           // Formatversion
+    uint16_t headerSize;        // sizeof(CaptureFileHeader)
+    uint8_t ownMac[6];          // MAC des aufzeichnenden Geräts
+    uint8_t reserved[2];
+    int64_t startUs;            // esp_timer beim Start
+};
+
+struct __attribute__((packed)) CaptureRecordHeader {
+    uint32_t timeUs;            // µs seit startUs (Überlauf nach ~71 min, Host entfaltet)
+    uint8_t flags;              // CAPTURE_FLAG_*
+    int8_t rssi;                // dBm (nur RX)
+    uint8_t mac[6];             // Peer-MAC (Quelle bei RX, Ziel bei TX)
+    uint8_t length;             // Länge der Rohdaten
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PACKET CAPTURE
+// ═══════════════════════════════════════════════════════════════════════════
+
+class PacketCapture {
+public:
+    /**
+     * Konstruktor
+     */
+    PacketCapture();
+
+    /**
+     * Destruktor
+     */
+    ~PacketCapture();
+
+    /**
+     * Initialisieren (Ringpuffer allokieren, bevorzugt PSRAM)
+     * @param sdHandler Pointer zum SDCardHandler
+     * @param espNow Pointer zum ESPNowManager (für Replay)
+     * @return true bei Erfolg
+     */
+    bool begin(SDCardHandler* sdHandler, ESPNowManager* espNow);
+
+    /**
+     * Aufzeichnung starten (neue Datei in CAPTURE_DIR)
+     * @return true bei Erfolg
+     */
+    bool startCapture();
+
+    /**
+     * Aufzeichnung beenden (Rest flushen)
+     */
+    void stopCapture();
+
+    /**
+     * Replay starten
+     * @param path Capture-Datei
+     * @param speed Geschwindigkeitsfaktor (1 = Echtzeit, 0 = so schnell wie möglich)
+     * @return true bei Erfolg
+     */
+    bool startReplay(const char* path, uint16_t speed);
+
+    /**
+     * Replay abbrechen
+     */
+    void stopReplay();
+
+    /**
+     * Update (in loop() aufrufen!)
+     * - Flusht Ringpuffer gebündelt auf SD
+     * - Speist fällige Replay-Frames ein
+     */
+    void update();
+
+    /**
+     * Status
+     */
+    bool isCapturing() const { return capturing; }
+    bool isReplaying() const { return replaying; }
+    const char* getCapturePath() const { return capturePath; }
+
+    /**
+     * Debug-Info ausgeben
+     */
+    void printInfo();
+
+private:
+    static PacketCapture* instance;
+
+    SDCardHandler* sdHandler;
+    ESPNowManager* espNow;
+
+    // Ringpuffer (Größe: Zweierpotenz)
+    uint8_t* ring;
+    volatile uint32_t ringHead;     // Schreibposition (frei laufend)
+    volatile uint32_t ringTail;     // Leseposition (frei laufend)
+    portMUX_TYPE ringLock;
+    uint8_t* stagingBuffer;         // Flush- bzw. Replay-Lesepuffer
+
+    // Aufzeichnung
+    bool capturing;
+    char capturePath[32];
+    int64_t captureStartUs;
+    unsigned long lastFlush;
+    uint32_t framesCaptured;
+    uint32_t framesDropped;
+    uint32_t bytesWritten;
+    uint32_t writeErrors;
+
+    // Replay
+    bool replaying;
+    char replayPath[32];
+    uint16_t replaySpeed;
+    size_t replayFileSize;
+    size_t replayOffset;            // Dateiposition des nächsten Records
+    size_t replayBufStart;          // Dateiposition des Lesepuffers
+    size_t replayBufLen;
+    int64_t replayStartUs;
+    int64_t replayFirstUs;          // Zeitstempel des ersten Records
+    uint32_t replayLastRawUs;       // Für Überlauf-Entfaltung
+    uint64_t replayTimeBaseUs;
+    uint32_t replayInjected;
+    uint32_t replaySkipped;         // TX-Records (nicht einspeisbar)
+
+    /**
+     * Capture-Hook (WiFi-Task bzw. send())
+     */
+    static void captureHook(bool tx, const uint8_t* mac, const uint8_t* data, size_t len,
+                            int8_t rssi, int64_t timeUs);
+
+    /**
+     * Record in Ringpuffer schreiben
+     */
+    void pushRecord(bool tx, const uint8_t* mac, const uint8_t* data, size_t len,
+                    int8_t rssi, int64_t timeUs);
+
+    /**
+     * Ringpuffer auf SD schreiben
+     * @param force Auch unterhalb der Schwelle schreiben
+     */
+    void flush(bool force);
+
+    /**
+     * Bereich der Replay-Datei über den Lesepuffer bereitstellen
+     * @return Pointer auf Daten, nullptr bei Dateiende/Fehler
+     */
+    const uint8_t* replayFetch(size_t offset, size_t len);
+
+    /**
+     * Fällige Replay-Frames einspeisen
+     */
+    void processReplay();
+};
+
+#endif // PACKET_CAPTURE_H
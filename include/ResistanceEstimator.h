@@ -0,0 +1,82 @@
+/**
+ * ResistanceEstimator.h
+ *
+ * Pack-Innenwiderstand aus Lastsprüngen (R = -ΔU / ΔI), laufend nachgeführt
+ *
+ * Features:
+ * - Schnelle Werte aus der DMA-Abtastung (jeder BatteryMonitor::update()-Aufruf)
+ * - Sprung-Erkennung, Ausreißer und Mittelung im LoadStepEstimator
+ *   (Motor an/aus, ≥ IR_STEP_MIN_CURRENT zwischen stabilen Blöcken)
+ * - Schätzwert auf SD gesichert (ab IR_SAVE_DELTA, vor Sleep/Shutdown)
+ * - Alterung: Warnung ab IR_AGING_FACTOR × BATTERY_INTERNAL_R
+ * - O(1) pro Wert
+ */
+
+#ifndef RESISTANCE_ESTIMATOR_H
+#define RESISTANCE_ESTIMATOR_H
+
+#include <Arduino.h>
+#include "setupConf.h"
+#include "SDCardHandler.h"
+#include "LoadStepEstimator.h"
+
+/**
+ * Gesicherter Zustand (IR_STATE_FILE)
+ */
+struct ResistanceState {
+    uint32_t magic;             // IR_STATE_MAGIC
+    float resistance;           // Schätzwert in Ohm
+    uint32_t measurements;      // Übernommene Messungen gesamt
+    uint32_t crc;               // CRC32 über die Felder davor
+};
+
+class ResistanceEstimator {
+public:
+    /**
+     * Konstruktor
+     */
+    ResistanceEstimator();
+
+    /**
+     * Gesicherten Schätzwert laden
+     * @param sdHandler Pointer zum SDCardHandler (nullptr = ohne Sicherung)
+     */
+    void begin(SDCardHandler* sdHandler);
+
+    /**
+     * Schnellen Messwert übernehmen (alle ~10 ms)
+     * @param voltage Packspannung in V (ungefiltert)
+     * @param current Strom in A (ungefiltert)
+     * @param nowMs millis()
+     * @return true wenn eine neue Messung in den Schätzwert einging
+     */
+    bool addSample(float voltage, float current, unsigned long nowMs);
+
+    /**
+     * Schätzwert sofort sichern (vor Sleep/Shutdown)
+     */
+    void save();
+
+    float getResistance() const { return core.getResistance(); }
+    float getLastMeasurement() const { return core.getLastMeasurement(); }
+    uint32_t getMeasurements() const { return core.getMeasurements(); }
+    uint32_t getRejected() const { return core.getRejected(); }
+    bool isAging() const { return core.getResistance() >= BATTERY_INTERNAL_R * IR_AGING_FACTOR; }
+
+    /**
+     * Debug-Informationen ausgeben
+     */
+    void printInfo() const;
+
+private:
+    SDCardHandler* sdHandler;
+    LoadStepEstimator core;
+
+    float savedResistance;
+    unsigned long lastSaveTime;
+    bool agingReported;
+
+    bool load(ResistanceState& state);
+};
+
+#endif // RESISTANCE_ESTIMATOR_H
@@ -0,0 +1,94 @@
+/**
+ * RuntimePredictor.h
+ *
+ * Restlaufzeit aus Restenergie und aktueller Leistungsaufnahme
+ *
+ * Features:
+ * - Leistungsmittel getrennt für Fahrt und Stand (je RUNTIME_POWER_WINDOW
+ *   Messungen), gewichtet mit dem Fahranteil der letzten RUNTIME_DUTY_WINDOW
+ *   Messungen → Prognose folgt dem Fahrprofil, nicht dem Augenblickswert
+ * - Restenergie aus Ladezustand × Kapazität × mittlerer Klemmenspannung
+ *   über den Rest der Kennlinie (Ruhespannung minus I · R)
+ * - Drei Zeiten:
+ *   - bis leer (0 %)
+ *   - bis zur Abschaltung: Spannung ohne Last (U + I·R, siehe BatteryMonitor)
+ *     erreicht VOLTAGE_SHUTDOWN. Mit VOLTAGE_SHUTDOWN = Kennlinien-Anfang
+ *     (12.8 V) ist das 0 % und gleich "bis leer"; getrennt geführt, damit ein
+ *     höher gesetzter Wert durchschlägt (Telemetrie DataCmd::BATTERY_CUTOFF)
+ *   - bis zur Drosselung: Ruhespannung minus mittlerer Fahrstrom × R erreicht
+ *     SAG_SOFT_MV, der SagGuard nimmt die Motoren zurück
+ * - O(1) pro Messung (laufende Summen, Kennlinie mit 11 Stützpunkten)
+ */
+
+#ifndef RUNTIME_PREDICTOR_H
+#define RUNTIME_PREDICTOR_H
+
+#include <Arduino.h>
+#include "setupConf.h"
+#include "Filters.h"
+
+class RuntimePredictor {
+public:
+    /**
+     * Konstruktor
+     */
+    RuntimePredictor();
+
+    /**
+     * Prognose fortschreiben (aus BatteryMonitor::update(), 1 s)
+     * @param power Leistung in W (gefiltert)
+     * @param voltage Packspannung in V (gefiltert)
+     * @param driving Motoren laufen
+     * @param socPercent Ladezustand (0-100)
+     * @param capacityMah Nennkapazität in mAh
+     * @param internalR Pack-Innenwiderstand in Ohm
+     */
+    void update(float power, float voltage, bool driving,
+                float socPercent, uint16_t capacityMah, float internalR);
+
+    /**
+     * Sekunden bis leer, bis zur Unterspannungs-Abschaltung bzw. bis zur
+     * Drosselung bei Fahrstrom
+     * @return Sekunden, RUNTIME_UNKNOWN ohne nennenswerten Verbrauch
+     */
+    uint32_t getSecondsToEmpty() const { return secondsToEmpty; }
+    uint32_t getSecondsToShutdown() const { return secondsToShutdown; }
+    uint32_t getSecondsToDerate() const { return secondsToDerate; }
+
+    float getPredictedPower() const { return predictedPower; }
+    float getDutyCycle() const { return dutyCycle; }
+    float getRemainingWh() const { return remainingWh; }
+    float getShutdownPercent() const { return shutdownPercent; }
+    float getDeratePercent() const { return deratePercent; }
+    float getDriveCurrent() const { return driveCurrent; }
+
+    /**
+     * Debug-Informationen ausgeben
+     */
+    void printInfo() const;
+
+private:
+    MovingAverage<float, RUNTIME_POWER_WINDOW> drivePower;
+    MovingAverage<float, RUNTIME_POWER_WINDOW> idlePower;
+    MovingAverage<float, RUNTIME_DUTY_WINDOW> duty;
+
+    float predictedPower;          // Gewichtete Leistung (W)
+    float dutyCycle;               // Fahranteil (0..1)
+    float remainingWh;             // Bis leer
+    float shutdownPercent;         // Ladezustand, bei dem die Abschaltung greift
+    float deratePercent;           // Ladezustand, bei dem der SagGuard drosselt
+    float driveCurrent;            // Mittlerer Fahrstrom (A)
+    uint32_t secondsToEmpty;
+    uint32_t secondsToShutdown;
+    uint32_t secondsToDerate;
+
+    static uint32_t toSeconds(float wh, float watts);
+
+    /**
+     * Energie zwischen Ladezustand und Untergrenze (Wh)
+     * Ladung × mittlere Klemmenspannung über diesen Teil der Kennlinie
+     */
+    static float energyAbove(float socPercent, float floorPercent, float capacityAh, float loadVoltage);
+};
+
+#endif // RUNTIME_PREDICTOR_H
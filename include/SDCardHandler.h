@@ -118,6 +118,35 @@ public:
      */
     int readBinaryFile(const char* path, uint8_t* buffer, size_t maxLen);
 
+    /**
+     * Binärdaten an Datei anhängen
+     * @param path Dateipfad
+     * @param data Daten
+     * @param len Länge in Bytes
+     * @return true bei Erfolg
+     */
+    bool appendBinaryFile(const char* path, const uint8_t* data, size_t len);
+
+    /**
+     * Binärdaten ab Position lesen
+     * @param path Dateipfad
+     * @param offset Byte-Offset in der Datei
+     * @param buffer Buffer für Daten
+     * @param len Anzahl zu lesender Bytes
+     * @return Anzahl gelesener Bytes, -1 bei Fehler
+     */
+    int readBinaryAt(const char* path, size_t offset, uint8_t* buffer, size_t len);
+
+    /**
+     * Binärdaten ab Position überschreiben (Datei muss existieren)
+     * @param path Dateipfad
+     * @param offset Byte-Offset in der Datei (≤ Dateigröße)
+     * @param data Daten
+     * @param len Anzahl Bytes
+     * @return true bei Erfolg
+     */
+    bool writeBinaryAt(const char* path, size_t offset, const uint8_t* data, size_t len);
+
     /**
      * Datei löschen
      * @param path Dateipfad
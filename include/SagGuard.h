@@ -0,0 +1,90 @@
+/**
+ * SagGuard.h
+ *
+ * Schneller Spannungseinbruch-Wächter für den Motor-Regeltakt
+ *
+ * Features:
+ * - Momentane Packspannung (DMA-Wert, 1 kHz) mit kurzem IIR-Filter
+ *   (Shift SAG_FILTER_SHIFT), reine Integer-Rechnung
+ * - Drosselung ab SAG_SOFT_MV, linear bis SAG_MIN_SCALE bei SAG_FLOOR_MV:
+ *   begrenzt den Einbruch beim Anfahren, bevor BMS oder Spannungsregler abschalten
+ * - Schnelles Eingreifen, langsames Freigeben (SAG_RELEASE pro Messung)
+ * - Statistik: Einbrüche, tiefste Spannung, Dauer unter SAG_SOFT_MV
+ *
+ * Kein Shutdown: ob der Akku wirklich leer ist, entscheidet BatteryMonitor
+ * (Spannung + I·R über SAG_CONFIRM_MS).
+ * Ohne Arduino-Abhängigkeiten (ADC-Lesen übernimmt der Aufrufer).
+ */
+
+#ifndef SAG_GUARD_H
+#define SAG_GUARD_H
+
+#include <stdint.h>
+#include "setupConf.h"
+
+/**
+ * Statistik des Spannungs-Wächters
+ */
+struct SagGuardStats {
+    uint32_t samples;           // Messungen gesamt
+    uint32_t sagEvents;         // Eingriffe (Faktor < 1)
+    int32_t filteredMv;         // Aktuelle gefilterte Spannung
+    int32_t minMv;              // Tiefster Rohwert seit Reset
+    uint16_t scaleQ8;           // Aktueller Faktor (256 = 100 %)
+    uint16_t minScaleQ8;        // Kleinster Faktor seit Reset
+    uint32_t lastSagUs;         // Letzte Dauer unter SAG_SOFT_MV
+    uint32_t maxSagUs;
+};
+
+class SagGuard {
+public:
+    static const uint16_t SCALE_ONE = 256;
+
+    /**
+     * Konstruktor
+     */
+    SagGuard();
+
+    /**
+     * Neue Messung verarbeiten
+     * @param voltageMv Momentane Packspannung in mV
+     * @param nowUs Zeitstempel (µs)
+     * @return Duty-Faktor Q8 (256 = ungedrosselt)
+     */
+    uint16_t update(int32_t voltageMv, uint32_t nowUs);
+
+    /**
+     * Motoren stehen: Filter und Faktor zurücksetzen
+     */
+    void idle();
+
+    /**
+     * Duty mit aktuellem Faktor skalieren
+     */
+    inline uint32_t apply(uint32_t duty) const {
+        return (scaleQ8 >= SCALE_ONE) ? duty : (duty * scaleQ8) >> 8;
+    }
+
+    /**
+     * Aktueller Zustand ohne Statistik-Kopie (für die Black Box im Takt)
+     */
+    uint16_t getScale() const { return scaleQ8; }
+    int32_t getFilteredMv() const { return filteredQ4 >> 4; }
+    bool isSagging() const { return sagging; }
+
+    /**
+     * Statistik
+     */
+    SagGuardStats getStats() const;
+    void resetStats();
+
+private:
+    int32_t filteredQ4;         // IIR-Zustand (mV · 16), 0 = leer
+    uint16_t scaleQ8;
+    bool sagging;               // Gefiltert unter SAG_SOFT_MV
+    uint32_t sagSinceUs;
+
+    SagGuardStats stats;
+};
+
+#endif // SAG_GUARD_H
@@ -19,8 +19,19 @@
  *   clearall       - Löscht alle Log-Dateien
  *   sysinfo        - Zeigt System-Informationen
  *   config         - Zeigt aktuelle Konfiguration
- *   battery        - Zeigt Battery-Status
+ *   battery        - Zeigt Battery-Status und Restlaufzeit (leer / Shutdown / Drosselung)
+ *                    'battery cal low|high <mV>' Spannungs-Korrektur, 'battery adc' Kennlinie als CSV
+ *   history        - Akku-Verlauf (Sekunden/Minuten/Stunden) aus dem SD-Ringspeicher
  *   espnow         - Zeigt ESP-NOW Status
+ *   timesync       - Zeigt Zeitsync-Status und Joystick-Latenz
+ *   capture        - ESP-NOW Mitschnitt (start/stop/replay)
+ *   blackbox       - Fahrtenschreiber-Status, 'blackbox dump' sichert auf SD
+ *   traj           - Sollwert-Verläufe laden/aufzeichnen/fahren (load/play/rec/save/stop)
+ *   crypto         - Verschlüsselungs-Status, 'crypto bench' misst Kosten pro Frame
+ *   ota            - Firmware-Update Status, 'ota abort' bricht ab
+ *   steer          - Steering-Kernel Self-Test & Zyklen pro Kommando
+ *   motor          - Motor-Status, Rampe und Regel-Takt Statistik
+ *                    'motor wdtest [ms]' misst den Command-Watchdog unter SD-Last
  */
 
 #ifndef SERIAL_COMMAND_HANDLER_H
@@ -90,8 +101,19 @@ private:
     void handleConfigSet(const String& key, const String& value);
     void handleConfigSave();
     void handleConfigReset();
-    void handleBattery();
+    void handleBattery(const String& args);
+    void handleBatteryCal(const String& args);
+    void handleHistory(const String& args);
     void handleESPNow();
+    void handleTimeSync(const String& args);
+    void handleCapture(const String& args);
+    void handleBlackBox(const String& args);
+    void handleTrajectory(const String& args);
+    void handleCrypto(const String& args);
+    void handleOta(const String& args);
+    void handleSteer(const String& args);
+    void handleMotor(const String& args);
+    void handleWatchdogTest(int blockMs);
 
     // Hilfsfunktionen
     void listDirectory(const char* dirname);
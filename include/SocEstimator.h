@@ -0,0 +1,118 @@
+/**
+ * SocEstimator.h
+ *
+ * Ladezustand (State of Charge) für 4S Li-Ion aus Coulomb-Zählung + Ruhespannung
+ *
+ * Features:
+ * - Coulomb-Zählung: verbrauchte mAh / Kapazität (batteryCapacity in UserConfig)
+ * - Ruhespannungs-Kennlinie (OCV) pro Zelle, nur in Ruhephasen angeglichen:
+ *   Strom unter SOC_REST_CURRENT seit SOC_REST_TIME_MS
+ * - IR-Korrektur: OCV = U + I · R (Pack-Innenwiderstand)
+ * - Angleich gewichtet nach Steilheit der Kennlinie (im flachen Mittelteil
+ *   bestimmt die Zählung, an den Enden die Spannung)
+ * - Zustand auf SD gesichert (ab SOC_SAVE_DELTA Änderung, vor Sleep/Shutdown)
+ *   und beim Start übernommen, außer die Ruhespannung widerspricht um mehr als
+ *   SOC_BOOT_MISMATCH (Akku getauscht oder geladen)
+ */
+
+#ifndef SOC_ESTIMATOR_H
+#define SOC_ESTIMATOR_H
+
+#include <Arduino.h>
+#include "setupConf.h"
+#include "SDCardHandler.h"
+
+/**
+ * Gesicherter Zustand (SOC_STATE_FILE)
+ */
+struct SocState {
+    uint32_t magic;             // SOC_STATE_MAGIC
+    float socPercent;
+    uint16_t capacityMah;       // Kapazität beim Sichern (Info)
+    uint16_t reserved;
+    uint32_t crc;               // CRC32 über die Felder davor
+};
+
+class SocEstimator {
+public:
+    /**
+     * Konstruktor
+     */
+    SocEstimator();
+
+    /**
+     * Gesicherten Zustand laden und mit der Ruhespannung abgleichen
+     * @param sdHandler Pointer zum SDCardHandler (nullptr = ohne Sicherung)
+     * @param voltage Packspannung beim Start (V, gefiltert)
+     * @param current Strom beim Start (A)
+     */
+    void begin(SDCardHandler* sdHandler, float voltage, float current);
+
+    /**
+     * Schätzung fortschreiben (aus BatteryMonitor::update())
+     * @param voltage Packspannung (V, gefiltert)
+     * @param current Strom (A, gefiltert)
+     * @param consumedMAh Energiezähler des BatteryMonitor (monoton)
+     * @param capacity Nennkapazität in mAh
+     */
+    void update(float voltage, float current, float consumedMAh, uint16_t capacity);
+
+    /**
+     * Zustand sofort sichern (vor Sleep/Shutdown)
+     */
+    void save();
+
+    /**
+     * Pack-Innenwiderstand für die IR-Korrektur
+     * @param ohm Widerstand in Ohm
+     */
+    void setInternalResistance(float ohm) { internalR = ohm; }
+    float getInternalResistance() const { return internalR; }
+
+    float getSoc() const { return socPercent; }
+    uint8_t getPercent() const;
+    bool isResting() const { return resting; }
+    float getOcvVoltage() const { return ocvVoltage; }
+
+    /**
+     * Ladezustand aus der Ruhespannung (Kennlinie, ohne Zählung)
+     * @param packVoltage Packspannung in Volt
+     * @return Prozent (0-100)
+     */
+    static float ocvToPercent(float packVoltage);
+
+    /**
+     * Ruhespannung zum Ladezustand (Umkehrung der Kennlinie)
+     * @param percent Ladezustand (0-100)
+     * @return Packspannung in Volt
+     */
+    static float percentToOcv(float percent);
+
+    /**
+     * Debug-Informationen ausgeben
+     */
+    void printInfo() const;
+
+private:
+    SDCardHandler* sdHandler;
+
+    float socPercent;
+    float internalR;
+    float ocvVoltage;              // Letzte IR-korrigierte Spannung
+    float lastConsumedMAh;
+    float savedSoc;                // Zuletzt gesicherter Wert
+    uint16_t capacityMah;          // Zuletzt verwendete Kapazität
+    bool resting;
+    bool fromFile;                 // Startwert aus Datei übernommen
+    unsigned long restSince;       // Beginn Ruhephase (0 = Last)
+    unsigned long lastSaveTime;
+
+    /**
+     * Steilheit der Kennlinie um die Spannung (0..1, 1 = steil)
+     */
+    static float ocvWeight(float packVoltage);
+
+    bool load(SocState& state);
+};
+
+#endif // SOC_ESTIMATOR_H
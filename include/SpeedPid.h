@@ -0,0 +1,125 @@
+/**
+ * SpeedPid.h
+ *
+ * Drehzahlregler pro Kette (Sollwert/Istwert in % der Maximaldrehzahl)
+ *
+ * Features:
+ * - Feed-Forward: Sollwert · kff als Basis, PID korrigiert nur die Abweichung
+ * - Anti-Windup: Integrator friert ein, solange der Ausgang in der Sättigung
+ *   steht und der Fehler weiter hineintreiben würde; zusätzlich begrenzt
+ * - D-Anteil auf den Istwert (kein Sprung bei Sollwertänderung), tiefpassgefiltert
+ *
+ * Header-only und ohne Arduino-Abhängigkeiten, damit derselbe Regler in
+ * tools/motor_plant_sim.cpp gegen das Streckenmodell läuft.
+ * Float: der ESP32-S3 rechnet einfache Genauigkeit in Hardware,
+ * der Regler läuft nur mit SPEED_LOOP_HZ.
+ */
+
+#ifndef SPEED_PID_H
+#define SPEED_PID_H
+
+/**
+ * Reglerparameter
+ */
+struct SpeedPidGains {
+    float kp;               // % Ausgang pro % Fehler
+    float ki;               // % Ausgang pro (% Fehler · s)
+    float kd;               // % Ausgang pro (%/s Istwert-Änderung)
+    float kff;              // Feed-Forward (1.0 = Sollwert direkt)
+};
+
+class SpeedPid {
+public:
+    SpeedPid()
+        : outMin(-100.0f), outMax(100.0f) {
+        gains.kp = 0.0f;
+        gains.ki = 0.0f;
+        gains.kd = 0.0f;
+        gains.kff = 1.0f;
+        reset();
+    }
+
+    void setGains(const SpeedPidGains& g) { gains = g; }
+    const SpeedPidGains& getGains() const { return gains; }
+
+    void setLimits(float minOut, float maxOut) {
+        outMin = minOut;
+        outMax = maxOut;
+    }
+
+    /**
+     * Zustand löschen (Stillstand, Umschalten Open-/Closed-Loop)
+     */
+    void reset() {
+        integral = 0.0f;
+        lastMeasured = 0.0f;
+        dFiltered = 0.0f;
+        lastOutput = 0.0f;
+        saturated = false;
+        first = true;
+    }
+
+    /**
+     * Einen Reglerschritt rechnen
+     * @param setpoint Soll in %
+     * @param measured Ist in %
+     * @param dt Abtastzeit in s
+     * @return Stellgröße in % (outMin..outMax)
+     */
+    float update(float setpoint, float measured, float dt) {
+        float error = setpoint - measured;
+
+        // D auf Istwert, einfacher Tiefpass (α = 0.5)
+        float derivative = 0.0f;
+        if (!first && dt > 0.0f) {
+            derivative = -(measured - lastMeasured) / dt;
+        }
+        dFiltered += (derivative - dFiltered) * 0.5f;
+        lastMeasured = measured;
+        first = false;
+
+        float ff = gains.kff * setpoint;
+        float p = gains.kp * error;
+        float d = gains.kd * dFiltered;
+
+        // Anti-Windup: nur integrieren, wenn es nicht weiter in die Sättigung treibt
+        float candidate = integral + gains.ki * error * dt;
+        float unsat = ff + p + candidate + d;
+        bool pushHigh = unsat > outMax && error > 0.0f;
+        bool pushLow = unsat < outMin && error < 0.0f;
+        if (!pushHigh && !pushLow) {
+            integral = candidate;
+        }
+
+        // Integrator zusätzlich auf den Stellbereich begrenzen
+        float span = outMax - outMin;
+        if (integral > span) integral = span;
+        if (integral < -span) integral = -span;
+
+        float out = ff + p + integral + d;
+        saturated = out > outMax || out < outMin;
+        if (out > outMax) out = outMax;
+        if (out < outMin) out = outMin;
+
+        lastOutput = out;
+        return out;
+    }
+
+    float getIntegral() const { return integral; }
+    float getOutput() const { return lastOutput; }
+    bool isSaturated() const { return saturated; }
+
+private:
+    SpeedPidGains gains;
+    float outMin;
+    float outMax;
+
+    float integral;
+    float lastMeasured;
+    float dFiltered;
+    float lastOutput;
+    bool saturated;
+    bool first;
+};
+
+#endif // SPEED_PID_H
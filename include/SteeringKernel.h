@@ -0,0 +1,91 @@
+/**
+ * SteeringKernel.h
+ *
+ * Festkomma-Kernel für Differential Steering (Joystick → Speed/PWM)
+ *
+ * Features:
+ * - Reine Integer-Arithmetik (kein sqrt, keine Float-Division, kein map())
+ * - Sättigende Umwandlung int16 → Prozent (-100..+100, kein Wrap)
+ * - Normalisierung per Q15-Tabelle: Auslenkung > 100 → auf Kreis r = 100
+ * - Beide Motoren in einem Durchlauf, weitgehend verzweigungsfrei
+ * - Referenzmodell (direkte Division) für bitgenauen Vergleich
+ *
+ * Modell:
+ *   x, y   = sat(joystick, ±100)
+ *   r      = ceil(sqrt(x² + y²))                     (nur wenn r > 100)
+ *   x', y' = trunc(x · 100 / r), trunc(y · 100 / r)
+ *   L, R   = sat(y' - x', ±100), sat(y' + x', ±100)
+ *   PWM    = |s| == 0 ? 0 : 127 + |s| · 128 / 100    (127..255)
+ *
+ * Bewusste Abweichung vom alten Float-Pfad: Speed wird auf ganze Prozent
+ * abgeschnitten, Rest-Speed < 1 % (nach Normalisierung) ist aus. Der Float-Pfad
+ * gab dort schon die Losbrech-PWM 127 bei angezeigtem Speed 0 aus
+ * (88 von 40401 Eingaben in ±100, sonst max. 2 PWM-Stufen Abweichung).
+ *
+ * Ohne Arduino-Abhängigkeiten, damit der Kernel auch auf dem Host läuft
+ * (tools/steering_bench.cpp).
+ */
+
+#ifndef STEERING_KERNEL_H
+#define STEERING_KERNEL_H
+
+#include <stdint.h>
+
+/**
+ * Ergebnis für beide Motoren
+ */
+struct SteeringOutput {
+    int8_t leftSpeed;       // -100 bis +100
+    int8_t rightSpeed;      // -100 bis +100
+    uint8_t leftPWM;        // 0 oder 127-255
+    uint8_t rightPWM;       // 0 oder 127-255
+};
+
+class SteeringKernel {
+public:
+    /**
+     * Joystick-Wert sättigend auf Prozent begrenzen
+     */
+    static inline int8_t toPercent(int16_t value) {
+        int32_t v = value;
+        v = v < -100 ? -100 : v;
+        v = v > 100 ? 100 : v;
+        return (int8_t)v;
+    }
+
+    /**
+     * Speed (-100..+100) → PWM (0 oder 127..255)
+     */
+    static inline uint8_t speedToPwm(int32_t speed) {
+        int32_t sign = speed >> 31;
+        uint32_t mag = (uint32_t)((speed ^ sign) - sign);
+        // 0 → 0, sonst 1..100 linear auf 128..255 (wie map(|s|, 0, 100, 127, 255))
+        return (uint8_t)((mag != 0) * (127 + mag * 128 / 100));
+    }
+
+    /**
+     * Festkomma-Mixer (Betriebspfad)
+     */
+    static void mix(int16_t joystickX, int16_t joystickY, SteeringOutput& out);
+
+    /**
+     * Referenzmodell (direkte Integer-Division, gleiche Semantik)
+     */
+    static void mixReference(int16_t joystickX, int16_t joystickY, SteeringOutput& out);
+
+    /**
+     * Alter Float-Pfad (sqrtf, Float-Skalierung) als Laufzeit-Vergleich
+     * für 'steer' und tools/steering_bench.cpp, nicht im Betriebspfad
+     */
+    static void mixFloat(int16_t joystickX, int16_t joystickY, SteeringOutput& out);
+
+    /**
+     * mix() gegen mixReference() prüfen
+     * Alle Paare in ±150 (inkl. Sättigung) plus int16-Extremwerte
+     * @param checked Ausgabe: Anzahl geprüfter Eingaben
+     * @return Anzahl Abweichungen (0 = bitgenau)
+     */
+    static uint32_t selfTest(uint32_t& checked);
+};
+
+#endif // STEERING_KERNEL_H
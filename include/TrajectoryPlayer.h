@@ -0,0 +1,174 @@
+/**
+ * TrajectoryPlayer.h
+ *
+ * Wiedergabe von Sollwert-Verläufen (Achter, Drehtest, Beschleunigung) im Regel-Takt
+ *
+ * Features:
+ * - Stützpunkte (Zeit, Soll links/rechts) aus Textdatei auf SD oder
+ *   aus der Live-Fahrt aufgezeichnet
+ * - Abtastung im Regel-Takt, Zeitachse auf das Takt-Raster quantisiert:
+ *   Tick-Jitter und ausgelassene Ticks verschieben den Verlauf nicht
+ * - Lineare Interpolation in Q8 (Festkomma, gerundet), Wiederholungen ohne Drift
+ * - Rampe, Strombegrenzer, Drehzahlregler und Command-Watchdog bleiben aktiv:
+ *   die Fernbedienung muss weiter senden (Totmann), Knüppel-Auslenkung
+ *   über TRAJ_OVERRIDE_PCT bricht ab und übernimmt
+ *
+ * Dateiformat (Text, eine Zeile pro Stützpunkt, '#' = Kommentar):
+ *   <t_ms> <links %> <rechts %>
+ *   0     0    0
+ *   1000  60   60
+ *   3000  60  -60
+ * Zeiten streng aufsteigend, Werte -100..+100 (Nachkommastellen erlaubt).
+ */
+
+#ifndef TRAJECTORY_PLAYER_H
+#define TRAJECTORY_PLAYER_H
+
+#include <Arduino.h>
+#include "setupConf.h"
+#include "SDCardHandler.h"
+
+/**
+ * Stützpunkt (8 Bytes)
+ */
+struct TrajectoryPoint {
+    uint32_t timeMs;            // Seit Start des Verlaufs
+    int16_t leftQ8;             // Soll links (% · 256)
+    int16_t rightQ8;            // Soll rechts (% · 256)
+};
+
+enum class TrajectoryState : uint8_t {
+    IDLE = 0,
+    PLAYING,
+    RECORDING
+};
+
+class TrajectoryPlayer {
+public:
+    /**
+     * Konstruktor
+     */
+    TrajectoryPlayer();
+
+    /**
+     * Destruktor
+     */
+    ~TrajectoryPlayer();
+
+    /**
+     * Stützpunkt-Puffer allokieren (PSRAM bevorzugt)
+     * @param sdHandler Pointer zum SDCardHandler
+     * @return true bei Erfolg
+     */
+    bool begin(SDCardHandler* sdHandler);
+
+    // ═══════════════════════════════════════════════════════════════════════
+    // LADEN & SPEICHERN (aus loop())
+    // ═══════════════════════════════════════════════════════════════════════
+
+    /**
+     * Verlauf aus Textdatei laden (ersetzt den aktuellen Verlauf)
+     * @param path Dateipfad
+     * @return true bei Erfolg
+     */
+    bool load(const char* path);
+
+    /**
+     * Aktuellen Verlauf als Textdatei speichern
+     * @param path Dateipfad
+     * @return true bei Erfolg
+     */
+    bool save(const char* path);
+
+    // ═══════════════════════════════════════════════════════════════════════
+    // WIEDERGABE & AUFZEICHNUNG
+    // ═══════════════════════════════════════════════════════════════════════
+
+    /**
+     * Wiedergabe starten
+     * @param repeats Durchläufe (0 = endlos)
+     * @return false wenn kein Verlauf geladen oder bereits aktiv
+     */
+    bool play(uint16_t repeats);
+
+    /**
+     * Aufzeichnung der Live-Sollwerte starten (ersetzt den aktuellen Verlauf)
+     */
+    bool startRecording();
+
+    /**
+     * Wiedergabe/Aufzeichnung beenden (schließt die Aufzeichnung ab, ohne Ausgabe)
+     * Setzt keine Sollwerte zurück - von außen über MotorController::stopTrajectory()
+     * unter dem Motor-Mutex
+     */
+    void stop();
+
+    /**
+     * Wiedergabe sofort abbrechen (aus jedem Kontext, auch Regel-Takt)
+     */
+    void abort() {
+        if (state == TrajectoryState::PLAYING) state = TrajectoryState::IDLE;
+    }
+
+    /**
+     * Live-Sollwert aufzeichnen (aus processMovementInput)
+     * Nur Änderungen werden gespeichert, der Verlauf dazwischen ist linear.
+     */
+    void recordPoint(int32_t leftQ8, int32_t rightQ8);
+
+    /**
+     * Sollwerte für den aktuellen Takt (nur aus dem Regel-Takt)
+     * @param nowUs esp_timer Zeit des Takts
+     * @param leftQ8 Ausgabe Soll links
+     * @param rightQ8 Ausgabe Soll rechts
+     * @return false wenn die Wiedergabe zu Ende ist (Sollwerte dann 0)
+     */
+    bool sample(int64_t nowUs, int32_t& leftQ8, int32_t& rightQ8);
+
+    // ═══════════════════════════════════════════════════════════════════════
+    // STATUS
+    // ═══════════════════════════════════════════════════════════════════════
+
+    bool isPlaying() const { return state == TrajectoryState::PLAYING; }
+    bool isRecording() const { return state == TrajectoryState::RECORDING; }
+    uint32_t getPointCount() const { return pointCount; }
+    uint32_t getDurationMs() const { return pointCount ? points[pointCount - 1].timeMs : 0; }
+
+    /**
+     * Debug-Informationen ausgeben
+     */
+    void printInfo() const;
+
+private:
+    SDCardHandler* sdHandler;
+
+    TrajectoryPoint* points;
+    uint32_t capacity;
+    uint32_t pointCount;
+    char name[32];                  // Herkunft (Dateiname / "live")
+
+    volatile TrajectoryState state;
+
+    // Wiedergabe (Regel-Takt)
+    int64_t startUs;                // Beginn des aktuellen Durchlaufs
+    uint32_t cursor;                // Segment-Index (monoton, kein Suchen pro Takt)
+    uint16_t repeatsWanted;
+    uint16_t repeatsDone;
+    uint32_t samples;
+    uint32_t lastSampleCycles;
+    uint32_t maxSampleCycles;
+
+    // Aufzeichnung (loop())
+    int64_t recordStartUs;
+    int32_t lastLeftQ8;
+    int32_t lastRightQ8;
+    bool recordOverflow;
+
+    /**
+     * Eine Zeile "<t_ms> <links> <rechts>" parsen
+     * @return true wenn ein Stützpunkt gelesen wurde
+     */
+    static bool parseLine(const char* line, TrajectoryPoint& point);
+};
+
+#endif // TRAJECTORY_PLAYER_H
@@ -30,9 +30,36 @@ struct UserConfigStruct {
     uint32_t espnowHeartbeat;
     uint32_t espnowTimeout;
     char espnowPeerMac[18];  // "XX:XX:XX:XX:XX:XX"
+    bool espnowEncrypt;
+    char espnowPsk[65];      // 32 oder 64 Hex-Zeichen
+    
+    // Motor
+    uint16_t motorAccel;     // %/s (0 = sofort)
+    uint16_t motorDecel;     // %/s (0 = sofort)
+    uint8_t motorMinPwm;     // Losbrech-PWM 0..254 (8 Bit)
+    uint8_t motorTrimLeft;   // Verstärkung links 50..100 %
+    uint8_t motorTrimRight;  // Verstärkung rechts 50..100 %
+    uint16_t motorCurrentLimit; // mA (0 = Begrenzer aus)
+    bool motorVoltComp;      // Spannungs-Kompensation der Duty
+    
+    // Drehzahlregelung
+    bool speedLoop;          // Closed-Loop mit Rad-Encodern
+    float speedKp;
+    float speedKi;
+    float speedKd;
+    float speedKff;
+    
+    // Joystick
+    uint8_t joyDeadzone;     // 0..50 %
+    uint8_t joyExpo;         // 0 = linear, 100 = kubisch
     
     // Power
     bool autoShutdownEnabled;
+    uint16_t batteryCapacity;    // mAh (Ladezustand)
+    uint16_t voltCalLowRaw;      // Spannungs-Korrektur: angezeigt (mV, 0 = aus)
+    uint16_t voltCalLowRef;      // ... gemessen (mV)
+    uint16_t voltCalHighRaw;     // Zweiter Punkt (0 = nur Faktor)
+    uint16_t voltCalHighRef;
     
     // Debug
     bool debugSerialEnabled;
@@ -103,9 +130,36 @@ public:
     uint32_t getEspnowHeartbeat() const { return config.espnowHeartbeat; }
     uint32_t getEspnowTimeout() const { return config.espnowTimeout; }
     const char* getEspnowPeerMac() const { return config.espnowPeerMac; }
+    bool getEspnowEncrypt() const { return config.espnowEncrypt; }
+    const char* getEspnowPsk() const { return config.espnowPsk; }
+    
+    // Motor
+    uint16_t getMotorAccel() const { return config.motorAccel; }
+    uint16_t getMotorDecel() const { return config.motorDecel; }
+    uint8_t getMotorMinPwm() const { return config.motorMinPwm; }
+    uint8_t getMotorTrimLeft() const { return config.motorTrimLeft; }
+    uint8_t getMotorTrimRight() const { return config.motorTrimRight; }
+    uint16_t getMotorCurrentLimit() const { return config.motorCurrentLimit; }
+    bool getMotorVoltComp() const { return config.motorVoltComp; }
+    
+    // Drehzahlregelung
+    bool getSpeedLoop() const { return config.speedLoop; }
+    float getSpeedKp() const { return config.speedKp; }
+    float getSpeedKi() const { return config.speedKi; }
+    float getSpeedKd() const { return config.speedKd; }
+    float getSpeedKff() const { return config.speedKff; }
+    
+    // Joystick
+    uint8_t getJoyDeadzone() const { return config.joyDeadzone; }
+    uint8_t getJoyExpo() const { return config.joyExpo; }
     
     // Power
     bool getAutoShutdownEnabled() const { return config.autoShutdownEnabled; }
+    uint16_t getBatteryCapacity() const { return config.batteryCapacity; }
+    uint16_t getVoltCalLowRaw() const { return config.voltCalLowRaw; }
+    uint16_t getVoltCalLowRef() const { return config.voltCalLowRef; }
+    uint16_t getVoltCalHighRaw() const { return config.voltCalHighRaw; }
+    uint16_t getVoltCalHighRef() const { return config.voltCalHighRef; }
     
     // Debug
     bool getDebugSerialEnabled() const { return config.debugSerialEnabled; }
@@ -120,9 +174,39 @@ public:
     void setEspnowHeartbeat(uint32_t value);
     void setEspnowTimeout(uint32_t value);
     void setEspnowPeerMac(const char* mac);
+    void setEspnowEncrypt(bool value);
+    void setEspnowPsk(const char* psk);
+    
+    // Motor
+    void setMotorAccel(uint16_t value);
+    void setMotorDecel(uint16_t value);
+    void setMotorMinPwm(uint8_t value);
+    void setMotorTrimLeft(uint8_t value);
+    void setMotorTrimRight(uint8_t value);
+    void setMotorCurrentLimit(uint16_t value);
+    void setMotorVoltComp(bool value);
+    
+    // Drehzahlregelung
+    void setSpeedLoop(bool value);
+    void setSpeedKp(float value);
+    void setSpeedKi(float value);
+    void setSpeedKd(float value);
+    void setSpeedKff(float value);
+    
+    // Joystick
+    void setJoyDeadzone(uint8_t value);
+    void setJoyExpo(uint8_t value);
+    
+    /**
+     * Änderung von außen markieren (z.B. 'config set' über das Scheme)
+     */
+    void markModified() { setDirty(true); }
     
     // Power
     void setAutoShutdownEnabled(bool value);
+    void setBatteryCapacity(uint16_t value);
+    void setVoltCalLow(uint16_t rawMv, uint16_t refMv);
+    void setVoltCalHigh(uint16_t rawMv, uint16_t refMv);
     
     // Debug
     void setDebugSerialEnabled(bool value);
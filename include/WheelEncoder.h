@@ -0,0 +1,60 @@
+/**
+ * WheelEncoder.h
+ *
+ * Quadratur-Encoder über die PCNT-Einheiten des ESP32-S3
+ *
+ * Features:
+ * - 4-fach Auswertung (beide Flanken beider Spuren) in Hardware
+ * - Glitch-Filter gegen Störimpulse der Motorleitungen
+ * - Überlauf-Akkumulation (accum_count): Zählerstand läuft nicht über
+ * - Auslesen ohne Interrupt, blockiert nicht (für den Regel-Takt)
+ */
+
+#ifndef WHEEL_ENCODER_H
+#define WHEEL_ENCODER_H
+
+#include <Arduino.h>
+#include <driver/pulse_cnt.h>
+#include "setupConf.h"
+
+class WheelEncoder {
+public:
+    /**
+     * Konstruktor
+     */
+    WheelEncoder();
+
+    /**
+     * PCNT-Unit und beide Kanäle einrichten
+     * @param pinA Spur A
+     * @param pinB Spur B
+     * @return true bei Erfolg
+     */
+    bool begin(uint8_t pinA, uint8_t pinB);
+
+    /**
+     * Unit und Kanäle freigeben (z.B. wenn der zweite Encoder fehlt)
+     */
+    void end();
+
+    /**
+     * Zählerstand seit begin() (vorzeichenbehaftet)
+     */
+    int32_t read() const;
+
+    /**
+     * Encoder verfügbar?
+     */
+    bool isReady() const { return unit != nullptr; }
+
+private:
+    pcnt_unit_handle_t unit;
+    pcnt_channel_handle_t channels[2];
+
+    /**
+     * Kanäle und Unit löschen (Fehlerpfad in begin() und end())
+     */
+    static void release(pcnt_unit_handle_t u, pcnt_channel_handle_t a, pcnt_channel_handle_t b);
+};
+
+#endif // WHEEL_ENCODER_H
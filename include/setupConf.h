@@ -12,7 +12,7 @@
  * - ACS712-20A Stromsensor (3.3V)
  * 
  * ESP32 Core Version: 3.3.0
- * - PWM Channels werden automatisch verwaltet
+ * - Motor-PWM auf festen LEDC-Kanälen (MotorDriver), Rest automatisch verwaltet
  */
 
 #ifndef SETUP_CONF_H
@@ -46,7 +46,34 @@
 
 // Motor PWM Einstellungen
 #define MOTOR_PWM_FREQ      20000 // 20 kHz PWM-Frequenz
-#define MOTOR_PWM_RES       8     // 8-Bit Auflösung (0-255)
+#define MOTOR_PWM_RES       10    // 10-Bit Auflösung (0-1023), max. 11 Bit bei 20 kHz
+#define MOTOR_PWM_CH_LEFT   0     // LEDC-Kanal linker Motor
+#define MOTOR_PWM_CH_RIGHT  1     // LEDC-Kanal rechter Motor
+#define MOTOR_PWM_SRC_CLK   80000000UL // LEDC Taktquelle (APB 80 MHz)
+
+// Regel-Takt (esp_timer, unabhängig von loop())
+#define MOTOR_TICK_HZ       1000  // 1 kHz Rampen-/Ausgabetakt
+#define MOTOR_TICK_US       (1000000 / MOTOR_TICK_HZ)
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 🔄 RAD-ENCODER (Quadratur, PCNT)
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define ENCODER_LEFT_A      6     // Spur A linke Kette
+#define ENCODER_LEFT_B      7     // Spur B linke Kette
+#define ENCODER_RIGHT_A     15    // Spur A rechte Kette
+#define ENCODER_RIGHT_B     21    // Spur B rechte Kette
+#define ENCODER_GLITCH_NS   1000  // PCNT Glitch-Filter (Impulse < 1 µs ignorieren)
+#define ENCODER_MAX_CPS     6000  // Counts/s bei 100 % (4-fach, 14.8 V, ohne Last)
+
+// Drehzahlregler (Closed-Loop, optional über speedLoop)
+#define SPEED_LOOP_DIV      10    // Regler jeden 10. Tick
+#define SPEED_LOOP_HZ       (MOTOR_TICK_HZ / SPEED_LOOP_DIV)
+
+// Plausibilität Drehzahlregler: Encoder fehlt oder A/B vertauscht → Open-Loop
+#define SPEED_FAULT_OUT_PCT 50    // Prüfung ab |Reglerausgang| ≥ 50 %
+#define SPEED_FAULT_MIN_PCT 3     // |Ist| < 3 % gilt als "kein Signal"
+#define SPEED_FAULT_STEPS   50    // Reglerschritte in Folge bis Fehler (0.5 s bei 100 Hz)
 
 // Motor Identifikation
 #define MOTOR_ID_LEFT       0     // Linker Motor
@@ -71,18 +98,109 @@
 #define CURRENT_MAX             20.0    // Maximaler Strom in Ampere
 #define CURRENT_WARNING         15.0    // Warnlimit für hohen Strom in Ampere
 
+// Nullpunkt-Kalibrierung im Hintergrund (nur bei stehenden Motoren)
+#define CURRENT_CAL_SAMPLES         100     // Messungen pro Kalibrierung ...
+#define CURRENT_CAL_SAMPLE_MS       10      // ... im Abstand von 10 ms (≈ 1 s)
+#define CURRENT_CAL_IDLE_MS         2000    // Motoren stehen seit 2 s (Strom abgeklungen)
+#define CURRENT_CAL_INTERVAL_MS     60000   // Nachkalibrierung höchstens jede Minute
+#define CURRENT_CAL_BLEND           0.25    // Anteil neuer Messung bei Nachkalibrierung
+#define CURRENT_CAL_MAX_DEV         250     // Max. Abweichung vom Soll-Nullpunkt (Counts, ~0.2 V)
+#define CURRENT_CAL_SAVE_DELTA      2.0     // Auf SD sichern ab 2 Counts Änderung
+#define CURRENT_CAL_FILE            "/battery/ioffset.bin"
+#define CURRENT_CAL_MAGIC           0x31464F49  // "IOF1"
+
+// Strombegrenzer im Motor-Regeltakt (Limit selbst: motorCurrentLimit in UserConfig)
+#define CURRENT_LIMIT_SAMPLE_DIV    1     // Messung jeden n-ten Tick (1 = 1 kHz, nur bei Fahrt)
+#define CURRENT_LIMIT_FILTER_SHIFT  3     // IIR-Glättung 1/8 (~8 ms Zeitkonstante)
+#define CURRENT_LIMIT_SOFT_PCT      80    // Drosselung ab 80 % des Limits
+#define CURRENT_LIMIT_MIN_SCALE     64    // Duty-Faktor am Limit (Q8, 64 = 25 %)
+#define CURRENT_LIMIT_RELEASE       1     // Freigabe pro Messung (Q8, 1 → ~0.2 s bis 100 %)
+
+// Spannungseinbruch-Wächter im Motor-Regeltakt (SagGuard, gleicher Takt wie Strombegrenzer)
+#define SAG_FILTER_SHIFT            2     // IIR-Glättung 1/4 (~4 ms Zeitkonstante)
+#define SAG_SOFT_MV                 12000 // Drosselung ab 12.0 V unter Last (3.0 V/Zelle)
+#define SAG_FLOOR_MV                11000 // Minimaler Faktor ab 11.0 V (BMS trennt bei ~10 V)
+#define SAG_MIN_SCALE               64    // Duty-Faktor am Boden (Q8, 64 = 25 %)
+#define SAG_RELEASE                 1     // Freigabe pro Messung (Q8, 1 → ~0.2 s bis 100 %)
+#define SAG_CONFIRM_MS              3000  // Shutdown erst nach 3 s Unterspannung trotz I·R-Ausgleich
+
+// Spannungs-Kompensation der Motor-Duty (Ein/Aus: motorVoltComp in UserConfig)
+#define MOTOR_VCOMP_NOMINAL_MV      14800 // Bezugsspannung, Faktor 1.0 (3.7 V/Zelle)
+#define MOTOR_VCOMP_MIN_MV          9000  // Darunter keine Kompensation (kein Akku / USB-Versorgung)
+#define MOTOR_VCOMP_MIN_Q8          205   // Kleinster Faktor (Q8, 0.8; voller Akku 16.8 V → 0.88)
+#define MOTOR_VCOMP_MAX_Q8          333   // Größter Faktor (Q8, 1.3; entspricht ~11.4 V)
+
 // ═══════════════════════════════════════════════════════════════════════════
 // 🔋 BATTERIE SCHWELLWERTE (4S Li-Ion)
 // ═══════════════════════════════════════════════════════════════════════════
 
 #define VOLTAGE_RANGE_MAX           25.0  // Modul-Maximum (Hardware-Limit)
+#define VOLTAGE_DIVIDER_RATIO       5.0   // Spannungsteiler des Moduls (30k / 7.5k)
 #define VOLTAGE_BATTERY_MIN         12.8  // 4S Li-Ion sicher leer (3.2V/Zelle)
 #define VOLTAGE_BATTERY_MAX         16.8  // 4S Li-Ion voll (4.2V/Zelle)
 #define VOLTAGE_BATTERY_NOM         14.8  // 4S Li-Ion nominal (3.7V/Zelle)
 #define VOLTAGE_ALARM_LOW           13.2  // Warnung bei <13.2V (3.3V/Zelle)
 #define VOLTAGE_SHUTDOWN            12.8  // AUTO-SHUTDOWN bei 12.8V (3.2V/Zelle)
-#define VOLTAGE_CALIBRATION_FACTOR  0.7   // Kalibrierungsfaktor (Hardware-abhängig)
 #define VOLTAGE_CHECK_INTERVAL      1000  // Spannungs-/Strom-Check alle 1000ms
+#define BATTERY_STATE_DIR           "/battery"  // Ladezustand & Strom-Nullpunkt auf SD
+
+// Ladezustand (SocEstimator: Coulomb-Zählung + Ruhespannung)
+#define BATTERY_CELLS               4       // Zellen in Serie
+#define BATTERY_INTERNAL_R          0.12    // Pack-Innenwiderstand in Ohm (Startwert, wird gemessen)
+#define SOC_REST_CURRENT            0.3     // Ruhe unter 0.3 A ...
+#define SOC_REST_TIME_MS            30000   // ... seit 30 s (Zellspannung erholt)
+#define SOC_OCV_GAIN                0.05    // Angleich an Ruhespannung pro Messung (1 s)
+#define SOC_OCV_SLOPE_FULL_MV       100     // Volle Gewichtung ab 100 mV/Zelle pro 10 % Kennlinie
+#define SOC_BOOT_MISMATCH           15.0    // Start: gesichert vs. Ruhespannung > 15 % → Ruhespannung
+#define SOC_SAVE_DELTA              1.0     // Sichern ab 1 % Änderung ...
+#define SOC_SAVE_INTERVAL_MS        60000   // ... höchstens jede Minute
+#define SOC_STATE_FILE              "/battery/soc.bin"
+#define SOC_STATE_MAGIC             0x31434F53  // "SOC1"
+
+// Innenwiderstand (ResistanceEstimator: ΔU/ΔI bei Lastsprüngen, nur mit DMA-Abtastung)
+#define IR_BLOCK_MS                 100     // Mittelungsblock aus schnellen Werten (~10 pro Block)
+#define IR_BLOCK_MIN_SAMPLES        4       // Mindestens 4 Werte pro Block
+#define IR_STABLE_CURRENT           0.3     // Block stabil bei Strom-Spanne < 0.3 A
+#define IR_STEP_MIN_CURRENT         2.0     // Lastsprung ab 2 A
+#define IR_STEP_TIMEOUT_MS          1500    // Neuer stabiler Arbeitspunkt spätestens nach 1.5 s
+#define IR_MIN_OHM                  0.02    // Plausibel 20 mΩ ...
+#define IR_MAX_OHM                  1.0     // ... bis 1 Ω
+#define IR_AGING_FACTOR             2.0     // Warnung ab 2x BATTERY_INTERNAL_R
+#define IR_SAVE_DELTA               0.005   // Sichern ab 5 mΩ Änderung ...
+#define IR_SAVE_INTERVAL_MS         60000   // ... höchstens jede Minute
+#define IR_STATE_FILE               "/battery/ir.bin"
+#define IR_STATE_MAGIC              0x31455249  // "IRE1"
+
+// Restlaufzeit (RuntimePredictor: Restenergie / Leistung, gewichtet nach Fahranteil)
+#define RUNTIME_POWER_WINDOW        120     // Leistungsmittel über 120 Messungen je Fahrt/Stand (1 s)
+#define RUNTIME_DUTY_WINDOW         600     // Fahranteil der letzten 10 min
+#define RUNTIME_MIN_POWER           0.5     // Darunter keine Prognose (W)
+#define RUNTIME_UNKNOWN             0xFFFFFFFF  // Restlaufzeit unbekannt
+
+// Akku-Verlauf (BatteryHistory: Ringspeicher auf SD, Zeitachse = Betriebszeit)
+#define HISTORY_FILE                "/battery/history.rrd"
+#define HISTORY_SECONDS_SLOTS       600     // 1-s-Werte: 10 min
+#define HISTORY_MINUTES_SLOTS       1440    // 1-min-Aggregate: 24 h
+#define HISTORY_HOURS_SLOTS         720     // 1-h-Aggregate: 30 Tage
+#define HISTORY_FLUSH_MS            10000   // 1-s-Werte alle 10 s am Stück schreiben
+#define HISTORY_FLUSH_RECORDS       16      // RAM-Puffer 1-s-Werte (voll → sofort schreiben)
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 📈 ADC DMA-ABTASTUNG (Spannung + Strom kontinuierlich)
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define ADC_SAMPLE_HZ               20000   // Rohwerte/s gesamt (beide Kanäle abwechselnd)
+#define ADC_DECIMATION              10      // Rohwerte pro dezimiertem Wert (→ 1 kHz/Kanal)
+#define ADC_DMA_FRAME_SIZE          256     // Bytes pro DMA-Frame (64 Rohwerte, ~3.2 ms)
+#define ADC_DMA_POOL_SIZE           1024    // Zwischenspeicher im Treiber (4 Frames)
+#define ADC_TASK_STACK              3072
+#define ADC_TASK_PRIORITY           5       // Über loop(), unter WiFi/esp_timer
+#define ADC_TASK_CORE               1
+
+// Umrechnung Counts → mV (AdcConverter): Werkskalibrierung aus eFuse, sonst linear
+#define ADC_FULL_SCALE_MV           3300    // Lineare Kennlinie ohne eFuse-Daten (4095 Counts)
+#define VOLTAGE_CAL_MIN_SPAN_MV     1000    // Zwei-Punkt-Korrektur: Mindestabstand der Punkte
+#define VOLTAGE_CAL_MAX_DEV         0.2     // Korrekturfaktor höchstens ±20 %
 
 // HINWEIS: 
 // - Software-Shutdown bei 3.2V/Zelle für maximale Akku-Lebensdauer
@@ -108,6 +226,11 @@
 #define LOG_MAX_FILE_SIZE   1048576  // 1 MB
 #define LOG_ROTATION_KEEP   3        // Anzahl rotierter Dateien
 
+// Binäre Log-Records (Hot-Path: kein Formatieren, keine Allokation)
+#define LOG_RECORD_QUEUE_SIZE   64   // Records im Ringpuffer
+#define LOG_RECORD_MAX_ARGS     6    // int32-Argumente pro Record
+#define LOG_RECORD_DRAIN_MAX    16   // Max. formatierte Records pro update()
+
 // ═══════════════════════════════════════════════════════════════════════════
 // 🛡️ FEHLERCODES
 // ═══════════════════════════════════════════════════════════════════════════
@@ -204,4 +327,74 @@ enum ErrorCode {
 #define ESPNOW_MAX_PEERS_LIMIT  20      // ESP-NOW Hardware-Maximum
 #endif
 
+#define TELEMETRY_INTERVAL_MS   500     // Telemetrie an den Master alle 500ms
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ⏱️ ZEITSYNCHRONISATION (NTP-artig über ESP-NOW)
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define TIMESYNC_INTERVAL_MS        1000    // Sync-Request an Master alle 1000ms
+#define TIMESYNC_MAX_DELAY_US       20000   // Samples mit Round-Trip > 20ms verwerfen
+#define TIMESYNC_OFFSET_GAIN_DIV    4       // Offset-Nachführung: 1/4 des Residuums
+#define TIMESYNC_DRIFT_GAIN_DIV     10      // Drift-Nachführung: 1/10 des Residuums/dt
+#define TIMESYNC_MAX_DRIFT_PPM      500.0   // Maximale Quarz-Abweichung (ppm)
+#define TIMESYNC_STEP_US            20000   // Offset-Sprung > 20ms (Master-Neustart): neu aufsetzen
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 📼 PAKET-MITSCHNITT (ESP-NOW Capture)
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define CAPTURE_DIR                 "/capture"
+#define CAPTURE_RING_SIZE           32768   // RAM-Ringpuffer (Zweierpotenz!, PSRAM bevorzugt)
+#define CAPTURE_STAGING_SIZE        4096    // Schreib-/Lesepuffer für SD-Zugriffe
+#define CAPTURE_FLUSH_THRESHOLD     4096    // Flush ab diesem Füllstand (Bytes)
+#define CAPTURE_FLUSH_INTERVAL_MS   1000    // Spätestens alle 1000ms flushen
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ✈️ BLACK BOX (Fahrtenschreiber)
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define BLACKBOX_DIR                "/blackbox"
+#define BLACKBOX_RATE_HZ            MOTOR_TICK_HZ   // Ein Record pro Regel-Takt
+#define BLACKBOX_SECONDS            10      // Zeitfenster mit PSRAM (ohne: 1 s)
+#define BLACKBOX_POST_RECORDS       500     // Nachlauf nach Auslöser (0.5 s)
+#define BLACKBOX_STAGING_SIZE       4096    // Schreibblock für SD (128 Records)
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 🎬 TRAJECTORY (Sollwert-Wiedergabe)
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define TRAJ_DIR                    "/traj"
+#define TRAJ_MAX_POINTS             4096    // Stützpunkte mit PSRAM (8 Bytes/Punkt)
+#define TRAJ_MAX_POINTS_INTERNAL    512     // Ohne PSRAM
+#define TRAJ_OVERRIDE_PCT           20      // Knüppel-Auslenkung bricht Wiedergabe ab
+#define TRAJ_RECORD_HOLD_MS         50      // Länger gehaltener Wert → Haltepunkt vor Sprung
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 🔐 FRAME-VERSCHLÜSSELUNG (AES-CCM)
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define CRYPTO_KEY_LEN          16      // AES-128
+#define CRYPTO_TAG_LEN          8       // CCM Auth-Tag
+#define CRYPTO_NONCE_LEN        12      // CCM Nonce (Richtung + Sequenz + Salt)
+#define CRYPTO_PAIR_NONCE_LEN   8       // Pairing-Nonce je Seite
+#define CRYPTO_PAIR_AUTH_LEN    16      // Pairing-Tag (gekürztes HMAC-SHA256)
+#define CRYPTO_PAIR_HISTORY     8       // Zuletzt akzeptierte Master-Nonces (Replay-Schutz)
+#define CRYPTO_DIR_MASTER       0x01    // Richtung Master → Fahrzeug
+#define CRYPTO_DIR_DEVICE       0x02    // Richtung Fahrzeug → Master
+
+// Max. innerer Frame: 250 - Header(2) - SEQ-TLV(6) - PAYLOAD-TLV-Header(2) - Tag
+#define CRYPTO_MAX_PLAINTEXT    (ESPNOW_MAX_PACKET_SIZE - 10 - CRYPTO_TAG_LEN)
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 📦 FIRMWARE-UPDATE (OTA über ESP-NOW)
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Max. Chunk: innerer Frame - Header(2) - OFFSET-TLV(6) - DATA-TLV-Header(2)
+#define OTA_MAX_CHUNK           (CRYPTO_MAX_PLAINTEXT - 10)
+#define OTA_WINDOW_CHUNKS       8       // Chunks im Flug (< ESPNOW_RX_QUEUE_SIZE!)
+#define OTA_REORDER_SLOTS       4       // Puffer für Chunks außer der Reihe
+#define OTA_SESSION_TIMEOUT_MS  300000  // Session für Resume 5 min halten
+#define OTA_REBOOT_DELAY_MS     1000    // Neustart nach erfolgreichem Update
+
 #endif // SETUP_CONF_H
\ No newline at end of file
@@ -9,6 +9,7 @@
  * - Touch-Kalibrierung
  * - ESP-NOW Parameter
  * - Joystick Parameter
+ * - Akku (Kapazität, Spannungs-Korrektur)
  * - Debug-Einstellungen
  */
 
@@ -25,6 +26,44 @@
 #define ESPNOW_HEARTBEAT_INTERVAL 500                 // Heartbeat alle 500ms
 #define ESPNOW_TIMEOUT            30000                // Verbindungs-Timeout 2s
 #define ESPNOW_PEER_MAC           "10:20:BA:4D:6C:E4" // Peer device MAC (Beispiel)
+#define ESPNOW_ENCRYPT            false               // Steuer-Frames nur verschlüsselt akzeptieren
+#define ESPNOW_PSK                ""                  // Pre-Shared Key (32 oder 64 Hex-Zeichen)
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 🚗 MOTOR BENUTZER-EINSTELLUNGEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define MOTOR_ACCEL_RATE     400      // Beschleunigung in %/s (0 = sofort)
+#define MOTOR_DECEL_RATE     800      // Verzögerung in %/s (0 = sofort)
+#define MOTOR_MIN_PWM        127      // Losbrech-PWM (0-254, auf 8 Bit bezogen)
+#define MOTOR_TRIM_LEFT      100      // Verstärkung links in % (50-100)
+#define MOTOR_TRIM_RIGHT     100      // Verstärkung rechts in % (50-100)
+#define MOTOR_CURRENT_LIMIT  12000    // Strombegrenzung in mA (0 = aus)
+#define MOTOR_VOLT_COMP      true     // Duty mit Nenn-/Akkuspannung skalieren
+
+// Drehzahlregelung (benötigt Rad-Encoder, siehe setupConf.h)
+#define SPEED_LOOP_ENABLED   false    // Closed-Loop aktiv
+#define SPEED_KP             0.8f     // % Ausgang pro % Fehler
+#define SPEED_KI             6.0f     // % Ausgang pro (% Fehler · s)
+#define SPEED_KD             0.0f     // % Ausgang pro (%/s)
+#define SPEED_KFF            1.0f     // Feed-Forward (1.0 = Sollwert als Basis)
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 🕹️ JOYSTICK BENUTZER-EINSTELLUNGEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define JOY_DEADZONE         0        // Deadzone in % (0-50)
+#define JOY_EXPO             0        // Expo in % (0 = linear, 100 = kubisch)
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 🔋 AKKU BENUTZER-EINSTELLUNGEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define BATTERY_CAPACITY     5000     // Akku-Nennkapazität in mAh (4S2P 18650: 2 × 2500 mAh)
+#define VOLT_CAL_LOW_RAW     0        // Spannungs-Korrektur: angezeigt (mV, 0 = aus) ...
+#define VOLT_CAL_LOW_REF     0        // ... und gemessen (Multimeter, mV)
+#define VOLT_CAL_HIGH_RAW    0        // Zweiter Punkt (0 = nur Faktor aus erstem Punkt)
+#define VOLT_CAL_HIGH_REF    0
 
 // ═══════════════════════════════════════════════════════════════════════════
 // 🔧 DEBUG EINSTELLUNGEN
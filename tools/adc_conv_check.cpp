@@ -0,0 +1,266 @@
+/**
+ * adc_conv_check.cpp
+ *
+ * Host-Test für AdcConverter / AdcLinear (Integer-Umrechnung Counts → mV / mA)
+ *
+ * - Kennlinien-Tabelle gegen die volle Kennlinie (jeder Rohwert 0..4095):
+ *   linear, synthetische Kurve mit Krümmung an den Rändern und optional
+ *   eine vom Gerät aufgezeichnete eFuse-Kennlinie ('battery adc' → CSV)
+ * - Spannung (Teiler, Zwei-Punkt-Korrektur) und Strom (Nullpunkt,
+ *   Sensitivität) gegen Gleitkomma-Referenz
+ * - Zeit pro Umrechnung, zum Vergleich die alte Gleitkomma-Formel
+ *
+ * Aufzeichnung: im Serial Monitor 'battery adc', Ausgabe als adc.csv speichern
+ *
+ * Bauen & Starten (aus dem Repo-Root):
+ *   g++ -O2 -std=c++17 -o adc_conv_check tools/adc_conv_check.cpp AdcConverter.cpp
+ *   ./adc_conv_check [adc.csv]
+ */
+
+#include "../include/AdcConverter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static int failures = 0;
+
+static void check(const char* name, bool ok, const char* detailFmt, double a, double b) {
+    printf("  %-34s ", name);
+    printf(detailFmt, a, b);
+    printf(" -> %s\n", ok ? "OK" : "FEHLER");
+    if (!ok) failures++;
+}
+
+// Kennlinie als Wertetabelle für alle Rohwerte (Quelle für AdcConverter::build)
+struct Curve {
+    int mv[AdcConverter::MAX_COUNTS + 1];
+};
+
+static int curveSource(int raw, void* ctx) {
+    const Curve* curve = (const Curve*)ctx;
+    if (raw < 0) raw = 0;
+    if (raw > AdcConverter::MAX_COUNTS) raw = AdcConverter::MAX_COUNTS;
+    return curve->mv[raw];
+}
+
+static void makeLinear(Curve& c, double fullScaleMv) {
+    for (int raw = 0; raw <= AdcConverter::MAX_COUNTS; raw++) {
+        c.mv[raw] = (int)lround(raw * fullScaleMv / AdcConverter::MAX_COUNTS);
+    }
+}
+
+// Synthetisch: Offset am unteren Rand, Steigung < 1 mV/Count und Krümmung
+// oben wie bei 12 dB Dämpfung (Form angelehnt an typische S3-Kennlinien)
+static void makeBent(Curve& c) {
+    for (int raw = 0; raw <= AdcConverter::MAX_COUNTS; raw++) {
+        double x = raw / (double)AdcConverter::MAX_COUNTS;
+        double mv = 12.0 + 3080.0 * x - 60.0 * x * x + 110.0 * pow(x, 8);
+        c.mv[raw] = (int)lround(mv);
+    }
+}
+
+static bool loadCsv(const char* path, Curve& c) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+
+    bool seen[AdcConverter::MAX_COUNTS + 1] = {};
+    char line[64];
+    int count = 0;
+    while (fgets(line, sizeof(line), f)) {
+        int raw, mv;
+        if (sscanf(line, "%d,%d", &raw, &mv) != 2) continue;   // Kopfzeile, Log-Zeilen
+        if (raw < 0 || raw > AdcConverter::MAX_COUNTS) continue;
+        c.mv[raw] = mv;
+        if (!seen[raw]) count++;
+        seen[raw] = true;
+    }
+    fclose(f);
+
+    if (count != AdcConverter::MAX_COUNTS + 1) {
+        printf("  %s: nur %d von %d Rohwerten\n", path, count, AdcConverter::MAX_COUNTS + 1);
+        return false;
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// KENNLINIE
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void testCurve(const char* name, const Curve& curve, int maxErrMv) {
+    printf("\n%s\n", name);
+
+    AdcConverter conv;
+    conv.build(curveSource, (void*)&curve, name);
+
+    int worst = 0;
+    int worstRaw = 0;
+    for (int raw = 0; raw <= AdcConverter::MAX_COUNTS; raw++) {
+        int err = abs(conv.toMv(raw) - curve.mv[raw]);
+        if (err > worst) {
+            worst = err;
+            worstRaw = raw;
+        }
+    }
+    char label[48];
+    snprintf(label, sizeof(label), "Tabelle vs. Kennlinie (@%d)", worstRaw);
+    check(label, worst <= maxErrMv, "max %.0f mV (Grenze %.0f)", worst, maxErrMv);
+
+    // Stützpunkte exakt, Rand und Überlauf
+    check("Stützpunkt 2048", conv.toMv(2048) == curve.mv[2048], "%.0f / %.0f mV",
+          conv.toMv(2048), curve.mv[2048]);
+    check("4095 Counts", abs(conv.toMv(4095) - curve.mv[4095]) <= maxErrMv, "%.0f / %.0f mV",
+          conv.toMv(4095), curve.mv[4095]);
+    check("Überlauf > 4095 begrenzt", conv.toMv(65535) == conv.toMv(4095), "%.0f / %.0f mV",
+          conv.toMv(65535), conv.toMv(4095));
+
+    // Gebrochene Counts (Strom-Nullpunkt) zwischen den ganzzahligen Werten
+    float mid = conv.toMvFloat(2047.5f);
+    bool between = mid >= conv.toMv(2047) - 1 && mid <= conv.toMv(2048) + 1;
+    check("toMvFloat(2047.5)", between, "%.1f mV (Nachbarn %.0f)", mid, conv.toMv(2048));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SPANNUNG / STROM
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void testLinear() {
+    printf("\nAdcLinear\n");
+
+    // Teiler 5.0 über den ganzen Pin-Bereich
+    AdcLinear divider = AdcLinear::make(5.0f);
+    int worst = 0;
+    for (int mv = 0; mv <= 3300; mv++) {
+        worst = std::max(worst, abs(divider.apply(mv) - mv * 5));
+    }
+    check("Teiler × 5", worst == 0, "max %.0f mV Fehler", worst, 0);
+
+    // Zwei-Punkt: angezeigt 13000/16000 mV, gemessen 13150/16240 mV
+    AdcLinear corr;
+    bool ok = AdcLinear::fromPoints(13000, 13150, 16000, 16240, corr);
+    check("Zwei-Punkt unten", ok && abs(corr.apply(13000) - 13150) <= 1, "%.0f / %.0f mV",
+          corr.apply(13000), 13150);
+    check("Zwei-Punkt oben", ok && abs(corr.apply(16000) - 16240) <= 1, "%.0f / %.0f mV",
+          corr.apply(16000), 16240);
+    check("Zwei-Punkt Faktor", fabs(corr.getGain() - 1.03) < 1e-4, "%.5f (Soll %.5f)",
+          corr.getGain(), 1.03);
+    check("Gleiche Punkte abgelehnt", !AdcLinear::fromPoints(14000, 14000, 14000, 15000, corr),
+          "%.0f", 0, 0);
+
+    // Fallende Gerade (Rundung mit negativem Faktor)
+    AdcLinear falling;
+    AdcLinear::fromPoints(0, 1000, 1000, 0, falling);
+    check("Fallende Gerade", falling.apply(250) == 750, "%.0f (Soll %.0f)", falling.apply(250), 750);
+
+    // Hintereinander = Teiler, dann Korrektur
+    AdcLinear::fromPoints(13000, 13150, 16000, 16240, corr);
+    AdcLinear both = divider.then(corr);
+    worst = 0;
+    for (int mv = 0; mv <= 3300; mv++) {
+        worst = std::max(worst, abs(both.apply(mv) - corr.apply(divider.apply(mv))));
+    }
+    check("then() = nacheinander", worst <= 1, "max %.0f mV", worst, 0);
+}
+
+static void testPipeline(const Curve& curve) {
+    printf("\nSpannung & Strom (Kennlinie 'gekrümmt')\n");
+
+    AdcConverter conv;
+    conv.build(curveSource, (void*)&curve, "gekrümmt");
+
+    // Spannung: Teiler 5.0, Korrektur × 1.03 - 240 mV
+    AdcLinear corr;
+    AdcLinear::fromPoints(13000, 13150, 16000, 16240, corr);
+    AdcLinear voltage = AdcLinear::make(5.0f).then(corr);
+    double worstV = 0.0;
+    for (int raw = 0; raw <= AdcConverter::MAX_COUNTS; raw++) {
+        double ref = curve.mv[raw] * 5.0 * 1.03 + (13150.0 - 13000.0 * 1.03);
+        worstV = std::max(worstV, fabs(voltage.apply(conv.toMv(raw)) - ref));
+    }
+    check("Pack-mV vs. Gleitkomma", worstV <= 15.0, "max %.1f mV (Grenze %.0f)", worstV, 15.0);
+
+    // Strom: 66 mV/A, Nullpunkt bei 2047.3 Counts
+    AdcLinear current = AdcLinear::make(1.0f / 0.066f);
+    float zeroCounts = 2047.3f;
+    float zeroMv = conv.toMvFloat(zeroCounts);
+    int32_t zeroMa = (int32_t)(zeroMv * current.getGain() + 0.5f);
+    double worstI = 0.0;
+    for (int raw = 0; raw <= AdcConverter::MAX_COUNTS; raw++) {
+        double ref = (curve.mv[raw] - zeroMv) / 0.066;
+        worstI = std::max(worstI, fabs((current.apply(conv.toMv(raw)) - zeroMa) - ref));
+    }
+    check("mA vs. Gleitkomma", worstI <= 40.0, "max %.1f mA (Grenze %.0f)", worstI, 40.0);
+    int32_t atZero = current.apply(conv.toMv(2047)) - zeroMa;
+    check("Nullpunkt ≈ 0 mA", abs(atZero) <= 20, "%.0f mA", atZero, 0);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// BENCHMARK
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void benchmark(const Curve& curve) {
+    printf("\nBenchmark (4096 × 2000 Umrechnungen)\n");
+
+    AdcConverter conv;
+    conv.build(curveSource, (void*)&curve, "gekrümmt");
+    AdcLinear voltage = AdcLinear::make(5.0f);
+
+    const int rounds = 2000;
+    volatile int64_t sinkInt = 0;
+    volatile float sinkFloat = 0.0f;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int raw = 0; raw <= AdcConverter::MAX_COUNTS; raw++) {
+            sinkInt = sinkInt + voltage.apply(conv.toMv(raw));
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int raw = 0; raw <= AdcConverter::MAX_COUNTS; raw++) {
+            sinkFloat = sinkFloat + (25.0f / 4095.0f) * float(raw) * 0.7f;   // alte Formel
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    double n = rounds * (AdcConverter::MAX_COUNTS + 1.0);
+    printf("  Integer (Tabelle + Q16):  %.2f ns/Wert\n",
+           std::chrono::duration<double, std::nano>(t1 - t0).count() / n);
+    printf("  Gleitkomma (alt):         %.2f ns/Wert (ohne Kennlinie, nur Faktor)\n",
+           std::chrono::duration<double, std::nano>(t2 - t1).count() / n);
+}
+
+int main(int argc, char** argv) {
+    static Curve linear;
+    static Curve bent;
+    static Curve recorded;
+
+    makeLinear(linear, 3300.0);
+    makeBent(bent);
+
+    printf("AdcConverter Host-Test\n");
+    testCurve("Kennlinie linear (3300 mV)", linear, 1);
+    testCurve("Kennlinie gekrümmt (synthetisch)", bent, 2);
+
+    if (argc > 1) {
+        if (loadCsv(argv[1], recorded)) {
+            char name[96];
+            snprintf(name, sizeof(name), "Kennlinie aufgezeichnet (%s)", argv[1]);
+            testCurve(name, recorded, 2);
+        } else {
+            printf("\n%s: nicht lesbar oder unvollständig\n", argv[1]);
+            failures++;
+        }
+    }
+
+    testLinear();
+    testPipeline(bent);
+    benchmark(bent);
+
+    printf("\n%s (%d Fehler)\n", failures ? "❌ FEHLGESCHLAGEN" : "✅ ALLE TESTS OK", failures);
+    return failures ? 1 : 0;
+}
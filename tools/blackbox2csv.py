@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""
+blackbox2csv.py
+
+Konvertiert Black-Box Dateien (/blackbox/bb_NNN.bin) nach CSV.
+
+Dateiformat siehe include/BlackBox.h:
+  BlackBoxFileHeader <4s H H H H B 3x I q I>          (32 Bytes)
+  BlackBoxRecord     <I h h h h h h h h H H H H b B B x>  (32 Bytes) * recordCount
+
+CSV-Spalten: Zeit relativ zum Auslöser (ms, negativ = Vorgeschichte),
+Joystick, Soll/Ausgabe/Ist in %, Duty in %, Strom (A), Spannung (V), RSSI, Flags.
+
+Verwendung:
+  blackbox2csv.py bb_000.bin                  -> bb_000.csv
+  blackbox2csv.py bb_000.bin -o out.csv
+  blackbox2csv.py bb_000.bin --summary        -> nur Kopfdaten und Eckwerte ausgeben
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+FILE_HEADER = struct.Struct("<4sHHHHB3xIqI")
+RECORD = struct.Struct("<IhhhhhhhhHHHHbBBx")
+MAGIC = b"EBBX"
+VERSION = 1
+
+TRIGGERS = {0: "Befehl", 1: "Stopp", 2: "Watchdog"}
+FLAGS = [
+    (0x01, "EN"), (0x02, "CL"), (0x04, "LREV"), (0x08, "RREV"),
+    (0x10, "WDT"), (0x20, "ILIM"), (0x40, "SAG"), (0x80, "SPDF"),
+]
+
+COLUMNS = [
+    "t_ms", "joy_x", "joy_y", "target_l", "target_r", "command_l", "command_r",
+    "measured_l", "measured_r", "duty_l", "duty_r", "current_a", "voltage_v",
+    "rssi", "limit_scale", "flags",
+]
+
+
+def flag_str(flags):
+    return "|".join(name for bit, name in FLAGS if flags & bit)
+
+
+def read_blackbox(path):
+    """Liefert (header_dict, [records]) mit Zeit relativ zum Auslöser."""
+    with open(path, "rb") as f:
+        raw = f.read()
+
+    if len(raw) < FILE_HEADER.size:
+        raise ValueError("Datei zu kurz")
+
+    (magic, version, header_size, record_size, rate_hz, trigger,
+     record_count, trigger_us, pwm_max) = FILE_HEADER.unpack_from(raw, 0)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("Keine gültige Black-Box Datei (magic=%r, version=%d)" % (magic, version))
+    if record_size != RECORD.size:
+        raise ValueError("Unbekannte Record-Größe %d" % record_size)
+
+    header = {
+        "rate_hz": rate_hz, "trigger": trigger, "record_count": record_count,
+        "trigger_us": trigger_us, "pwm_max": pwm_max,
+    }
+
+    available = (len(raw) - header_size) // record_size
+    if available < record_count:
+        print("⚠️  Nur %d von %d Records vorhanden" % (available, record_count), file=sys.stderr)
+
+    trigger_low = trigger_us & 0xFFFFFFFF
+    records = []
+    for i in range(min(available, record_count)):
+        fields = RECORD.unpack_from(raw, header_size + i * record_size)
+        # Zeitstempel sind die unteren 32 Bit: Abstand zum Auslöser vorzeichenrichtig
+        rel = (fields[0] - trigger_low) & 0xFFFFFFFF
+        if rel >= 1 << 31:
+            rel -= 1 << 32
+        records.append((rel,) + fields[1:])
+
+    return header, records
+
+
+def to_row(rec, pwm_max):
+    (rel_us, joy_x, joy_y, tgt_l, tgt_r, cmd_l, cmd_r, meas_l, meas_r,
+     duty_l, duty_r, current_ma, voltage_mv, rssi, flags, scale) = rec
+    return [
+        "%.3f" % (rel_us / 1000.0), joy_x, joy_y,
+        "%.2f" % (tgt_l / 256.0), "%.2f" % (tgt_r / 256.0),
+        "%.2f" % (cmd_l / 256.0), "%.2f" % (cmd_r / 256.0),
+        "%.2f" % (meas_l / 256.0), "%.2f" % (meas_r / 256.0),
+        "%.1f" % (100.0 * duty_l / pwm_max), "%.1f" % (100.0 * duty_r / pwm_max),
+        "%.3f" % (current_ma / 1000.0), "%.3f" % (voltage_mv / 1000.0),
+        rssi, scale, flag_str(flags),
+    ]
+
+
+def summary(header, records):
+    print("Auslöser:   %s" % TRIGGERS.get(header["trigger"], header["trigger"]))
+    print("Records:    %d @ %d Hz" % (len(records), header["rate_hz"]))
+    if not records:
+        return
+    print("Zeitraum:   %.1f .. %.1f ms" % (records[0][0] / 1000.0, records[-1][0] / 1000.0))
+    print("Strom max:  %.2f A" % (max(r[11] for r in records) / 1000.0))
+    print("Spannung:   %.2f .. %.2f V" % (min(r[12] for r in records) / 1000.0,
+                                          max(r[12] for r in records) / 1000.0))
+    limited = sum(1 for r in records if r[15] & 0x20)
+    print("Gedrosselt: %d Records" % limited)
+    sagged = sum(1 for r in records if r[15] & 0x40)
+    print("Einbruch:   %d Records" % sagged)
+    faulted = sum(1 for r in records if r[15] & 0x80)
+    print("Encoder-F.: %d Records" % faulted)
+
+    # Lücken im Takt (Takt verpasst oder Ring übergelaufen)
+    step_us = 1000000 // header["rate_hz"]
+    gaps = sum(1 for a, b in zip(records, records[1:]) if b[0] - a[0] > 2 * step_us)
+    print("Lücken:     %d" % gaps)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Black-Box Datei nach CSV konvertieren")
+    parser.add_argument("input", help="Black-Box Datei (bb_NNN.bin)")
+    parser.add_argument("-o", "--output", help="Ausgabedatei")
+    parser.add_argument("--summary", action="store_true", help="Nur Übersicht ausgeben")
+    args = parser.parse_args()
+
+    try:
+        header, records = read_blackbox(args.input)
+    except (OSError, ValueError) as e:
+        print("❌ %s" % e, file=sys.stderr)
+        return 1
+
+    print("📦 %s: %d Records, Auslöser %s" % (
+        args.input, len(records), TRIGGERS.get(header["trigger"], header["trigger"])),
+        file=sys.stderr)
+
+    if args.summary:
+        summary(header, records)
+        return 0
+
+    output = args.output or args.input.rsplit(".", 1)[0] + ".csv"
+    with open(output, "w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow(COLUMNS)
+        for rec in records:
+            writer.writerow(to_row(rec, header["pwm_max"]))
+    print("✅ CSV -> %s" % output, file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
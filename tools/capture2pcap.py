@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""
+capture2pcap.py
+
+Konvertiert ESP-NOW Capture-Dateien (/capture/cap_NNN.bin) nach pcap
+und schneidet Ausschnitte für das Replay auf dem Gerät zu.
+
+Dateiformat siehe include/PacketCapture.h:
+  CaptureFileHeader   <4s H H 6s 2x q>   (24 Bytes)
+  CaptureRecordHeader <I B b 6s B>       (13 Bytes) + Rohdaten
+
+pcap-Ausgabe (LINKTYPE_USER0 = 147), pro Frame ein 8-Byte Pseudo-Header:
+  [flags 1B] [rssi 1B] [peer mac 6B] [ESP-NOW Rohdaten ...]
+  flags Bit0 = TX (sonst RX)
+
+Verwendung:
+  capture2pcap.py cap_000.bin                 -> cap_000.pcap
+  capture2pcap.py cap_000.bin -o out.pcap
+  capture2pcap.py cap_000.bin --dump          -> Frames als Text ausgeben
+  capture2pcap.py cap_000.bin --trim 10 25 -o part.bin
+                                              -> Ausschnitt 10s..25s als Capture-Datei
+                                                 (auf SD kopieren, 'capture replay part.bin 10')
+"""
+
+import argparse
+import struct
+import sys
+
+FILE_HEADER = struct.Struct("<4sHH6s2xq")
+RECORD_HEADER = struct.Struct("<IBb6sB")
+MAGIC = b"ECAP"
+VERSION = 1
+FLAG_TX = 0x01
+LINKTYPE_USER0 = 147
+
+MAIN_CMDS = {
+    0x01: "HEARTBEAT", 0x02: "ACK", 0x03: "DATA_REQUEST", 0x04: "DATA_RESPONSE",
+    0x05: "PAIR_REQUEST", 0x06: "PAIR_RESPONSE", 0x07: "ERROR",
+    0x08: "TIME_SYNC_REQ", 0x09: "TIME_SYNC_RESP", 0x0A: "SECURE",
+    0x0B: "OTA_BEGIN", 0x0C: "OTA_DATA", 0x0D: "OTA_END", 0x0E: "OTA_ABORT", 0x0F: "OTA_ACK",
+    0x10: "USER_START",
+}
+
+
+def mac_str(mac):
+    return ":".join("%02X" % b for b in mac)
+
+
+def read_capture(path):
+    """Liefert (header_dict, [records]) mit entfaltetem 64-Bit Zeitstempel."""
+    with open(path, "rb") as f:
+        raw = f.read()
+
+    if len(raw) < FILE_HEADER.size:
+        raise ValueError("Datei zu kurz")
+
+    magic, version, header_size, own_mac, start_us = FILE_HEADER.unpack_from(raw, 0)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("Keine gültige Capture-Datei (magic=%r, version=%d)" % (magic, version))
+
+    header = {"own_mac": own_mac, "start_us": start_us, "header_size": header_size}
+    records = []
+
+    offset = header_size
+    time_base = 0
+    last_raw = 0
+    while offset + RECORD_HEADER.size <= len(raw):
+        time_us, flags, rssi, mac, length = RECORD_HEADER.unpack_from(raw, offset)
+        end = offset + RECORD_HEADER.size + length
+        if end > len(raw):
+            print("⚠️  Abgeschnittener Record bei Offset %d ignoriert" % offset, file=sys.stderr)
+            break
+
+        # 32-Bit Überlauf (~71 min) entfalten
+        if time_us < last_raw:
+            time_base += 1 << 32
+        last_raw = time_us
+
+        records.append({
+            "time_us": time_base + time_us,
+            "raw_time_us": time_us,
+            "flags": flags,
+            "rssi": rssi,
+            "mac": mac,
+            "data": raw[offset + RECORD_HEADER.size:end],
+        })
+        offset = end
+
+    return header, records
+
+
+def write_pcap(path, header, records):
+    with open(path, "wb") as f:
+        # Globaler Header: µs-Auflösung, Snaplen 8 + 250
+        f.write(struct.pack("<IHHiIII", 0xA1B2C3D4, 2, 4, 0, 0, 258, LINKTYPE_USER0))
+        for rec in records:
+            ts = header["start_us"] + rec["time_us"]
+            payload = struct.pack("<Bb6s", rec["flags"], rec["rssi"], rec["mac"]) + rec["data"]
+            f.write(struct.pack("<IIII", ts // 1000000, ts % 1000000, len(payload), len(payload)))
+            f.write(payload)
+
+
+def write_capture(path, header, records):
+    """Schreibt Records als Capture-Datei (Zeitbasis = erster Record)."""
+    base = records[0]["time_us"] if records else 0
+    with open(path, "wb") as f:
+        f.write(FILE_HEADER.pack(MAGIC, VERSION, FILE_HEADER.size, header["own_mac"],
+                                 header["start_us"] + base))
+        for rec in records:
+            rel = (rec["time_us"] - base) & 0xFFFFFFFF
+            f.write(RECORD_HEADER.pack(rel, rec["flags"], rec["rssi"], rec["mac"], len(rec["data"])))
+            f.write(rec["data"])
+
+
+def dump(records):
+    for rec in records:
+        data = rec["data"]
+        cmd = MAIN_CMDS.get(data[0], "0x%02X" % data[0]) if data else "-"
+        direction = "TX" if rec["flags"] & FLAG_TX else "RX"
+        rssi = "%4d dBm" % rec["rssi"] if direction == "RX" else "        "
+        print("%12.6f  %s  %s  %s  %-14s %s" % (
+            rec["time_us"] / 1e6, direction, mac_str(rec["mac"]), rssi, cmd, data.hex()))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="ESP-NOW Capture nach pcap konvertieren")
+    parser.add_argument("input", help="Capture-Datei (cap_NNN.bin)")
+    parser.add_argument("-o", "--output", help="Ausgabedatei")
+    parser.add_argument("--dump", action="store_true", help="Frames als Text ausgeben")
+    parser.add_argument("--trim", nargs=2, type=float, metavar=("START", "END"),
+                        help="Ausschnitt in Sekunden als Capture-Datei schreiben (für Replay)")
+    args = parser.parse_args()
+
+    try:
+        header, records = read_capture(args.input)
+    except (OSError, ValueError) as e:
+        print("❌ %s" % e, file=sys.stderr)
+        return 1
+
+    rx = sum(1 for r in records if not r["flags"] & FLAG_TX)
+    duration = records[-1]["time_us"] / 1e6 if records else 0.0
+    print("📼 %s: %d Frames (%d RX, %d TX), %.3f s, Gerät %s" % (
+        args.input, len(records), rx, len(records) - rx, duration, mac_str(header["own_mac"])),
+        file=sys.stderr)
+
+    if args.dump:
+        dump(records)
+        return 0
+
+    if args.trim:
+        start_us, end_us = int(args.trim[0] * 1e6), int(args.trim[1] * 1e6)
+        part = [r for r in records if start_us <= r["time_us"] <= end_us]
+        output = args.output or args.input.rsplit(".", 1)[0] + "_trim.bin"
+        write_capture(output, header, part)
+        print("✅ %d Frames -> %s" % (len(part), output), file=sys.stderr)
+        return 0
+
+    output = args.output or args.input.rsplit(".", 1)[0] + ".pcap"
+    write_pcap(output, header, records)
+    print("✅ pcap -> %s" % output, file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
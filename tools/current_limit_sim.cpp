@@ -0,0 +1,111 @@
+/**
+ * current_limit_sim.cpp
+ *
+ * Host-Simulation des Strombegrenzers (Sprungantwort bei Blockade)
+ *
+ * - Einfaches DC-Motormodell: I = (U · Duty - k · ω) / R, mit Ankerzeitkonstante
+ * - Fahrt mit Vollausschlag, nach 0.5 s blockiert der Motor (ω → 0)
+ * - Misst Spitzenstrom, Zeit bis unter Limit und stationären Strom
+ *   mit und ohne Begrenzer
+ *
+ * Bauen & Starten (aus dem Repo-Root):
+ *   g++ -O2 -std=c++17 -o current_limit_sim tools/current_limit_sim.cpp CurrentLimiter.cpp
+ *   ./current_limit_sim [limit_mA]
+ */
+
+#include "../include/CurrentLimiter.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+struct MotorModel {
+    float voltage = 14.8f;      // Akku nominal
+    float resistance = 0.6f;    // Anker (beide Motoren parallel)
+    float backEmfFree = 13.0f;  // Gegen-EMK bei Leerlaufdrehzahl
+    float tauElectric = 0.002f; // Ankerzeitkonstante L/R
+    float current = 0.0f;       // A
+
+    // dt in s, duty 0..1, speed 0..1 (relativ zur Leerlaufdrehzahl)
+    float step(float dt, float duty, float speed) {
+        float steady = (voltage * duty - backEmfFree * speed) / resistance;
+        if (steady < 0.0f) steady = 0.0f;
+        current += (steady - current) * (dt / tauElectric);
+        return current;
+    }
+};
+
+struct Result {
+    float peakA;
+    float finalA;
+    float responseMs;
+    uint16_t minScale;
+};
+
+static Result run(int32_t limitMa, bool verbose) {
+    const float dt = 1.0f / MOTOR_TICK_HZ;
+    const float stallAt = 0.5f;
+    const float endAt = 1.5f;
+
+    CurrentLimiter limiter;
+    limiter.setLimit(limitMa);
+    MotorModel motor;
+
+    float speed = 0.0f;
+    uint16_t scale = CurrentLimiter::SCALE_ONE;
+    Result r = { 0.0f, 0.0f, -1.0f, CurrentLimiter::SCALE_ONE };
+    float overSince = -1.0f;
+
+    for (int tick = 0; tick * dt < endAt; tick++) {
+        float t = tick * dt;
+
+        // Mechanik: fährt hoch, ab stallAt blockiert
+        if (t < stallAt) {
+            speed += (0.9f - speed) * (dt / 0.15f);
+        } else {
+            speed = 0.0f;
+        }
+
+        float duty = (float)limiter.apply(1023) / 1023.0f;
+        float amps = motor.step(dt, duty, speed);
+        int32_t ma = (int32_t)(amps * 1000.0f);
+
+        scale = limiter.update(ma, (uint32_t)(t * 1e6f));
+
+        if (t >= stallAt) {
+            if (amps > r.peakA) r.peakA = amps;
+            if (limitMa > 0 && ma > limitMa && overSince < 0.0f) overSince = t;
+            if (overSince >= 0.0f && r.responseMs < 0.0f && ma <= limitMa) {
+                r.responseMs = (t - overSince) * 1000.0f;
+            }
+        }
+        if (scale < r.minScale) r.minScale = scale;
+
+        if (verbose && tick % 20 == 0 && t >= stallAt - 0.02f && t < stallAt + 0.2f) {
+            printf("  t=%6.3f s  I=%6.2f A  Faktor=%3u/256\n", t, amps, scale);
+        }
+    }
+
+    r.finalA = motor.current;
+    return r;
+}
+
+int main(int argc, char** argv) {
+    int32_t limitMa = argc > 1 ? atoi(argv[1]) : 12000;
+
+    printf("Motor blockiert bei t=0.5 s, Limit %ld mA (Drosselung ab %d %%)\n\n",
+           (long)limitMa, CURRENT_LIMIT_SOFT_PCT);
+
+    printf("Mit Begrenzer:\n");
+    Result on = run(limitMa, true);
+    Result off = run(0, false);
+
+    printf("\n");
+    printf("                 Spitze     Stationär   Zeit bis < Limit   min. Faktor\n");
+    printf("  ohne Limit:  %7.2f A   %7.2f A\n", off.peakA, off.finalA);
+    printf("  mit Limit:   %7.2f A   %7.2f A   %9.1f ms        %3u/256\n",
+           on.peakA, on.finalA, on.responseMs, on.minScale);
+
+    bool ok = on.finalA * 1000.0f <= limitMa;
+    printf("\nStationär unter Limit: %s\n", ok ? "OK" : "FEHLER");
+    return ok ? 0 : 1;
+}
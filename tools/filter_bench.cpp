@@ -0,0 +1,269 @@
+/**
+ * filter_bench.cpp
+ *
+ * Host-Test und Benchmark für include/Filters.h
+ *
+ * - Genauigkeit: MovingAverage ↔ naive Summe, Median ↔ Sortieren,
+ *   EMA-Sprungantwort, Kalman-Konvergenz, Biquad-Dämpfung (fc, 10·fc)
+ * - Festkomma-Varianten (int32 ADC-Counts) gegen Gleitkomma-Referenz
+ * - Zeit pro Wert, zum Vergleich der alte Moving Average (Summe neu pro Wert)
+ *
+ * Bauen & Starten (aus dem Repo-Root):
+ *   g++ -O2 -std=c++17 -o filter_bench tools/filter_bench.cpp
+ *   ./filter_bench
+ */
+
+#include "../include/Filters.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+static int failures = 0;
+
+static void check(const char* name, bool ok, const char* detailFmt, double a, double b) {
+    printf("  %-34s ", name);
+    printf(detailFmt, a, b);
+    printf(" -> %s\n", ok ? "OK" : "FEHLER");
+    if (!ok) failures++;
+}
+
+static uint32_t seed = 12345;
+
+static int32_t randRange(int32_t lo, int32_t hi) {
+    seed = seed * 1103515245 + 12345;
+    return lo + (int32_t)((seed >> 8) % (uint32_t)(hi - lo + 1));
+}
+
+/**
+ * Alter BatteryMonitor-Filter: Ringpuffer, Summe pro Wert neu gebildet
+ */
+template <int N>
+struct LegacyAverage {
+    float buffer[N] = {};
+    int index = 0;
+
+    float update(float value) {
+        buffer[index] = value;
+        index = (index + 1) % N;
+        float sum = 0.0f;
+        for (int i = 0; i < N; i++) sum += buffer[i];
+        return sum / N;
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// GENAUIGKEIT
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void testMovingAverage() {
+    const int n = 20;
+    const int count = 1000000;
+    static int32_t history[count];
+
+    MovingAverage<int32_t, n> fixed;
+    MovingAverage<float, n> floating;
+    int32_t maxIntDiff = 0;
+    double maxFloatDiff = 0.0;
+
+    for (int i = 0; i < count; i++) {
+        history[i] = randRange(0, 4095);
+        int32_t gotInt = fixed.update(history[i]);
+        float gotFloat = floating.update((float)history[i]);
+
+        int from = std::max(0, i - n + 1);
+        int64_t sum = 0;
+        for (int j = from; j <= i; j++) sum += history[j];
+        int len = i - from + 1;
+        double exact = (double)sum / len;
+
+        int32_t expectInt = (int32_t)((sum + len / 2) / len);
+        maxIntDiff = std::max(maxIntDiff, std::abs(gotInt - expectInt));
+        maxFloatDiff = std::max(maxFloatDiff, std::fabs(gotFloat - exact));
+    }
+
+    check("MovingAverage<int32,20>", maxIntDiff == 0, "max. Abweichung %.0f (Soll %.0f)", maxIntDiff, 0);
+    check("MovingAverage<float,20> 1e6 Werte", maxFloatDiff < 1e-3, "max. Abweichung %.2e (Grenze %.0e)",
+          maxFloatDiff, 1e-3);
+}
+
+static void testMedian() {
+    const int n = 7;
+    const int count = 200000;
+    static int16_t history[count];
+
+    Median<int16_t, n> median;
+    int mismatches = 0;
+
+    for (int i = 0; i < count; i++) {
+        // Wenige Werte → viele Duplikate (Entfernen gleicher Werte prüfen)
+        history[i] = (int16_t)randRange(-20, 20);
+        int16_t got = median.update(history[i]);
+
+        int from = std::max(0, i - n + 1);
+        int16_t window[n];
+        int len = 0;
+        for (int j = from; j <= i; j++) window[len++] = history[j];
+        std::sort(window, window + len);
+        if (got != window[(len - 1) / 2]) mismatches++;
+    }
+
+    check("Median<int16,7> = Sortieren", mismatches == 0, "%.0f Abweichungen (Soll %.0f)", mismatches, 0);
+
+    // Spike-Unterdrückung: einzelne Ausreißer erscheinen nie im Ausgang
+    Median<int32_t, 5> spikes;
+    spikes.fill(1000);
+    int32_t worst = 0;
+    for (int i = 0; i < 1000; i++) {
+        int32_t value = (i % 3 == 0) ? 4095 : 1000;
+        worst = std::max(worst, spikes.update(value));
+    }
+    check("Median<int32,5> Spikes (1 von 3)", worst == 1000, "max. Ausgang %.0f (Soll %.0f)", worst, 1000);
+}
+
+static void testEma() {
+    // Sprung 0 → 1000: nach 2^S Werten 1 - 1/e ≈ 63 % (diskret: 1-(1-α)^N)
+    Ema<int32_t, 4> fixed;
+    Ema<float, 4> floating;
+    fixed.fill(0);
+    floating.fill(0.0f);
+    int32_t fixedAt16 = 0;
+    float floatAt16 = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        fixedAt16 = fixed.update(1000);
+        floatAt16 = floating.update(1000.0f);
+    }
+    double expect = 1000.0 * (1.0 - std::pow(1.0 - 1.0 / 16.0, 16));
+    check("Ema<float,4> Sprung nach 16", std::fabs(floatAt16 - expect) < 0.01, "%.2f (Soll %.2f)",
+          floatAt16, expect);
+    check("Ema<int32,4> Sprung nach 16", std::abs(fixedAt16 - expect) <= 1.0, "%.0f (Soll %.2f)",
+          fixedAt16, expect);
+
+    // Festkomma darf nicht unterhalb des Endwerts hängen bleiben
+    for (int i = 0; i < 1000; i++) fixed.update(1000);
+    check("Ema<int32,4> Endwert", fixed.get() == 1000, "%.0f (Soll %.0f)", fixed.get(), 1000);
+
+    // Negative Werte (RSSI): symmetrisch gerundet
+    Ema<int16_t, 3> rssi;
+    for (int i = 0; i < 200; i++) rssi.update(-67);
+    check("Ema<int16,3> RSSI -67 dBm", rssi.get() == -67, "%.0f (Soll %.0f)", rssi.get(), -67);
+}
+
+static void testKalman() {
+    // Konstanter Wert mit gleichverteiltem Rauschen ±0.5 (Varianz 1/12)
+    Kalman1D<float> kalman(1e-6f, 1.0f / 12.0f);
+    const float truth = 7.4f;
+    float got = 0.0f;
+    for (int i = 0; i < 2000; i++) {
+        float noise = (float)randRange(-500, 500) / 1000.0f;
+        got = kalman.update(truth + noise);
+    }
+    check("Kalman1D konstant + Rauschen", std::fabs(got - truth) < 0.03f, "%.4f (Soll %.4f)", got, truth);
+
+    // Folgt einem Sprung mit eingeschwungener Verstärkung
+    Kalman1D<float> tracker(1e-2f, 1e-1f);
+    tracker.fill(0.0f);
+    for (int i = 0; i < 50; i++) got = tracker.update(1.0f);
+    check("Kalman1D Sprung nach 50", std::fabs(got - 1.0f) < 0.01f, "%.4f (Soll %.4f)", got, 1.0);
+}
+
+static double biquadGain(double freqHz, double sampleHz, double cutoffHz) {
+    Biquad<double> lp(cutoffHz, sampleHz);
+    double peak = 0.0;
+    const int total = (int)(sampleHz * 2);
+    for (int i = 0; i < total; i++) {
+        double y = lp.update(std::sin(2.0 * M_PI * freqHz * i / sampleHz));
+        if (i > total / 2) peak = std::max(peak, std::fabs(y));
+    }
+    return 20.0 * std::log10(peak);
+}
+
+static void testBiquad() {
+    const double fs = 1000.0;
+    const double fc = 20.0;
+
+    double atCutoff = biquadGain(fc, fs, fc);
+    double atDecade = biquadGain(fc * 10, fs, fc);
+    double passband = biquadGain(fc / 10, fs, fc);
+
+    check("Biquad fc=20 Hz @ 2 Hz", std::fabs(passband) < 0.1, "%.2f dB (Soll %.1f dB)", passband, 0.0);
+    check("Biquad fc=20 Hz @ 20 Hz", std::fabs(atCutoff + 3.01) < 0.2, "%.2f dB (Soll %.2f dB)", atCutoff, -3.01);
+    check("Biquad fc=20 Hz @ 200 Hz", atDecade < -38.0, "%.2f dB (Grenze %.0f dB)", atDecade, -38.0);
+
+    // fill(): Gleichwert ohne Einschwingen
+    Biquad<float> settled(20.0f, 1000.0f);
+    settled.fill(12.0f);
+    float worst = 0.0f;
+    for (int i = 0; i < 100; i++) worst = std::max(worst, std::fabs(settled.update(12.0f) - 12.0f));
+    check("Biquad fill() Gleichwert", worst < 1e-3f, "max. Abweichung %.2e (Grenze %.0e)", worst, 1e-3);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LAUFZEIT
+// ═══════════════════════════════════════════════════════════════════════════
+
+template <typename Filter, typename T>
+static void bench(const char* name, Filter& filter, const T* values, int count, int rounds) {
+    volatile double sink = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < count; i++) {
+            sink = sink + (double)filter.update(values[i]);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / ((double)count * rounds);
+    printf("  %-28s %8.2f ns/Wert\n", name, ns);
+    (void)sink;
+}
+
+int main() {
+    printf("Genauigkeit:\n");
+    testMovingAverage();
+    testMedian();
+    testEma();
+    testKalman();
+    testBiquad();
+
+    const int count = 4096;
+    static int32_t ints[count];
+    static int16_t shorts[count];
+    static float floats[count];
+    for (int i = 0; i < count; i++) {
+        ints[i] = randRange(0, 4095);
+        shorts[i] = (int16_t)ints[i];
+        floats[i] = ints[i] * (3.3f / 4095.0f);
+    }
+
+    LegacyAverage<20> legacy20;
+    LegacyAverage<64> legacy64;
+    MovingAverage<float, 20> ma20;
+    MovingAverage<float, 64> ma64;
+    MovingAverage<int32_t, 64> ma64i;
+    Ema<int32_t, 4> emaI;
+    Ema<float, 4> emaF;
+    Median<int16_t, 5> med5;
+    Median<int16_t, 9> med9;
+    Kalman1D<float> kalman(1e-4f, 1e-2f);
+    Biquad<float> biquad(20.0f, 1000.0f);
+
+    printf("Laufzeit:\n");
+    bench("alt: Summe neu (N=20)", legacy20, floats, count, 500);
+    bench("alt: Summe neu (N=64)", legacy64, floats, count, 500);
+    bench("MovingAverage<float,20>", ma20, floats, count, 500);
+    bench("MovingAverage<float,64>", ma64, floats, count, 500);
+    bench("MovingAverage<int32,64>", ma64i, ints, count, 500);
+    bench("Ema<int32,4>", emaI, ints, count, 500);
+    bench("Ema<float,4>", emaF, floats, count, 500);
+    bench("Median<int16,5>", med5, shorts, count, 500);
+    bench("Median<int16,9>", med9, shorts, count, 500);
+    bench("Kalman1D<float>", kalman, floats, count, 500);
+    bench("Biquad<float>", biquad, floats, count, 500);
+
+    printf("Ergebnis:     %s (%d Fehler)\n", failures == 0 ? "OK" : "FEHLER", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,194 @@
+/**
+ * motor_plant_sim.cpp
+ *
+ * Host-Simulation der Drehzahlregelung gegen ein DC-Motor-Streckenmodell
+ *
+ * - Zwei Ketten, links 10 % schwächerer Motor (Fertigungsstreuung)
+ * - Akku sackt bei t=2 s von 16.8 V auf 13.5 V ab, ab t=3 s Zusatzlast links (Gelände)
+ * - Gleiche Kette wie auf dem Board: 1 kHz Takt, Rampe, Regler alle
+ *   SPEED_LOOP_DIV Ticks, Duty-Kennlinie aus InputShaper, Encoder quantisiert
+ * - Vergleich Open-Loop ↔ Closed-Loop: Abweichung vom Soll und zwischen den Ketten
+ * - Laufzeit eines Reglerschritts
+ *
+ * Bauen & Starten (aus dem Repo-Root):
+ *   g++ -O2 -std=c++17 -o motor_plant_sim tools/motor_plant_sim.cpp InputShaper.cpp
+ *   ./motor_plant_sim [kp ki kd kff]
+ */
+
+#include "../include/SpeedPid.h"
+#include "../include/InputShaper.h"
+#include "../include/setupConf.h"
+#include "../include/userConf.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+static const uint32_t MAX_DUTY = (1UL << MOTOR_PWM_RES) - 1;
+
+/**
+ * DC-Motor mit Getriebe, Drehzahl in Encoder-Counts/s
+ * Elektrische Zeitkonstante vernachlässigt (≪ 1 ms)
+ */
+struct MotorPlant {
+    float resistance = 1.5f;    // Ω
+    float ke = 0.0022f;         // V pro Count/s
+    float kt = 1.0f;            // Moment pro A (normiert)
+    float inertia = 2.4e-4f;    // Trägheit (normiert, τ_mech ≈ 0.15 s)
+    float viscous = 1.28e-4f;   // Viskose Reibung
+    float coulomb = 0.3f;       // Haft-/Gleitreibung
+    float load = 0.0f;          // Zusatzlast
+
+    float speed = 0.0f;         // Counts/s
+    double position = 0.0;      // Counts (für Encoder)
+
+    void step(float dt, float voltage, float dutyFrac, int direction) {
+        float current = (voltage * dutyFrac * direction - ke * speed) / resistance;
+        float torque = kt * current;
+        float friction = coulomb + load;
+
+        // Haftreibung: steht und Moment reicht nicht → bleibt stehen
+        if (fabsf(speed) < 1.0f && fabsf(torque) <= friction) {
+            speed = 0.0f;
+            return;
+        }
+
+        float sign = speed > 0.0f ? 1.0f : (speed < 0.0f ? -1.0f : (torque > 0.0f ? 1.0f : -1.0f));
+        float accel = (torque - viscous * speed - friction * sign) / inertia;
+        speed += accel * dt;
+        position += speed * dt;
+    }
+};
+
+struct RunResult {
+    float rmsErrorPct;          // Ist ↔ Soll (beide Ketten, ab 1.5 s)
+    float rmsDriftPct;          // links ↔ rechts
+    float worstDriftPct;
+    float finalLeftPct;
+    float finalRightPct;
+};
+
+static RunResult run(bool closedLoop, const SpeedPidGains& gains, bool verbose) {
+    const float dt = 1.0f / MOTOR_TICK_HZ;
+    const float loopDt = dt * SPEED_LOOP_DIV;
+    const float endAt = 5.0f;
+    const float setpointPct = 60.0f;
+
+    InputShaper shaper;
+    ShapingParams params = { 0, 0, 100, 100, MOTOR_MIN_PWM };
+    shaper.build(params, MAX_DUTY);
+
+    MotorPlant plant[2];
+    plant[MOTOR_ID_LEFT].kt = 0.9f;
+
+    SpeedPid pid[2];
+    for (int m = 0; m < 2; m++) pid[m].setGains(gains);
+
+    int32_t appliedQ8 = 0;
+    int32_t outputQ8[2] = { 0, 0 };
+    int32_t lastCount[2] = { 0, 0 };
+    float measured[2] = { 0.0f, 0.0f };
+    const int32_t accelStep = (MOTOR_ACCEL_RATE * 256) / MOTOR_TICK_HZ;
+
+    double errSum = 0.0, driftSum = 0.0;
+    float worstDrift = 0.0f;
+    int samples = 0;
+
+    for (int tick = 0; tick * dt < endAt; tick++) {
+        float t = tick * dt;
+        float voltage = t < 2.0f ? 16.8f : 13.5f;
+        plant[MOTOR_ID_LEFT].load = t < 3.0f ? 0.0f : 0.25f;
+
+        // Rampe wie MotorController::rampStep (nur Beschleunigung nötig)
+        int32_t target = (int32_t)(setpointPct * 256);
+        appliedQ8 = appliedQ8 + accelStep < target ? appliedQ8 + accelStep : target;
+
+        // Drehzahlregler alle SPEED_LOOP_DIV Ticks
+        if (tick % SPEED_LOOP_DIV == 0) {
+            for (int m = 0; m < 2; m++) {
+                int32_t count = (int32_t)plant[m].position;
+                int32_t delta = count - lastCount[m];
+                lastCount[m] = count;
+                measured[m] = delta * (float)SPEED_LOOP_HZ * 100.0f / ENCODER_MAX_CPS;
+
+                if (closedLoop) {
+                    float out = pid[m].update(appliedQ8 / 256.0f, measured[m], loopDt);
+                    outputQ8[m] = (int32_t)(out * 256.0f);
+                } else {
+                    outputQ8[m] = appliedQ8;
+                }
+            }
+        }
+
+        for (int m = 0; m < 2; m++) {
+            uint32_t duty = shaper.toDuty(outputQ8[m]);
+            plant[m].step(dt, voltage, (float)duty / MAX_DUTY, outputQ8[m] >= 0 ? 1 : -1);
+        }
+
+        if (t >= 1.5f && tick % SPEED_LOOP_DIV == 0) {
+            float e0 = measured[0] - setpointPct;
+            float e1 = measured[1] - setpointPct;
+            float drift = measured[0] - measured[1];
+            errSum += 0.5 * (e0 * e0 + e1 * e1);
+            driftSum += drift * drift;
+            if (fabsf(drift) > worstDrift) worstDrift = fabsf(drift);
+            samples++;
+        }
+
+        if (verbose && tick % 250 == 0) {
+            printf("  t=%4.2f s  U=%4.1f V  Soll=%5.1f %%  L=%5.1f %%  R=%5.1f %%\n",
+                   t, voltage, appliedQ8 / 256.0f, measured[0], measured[1]);
+        }
+    }
+
+    RunResult r;
+    r.rmsErrorPct = (float)sqrt(errSum / samples);
+    r.rmsDriftPct = (float)sqrt(driftSum / samples);
+    r.worstDriftPct = worstDrift;
+    r.finalLeftPct = measured[0];
+    r.finalRightPct = measured[1];
+    return r;
+}
+
+int main(int argc, char** argv) {
+    SpeedPidGains gains = { SPEED_KP, SPEED_KI, SPEED_KD, SPEED_KFF };
+    if (argc >= 5) {
+        gains.kp = (float)atof(argv[1]);
+        gains.ki = (float)atof(argv[2]);
+        gains.kd = (float)atof(argv[3]);
+        gains.kff = (float)atof(argv[4]);
+    }
+
+    printf("Strecke: links 10 %% schwächer, Akku 16.8 → 13.5 V bei 2 s, Last links ab 3 s\n");
+    printf("Regler:  kp=%.2f ki=%.2f kd=%.3f kff=%.2f @ %d Hz\n\n",
+           gains.kp, gains.ki, gains.kd, gains.kff, SPEED_LOOP_HZ);
+
+    printf("Open-Loop:\n");
+    RunResult open = run(false, gains, true);
+    printf("\nClosed-Loop:\n");
+    RunResult closed = run(true, gains, true);
+
+    printf("\n");
+    printf("               RMS Soll-Fehler   RMS L↔R   max L↔R   Ende L / R\n");
+    printf("  Open-Loop:   %8.2f %%       %6.2f %%  %6.2f %%  %5.1f / %5.1f %%\n",
+           open.rmsErrorPct, open.rmsDriftPct, open.worstDriftPct, open.finalLeftPct, open.finalRightPct);
+    printf("  Closed-Loop: %8.2f %%       %6.2f %%  %6.2f %%  %5.1f / %5.1f %%\n",
+           closed.rmsErrorPct, closed.rmsDriftPct, closed.worstDriftPct, closed.finalLeftPct, closed.finalRightPct);
+
+    // Laufzeit eines Reglerschritts
+    SpeedPid pid;
+    pid.setGains(gains);
+    volatile float sink = 0.0f;
+    const int iterations = 10000000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        sink += pid.update(50.0f, (float)(i & 63), 0.01f);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    printf("\nReglerschritt: %.1f ns (Host)\n",
+           std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations);
+    (void)sink;
+
+    return closed.rmsDriftPct < open.rmsDriftPct ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+/**
+ * resistance_sim.cpp
+ *
+ * Host-Simulation der Innenwiderstands-Schätzung (LoadStepEstimator)
+ *
+ * - Akku: Ruhespannung (langsam fallend) minus I · R, Rauschen auf U und I
+ * - Motorstrom mit Einschwingen (τ 30 ms) und PWM-Welligkeit, ein Wert
+ *   alle 10 ms wie aus der DMA-Abtastung
+ * - Szenarien: Lastsprünge an/aus, langsame Rampe, unruhige Fahrt,
+ *   Ausreißer (Spannungssprung während Lastsprung, Einzelwerte über R)
+ * - Prüft Konvergenz auf den wahren Widerstand (±5 %), keine Messungen aus
+ *   Rampe und Fahrt, verworfene bzw. weggefilterte Ausreißer
+ *
+ * Bauen & Starten (aus dem Repo-Root):
+ *   g++ -O2 -std=c++17 -o resistance_sim tools/resistance_sim.cpp LoadStepEstimator.cpp
+ *   ./resistance_sim [innenwiderstand_Ohm]
+ */
+
+#include "../include/LoadStepEstimator.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+static const unsigned long SAMPLE_MS = 10;
+
+static float noise(float amplitude) {
+    return amplitude * (2.0f * rand() / (float)RAND_MAX - 1.0f);
+}
+
+struct PackModel {
+    float ocv = 15.6f;          // Ruhespannung
+    float packR = 0.15f;        // Wahrer Innenwiderstand
+    float current = 0.0f;       // A
+    float tauCurrent = 0.03f;   // Einschwingen Motorstrom
+    float glitchV = 0.0f;       // Zusätzlicher Spannungssprung (Ausreißer)
+    unsigned long nowMs = 0;
+
+    // Einen Abtastwert erzeugen und an den Schätzer geben
+    bool sample(LoadStepEstimator& est, float targetA, float rippleA) {
+        float dt = SAMPLE_MS / 1000.0f;
+        current += (targetA - current) * (1.0f - expf(-dt / tauCurrent));
+        ocv -= 0.00002f;        // ~2 mV/s Entladung
+        nowMs += SAMPLE_MS;
+
+        float i = current + noise(rippleA) + noise(0.03f);
+        float u = ocv + glitchV - current * packR + noise(0.004f);
+        return est.addSample(u, i, nowMs);
+    }
+
+    // Konstante Last für durationMs
+    int hold(LoadStepEstimator& est, float targetA, unsigned long durationMs, float rippleA = 0.05f) {
+        int accepted = 0;
+        for (unsigned long t = 0; t < durationMs; t += SAMPLE_MS) {
+            accepted += sample(est, targetA, rippleA) ? 1 : 0;
+        }
+        return accepted;
+    }
+};
+
+static int failures = 0;
+
+static void report(const char* name, bool ok, const char* fmt, float a, float b) {
+    printf("  %-34s ", name);
+    printf(fmt, a, b);
+    printf(" -> %s\n", ok ? "OK" : "FEHLER");
+    if (!ok) failures++;
+}
+
+// Lastsprünge 0 ↔ 6..12 A, jeweils 1 s Standzeit
+static void testSteps(float packR) {
+    LoadStepEstimator est;
+    PackModel pack;
+    pack.packR = packR;
+    est.seed(BATTERY_INTERNAL_R, 0, 0);
+
+    int accepted = 0;
+    pack.hold(est, 0.0f, 1000);
+    for (int n = 0; n < 20; n++) {
+        float load = 6.0f + (n % 4) * 2.0f;
+        accepted += pack.hold(est, load, 1000, 0.1f);
+        accepted += pack.hold(est, 0.0f, 1000);
+    }
+
+    float err = fabsf(est.getResistance() - packR) / packR;
+    report("Lastsprünge: Messungen", accepted >= 30, "%.0f (Minimum %.0f)", (float)accepted, 30.0f);
+    report("Lastsprünge: Schätzwert", err <= 0.05f, "%.1f mΩ (Soll %.1f mΩ)",
+           est.getResistance() * 1000.0f, packR * 1000.0f);
+}
+
+// Langsame Rampe 0 → 12 A über 3 s und zurück: keine stabilen Arbeitspunkte direkt am Sprung
+static void testRamp(float packR) {
+    LoadStepEstimator est;
+    PackModel pack;
+    pack.packR = packR;
+    est.seed(BATTERY_INTERNAL_R, 0, 0);
+
+    int accepted = pack.hold(est, 0.0f, 1000);
+    for (int n = 0; n < 5; n++) {
+        for (int k = 0; k <= 300; k++) accepted += pack.sample(est, 12.0f * k / 300.0f, 0.05f) ? 1 : 0;
+        accepted += pack.hold(est, 12.0f, 1000, 0.1f);
+        for (int k = 300; k >= 0; k--) accepted += pack.sample(est, 12.0f * k / 300.0f, 0.05f) ? 1 : 0;
+        accepted += pack.hold(est, 0.0f, 1000);
+    }
+
+    report("Rampe 4 A/s: Messungen", accepted == 0, "%.0f (Soll %.0f)", (float)accepted, 0.0f);
+}
+
+// Fahrt mit ständig wechselndem Strom: jeder Block unruhig
+static void testDriving(float packR) {
+    LoadStepEstimator est;
+    PackModel pack;
+    pack.packR = packR;
+    est.seed(BATTERY_INTERNAL_R, 0, 0);
+
+    int accepted = pack.hold(est, 0.0f, 1000);
+    for (int k = 0; k < 3000; k++) {
+        float load = 6.0f + 5.0f * sinf(k * 0.07f) + noise(1.0f);
+        accepted += pack.sample(est, load, 0.3f) ? 1 : 0;
+    }
+
+    report("Fahrt 30 s: Messungen", accepted == 0, "%.0f (Soll %.0f)", (float)accepted, 0.0f);
+}
+
+// Ausreißer: Spannungssprung zeitgleich mit dem Lastsprung (unplausibel → verworfen)
+// und einzelne zu hohe, noch plausible Werte (Median)
+static void testOutliers(float packR) {
+    LoadStepEstimator est;
+    PackModel pack;
+    pack.packR = packR;
+    est.seed(packR, 0, 0);
+
+    pack.hold(est, 0.0f, 1000);
+    for (int n = 0; n < 5; n++) {
+        pack.glitchV = (n % 2) ? 0.0f : 8.0f * packR + 1.0f;   // Spannung steigt trotz Last → R negativ
+        pack.hold(est, 8.0f, 1000, 0.1f);
+        pack.glitchV = 0.0f;
+        pack.hold(est, 0.0f, 1000);
+    }
+    uint32_t rejected = est.getRejected();
+    report("Spannungssprung: verworfen", rejected >= 3, "%.0f (Minimum %.0f)", (float)rejected, 3.0f);
+
+    // Jede fünfte Entlastung mit 1.6 V zu hoher Spannung → zwei Messungen 200 mΩ zu hoch
+    float maxRaw = 0.0f;
+    float maxR = 0.0f;
+    for (int n = 0; n < 20; n++) {
+        pack.hold(est, 8.0f, 1000, 0.1f);
+        if (est.getLastMeasurement() > maxRaw) maxRaw = est.getLastMeasurement();
+        pack.glitchV = (n % 5 == 0) ? 1.6f : 0.0f;
+        pack.hold(est, 0.0f, 1000);
+        pack.glitchV = 0.0f;
+        if (est.getLastMeasurement() > maxRaw) maxRaw = est.getLastMeasurement();
+        if (est.getResistance() > maxR) maxR = est.getResistance();
+    }
+    float err = (maxR - packR) / packR;
+    report("Einzelausreißer: max. Messung", maxRaw >= packR + 0.15f, "%.1f mΩ (Minimum %.1f mΩ)",
+           maxRaw * 1000.0f, (packR + 0.15f) * 1000.0f);
+    report("Einzelausreißer: max. Schätzwert", err <= 0.05f, "%.1f mΩ (Soll %.1f mΩ)",
+           maxR * 1000.0f, packR * 1000.0f);
+}
+
+int main(int argc, char** argv) {
+    float packR = 0.15f;
+    if (argc > 1) packR = (float)atof(argv[1]);
+    srand(1);
+
+    printf("Innenwiderstand %.0f mΩ (Startwert %.0f mΩ), Block %d ms, Sprung ab %.1f A\n\n",
+           packR * 1000.0f, BATTERY_INTERNAL_R * 1000.0f, IR_BLOCK_MS, IR_STEP_MIN_CURRENT);
+
+    testSteps(packR);
+    testRamp(packR);
+    testDriving(packR);
+    testOutliers(packR);
+
+    printf("\nErgebnis:     %s (%d Fehler)\n", failures ? "FEHLER" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * sag_guard_sim.cpp
+ *
+ * Host-Simulation des Spannungseinbruch-Wächters (Anfahren mit Vollausschlag)
+ *
+ * - Akku: Ruhespannung minus I · R (Pack-Innenwiderstand + Zuleitung)
+ * - DC-Motoren wie in current_limit_sim: I = (U · Duty - k · ω) / R, dazu
+ *   Hochlaufen mit mechanischer Zeitkonstante
+ * - Misst tiefste Spannung, Zeit unter SAG_FLOOR_MV und unter der BMS-Trennung
+ *   sowie die Zeit bis 90 % Drehzahl, mit und ohne Wächter
+ *
+ * Bauen & Starten (aus dem Repo-Root):
+ *   g++ -O2 -std=c++17 -o sag_guard_sim tools/sag_guard_sim.cpp SagGuard.cpp
+ *   ./sag_guard_sim [ruhespannung_V] [innenwiderstand_Ohm]
+ */
+
+#include "../include/SagGuard.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+static const float BMS_CUTOFF_V = 10.0f;    // 2.5 V/Zelle
+
+struct DriveModel {
+    float ocv = 13.2f;          // Akku fast leer
+    float packR = 0.25f;        // Innenwiderstand + Zuleitung
+    float motorR = 0.6f;        // Anker (beide Motoren parallel)
+    float backEmfFree = 13.0f;  // Gegen-EMK bei Leerlaufdrehzahl (bei 14.8 V)
+    float tauElectric = 0.002f; // Ankerzeitkonstante L/R
+    float tauMech = 0.25f;      // Hochlaufzeit (63 %)
+    float current = 0.0f;       // A
+    float speed = 0.0f;         // 0..1 relativ zur Leerlaufdrehzahl
+
+    // dt in s, duty 0..1 → Packspannung
+    float step(float dt, float duty) {
+        float pack = ocv - current * packR;
+        float steady = (pack * duty - backEmfFree * speed) / motorR;
+        if (steady < 0.0f) steady = 0.0f;
+        current += (steady - current) * (dt / tauElectric);
+
+        // Endgeschwindigkeit folgt der Klemmenspannung
+        float target = pack * duty / 14.8f;
+        speed += (target - speed) * (dt / tauMech);
+        return ocv - current * packR;
+    }
+};
+
+struct Result {
+    float minV;
+    float belowFloorMs;
+    float belowBmsMs;
+    float to90Ms;
+    float finalV;
+};
+
+static Result run(const DriveModel& base, bool guarded) {
+    DriveModel model = base;
+    SagGuard guard;
+    Result r = { 100.0f, 0.0f, 0.0f, -1.0f, 0.0f };
+
+    const float dtTick = 0.001f;         // 1 kHz Regel-Takt
+    const int subSteps = 20;             // Modell feiner als der Takt
+    const float dt = dtTick / subSteps;
+    float pack = model.ocv;
+
+    for (int tick = 0; tick < 2000; tick++) {
+        uint32_t nowUs = (uint32_t)tick * 1000;
+        uint16_t scale = guarded ? guard.update((int32_t)(pack * 1000.0f), nowUs) : SagGuard::SCALE_ONE;
+        float duty = scale / 256.0f;
+
+        for (int s = 0; s < subSteps; s++) {
+            pack = model.step(dt, duty);
+            if (pack < r.minV) r.minV = pack;
+            if (pack * 1000.0f < SAG_FLOOR_MV) r.belowFloorMs += dt * 1000.0f;
+            if (pack < BMS_CUTOFF_V) r.belowBmsMs += dt * 1000.0f;
+        }
+
+        // 90 % der ungedrosselten Enddrehzahl
+        if (r.to90Ms < 0.0f && model.speed >= 0.9f * (model.ocv - 1.0f) / 14.8f) {
+            r.to90Ms = tick + 1.0f;
+        }
+    }
+    r.finalV = pack;
+    return r;
+}
+
+static void print(const char* name, const Result& r) {
+    printf("  %-14s min %5.2f V | < %.1f V: %6.1f ms | < BMS %.1f V: %6.1f ms | 90 %% Drehzahl: ",
+           name, r.minV, SAG_FLOOR_MV / 1000.0f, r.belowFloorMs, BMS_CUTOFF_V, r.belowBmsMs);
+    if (r.to90Ms < 0.0f) printf("nicht erreicht");
+    else printf("%.0f ms", r.to90Ms);
+    printf(" | Ende %.2f V\n", r.finalV);
+}
+
+int main(int argc, char** argv) {
+    DriveModel model;
+    if (argc > 1) model.ocv = (float)atof(argv[1]);
+    if (argc > 2) model.packR = (float)atof(argv[2]);
+
+    printf("Anfahren mit Vollausschlag: Ruhespannung %.2f V, R %.0f mΩ\n", model.ocv, model.packR * 1000.0f);
+    printf("Wächter: Drosselung ab %.2f V, Faktor %d/256 ab %.2f V, Filter 1/%d\n\n",
+           SAG_SOFT_MV / 1000.0f, SAG_MIN_SCALE, SAG_FLOOR_MV / 1000.0f, 1 << SAG_FILTER_SHIFT);
+
+    Result plain = run(model, false);
+    Result guarded = run(model, true);
+    print("ohne Wächter", plain);
+    print("mit Wächter", guarded);
+
+    bool ok = guarded.minV >= plain.minV && guarded.belowBmsMs <= plain.belowBmsMs;
+    printf("\n%s\n", ok ? "✅ Wächter hebt die tiefste Spannung an" : "❌ Wächter verschlechtert den Einbruch");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+/**
+ * steering_bench.cpp
+ *
+ * Host-Benchmark für den Festkomma-Steering-Kernel
+ *
+ * - Bitgenauer Vergleich mix() ↔ mixReference()
+ * - Abweichung zum alten Float-Pfad (sqrt/map/constrain)
+ * - Zeit bzw. Zyklen pro Kommando (x86: rdtsc). Auf dem Host ist der Festkomma-
+ *   Pfad nicht schneller als Float (SSE hat sqrtss) - maßgeblich ist 'steer'
+ *   auf dem ESP32-S3
+ *
+ * Bauen & Starten (aus dem Repo-Root):
+ *   g++ -O2 -std=c++17 -o steering_bench tools/steering_bench.cpp SteeringKernel.cpp
+ *   ./steering_bench
+ */
+
+#include "../include/SteeringKernel.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_RDTSC 1
+#endif
+
+/**
+ * Alter Pfad aus MotorController::processMovementInput (mit int8-Cast),
+ * nur für den Genauigkeitsvergleich
+ */
+static void mixLegacyFloat(int16_t joystickX, int16_t joystickY, SteeringOutput& out) {
+    int8_t jx = (int8_t)joystickX;
+    int8_t jy = (int8_t)joystickY;
+
+    float distance = sqrtf(jx * jx + jy * jy);
+    float scaleFactor = 1.0f;
+    if (distance > 100.0f) scaleFactor = 100.0f / distance;
+
+    float left = jy * scaleFactor - jx * scaleFactor;
+    float right = jy * scaleFactor + jx * scaleFactor;
+
+    auto toPwm = [](float s) {
+        int mag = (int)fabsf(s);
+        int pwm = (fabsf(s) > 0) ? mag * 128 / 100 + 127 : 0;
+        return (uint8_t)(pwm < 0 ? 0 : pwm > 255 ? 255 : pwm);
+    };
+
+    out.leftSpeed = (int8_t)(left < -100 ? -100 : left > 100 ? 100 : left);
+    out.rightSpeed = (int8_t)(right < -100 ? -100 : right > 100 ? 100 : right);
+    out.leftPWM = toPwm(left);
+    out.rightPWM = toPwm(right);
+}
+
+template <typename Fn>
+static void bench(const char* name, Fn fn, const int16_t* xs, const int16_t* ys, int count, int rounds) {
+    volatile uint32_t sink = 0;
+    SteeringOutput out;
+
+    auto t0 = std::chrono::steady_clock::now();
+#ifdef HAVE_RDTSC
+    uint64_t c0 = __rdtsc();
+#endif
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < count; i++) {
+            fn(xs[i], ys[i], out);
+            sink += out.leftPWM + out.rightPWM;
+        }
+    }
+#ifdef HAVE_RDTSC
+    uint64_t c1 = __rdtsc();
+#endif
+    auto t1 = std::chrono::steady_clock::now();
+
+    double n = (double)count * rounds;
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+#ifdef HAVE_RDTSC
+    printf("  %-12s %8.2f ns/cmd  %8.2f cycles/cmd\n", name, ns, (double)(c1 - c0) / n);
+#else
+    printf("  %-12s %8.2f ns/cmd\n", name, ns);
+#endif
+    (void)sink;
+}
+
+int main() {
+    // 1. Bitgenauigkeit
+    uint32_t checked = 0;
+    uint32_t mismatches = SteeringKernel::selfTest(checked);
+    printf("Self-Test:    %u Eingaben, %u Abweichungen -> %s\n",
+           checked, mismatches, mismatches == 0 ? "OK" : "FEHLER");
+
+    // 2. Abweichung zum alten Float-Pfad (nur gültiger Bereich ±100)
+    int maxPwmDiff = 0;
+    int diffCount = 0;
+    int zeroDiffCount = 0;
+    for (int x = -100; x <= 100; x++) {
+        for (int y = -100; y <= 100; y++) {
+            SteeringOutput a, b;
+            SteeringKernel::mix(x, y, a);
+            mixLegacyFloat(x, y, b);
+            // Float-Pfad liefert für 0 < |s| < 1 bereits PWM 127 → nicht vergleichbar
+            if ((a.leftPWM == 0) != (b.leftPWM == 0) || (a.rightPWM == 0) != (b.rightPWM == 0)) {
+                zeroDiffCount++;
+                continue;
+            }
+            int d = abs(a.leftPWM - b.leftPWM);
+            int e = abs(a.rightPWM - b.rightPWM);
+            if (d || e) diffCount++;
+            if (d > maxPwmDiff) maxPwmDiff = d;
+            if (e > maxPwmDiff) maxPwmDiff = e;
+        }
+    }
+    printf("Float-Pfad:   %d von 40401 Eingaben abweichend, max. %d PWM-Stufen\n", diffCount, maxPwmDiff);
+    printf("              %d mit Rest-Speed < 1 %% (Float: PWM 127, Kernel: aus - gewollt, Speed 0 = aus)\n",
+           zeroDiffCount);
+
+    // 3. Laufzeit (pseudo-zufällige Eingaben, Überlauf über ±100 eingeschlossen)
+    const int count = 4096;
+    static int16_t xs[count], ys[count];
+    uint32_t seed = 12345;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1103515245 + 12345;
+        xs[i] = (int16_t)((seed >> 16) % 301) - 150;
+        seed = seed * 1103515245 + 12345;
+        ys[i] = (int16_t)((seed >> 16) % 301) - 150;
+    }
+
+    printf("Laufzeit:\n");
+    bench("fixed-point", SteeringKernel::mix, xs, ys, count, 2000);
+    bench("reference", SteeringKernel::mixReference, xs, ys, count, 2000);
+    bench("float", SteeringKernel::mixFloat, xs, ys, count, 2000);
+
+    return mismatches == 0 ? 0 : 1;
+}